@@ -20,6 +20,7 @@
 #include "addons/Skin.h"
 #include "addons/VFSEntry.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "dialogs/GUIDialogBusy.h"
@@ -3157,6 +3158,8 @@ void CApplication::OnPlayBackEnded()
 {
   CLog::LogF(LOGDEBUG ,"CApplication::OnPlayBackEnded");
 
+  CServiceBroker::GetDataCacheCore().SignalPlaybackChange();
+
   CServiceBroker::GetPVRManager().OnPlaybackEnded(m_itemCurrentFile);
 
   CVariant data(CVariant::VariantTypeObject);
@@ -3172,6 +3175,8 @@ void CApplication::OnPlayBackStarted(const CFileItem &file)
 {
   CLog::LogF(LOGDEBUG,"CApplication::OnPlayBackStarted");
 
+  CServiceBroker::GetDataCacheCore().SignalPlaybackChange();
+
   // check if VideoPlayer should set file item stream details from its current streams
   if (file.GetProperty("get_stream_details_from_player").asBoolean())
     m_appPlayer.SetUpdateStreamDetails();
@@ -3280,6 +3285,8 @@ void CApplication::OnPlayBackStopped()
 {
   CLog::LogF(LOGDEBUG, "CApplication::OnPlayBackStopped");
 
+  CServiceBroker::GetDataCacheCore().SignalPlaybackChange();
+
   CServiceBroker::GetPVRManager().OnPlaybackStopped(m_itemCurrentFile);
 
   CVariant data(CVariant::VariantTypeObject);
@@ -3367,6 +3374,8 @@ void CApplication::OnAVStarted(const CFileItem &file)
 {
   CLog::LogF(LOGDEBUG, "CApplication::OnAVStarted");
 
+  CServiceBroker::GetDataCacheCore().SignalPlaybackChange();
+
   CGUIMessage msg(GUI_MSG_PLAYBACK_AVSTARTED, 0, 0);
   CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
 
@@ -3381,6 +3390,8 @@ void CApplication::OnAVChange()
 {
   CLog::LogF(LOGDEBUG, "CApplication::OnAVChange");
 
+  CServiceBroker::GetDataCacheCore().SignalPlaybackChange();
+
   CServiceBroker::GetGUI()->GetStereoscopicsManager().OnStreamChange();
 
   CGUIMessage msg(GUI_MSG_PLAYBACK_AVCHANGE, 0, 0);
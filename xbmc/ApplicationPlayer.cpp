@@ -41,6 +41,7 @@ void CApplicationPlayer::ResetPlayer()
   // we need to do this directly on the member
   CSingleLock lock(m_playerLock);
   m_pPlayer.reset();
+  CDataCacheCore::GetInstance().SignalPlaybackChange();
 }
 
 void CApplicationPlayer::CloseFile(bool reopen)
@@ -111,6 +112,7 @@ bool CApplicationPlayer::OpenFile(const CFileItem& item, const CPlayerOptions& o
       {
         CSingleLock lock(m_playerLock);
         m_pPlayer.reset();
+        CDataCacheCore::GetInstance().SignalPlaybackChange();
       }
       return true;
     }
@@ -122,6 +124,7 @@ bool CApplicationPlayer::OpenFile(const CFileItem& item, const CPlayerOptions& o
       CSingleLock lock(m_playerLock);
       m_pPlayer.reset();
       player.reset();
+      CDataCacheCore::GetInstance().SignalPlaybackChange();
     }
   }
 
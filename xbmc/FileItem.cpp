@@ -2378,25 +2378,26 @@ void CFileItemList::Sort(SortDescription sortDescription)
     sortDescription.sortAttributes = (SortAttribute)((int)sortDescription.sortAttributes | SortAttributeIgnoreFolders);
 
   const Fields fields = SortUtils::GetFieldsForSorting(sortDescription.sortBy);
-  SortItems sortItems((size_t)Size());
-  for (int index = 0; index < Size(); index++)
-  {
-    sortItems[index] = std::shared_ptr<SortItem>(new SortItem);
-    m_items[index]->ToSortable(*sortItems[index], fields);
-    (*sortItems[index])[FieldId] = index;
-  }
+  std::vector<std::wstring> sortLabels;
 
   // do the sorting
-  SortUtils::Sort(sortDescription, sortItems);
+  const std::vector<size_t> order = SortUtils::SortIndexed(
+      sortDescription, m_items.size(),
+      [this, &fields](size_t index, SortItem& sortable) {
+        m_items[index]->ToSortable(sortable, fields);
+        sortable[FieldId] = static_cast<int>(index);
+      },
+      &sortLabels);
 
   // apply the new order to the existing CFileItems
   VECFILEITEMS sortedFileItems;
-  sortedFileItems.reserve(Size());
-  for (SortItems::const_iterator it = sortItems.begin(); it != sortItems.end(); it++)
+  sortedFileItems.reserve(order.size());
+  for (size_t index : order)
   {
-    CFileItemPtr item = m_items[(int)(*it)->at(FieldId).asInteger()];
+    CFileItemPtr item = m_items[index];
     // Set the sort label in the CFileItem
-    item->SetSortLabel((*it)->at(FieldSort).asWideString());
+    if (index < sortLabels.size())
+      item->SetSortLabel(sortLabels[index]);
 
     sortedFileItems.push_back(item);
   }
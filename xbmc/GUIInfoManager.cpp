@@ -38,14 +38,8 @@ using namespace KODI::GUILIB;
 using namespace KODI::GUILIB::GUIINFO;
 using namespace INFO;
 
-bool InfoBoolComparator(const InfoPtr &right, const InfoPtr &left)
-{
-  return *right < *left;
-}
-
 CGUIInfoManager::CGUIInfoManager(void)
-: m_currentFile(new CFileItem),
-  m_bools(&InfoBoolComparator)
+: m_currentFile(new CFileItem)
 {
 }
 
@@ -9598,6 +9592,28 @@ int CGUIInfoManager::TranslateSingleString(const std::string &strCondition)
 }
 
 int CGUIInfoManager::TranslateSingleString(const std::string &strCondition, bool &listItemDependent)
+{
+  CSingleLock lock(m_critInfo);
+
+  const auto it = m_translatedConditions.find(strCondition);
+  if (it != m_translatedConditions.end())
+  {
+    if (it->second.listItemDependent)
+      listItemDependent = true;
+    return it->second.condition;
+  }
+
+  TranslatedCondition translated;
+  translated.listItemDependent = false;
+  translated.condition = TranslateSingleStringUncached(strCondition, translated.listItemDependent);
+  m_translatedConditions.emplace(strCondition, translated);
+
+  if (translated.listItemDependent)
+    listItemDependent = true;
+  return translated.condition;
+}
+
+int CGUIInfoManager::TranslateSingleStringUncached(const std::string &strCondition, bool &listItemDependent)
 {
   /* We need to disable caching in INFO::InfoBool::Get if either of the following are true:
    *  1. if condition is between LISTITEM_START and LISTITEM_END
@@ -10361,18 +10377,26 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   if (condition.empty())
     return INFO::InfoPtr();
 
+  // info bools compare their expressions in lower case
+  InfoBoolKey key{condition, context};
+  StringUtils::ToLower(key.expression);
+
   CSingleLock lock(m_critInfo);
-  std::pair<INFOBOOLTYPE::iterator, bool> res;
+  const auto it = m_bools.find(key);
+  if (it != m_bools.end())
+    return it->second;
 
+  INFO::InfoPtr info;
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    info = std::make_shared<InfoExpression>(condition, context, m_refreshCounter);
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    info = std::make_shared<InfoSingle>(condition, context, m_refreshCounter);
 
-  if (res.second)
-    res.first->get()->Initialize();
+  // expressions register their operands while initializing
+  m_bools.emplace(std::move(key), info);
+  info->Initialize();
 
-  return *(res.first);
+  return info;
 }
 
 bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWindow /* = 0 */, const CGUIListItemPtr &item /* = nullptr */)
@@ -10412,6 +10436,25 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   return (condition1 < 0) ? !bReturn : bReturn;
 }
 
+const IGUIInfoProvider* CGUIInfoManager::GetVersionedProvider(int condition1) const
+{
+  int condition = std::abs(condition1);
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    const CGUIInfo& info = m_multiInfo[condition - MULTI_INFO_START];
+    condition = std::abs(info.m_info);
+    if (condition >= LISTITEM_START && condition <= LISTITEM_END)
+      return nullptr;
+
+    return m_infoProviders.GetVersionedProvider(info);
+  }
+  else if (condition >= LISTITEM_START && condition <= LISTITEM_END)
+    return nullptr;
+
+  return m_infoProviders.GetVersionedProvider(CGUIInfo(condition));
+}
+
 bool CGUIInfoManager::GetMultiInfoBool(const CGUIInfo &info, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
@@ -10684,19 +10727,22 @@ void CGUIInfoManager::Clear()
     will remove those bools that are no longer dependencies of other bools
     in the vector.
    */
-  INFOBOOLTYPE swapList(&InfoBoolComparator);
+  INFOBOOLTYPE swapList;
   do
   {
     swapList.clear();
     for (auto &item : m_bools)
-      if (!item.unique())
+      if (!item.second.unique())
         swapList.insert(item);
     m_bools.swap(swapList);
   } while (swapList.size() != m_bools.size());
 
   // log which ones are used - they should all be gone by now
   for (INFOBOOLTYPE::const_iterator i = m_bools.begin(); i != m_bools.end(); ++i)
-    CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", (*i)->GetExpression().c_str(), (unsigned int) i->use_count());
+    CLog::Log(LOGDEBUG, "Infobool '%s' still used by %u instances", i->second->GetExpression().c_str(), (unsigned int) i->second.use_count());
+
+  // translations may contain localized strings of the skin
+  m_translatedConditions.clear();
 }
 
 void CGUIInfoManager::UpdateAVInfo()
@@ -10718,17 +10764,27 @@ void CGUIInfoManager::UpdateAVInfo()
 int CGUIInfoManager::AddMultiInfo(const CGUIInfo &info)
 {
   // check to see if we have this info already
-  for (unsigned int i = 0; i < m_multiInfo.size(); ++i)
-    if (m_multiInfo[i] == info)
-      return static_cast<int>(i) + MULTI_INFO_START;
+  const auto it = m_multiInfoIds.find(info);
+  if (it != m_multiInfoIds.end())
+    return it->second;
   // return the new offset
   m_multiInfo.emplace_back(info);
   int id = static_cast<int>(m_multiInfo.size()) + MULTI_INFO_START - 1;
   if (id > MULTI_INFO_END)
     CLog::Log(LOGERROR, "%s - too many multiinfo bool/labels in this skin", __FUNCTION__);
+  m_multiInfoIds.emplace(info, id);
   return id;
 }
 
+std::size_t CGUIInfoManager::MultiInfoHash::operator()(const CGUIInfo& info) const
+{
+  std::size_t hash = std::hash<int>()(info.m_info);
+  hash = hash * 31 + std::hash<uint32_t>()(info.GetData1());
+  hash = hash * 31 + std::hash<int>()(info.GetData2());
+  hash = hash * 31 + std::hash<std::string>()(info.GetData3());
+  return hash * 31 + std::hash<int>()(info.GetData4());
+}
+
 int CGUIInfoManager::ResolveMultiInfo(int info) const
 {
   int iLastInfo = 0;
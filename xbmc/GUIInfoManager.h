@@ -18,6 +18,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class CFileItem;
@@ -96,6 +97,12 @@ public:
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item = nullptr);
 
+  /*! \brief Get the info provider the value of a condition is versioned by
+   \param condition the condition, as returned by TranslateSingleString
+   \return the provider, nullptr if the condition has to be evaluated on every refresh
+   */
+  const KODI::GUILIB::GUIINFO::IGUIInfoProvider* GetVersionedProvider(int condition) const;
+
   std::string GetItemLabel(const CFileItem *item, int contextWindow, int info, std::string *fallback = nullptr) const;
   std::string GetItemImage(const CGUIListItem *item, int contextWindow, int info, std::string *fallback = nullptr) const;
   /*! \brief Get integer value of info.
@@ -171,6 +178,7 @@ private:
   void SplitInfoString(const std::string &infoString, std::vector<Property> &info);
 
   int TranslateSingleString(const std::string &strCondition);
+  int TranslateSingleStringUncached(const std::string &strCondition, bool &listItemDependent);
   int TranslateListItem(const Property& cat, const Property& prop, int id, bool container);
   int TranslateMusicPlayerString(const std::string &info) const;
   int TranslateVideoPlayerString(const std::string& info) const;
@@ -188,6 +196,36 @@ private:
 
   int AddMultiInfo(const KODI::GUILIB::GUIINFO::CGUIInfo &info);
 
+  struct MultiInfoHash
+  {
+    std::size_t operator()(const KODI::GUILIB::GUIINFO::CGUIInfo& info) const;
+  };
+
+  struct InfoBoolKey
+  {
+    std::string expression; ///< lower case
+    int context;
+
+    bool operator==(const InfoBoolKey& other) const
+    {
+      return context == other.context && expression == other.expression;
+    }
+  };
+
+  struct InfoBoolKeyHash
+  {
+    std::size_t operator()(const InfoBoolKey& key) const
+    {
+      return std::hash<std::string>()(key.expression) ^ std::hash<int>()(key.context);
+    }
+  };
+
+  struct TranslatedCondition
+  {
+    int condition;
+    bool listItemDependent;
+  };
+
   int ResolveMultiInfo(int info) const;
   bool IsListItemInfo(int info) const;
 
@@ -196,11 +234,15 @@ private:
 
   // Vector of multiple information mapped to a single integer lookup
   std::vector<KODI::GUILIB::GUIINFO::CGUIInfo> m_multiInfo;
+  std::unordered_map<KODI::GUILIB::GUIINFO::CGUIInfo, int, MultiInfoHash> m_multiInfoIds;
+
+  // Conditions translated by TranslateSingleString, windows register the same ones on every load
+  std::unordered_map<std::string, TranslatedCondition> m_translatedConditions;
 
   // Current playing stuff
   CFileItem* m_currentFile;
 
-  typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
+  typedef std::unordered_map<InfoBoolKey, INFO::InfoPtr, InfoBoolKeyHash> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
   unsigned int m_refreshCounter = 0;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
@@ -30,7 +30,12 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+// each job decodes, scales and encodes an image of its own, so run as many at once as the job
+// manager allows to spread them over the cores
+CTextureCache::CTextureCache()
+  : CJobQueue(false,
+              CJobManager::GetMaxWorkers(CJob::PRIORITY_LOW_PAUSABLE),
+              CJob::PRIORITY_LOW_PAUSABLE)
 {
 }
 
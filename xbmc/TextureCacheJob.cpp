@@ -23,8 +23,34 @@
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
 
+#include <algorithm>
 #include <inttypes.h>
 
+namespace
+{
+/*!
+ \brief Get the size to pass to the loader of an image to be cached
+ The JPEG loader only takes the size as a hint to decode at a reduced scale, skipping most of the
+ inverse DCT, and leaves the scaling to CPicture::CacheTexture. As the image is cached at no more
+ than the image or fanart resolution, it needn't be decoded any larger. Other loaders may fit the
+ image into the size they get, so they keep the requested size to not scale the image twice.
+ */
+void GetCacheLoadSize(const std::string& mimeType, unsigned int& width, unsigned int& height)
+{
+  if (!StringUtils::EqualsNoCase(mimeType, "image/jpeg") &&
+      !StringUtils::EqualsNoCase(mimeType, "image/jpg"))
+    return;
+
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const unsigned int maxHeight =
+      std::max(advancedSettings->m_imageRes, advancedSettings->m_fanartRes);
+  const unsigned int maxWidth = maxHeight * 16 / 9;
+  width = width ? std::min(width, maxWidth) : maxWidth;
+  height = height ? std::min(height, maxHeight) : maxHeight;
+}
+} // unnamed namespace
+
 CTextureCacheJob::CTextureCacheJob(const std::string &url, const std::string &oldHash):
   m_url(url),
   m_oldHash(oldHash),
@@ -77,7 +103,7 @@ bool CTextureCacheJob::CacheTexture(CTexture** out_texture)
   else if (m_details.hash == m_oldHash)
     return true;
 
-  CTexture* texture = LoadImage(image, width, height, additional_info, true);
+  CTexture* texture = LoadImage(image, width, height, additional_info, true, true);
   if (texture)
   {
     if (texture->HasAlpha())
@@ -172,22 +198,31 @@ CTexture* CTextureCacheJob::LoadImage(const std::string& image,
                                       unsigned int width,
                                       unsigned int height,
                                       const std::string& additional_info,
-                                      bool requirePixels)
+                                      bool requirePixels,
+                                      bool forCache)
 {
   if (additional_info == "music")
   { // special case for embedded music images
     EmbeddedArt art;
     if (CMusicThumbLoader::GetEmbeddedThumb(image, art))
+    {
+      if (forCache)
+        GetCacheLoadSize(art.m_mime, width, height);
       return CTexture::LoadFromFileInMemory(art.m_data.data(), art.m_size, art.m_mime, width,
                                             height);
+    }
   }
 
   if (StringUtils::StartsWith(additional_info, "video_"))
   {
     EmbeddedArt art;
     if (CVideoThumbLoader::GetEmbeddedThumb(image, additional_info.substr(6), art))
+    {
+      if (forCache)
+        GetCacheLoadSize(art.m_mime, width, height);
       return CTexture::LoadFromFileInMemory(art.m_data.data(), art.m_size, art.m_mime, width,
                                             height);
+    }
   }
 
   // Validate file URL to see if it is an image
@@ -197,6 +232,9 @@ CTexture* CTextureCacheJob::LoadImage(const std::string& image,
       && !StringUtils::StartsWithNoCase(file.GetMimeType(), "image/") && !StringUtils::EqualsNoCase(file.GetMimeType(), "application/octet-stream")) // ignore non-pictures
     return NULL;
 
+  if (forCache)
+    GetCacheLoadSize(file.GetMimeType(), width, height);
+
   CTexture* texture =
       CTexture::LoadFromFile(image, width, height, requirePixels, file.GetMimeType());
   if (!texture)
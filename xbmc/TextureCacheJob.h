@@ -108,13 +108,16 @@ private:
    \param width the desired maximum width.
    \param height the desired maximum height.
    \param additional_info extra info for loading, such as whether to flip horizontally.
+   \param forCache whether the image is loaded to be cached. JPEGs are then decoded at a reduced
+   scale if much larger than the size they are cached at.
    \return a pointer to a CTexture object, NULL if failed.
    */
   static CTexture* LoadImage(const std::string& image,
                              unsigned int width,
                              unsigned int height,
                              const std::string& additional_info,
-                             bool requirePixels = false);
+                             bool requirePixels = false,
+                             bool forCache = false);
 
   std::string    m_cachePath;
 };
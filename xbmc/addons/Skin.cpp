@@ -32,6 +32,8 @@
 #include "utils/XMLUtils.h"
 #include "utils/Variant.h"
 
+#include <atomic>
+
 #define XML_SETTINGS      "settings"
 #define XML_SETTING       "setting"
 #define XML_ATTR_TYPE     "type"
@@ -64,6 +66,12 @@ private:
   CTimer m_timer;
 };
 
+namespace
+{
+// increased whenever a setting of the skin in use may have changed
+std::atomic<unsigned int> settingsVersion{0};
+} // unnamed namespace
+
 bool CSkinSetting::Serialize(TiXmlElement* parent) const
 {
   if (parent == nullptr)
@@ -211,6 +219,9 @@ struct closestRes
 
 void CSkinInfo::Start()
 {
+  // the skin in use changes
+  ++settingsVersion;
+
   if (!LoadUserSettings())
     CLog::Log(LOGWARNING, "CSkinInfo: failed to load skin settings");
 
@@ -596,6 +607,7 @@ void CSkinInfo::SetString(int setting, const std::string &label)
   if (it != m_strings.end())
   {
     it->second->value = label;
+    ++settingsVersion;
     m_settingsUpdateHandler->TriggerSave();
     return;
   }
@@ -634,12 +646,18 @@ bool CSkinInfo::GetBool(int setting) const
   return false;
 }
 
+unsigned int CSkinInfo::GetSettingsVersion()
+{
+  return settingsVersion;
+}
+
 void CSkinInfo::SetBool(int setting, bool set)
 {
   auto&& it = m_bools.find(setting);
   if (it != m_bools.end())
   {
     it->second->value = set;
+    ++settingsVersion;
     m_settingsUpdateHandler->TriggerSave();
     return;
   }
@@ -656,6 +674,7 @@ void CSkinInfo::Reset(const std::string &setting)
     if (StringUtils::EqualsNoCase(setting, it.second->name))
     {
       it.second->value.clear();
+      ++settingsVersion;
       m_settingsUpdateHandler->TriggerSave();
       return;
     }
@@ -667,6 +686,7 @@ void CSkinInfo::Reset(const std::string &setting)
     if (StringUtils::EqualsNoCase(setting, it.second->name))
     {
       it.second->value = false;
+      ++settingsVersion;
       m_settingsUpdateHandler->TriggerSave();
       return;
     }
@@ -682,6 +702,7 @@ void CSkinInfo::Reset()
   for (auto& it : m_strings)
     it.second->value.clear();
 
+  ++settingsVersion;
   m_settingsUpdateHandler->TriggerSave();
 }
 
@@ -748,6 +769,7 @@ bool CSkinInfo::SettingsFromXML(const CXBMCTinyXML &doc, bool loadDefaults /* =
 
   m_strings.clear();
   m_bools.clear();
+  ++settingsVersion;
 
   int number = 0;
   std::set<CSkinSettingPtr> settings = ParseSettings(rootElement);
@@ -202,6 +202,11 @@ public:
   void Reset(const std::string &setting);
   void Reset();
 
+  /*! \brief Get the version of the skin settings
+   \return the version, increased whenever a setting of the skin in use may have changed
+   */
+  static unsigned int GetSettingsVersion();
+
   static std::set<CSkinSettingPtr> ParseSettings(const TiXmlElement* rootElement);
 
   void OnPreInstall() override;
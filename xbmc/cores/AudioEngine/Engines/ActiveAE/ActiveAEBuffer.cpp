@@ -12,9 +12,101 @@
 #include "ActiveAEFilter.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <map>
+#include <tuple>
 
 using namespace ActiveAE;
 
+namespace
+{
+
+// enough for the pools of a 7.1 stream and the sink while the engine reconfigures
+constexpr size_t MAX_CACHED_BYTES = 8 * 1024 * 1024;
+
+/*!
+ * Sound packets of deleted buffer pools, grouped by size class. Pools are created and deleted
+ * whenever streams come and go or the engine reconfigures, mostly with the formats seen before.
+ */
+class CSoundPacketCache
+{
+public:
+  ~CSoundPacketCache()
+  {
+    for (auto& sizeClass : m_packets)
+    {
+      for (CSoundPacket* packet : sizeClass.second)
+        delete packet;
+    }
+  }
+
+  CSoundPacket* Take(const SampleConfig& config, int samples)
+  {
+    CSingleLock lock(m_critSection);
+
+    auto it = m_packets.find(SizeClass(config.fmt, config.channels, samples));
+    if (it == m_packets.end() || it->second.empty())
+    {
+      m_stats.allocated++;
+      return new CSoundPacket(config, samples);
+    }
+
+    CSoundPacket* packet = it->second.back();
+    it->second.pop_back();
+    m_stats.reused++;
+    m_stats.cachedBytes -= Size(*packet);
+
+    packet->config = config;
+    packet->nb_samples = 0;
+    packet->pause_burst_ms = 0;
+    return packet;
+  }
+
+  void Put(CSoundPacket* packet)
+  {
+    CSingleLock lock(m_critSection);
+
+    if (m_stats.cachedBytes + Size(*packet) > MAX_CACHED_BYTES)
+    {
+      delete packet;
+      return;
+    }
+
+    m_stats.cachedBytes += Size(*packet);
+    m_packets[SizeClass(packet->config.fmt, packet->config.channels, packet->max_nb_samples)]
+        .emplace_back(packet);
+  }
+
+  SampleBufferPoolStats GetStats()
+  {
+    CSingleLock lock(m_critSection);
+    return m_stats;
+  }
+
+private:
+  using SizeClass = std::tuple<AVSampleFormat, int, int>;
+
+  static size_t Size(const CSoundPacket& packet)
+  {
+    return static_cast<size_t>(packet.linesize) * packet.planes;
+  }
+
+  CCriticalSection m_critSection;
+  std::map<SizeClass, std::vector<CSoundPacket*>> m_packets;
+  SampleBufferPoolStats m_stats = {};
+};
+
+CSoundPacketCache& GetSoundPacketCache()
+{
+  static CSoundPacketCache cache;
+  return cache;
+}
+
+} // unnamed namespace
+
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
 {
   data = CActiveAE::AllocSoundSample(config, samples, bytes_per_sample, planes, linesize);
@@ -42,8 +134,7 @@ CSampleBuffer* CSampleBuffer::Acquire()
 
 void CSampleBuffer::Return()
 {
-  refCount--;
-  if (pool && refCount <= 0)
+  if (--refCount <= 0 && pool)
     pool->ReturnBuffer(this);
 }
 
@@ -61,23 +152,27 @@ CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format)
 
 CActiveAEBufferPool::~CActiveAEBufferPool()
 {
-  CSampleBuffer *buffer;
-  while(!m_allSamples.empty())
+  for (CSampleBuffer* buffer : m_allSamples)
   {
-    buffer = m_allSamples.front();
-    m_allSamples.pop_front();
+    GetSoundPacketCache().Put(buffer->pkt);
+    buffer->pkt = nullptr;
     delete buffer;
   }
 }
 
 CSampleBuffer* CActiveAEBufferPool::GetFreeBuffer()
 {
-  CSampleBuffer* buf = NULL;
+  // only the engine takes buffers, so a buffer can't be taken and returned by another thread
+  // between reading the head and its link (no ABA problem)
+  CSampleBuffer* buf = m_freeSamples.load(std::memory_order_acquire);
+  while (buf && !m_freeSamples.compare_exchange_weak(buf, buf->nextFree, std::memory_order_acquire))
+  {
+  }
 
-  if (!m_freeSamples.empty())
+  if (buf)
   {
-    buf = m_freeSamples.front();
-    m_freeSamples.pop_front();
+    m_freeCount--;
+    buf->nextFree = nullptr;
     buf->refCount = 1;
     buf->centerMixLevel = M_SQRT1_2;
   }
@@ -88,7 +183,28 @@ void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
 {
   buffer->pkt->nb_samples = 0;
   buffer->pkt->pause_burst_ms = 0;
-  m_freeSamples.push_back(buffer);
+
+  buffer->nextFree = m_freeSamples.load(std::memory_order_relaxed);
+  while (!m_freeSamples.compare_exchange_weak(buffer->nextFree, buffer, std::memory_order_release,
+                                              std::memory_order_relaxed))
+  {
+  }
+  m_freeCount++;
+}
+
+bool CActiveAEBufferPool::HasFreeBuffers() const
+{
+  return m_freeSamples.load(std::memory_order_relaxed) != nullptr;
+}
+
+bool CActiveAEBufferPool::AllBuffersReturned() const
+{
+  return m_freeCount == m_allSamples.size();
+}
+
+SampleBufferPoolStats CActiveAEBufferPool::GetStats()
+{
+  return GetSoundPacketCache().GetStats();
 }
 
 bool CActiveAEBufferPool::Create(unsigned int totaltime)
@@ -113,14 +229,20 @@ bool CActiveAEBufferPool::Create(unsigned int totaltime)
   {
     buffer = new CSampleBuffer();
     buffer->pool = this;
-    buffer->pkt = new CSoundPacket(config, m_format.m_frames);
+    buffer->pkt = GetSoundPacketCache().Take(config, m_format.m_frames);
 
     m_allSamples.push_back(buffer);
-    m_freeSamples.push_back(buffer);
+    ReturnBuffer(buffer);
     time += buffertime;
     n++;
   }
 
+  const SampleBufferPoolStats stats = GetStats();
+  CLog::Log(LOGDEBUG,
+            "CActiveAEBufferPool::Create - {} buffers, packets reused: {}, allocated: {}, "
+            "cached: {} bytes",
+            n, stats.reused, stats.allocated, stats.cachedBytes);
+
   return true;
 }
 
@@ -231,7 +353,7 @@ bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffers())
   {
     int free_samples;
     if (m_procSample)
@@ -512,7 +634,7 @@ bool CActiveAEBufferPoolAtempo::ProcessBuffers()
       busy = true;
     }
   }
-  else if (m_procSample || !m_freeSamples.empty())
+  else if (m_procSample || HasFreeBuffers())
   {
     bool skipInput = false;
 
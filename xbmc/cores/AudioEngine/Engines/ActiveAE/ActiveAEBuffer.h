@@ -10,9 +10,11 @@
 
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
+#include <atomic>
 #include <cmath>
 #include <deque>
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include <libavutil/avutil.h>
@@ -53,10 +55,26 @@ public:
   CActiveAEBufferPool *pool = nullptr;
   int64_t timestamp;
   int pkt_start_offset = 0;
-  int refCount = 0;
+  std::atomic<int> refCount{0};
   double centerMixLevel;
+  CSampleBuffer *nextFree = nullptr;     // link in the free list of the pool
 };
 
+struct SampleBufferPoolStats
+{
+  unsigned int reused;                   // packets taken from the cache of deleted pools
+  unsigned int allocated;                // packets allocated because the cache had none
+  size_t cachedBytes;                    // memory held by the cache
+};
+
+/**
+ * Preallocated sample buffers of one format.
+ *
+ * Free buffers are kept in a lock-free list, buffers may be returned from any thread. Only one
+ * thread, the engine, takes buffers. Packets of deleted pools are cached by size class and
+ * reused by the next pool of the same sample format, channel count and size, so reconfiguring
+ * the engine doesn't need to allocate memory either.
+ */
 class CActiveAEBufferPool
 {
 public:
@@ -65,9 +83,15 @@ public:
   virtual bool Create(unsigned int totaltime);
   CSampleBuffer *GetFreeBuffer();
   void ReturnBuffer(CSampleBuffer *buffer);
+  bool HasFreeBuffers() const;
+  bool AllBuffersReturned() const;
+  static SampleBufferPoolStats GetStats();
   AEAudioFormat m_format;
-  std::deque<CSampleBuffer*> m_allSamples;
-  std::deque<CSampleBuffer*> m_freeSamples;
+  std::vector<CSampleBuffer*> m_allSamples;
+
+protected:
+  std::atomic<CSampleBuffer*> m_freeSamples{nullptr};
+  std::atomic<size_t> m_freeCount{0};
 };
 
 class IAEResample;
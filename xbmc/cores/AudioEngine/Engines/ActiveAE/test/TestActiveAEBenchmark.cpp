@@ -0,0 +1,227 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+// seconds of audio pushed through the engine per scenario
+constexpr unsigned int DURATION = 20;
+
+struct Scenario
+{
+  const char* name;
+  AEDataFormat dataFormat;
+  unsigned int sampleRate;
+  AEStdChLayout layout;
+};
+
+class CStageTimer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  void Start() { m_start = Clock::now(); }
+  void Stop()
+  {
+    const auto duration = Clock::now() - m_start;
+    m_total += duration;
+    m_max = std::max(m_max, duration);
+    m_count++;
+  }
+
+  void Report(const std::string& scenario, const std::string& stage, double seconds) const
+  {
+    using namespace std::chrono;
+    const double total = duration_cast<duration<double>>(m_total).count();
+    const std::string prefix = scenario + "_" + stage + "_";
+    ::testing::Test::RecordProperty(prefix + "RealtimeFactor",
+                                    std::to_string(seconds / std::max(total, 1e-9)));
+    ::testing::Test::RecordProperty(
+        prefix + "MeanLatencyUs", std::to_string(total * 1e6 / std::max<unsigned int>(m_count, 1)));
+    ::testing::Test::RecordProperty(prefix + "MaxLatencyUs",
+                                    std::to_string(duration_cast<microseconds>(m_max).count()));
+  }
+
+private:
+  Clock::time_point m_start;
+  Clock::duration m_total = Clock::duration::zero();
+  Clock::duration m_max = Clock::duration::zero();
+  unsigned int m_count = 0;
+};
+
+void FillSine(CSoundPacket& pkt, AEDataFormat format, unsigned int& phase)
+{
+  const unsigned int channels = pkt.config.channels;
+  for (int frame = 0; frame < pkt.max_nb_samples; ++frame, ++phase)
+  {
+    const float value = 0.5f * sinf(2.0f * static_cast<float>(M_PI) * 440.0f * phase /
+                                     pkt.config.sample_rate);
+    for (unsigned int ch = 0; ch < channels; ++ch)
+    {
+      const unsigned int i = frame * channels + ch;
+      if (format == AE_FMT_S16NE)
+        reinterpret_cast<int16_t*>(pkt.data[0])[i] = static_cast<int16_t>(value * INT16_MAX);
+      else if (format == AE_FMT_S32NE)
+        reinterpret_cast<int32_t*>(pkt.data[0])[i] = static_cast<int32_t>(value * INT32_MAX);
+      else
+        reinterpret_cast<float*>(pkt.data[0])[i] = value;
+    }
+  }
+  pkt.nb_samples = pkt.max_nb_samples;
+}
+
+} // namespace
+
+/*!
+ * Pushes synthetic streams through the stages of the transcode path of the engine: the stream
+ * buffers (resample, remap and tempo), mixing with a gui sound, the AC3 encoder and IEC packing
+ * into the null sink. Each stage reports how much faster than realtime it runs and its latency
+ * per buffer.
+ */
+TEST(TestActiveAEBenchmark, DISABLED_Transcode)
+{
+  const std::vector<Scenario> scenarios = {
+      {"2.0_44100_S16", AE_FMT_S16NE, 44100, AE_CH_LAYOUT_2_0},
+      {"5.1_48000_FLOAT", AE_FMT_FLOAT, 48000, AE_CH_LAYOUT_5_1},
+      {"7.1_96000_S32", AE_FMT_S32NE, 96000, AE_CH_LAYOUT_7_1}};
+
+  for (const auto& scenario : scenarios)
+  {
+    SCOPED_TRACE(scenario.name);
+
+    // the engine transcodes planar float at 48kHz in the layout of the encoder
+    AEAudioFormat encoderFormat;
+    encoderFormat.m_dataFormat = AE_FMT_FLOATP;
+    encoderFormat.m_sampleRate = 48000;
+    encoderFormat.m_channelLayout = scenario.layout;
+    CAEEncoderFFmpeg encoder;
+    ASSERT_TRUE(encoder.Initialize(encoderFormat, true));
+    ASSERT_EQ(AV_CODEC_ID_AC3, encoder.GetCodecID());
+
+    AEAudioFormat inputFormat;
+    inputFormat.m_dataFormat = scenario.dataFormat;
+    inputFormat.m_sampleRate = scenario.sampleRate;
+    inputFormat.m_channelLayout = scenario.layout;
+    inputFormat.m_frames = 1024;
+    inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() *
+                              (CAEUtil::DataFormatToBits(inputFormat.m_dataFormat) >> 3);
+
+    CActiveAEBufferPool input(inputFormat);
+    ASSERT_TRUE(input.Create(500));
+    CActiveAEStreamBuffers stream(inputFormat, encoderFormat, AE_QUALITY_MID);
+    ASSERT_TRUE(stream.Create(500, false, false));
+    // like the engine does when transcoding, the encoder needs full frames
+    stream.FillBuffer();
+
+    AEAudioFormat sinkFormat;
+    sinkFormat.m_dataFormat = AE_FMT_RAW;
+    sinkFormat.m_sampleRate = 48000;
+    sinkFormat.m_channelLayout = AE_CH_LAYOUT_2_0;
+    sinkFormat.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+    sinkFormat.m_streamInfo.m_channels = 2;
+    sinkFormat.m_streamInfo.m_sampleRate = 48000;
+    sinkFormat.m_streamInfo.m_ac3FrameSize = encoderFormat.m_frames;
+    std::string device = "null";
+    CAESinkNULL sink;
+    ASSERT_TRUE(sink.Initialize(sinkFormat, device));
+    CAEBitstreamPacker packer;
+
+    const std::vector<float> sound(encoderFormat.m_frames, 0.25f);
+    std::vector<uint8_t> encoded(MAX_IEC61937_PACKET);
+
+    CStageTimer streamTimer, mixTimer, encodeTimer, sinkTimer;
+    const auto start = CStageTimer::Clock::now();
+    const unsigned int inputFrames = DURATION * scenario.sampleRate;
+    unsigned int fed = 0;
+    unsigned int phase = 0;
+    unsigned int mixed = 0;
+
+    while (fed < inputFrames || !stream.m_outputSamples.empty())
+    {
+      while (fed < inputFrames && input.HasFreeBuffers())
+      {
+        CSampleBuffer* buffer = input.GetFreeBuffer();
+        FillSine(*buffer->pkt, scenario.dataFormat, phase);
+        buffer->timestamp = 0;
+        stream.m_inputSamples.push_back(buffer);
+        fed += buffer->pkt->nb_samples;
+      }
+
+      streamTimer.Start();
+      stream.ProcessBuffers();
+      streamTimer.Stop();
+
+      while (!stream.m_outputSamples.empty())
+      {
+        CSampleBuffer* out = stream.m_outputSamples.front();
+        stream.m_outputSamples.pop_front();
+        CSoundPacket& pkt = *out->pkt;
+
+        // like CActiveAE::MixSounds and Deamplify
+        mixTimer.Start();
+        for (int plane = 0; plane < pkt.planes; ++plane)
+        {
+          float* data = reinterpret_cast<float*>(pkt.data[plane]);
+          CAEUtil::MulAddArray(data, sound.data(), 0.5f, pkt.nb_samples);
+          CAEUtil::MulArray(data, 0.8f, pkt.nb_samples);
+          CAEUtil::ClampArray(data, pkt.nb_samples);
+        }
+        mixTimer.Stop();
+        mixed += pkt.nb_samples;
+
+        if (pkt.nb_samples == pkt.max_nb_samples)
+        {
+          encodeTimer.Start();
+          const int size = encoder.Encode(pkt.data[0], pkt.planes * pkt.linesize, encoded.data(),
+                                          encoded.size());
+          encodeTimer.Stop();
+          EXPECT_GT(size, 0);
+
+          sinkTimer.Start();
+          packer.Pack(sinkFormat.m_streamInfo, encoded.data(), size);
+          uint8_t* packed = packer.GetBuffer();
+          sink.AddPackets(&packed, packer.GetSize() / sinkFormat.m_frameSize, 0);
+          sinkTimer.Stop();
+        }
+        out->Return();
+      }
+    }
+
+    const double total = std::chrono::duration_cast<std::chrono::duration<double>>(
+                             CStageTimer::Clock::now() - start)
+                             .count();
+    EXPECT_GT(sink.GetFramesConsumed(), 0u);
+    EXPECT_NEAR(static_cast<double>(DURATION), static_cast<double>(mixed) / 48000, 0.5);
+
+    streamTimer.Report(scenario.name, "Stream", DURATION);
+    mixTimer.Report(scenario.name, "Mix", DURATION);
+    encodeTimer.Report(scenario.name, "Encode", DURATION);
+    sinkTimer.Report(scenario.name, "Sink", DURATION);
+    RecordProperty(std::string(scenario.name) + "_RealtimeFactor",
+                   std::to_string(DURATION / total));
+
+    sink.Deinitialize();
+  }
+}
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+AEAudioFormat Format(unsigned int channels)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_sampleRate = 48000;
+  format.m_frames = 1024;
+  const AEChannel layout[] = {AE_CH_FL, AE_CH_FR, AE_CH_FC, AE_CH_LFE,
+                              AE_CH_BL, AE_CH_BR, AE_CH_SL, AE_CH_SR};
+  for (unsigned int i = 0; i < channels; ++i)
+    format.m_channelLayout += layout[i];
+  format.m_frameSize = channels * sizeof(float);
+  return format;
+}
+} // namespace
+
+TEST(TestActiveAEBuffer, GetAndReturn)
+{
+  CActiveAEBufferPool pool(Format(2));
+  ASSERT_TRUE(pool.Create(200));
+  ASSERT_GE(pool.m_allSamples.size(), 5u);
+  EXPECT_TRUE(pool.AllBuffersReturned());
+
+  std::set<CSampleBuffer*> taken;
+  while (pool.HasFreeBuffers())
+  {
+    CSampleBuffer* buffer = pool.GetFreeBuffer();
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(1, buffer->refCount);
+    EXPECT_TRUE(taken.insert(buffer).second);
+    EXPECT_FALSE(pool.AllBuffersReturned());
+  }
+  EXPECT_EQ(pool.m_allSamples.size(), taken.size());
+  EXPECT_EQ(nullptr, pool.GetFreeBuffer());
+
+  for (CSampleBuffer* buffer : taken)
+  {
+    buffer->Acquire();
+    buffer->pkt->nb_samples = 512;
+    buffer->Return();
+    EXPECT_EQ(512, buffer->pkt->nb_samples);
+    buffer->Return();
+    EXPECT_EQ(0, buffer->pkt->nb_samples);
+  }
+  EXPECT_TRUE(pool.AllBuffersReturned());
+}
+
+TEST(TestActiveAEBuffer, ReturnFromOtherThreads)
+{
+  // buffers are taken by the engine and returned by the sink and the streams
+  CActiveAEBufferPool pool(Format(2));
+  ASSERT_TRUE(pool.Create(200));
+
+  std::vector<std::vector<CSampleBuffer*>> returned(2);
+  for (size_t i = 0; pool.HasFreeBuffers(); ++i)
+    returned[i % returned.size()].push_back(pool.GetFreeBuffer());
+
+  const int rounds = 10000;
+  int taken = 0;
+  std::vector<std::unique_ptr<std::thread>> threads;
+  for (auto& buffers : returned)
+  {
+    threads.emplace_back(std::make_unique<std::thread>([&buffers]() {
+      for (CSampleBuffer* buffer : buffers)
+        buffer->Return();
+    }));
+  }
+  while (taken < rounds)
+  {
+    CSampleBuffer* buffer = pool.GetFreeBuffer();
+    if (buffer)
+    {
+      buffer->Return();
+      taken++;
+    }
+  }
+  for (auto& thread : threads)
+    thread->join();
+
+  EXPECT_TRUE(pool.AllBuffersReturned());
+  std::set<CSampleBuffer*> free;
+  while (CSampleBuffer* buffer = pool.GetFreeBuffer())
+    EXPECT_TRUE(free.insert(buffer).second);
+  EXPECT_EQ(pool.m_allSamples.size(), free.size());
+}
+
+TEST(TestActiveAEBuffer, ReusePacketsOfDeletedPools)
+{
+  size_t count;
+  {
+    CActiveAEBufferPool pool(Format(6));
+    ASSERT_TRUE(pool.Create(200));
+    count = pool.m_allSamples.size();
+  }
+
+  const SampleBufferPoolStats before = CActiveAEBufferPool::GetStats();
+  EXPECT_GT(before.cachedBytes, 0u);
+
+  CActiveAEBufferPool pool(Format(6));
+  ASSERT_TRUE(pool.Create(200));
+  ASSERT_EQ(count, pool.m_allSamples.size());
+
+  const SampleBufferPoolStats after = CActiveAEBufferPool::GetStats();
+  EXPECT_EQ(before.reused + count, after.reused);
+  EXPECT_EQ(before.allocated, after.allocated);
+  EXPECT_LT(after.cachedBytes, before.cachedBytes);
+
+  // packets of another size can't be used
+  AEAudioFormat format = Format(6);
+  format.m_frames = 1536;
+  CActiveAEBufferPool other(format);
+  ASSERT_TRUE(other.Create(200));
+  EXPECT_EQ(after.allocated + other.m_allSamples.size(), CActiveAEBufferPool::GetStats().allocated);
+}
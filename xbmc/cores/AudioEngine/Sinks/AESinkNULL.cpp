@@ -0,0 +1,213 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+constexpr unsigned int PERIOD_MS = 20;
+constexpr uint16_t WAVE_FORMAT_PCM = 1;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+constexpr size_t WAVE_HEADER_SIZE = 44;
+
+void PutLE16(uint8_t* dst, uint16_t value)
+{
+  dst[0] = value & 0xff;
+  dst[1] = value >> 8;
+}
+
+void PutLE32(uint8_t* dst, uint32_t value)
+{
+  PutLE16(dst, value & 0xffff);
+  PutLE16(dst + 2, value >> 16);
+}
+
+} // unnamed namespace
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string& device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList& list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "null";
+  info.m_displayName = "Null output";
+  info.m_displayNameExtra = "faster than realtime";
+  info.m_deviceType = AE_DEVTYPE_HDMI;
+  info.m_channels = AE_CH_LAYOUT_7_1;
+  info.m_sampleRates = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+  info.m_dataFormats = {AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S16NE, AE_FMT_RAW};
+  info.m_streamTypes = {CAEStreamInfo::STREAM_TYPE_AC3,      CAEStreamInfo::STREAM_TYPE_EAC3,
+                        CAEStreamInfo::STREAM_TYPE_DTS_512,  CAEStreamInfo::STREAM_TYPE_DTS_1024,
+                        CAEStreamInfo::STREAM_TYPE_DTS_2048, CAEStreamInfo::STREAM_TYPE_DTSHD_CORE,
+                        CAEStreamInfo::STREAM_TYPE_DTSHD,    CAEStreamInfo::STREAM_TYPE_DTSHD_MA,
+                        CAEStreamInfo::STREAM_TYPE_TRUEHD};
+  info.m_wantsIECPassthrough = true;
+  list.push_back(info);
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat& format, std::string& device)
+{
+  Deinitialize();
+
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    // IEC 61937 packed, 16 bit per channel
+    format.m_frameSize = format.m_channelLayout.Count() * 2;
+  }
+  else
+  {
+    if (format.m_dataFormat != AE_FMT_S16NE && format.m_dataFormat != AE_FMT_S32NE)
+      format.m_dataFormat = AE_FMT_FLOAT;
+    format.m_frameSize =
+        format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  }
+
+  if (format.m_frameSize == 0 || format.m_sampleRate == 0)
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::Initialize - invalid format");
+    return false;
+  }
+
+  format.m_frames = std::max(format.m_sampleRate * PERIOD_MS / 1000, 1u);
+  m_format = format;
+  m_framesConsumed = 0;
+  m_bytesWritten = 0;
+
+  m_writeFile = !device.empty() && !StringUtils::EqualsNoCase(device, "null") &&
+                !StringUtils::EqualsNoCase(device, "default");
+  if (m_writeFile)
+  {
+    if (!m_file.OpenForWrite(device, true) || !WriteHeader())
+    {
+      CLog::Log(LOGERROR, "CAESinkNULL::Initialize - failed to open {}", device);
+      m_file.Close();
+      m_writeFile = false;
+      return false;
+    }
+  }
+
+  CLog::Log(LOGINFO, "CAESinkNULL::Initialize - {} {} channels {} Hz, writing to {}",
+            CAEUtil::DataFormatToStr(m_format.m_dataFormat), m_format.m_channelLayout.Count(),
+            m_format.m_sampleRate, m_writeFile ? device : "nowhere");
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  if (!m_writeFile)
+    return;
+
+  // now that the size of the data is known
+  if (m_file.Seek(0, SEEK_SET) == 0)
+    WriteHeader();
+  m_file.Close();
+  m_writeFile = false;
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  status.SetDelay(0.0);
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  return static_cast<double>(m_format.m_frames) / m_format.m_sampleRate;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t** data, unsigned int frames, unsigned int offset)
+{
+  if (m_writeFile &&
+      !Write(data[0] + offset * m_format.m_frameSize, frames * m_format.m_frameSize))
+    return INT_MAX;
+
+  m_framesConsumed += frames;
+  return frames;
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  const unsigned int frames = m_format.m_sampleRate * millis / 1000;
+  if (m_writeFile)
+  {
+    const std::vector<uint8_t> silence(frames * m_format.m_frameSize, 0);
+    if (!Write(silence.data(), silence.size()))
+      return;
+  }
+
+  m_framesConsumed += frames;
+}
+
+bool CAESinkNULL::WriteHeader()
+{
+  const bool isFloat = m_format.m_dataFormat == AE_FMT_FLOAT;
+  const uint16_t channels = m_format.m_channelLayout.Count();
+  const uint16_t blockAlign = m_format.m_frameSize;
+  const uint32_t dataSize = static_cast<uint32_t>(
+      std::min<uint64_t>(m_bytesWritten, UINT32_MAX - WAVE_HEADER_SIZE));
+
+  uint8_t header[WAVE_HEADER_SIZE];
+  memcpy(header, "RIFF", 4);
+  PutLE32(header + 4, dataSize + WAVE_HEADER_SIZE - 8);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  PutLE32(header + 16, 16);
+  PutLE16(header + 20, isFloat ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM);
+  PutLE16(header + 22, channels);
+  PutLE32(header + 24, m_format.m_sampleRate);
+  PutLE32(header + 28, m_format.m_sampleRate * blockAlign);
+  PutLE16(header + 32, blockAlign);
+  PutLE16(header + 34, blockAlign / channels * 8);
+  memcpy(header + 36, "data", 4);
+  PutLE32(header + 40, dataSize);
+
+  return m_file.Write(header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+}
+
+bool CAESinkNULL::Write(const uint8_t* data, size_t size)
+{
+  if (m_file.Write(data, size) != static_cast<ssize_t>(size))
+  {
+    CLog::Log(LOGERROR, "CAESinkNULL::Write - failed to write");
+    return false;
+  }
+
+  m_bytesWritten += size;
+  return true;
+}
@@ -0,0 +1,59 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "filesystem/File.h"
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Sink that consumes audio as fast as the engine produces it.
+ *
+ * The device "null" discards the audio, any other device is the path of a WAV file the audio is
+ * written to. Without a clock to wait for, the engine renders faster than realtime, which makes
+ * the sink useful for testing and benchmarking the engine. Select it with KODI_AE_SINK=NULL.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char* GetName() override { return "NULL"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string& device, AEAudioFormat& desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList& list, bool force = false);
+
+  bool Initialize(AEAudioFormat& format, std::string& device) override;
+  void Deinitialize() override;
+
+  void GetDelay(AEDelayStatus& status) override;
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t** data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+
+  /*!
+   * \brief Get the number of frames consumed since the sink was initialized, including pauses
+   */
+  uint64_t GetFramesConsumed() const { return m_framesConsumed; }
+
+private:
+  bool WriteHeader();
+  bool Write(const uint8_t* data, size_t size);
+
+  AEAudioFormat m_format;
+  XFILE::CFile m_file;
+  bool m_writeFile = false;
+  uint64_t m_framesConsumed = 0;
+  uint64_t m_bytesWritten = 0;
+};
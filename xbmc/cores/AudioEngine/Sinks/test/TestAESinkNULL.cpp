@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+AEAudioFormat Format()
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOATP;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = AE_CH_LAYOUT_5_1;
+  return format;
+}
+
+uint32_t GetLE32(const uint8_t* src)
+{
+  return src[0] | (src[1] << 8) | (src[2] << 16) | (static_cast<uint32_t>(src[3]) << 24);
+}
+} // namespace
+
+TEST(TestAESinkNULL, Discard)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = Format();
+  std::string device = "null";
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  // planar formats are converted by the engine
+  EXPECT_EQ(AE_FMT_FLOAT, format.m_dataFormat);
+  EXPECT_EQ(6 * sizeof(float), format.m_frameSize);
+  EXPECT_GT(format.m_frames, 0u);
+
+  std::vector<uint8_t> samples(format.m_frames * format.m_frameSize);
+  uint8_t* data = samples.data();
+  EXPECT_EQ(format.m_frames, sink.AddPackets(&data, format.m_frames, 0));
+  sink.AddPause(10);
+  EXPECT_EQ(format.m_frames + 480u, sink.GetFramesConsumed());
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+}
+
+TEST(TestAESinkNULL, WriteWav)
+{
+  XFILE::CFile* file = XBMC_CREATETEMPFILE(".wav");
+  ASSERT_NE(nullptr, file);
+  file->Close();
+  std::string device = XBMC_TEMPFILEPATH(file);
+
+  AEAudioFormat format = Format();
+  format.m_dataFormat = AE_FMT_S16NE;
+  const unsigned int frames = 1000;
+  {
+    CAESinkNULL sink;
+    ASSERT_TRUE(sink.Initialize(format, device));
+
+    std::vector<int16_t> samples(frames * 6, 0x1234);
+    uint8_t* data = reinterpret_cast<uint8_t*>(samples.data());
+    EXPECT_EQ(100u, sink.AddPackets(&data, 100, 0));
+    EXPECT_EQ(frames - 100, sink.AddPackets(&data, frames - 100, 100));
+    sink.Deinitialize();
+  }
+
+  ASSERT_TRUE(file->Open(device));
+  std::vector<uint8_t> wav(44 + frames * 12 + 1);
+  ASSERT_EQ(static_cast<ssize_t>(wav.size() - 1), file->Read(wav.data(), wav.size()));
+  file->Close();
+
+  EXPECT_EQ("RIFF", std::string(reinterpret_cast<char*>(wav.data()), 4));
+  EXPECT_EQ(36 + frames * 12, GetLE32(wav.data() + 4));
+  EXPECT_EQ("WAVEfmt ", std::string(reinterpret_cast<char*>(wav.data() + 8), 8));
+  EXPECT_EQ(1u, wav[20]);
+  EXPECT_EQ(6u, wav[22]);
+  EXPECT_EQ(48000u, GetLE32(wav.data() + 24));
+  EXPECT_EQ(12u, wav[32]);
+  EXPECT_EQ(16u, wav[34]);
+  EXPECT_EQ("data", std::string(reinterpret_cast<char*>(wav.data() + 36), 4));
+  EXPECT_EQ(frames * 12, GetLE32(wav.data() + 40));
+  EXPECT_EQ(0x34, wav[44]);
+  EXPECT_EQ(0x12, wav[45]);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace
+{
+
+void MulArrayC(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayC(float* data, const float* add, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+void ClampArrayC(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const float x = std::min(std::max(data[i], -3.0f), 3.0f);
+    const float y = x * x;
+    data[i] = x * (27.0f + y) / (27.0f + 9.0f * y);
+  }
+}
+
+float PeakArrayC(const float* data, uint32_t count)
+{
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+    peak = std::max(peak, fabsf(data[i]));
+  return peak;
+}
+
+} // unnamed namespace
+
+namespace AE
+{
+namespace KERNELS
+{
+
+std::vector<SampleKernels> GetSupportedKernels(unsigned int cpuFeatures)
+{
+  std::vector<SampleKernels> kernels;
+  kernels.push_back({"C", MulArrayC, MulAddArrayC, ClampArrayC, PeakArrayC});
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+  kernels.push_back({"SSE", CAEUtil::SSEMulArray, CAEUtil::SSEMulAddArray, CAEUtil::SSEClampArray,
+                     CAEUtil::SSEPeakArray});
+#endif
+
+#if defined(HAS_AE_KERNELS_AVX2)
+  if (cpuFeatures & CPU_FEATURE_AVX2)
+    kernels.push_back({"AVX2", MulArrayAVX2, MulAddArrayAVX2, ClampArrayAVX2, PeakArrayAVX2});
+#endif
+
+#if defined(HAS_AE_KERNELS_NEON)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+    kernels.push_back({"NEON", MulArrayNEON, MulAddArrayNEON, ClampArrayNEON, PeakArrayNEON});
+#endif
+
+  return kernels;
+}
+
+} // namespace KERNELS
+} // namespace AE
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define HAS_AE_KERNELS_AVX2
+#endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define HAS_AE_KERNELS_NEON
+#endif
+
+namespace AE
+{
+namespace KERNELS
+{
+
+/*!
+ * \brief The float sample kernels of one instruction set. CAEUtil::MulArray and friends use the
+ * fastest set supported by the cpu.
+ */
+struct SampleKernels
+{
+  const char* name;
+  //! data[i] *= mul
+  void (*mulArray)(float* data, float mul, uint32_t count);
+  //! data[i] += add[i] * mul
+  void (*mulAddArray)(float* data, const float* add, float mul, uint32_t count);
+  //! soft clamp of data[i] to [-1, 1]
+  void (*clampArray)(float* data, uint32_t count);
+  //! max(|data[i]|)
+  float (*peakArray)(const float* data, uint32_t count);
+};
+
+/*!
+ * \brief Get the kernels built in and supported by a cpu.
+ * \param cpuFeatures the CPU_FEATURE_* flags of the cpu
+ * \return the kernels, ordered from the slowest to the fastest
+ */
+std::vector<SampleKernels> GetSupportedKernels(unsigned int cpuFeatures);
+
+#if defined(HAS_AE_KERNELS_AVX2)
+void MulArrayAVX2(float* data, float mul, uint32_t count);
+void MulAddArrayAVX2(float* data, const float* add, float mul, uint32_t count);
+void ClampArrayAVX2(float* data, uint32_t count);
+float PeakArrayAVX2(const float* data, uint32_t count);
+#endif
+
+#if defined(HAS_AE_KERNELS_NEON)
+void MulArrayNEON(float* data, float mul, uint32_t count);
+void MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count);
+void ClampArrayNEON(float* data, uint32_t count);
+float PeakArrayNEON(const float* data, uint32_t count);
+#endif
+
+} // namespace KERNELS
+} // namespace AE
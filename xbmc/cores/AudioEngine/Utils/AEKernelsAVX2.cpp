@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#if defined(HAS_AE_KERNELS_AVX2)
+
+#include <immintrin.h>
+
+// built without -mavx2, so only these functions may use AVX and are only called if the cpu
+// supports it. MSVC allows the intrinsics without any flag.
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+namespace
+{
+
+AVX2_TARGET inline __m256i TailMask(uint32_t count)
+{
+  // the lanes below count are set
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+AVX2_TARGET inline __m256 SoftClamp(__m256 x)
+{
+  // rational tanh approximation of CAEUtil::SoftClamp, which reaches +-1 at +-3
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-3.0f)), _mm256_set1_ps(3.0f));
+  const __m256 y = _mm256_mul_ps(x, x);
+  return _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(_mm256_set1_ps(27.0f), y)),
+                       _mm256_add_ps(_mm256_set1_ps(27.0f), _mm256_mul_ps(_mm256_set1_ps(9.0f), y)));
+}
+
+} // unnamed namespace
+
+namespace AE
+{
+namespace KERNELS
+{
+
+AVX2_TARGET void MulArrayAVX2(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+    _mm256_storeu_ps(data + i + 8, _mm256_mul_ps(_mm256_loadu_ps(data + i + 8), m));
+  }
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+
+  if (i < count)
+  {
+    const __m256i mask = TailMask(count - i);
+    _mm256_maskstore_ps(data + i, mask, _mm256_mul_ps(_mm256_maskload_ps(data + i, mask), m));
+  }
+}
+
+AVX2_TARGET void MulAddArrayAVX2(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    const __m256 a0 = _mm256_mul_ps(_mm256_loadu_ps(add + i), m);
+    const __m256 a1 = _mm256_mul_ps(_mm256_loadu_ps(add + i + 8), m);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), a0));
+    _mm256_storeu_ps(data + i + 8, _mm256_add_ps(_mm256_loadu_ps(data + i + 8), a1));
+  }
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 a = _mm256_mul_ps(_mm256_loadu_ps(add + i), m);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), a));
+  }
+
+  if (i < count)
+  {
+    const __m256i mask = TailMask(count - i);
+    const __m256 a = _mm256_mul_ps(_mm256_maskload_ps(add + i, mask), m);
+    _mm256_maskstore_ps(data + i, mask, _mm256_add_ps(_mm256_maskload_ps(data + i, mask), a));
+  }
+}
+
+AVX2_TARGET void ClampArrayAVX2(float* data, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, SoftClamp(_mm256_loadu_ps(data + i)));
+
+  if (i < count)
+  {
+    const __m256i mask = TailMask(count - i);
+    _mm256_maskstore_ps(data + i, mask, SoftClamp(_mm256_maskload_ps(data + i, mask)));
+  }
+}
+
+AVX2_TARGET float PeakArrayAVX2(const float* data, uint32_t count)
+{
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 peak0 = _mm256_setzero_ps();
+  __m256 peak1 = _mm256_setzero_ps();
+
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+    peak1 = _mm256_max_ps(peak1, _mm256_and_ps(_mm256_loadu_ps(data + i + 8), absMask));
+  }
+  for (; i + 8 <= count; i += 8)
+    peak0 = _mm256_max_ps(peak0, _mm256_and_ps(_mm256_loadu_ps(data + i), absMask));
+
+  if (i < count)
+  {
+    // masked out lanes load as 0
+    const __m256 tail = _mm256_maskload_ps(data + i, TailMask(count - i));
+    peak1 = _mm256_max_ps(peak1, _mm256_and_ps(tail, absMask));
+  }
+
+  __m256 peak = _mm256_max_ps(peak0, peak1);
+  __m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+  peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+  peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 1));
+  return _mm_cvtss_f32(peak4);
+}
+
+} // namespace KERNELS
+} // namespace AE
+
+#endif
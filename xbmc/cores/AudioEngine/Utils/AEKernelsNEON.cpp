@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#if defined(HAS_AE_KERNELS_NEON)
+
+#include <algorithm>
+#include <math.h>
+
+#include <arm_neon.h>
+
+namespace
+{
+
+inline float32x4_t SoftClamp(float32x4_t x)
+{
+  // rational tanh approximation of CAEUtil::SoftClamp, which reaches +-1 at +-3
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-3.0f)), vdupq_n_f32(3.0f));
+  const float32x4_t y = vmulq_f32(x, x);
+  const float32x4_t num = vmulq_f32(x, vaddq_f32(vdupq_n_f32(27.0f), y));
+  const float32x4_t den = vmlaq_n_f32(vdupq_n_f32(27.0f), y, 9.0f);
+#if defined(__aarch64__)
+  return vdivq_f32(num, den);
+#else
+  // two Newton-Raphson steps refine the reciprocal estimate to full float precision
+  float32x4_t rcp = vrecpeq_f32(den);
+  rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+  rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+  return vmulq_f32(num, rcp);
+#endif
+}
+
+inline float SoftClamp(float x)
+{
+  x = std::min(std::max(x, -3.0f), 3.0f);
+  const float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+} // unnamed namespace
+
+namespace AE
+{
+namespace KERNELS
+{
+
+void MulArrayNEON(float* data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+    vst1q_f32(data + i + 4, vmulq_n_f32(vld1q_f32(data + i + 4), mul));
+  }
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  for (; i < count; ++i)
+    data[i] *= mul;
+}
+
+void MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    vst1q_f32(data + i, vmlaq_n_f32(vld1q_f32(data + i), vld1q_f32(add + i), mul));
+    vst1q_f32(data + i + 4, vmlaq_n_f32(vld1q_f32(data + i + 4), vld1q_f32(add + i + 4), mul));
+  }
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmlaq_n_f32(vld1q_f32(data + i), vld1q_f32(add + i), mul));
+  for (; i < count; ++i)
+    data[i] += add[i] * mul;
+}
+
+void ClampArrayNEON(float* data, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, SoftClamp(vld1q_f32(data + i)));
+  for (; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+float PeakArrayNEON(const float* data, uint32_t count)
+{
+  float32x4_t peak0 = vdupq_n_f32(0.0f);
+  float32x4_t peak1 = vdupq_n_f32(0.0f);
+
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    peak0 = vmaxq_f32(peak0, vabsq_f32(vld1q_f32(data + i)));
+    peak1 = vmaxq_f32(peak1, vabsq_f32(vld1q_f32(data + i + 4)));
+  }
+  for (; i + 4 <= count; i += 4)
+    peak0 = vmaxq_f32(peak0, vabsq_f32(vld1q_f32(data + i)));
+
+  const float32x4_t peak4 = vmaxq_f32(peak0, peak1);
+  float32x2_t peak2 = vmax_f32(vget_low_f32(peak4), vget_high_f32(peak4));
+  peak2 = vpmax_f32(peak2, peak2);
+
+  float peak = vget_lane_f32(peak2, 0);
+  for (; i < count; ++i)
+    peak = std::max(peak, fabsf(data[i]));
+  return peak;
+}
+
+} // namespace KERNELS
+} // namespace AE
+
+#endif
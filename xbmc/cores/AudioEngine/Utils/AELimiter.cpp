@@ -9,6 +9,7 @@
 #include "AELimiter.h"
 
 #include "ServiceBroker.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "utils/MathUtils.h"
@@ -30,10 +31,7 @@ float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/,
   float highest = 0.0f;
   if (!planar)
   {
-    for(int i=0; i<channels; i++)
-    {
-      highest = std::max(highest, fabsf(*(frame[0]+offset+i)));
-    }
+    highest = CAEUtil::PeakArray(frame[0] + offset, channels);
   }
   else
   {
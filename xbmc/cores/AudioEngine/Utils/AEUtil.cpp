@@ -10,9 +10,14 @@
 #endif
 
 #include "AEUtil.h"
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cassert>
 
 extern "C" {
@@ -268,12 +273,12 @@ void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
   }
 }
 
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
+void CAEUtil::SSEMulAddArray(float *data, const float *add, const float mul, uint32_t count)
 {
   const __m128 m = _mm_set_ps1(mul);
 
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
+  /* work around invalid alignment, add is loaded unaligned as its offset may differ */
+  while (((uintptr_t)data & 0xF) && count > 0)
   {
     data[0] += add[0] * mul;
     ++add;
@@ -284,7 +289,7 @@ void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t
   uint32_t even = count & ~0x3;
   for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
   {
-    __m128 ad      = _mm_load_ps(add );
+    __m128 ad      = _mm_loadu_ps(add);
     __m128 to      = _mm_load_ps(data);
     *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
   }
@@ -355,15 +360,13 @@ inline float CAEUtil::SoftClamp(const float x)
 #endif
 }
 
-void CAEUtil::ClampArray(float *data, uint32_t count)
+#if defined(HAVE_SSE) && defined(__SSE__)
+void CAEUtil::SSEClampArray(float *data, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
-  for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
-
-#else
+  const __m128 lo = _mm_set_ps1(-3.0f);
+  const __m128 hi = _mm_set_ps1(3.0f);
   const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+  const __m128 c2 = _mm_set_ps1(9.0f);
 
   /* work around invalid alignment */
   while (((uintptr_t)data & 0xF) && count > 0)
@@ -376,64 +379,77 @@ void CAEUtil::ClampArray(float *data, uint32_t count)
   uint32_t even = count & ~0x3;
   for (uint32_t i = 0; i < even; i+=4, data+=4)
   {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
+    /* tanh approx clamp, see SoftClamp */
+    __m128 dt  = _mm_min_ps(_mm_max_ps(_mm_load_ps(data), lo), hi);
+    __m128 tmp = _mm_mul_ps(dt, dt);
     *(__m128*)data = _mm_div_ps(
       _mm_mul_ps(
         dt,
         _mm_add_ps(c1, tmp)
       ),
-      _mm_add_ps(c2, tmp)
+      _mm_add_ps(c1, _mm_mul_ps(c2, tmp))
     );
   }
 
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
-    {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
-    }
-  }
+  for (uint32_t i = 0; i < count - even; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+float CAEUtil::SSEPeakArray(const float *data, uint32_t count)
+{
+  const __m128 sign = _mm_set_ps1(-0.0f);
+  __m128 peak = _mm_setzero_ps();
+
+  uint32_t even = count & ~0x3;
+  for (uint32_t i = 0; i < even; i+=4)
+    peak = _mm_max_ps(peak, _mm_andnot_ps(sign, _mm_loadu_ps(data + i)));
+
+  peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+  peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+
+  float result = _mm_cvtss_f32(peak);
+  for (uint32_t i = even; i < count; ++i)
+    result = std::max(result, fabsf(data[i]));
+  return result;
+}
 #endif
+
+namespace
+{
+const AE::KERNELS::SampleKernels& GetSampleKernels()
+{
+  static const AE::KERNELS::SampleKernels kernels = []() {
+    std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+    if (!cpuInfo)
+      cpuInfo = CCPUInfo::GetCPUInfo();
+
+    const AE::KERNELS::SampleKernels fastest =
+        AE::KERNELS::GetSupportedKernels(cpuInfo->GetCPUFeatures()).back();
+    CLog::Log(LOGINFO, "CAEUtil - using {} sample kernels", fastest.name);
+    return fastest;
+  }();
+  return kernels;
+}
+} // unnamed namespace
+
+void CAEUtil::MulArray(float *data, float mul, uint32_t count)
+{
+  GetSampleKernels().mulArray(data, mul, count);
+}
+
+void CAEUtil::MulAddArray(float *data, const float *add, float mul, uint32_t count)
+{
+  GetSampleKernels().mulAddArray(data, add, mul, count);
+}
+
+void CAEUtil::ClampArray(float *data, uint32_t count)
+{
+  GetSampleKernels().clampArray(data, count);
+}
+
+float CAEUtil::PeakArray(const float *data, uint32_t count)
+{
+  return GetSampleKernels().peakArray(data, count);
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
@@ -180,11 +180,41 @@ public:
     return 20*log10(scale);
   }
 
+  /*! \brief multiply samples by a factor
+   The sample kernels of the fastest instruction set supported by the cpu are used.
+   \param data the samples
+   \param mul the factor
+   \param count the number of samples
+   */
+  static void MulArray(float *data, float mul, uint32_t count);
+
+  /*! \brief add samples multiplied by a factor to other samples
+   \param data the samples to add to
+   \param add the samples to add
+   \param mul the factor for the samples to add
+   \param count the number of samples
+   */
+  static void MulAddArray(float *data, const float *add, float mul, uint32_t count);
+
+  /*! \brief soft clamp samples to [-1, 1], see SoftClamp
+   \param data the samples
+   \param count the number of samples
+   */
+  static void ClampArray(float *data, uint32_t count);
+
+  /*! \brief get the highest absolute value of samples
+   \param data the samples
+   \param count the number of samples
+   \return the peak
+   */
+  static float PeakArray(const float *data, uint32_t count);
+
   #if defined(HAVE_SSE) && defined(__SSE__)
   static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
+  static void SSEMulAddArray  (float *data, const float *add, const float mul, uint32_t count);
+  static void SSEClampArray   (float *data, uint32_t count);
+  static float SSEPeakArray   (const float *data, uint32_t count);
   #endif
-  static void ClampArray(float *data, uint32_t count);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
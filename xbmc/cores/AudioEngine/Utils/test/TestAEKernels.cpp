@@ -0,0 +1,148 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace AE::KERNELS;
+
+namespace
+{
+std::vector<SampleKernels> GetKernels()
+{
+  return GetSupportedKernels(CCPUInfo::GetCPUInfo()->GetCPUFeatures());
+}
+
+std::vector<float> Samples(size_t count, float amplitude)
+{
+  std::vector<float> samples(count);
+  unsigned int seed = 1;
+  for (auto& sample : samples)
+  {
+    seed = seed * 1103515245 + 12345;
+    sample = amplitude * (static_cast<float>((seed >> 8) & 0xffff) / 32768.0f - 1.0f);
+  }
+  return samples;
+}
+
+// kernels may fuse the multiply and add or approximate the division of the clamp
+void ExpectNear(const std::vector<float>& expected, const std::vector<float>& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i)
+    EXPECT_NEAR(expected[i], actual[i], 1e-6f) << "at " << i;
+}
+} // namespace
+
+TEST(TestAEKernels, MatchReference)
+{
+  const std::vector<SampleKernels> kernels = GetKernels();
+  const SampleKernels& reference = kernels.front();
+  ASSERT_STREQ("C", reference.name);
+
+  const std::vector<float> input = Samples(80, 4.0f);
+  const std::vector<float> add = Samples(80, 2.0f);
+
+  for (const auto& kernel : kernels)
+  {
+    // all lengths and alignments, including the ones of a single frame of 2.0 to 7.1 audio
+    for (uint32_t offset = 0; offset < 8; ++offset)
+    {
+      for (uint32_t count = 0; count <= 67; ++count)
+      {
+        SCOPED_TRACE(std::string(kernel.name) + " offset " + std::to_string(offset) + " count " +
+                     std::to_string(count));
+
+        std::vector<float> expected(input);
+        std::vector<float> actual(input);
+
+        reference.mulArray(expected.data() + offset, 0.7f, count);
+        kernel.mulArray(actual.data() + offset, 0.7f, count);
+        EXPECT_EQ(expected, actual);
+
+        reference.mulAddArray(expected.data() + offset, add.data() + 1, 0.3f, count);
+        kernel.mulAddArray(actual.data() + offset, add.data() + 1, 0.3f, count);
+        ExpectNear(expected, actual);
+
+        EXPECT_NEAR(reference.peakArray(expected.data() + offset, count),
+                    kernel.peakArray(actual.data() + offset, count), 1e-6f);
+
+        reference.clampArray(expected.data() + offset, count);
+        kernel.clampArray(actual.data() + offset, count);
+        ExpectNear(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(TestAEKernels, Clamp)
+{
+  for (const auto& kernel : GetKernels())
+  {
+    SCOPED_TRACE(kernel.name);
+
+    std::vector<float> samples = {-10.0f, -3.0f, -1.0f, 0.0f, 0.5f, 1.0f, 2.0f, 3.0f, 100.0f};
+    kernel.clampArray(samples.data(), static_cast<uint32_t>(samples.size()));
+
+    EXPECT_FLOAT_EQ(-1.0f, samples[0]);
+    EXPECT_FLOAT_EQ(-1.0f, samples[1]);
+    EXPECT_EQ(0.0f, samples[3]);
+    EXPECT_FLOAT_EQ(1.0f, samples[7]);
+    EXPECT_FLOAT_EQ(1.0f, samples[8]);
+    for (float sample : samples)
+    {
+      EXPECT_LE(sample, 1.0f);
+      EXPECT_GE(sample, -1.0f);
+    }
+  }
+}
+
+TEST(TestAEKernels, DISABLED_Benchmark)
+{
+  // one second of interleaved 48kHz audio, processed like CActiveAE::MixSounds processes a
+  // stream mixed into the output: add, check for clipping, deamplify and clamp
+  const int sampleRate = 48000;
+  const std::vector<std::pair<const char*, int>> layouts = {{"2.0", 2}, {"5.1", 6}, {"7.1", 8}};
+
+  for (const auto& kernel : GetKernels())
+  {
+    for (const auto& layout : layouts)
+    {
+      const uint32_t count = sampleRate * layout.second;
+      const std::vector<float> stream = Samples(count, 0.8f);
+      std::vector<float> output = Samples(count, 0.8f);
+
+      const int iterations = 50;
+      float peak = 0.0f;
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; ++i)
+      {
+        kernel.mulAddArray(output.data(), stream.data(), 0.5f, count);
+        peak += kernel.peakArray(output.data(), count);
+        kernel.mulArray(output.data(), 0.5f, count);
+        kernel.clampArray(output.data(), count);
+      }
+      const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+
+      EXPECT_GT(peak, 0.0f);
+      const double samplesPerSecond = static_cast<double>(count) * iterations * 1000000.0 /
+                                      std::max<int64_t>(duration.count(), 1);
+      RecordProperty(std::string(kernel.name) + "_" + layout.first + "_MSamplesPerSecond",
+                     std::to_string(samplesPerSecond / 1000000.0));
+    }
+  }
+}
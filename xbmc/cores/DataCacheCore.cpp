@@ -42,6 +42,7 @@ void CDataCacheCore::Reset()
     m_stateInfo.m_renderGuiLayer = false;
     m_stateInfo.m_renderVideoLayer = false;
     m_playerStateChanged = false;
+    ++m_playbackVersion;
   }
 
   {
@@ -305,7 +306,16 @@ void CDataCacheCore::SetSpeed(float tempo, float speed)
   CSingleLock lock(m_stateSection);
 
   m_stateInfo.m_tempo = tempo;
-  m_stateInfo.m_speed = speed;
+  if (m_stateInfo.m_speed != speed)
+  {
+    m_stateInfo.m_speed = speed;
+    ++m_playbackVersion;
+  }
+}
+
+void CDataCacheCore::SignalPlaybackChange()
+{
+  ++m_playbackVersion;
 }
 
 float CDataCacheCore::GetSpeed()
@@ -78,6 +78,10 @@ public:
   void SetFrameAdvance(bool fa);
   bool IsFrameAdvance();
   bool IsPlayerStateChanged();
+  // the version of the speed and of what is playing, increased by SetSpeed(), Reset() and
+  // SignalPlaybackChange(), which the application calls on the callbacks of the player
+  void SignalPlaybackChange();
+  unsigned int GetPlaybackVersion() const { return m_playbackVersion; }
   void SetGuiRender(bool gui);
   bool GetGuiRender();
   void SetVideoRender(bool video);
@@ -167,6 +171,7 @@ protected:
 
   CCriticalSection m_stateSection;
   bool m_playerStateChanged = false;
+  std::atomic<unsigned int> m_playbackVersion{0};
   struct SStateInfo
   {
     bool m_stateSeeking;
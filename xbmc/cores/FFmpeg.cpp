@@ -16,10 +16,122 @@
 #include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 static thread_local CFFmpegLog* CFFmpegLogTls;
 
+namespace
+{
+
+class CSwsContextCache
+{
+public:
+  ~CSwsContextCache()
+  {
+    for (auto& entry : m_entries)
+      sws_freeContext(entry.context);
+  }
+
+  SwsContext* Get(int srcWidth,
+                  int srcHeight,
+                  AVPixelFormat srcFormat,
+                  int dstWidth,
+                  int dstHeight,
+                  AVPixelFormat dstFormat,
+                  int flags,
+                  int srcRange,
+                  int dstRange)
+  {
+    const Entry key = {srcWidth,  srcHeight, srcFormat, dstWidth, dstHeight,
+                       dstFormat, flags,     srcRange,  dstRange, nullptr};
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      if (it->Matches(key))
+      {
+        // most recently used first
+        std::rotate(m_entries.begin(), it, it + 1);
+        return m_entries.front().context;
+      }
+    }
+
+    SwsContext* context = sws_getContext(srcWidth, srcHeight, srcFormat, dstWidth, dstHeight,
+                                         dstFormat, flags, nullptr, nullptr, nullptr);
+    if (!context)
+      return nullptr;
+
+    if (srcRange >= 0 || dstRange >= 0)
+    {
+      int* inv_table = nullptr;
+      int* table = nullptr;
+      int defaultSrcRange, defaultDstRange, brightness, contrast, saturation;
+      if (sws_getColorspaceDetails(context, &inv_table, &defaultSrcRange, &table, &defaultDstRange,
+                                   &brightness, &contrast, &saturation) < 0 ||
+          sws_setColorspaceDetails(context, inv_table, srcRange >= 0 ? srcRange : defaultSrcRange,
+                                   table, dstRange >= 0 ? dstRange : defaultDstRange, brightness,
+                                   contrast, saturation) < 0)
+      {
+        sws_freeContext(context);
+        return nullptr;
+      }
+    }
+
+    if (m_entries.size() == MAX_ENTRIES)
+    {
+      sws_freeContext(m_entries.back().context);
+      m_entries.pop_back();
+    }
+    m_entries.insert(m_entries.begin(), key)->context = context;
+    return context;
+  }
+
+private:
+  static constexpr size_t MAX_ENTRIES = 4;
+
+  struct Entry
+  {
+    int srcWidth;
+    int srcHeight;
+    AVPixelFormat srcFormat;
+    int dstWidth;
+    int dstHeight;
+    AVPixelFormat dstFormat;
+    int flags;
+    int srcRange;
+    int dstRange;
+    SwsContext* context;
+
+    bool Matches(const Entry& other) const
+    {
+      return srcWidth == other.srcWidth && srcHeight == other.srcHeight &&
+             srcFormat == other.srcFormat && dstWidth == other.dstWidth &&
+             dstHeight == other.dstHeight && dstFormat == other.dstFormat &&
+             flags == other.flags && srcRange == other.srcRange && dstRange == other.dstRange;
+    }
+  };
+
+  std::vector<Entry> m_entries;
+};
+
+thread_local CSwsContextCache swsContextCache;
+
+} // unnamed namespace
+
+SwsContext* ff_get_cached_sws_context(int srcWidth,
+                                      int srcHeight,
+                                      AVPixelFormat srcFormat,
+                                      int dstWidth,
+                                      int dstHeight,
+                                      AVPixelFormat dstFormat,
+                                      int flags,
+                                      int srcRange,
+                                      int dstRange)
+{
+  return swsContextCache.Get(srcWidth, srcHeight, srcFormat, dstWidth, dstHeight, dstFormat, flags,
+                             srcRange, dstRange);
+}
+
 void CFFmpegLog::SetLogLevel(int level)
 {
   CFFmpegLog::ClearLogLevel();
@@ -19,6 +19,7 @@ extern "C" {
 #include <libavutil/ffversion.h>
 #include <libavfilter/avfilter.h>
 #include <libpostproc/postprocess.h>
+#include <libswscale/swscale.h>
 }
 
 inline int PPCPUFlags()
@@ -51,3 +52,24 @@ public:
   int level;
 };
 
+/*!
+ \brief Get a scaler from a small cache of the calling thread.
+
+ Creating a scaler computes its filters, which costs about as much as scaling a thumbnail. Images
+ of a library mostly come in a few sizes, so the scalers of the last sizes are kept per thread
+ instead of being created and freed for each image.
+
+ \param srcRange 1 for full range YUV sources like JPEG, 0 for limited range, -1 for the default
+ \param dstRange 1 for full range YUV destinations like JPEG, 0 for limited range, -1 for the default
+ \return the scaler, owned by the cache and valid until the next call on the same thread, or
+ nullptr on failure
+ */
+SwsContext* ff_get_cached_sws_context(int srcWidth,
+                                      int srcHeight,
+                                      AVPixelFormat srcFormat,
+                                      int dstWidth,
+                                      int dstHeight,
+                                      AVPixelFormat dstFormat,
+                                      int flags,
+                                      int srcRange = -1,
+                                      int dstRange = -1);
@@ -9,10 +9,19 @@
 #include "VideoBuffer.h"
 
 #include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
 
 #include <string.h>
 #include <utility>
 
+namespace
+{
+
+std::atomic<uint64_t> uploadedPictures{0};
+std::atomic<uint64_t> copiedBytes{0};
+
+} // unnamed namespace
+
 //-----------------------------------------------------------------------------
 // CVideoBuffer
 //-----------------------------------------------------------------------------
@@ -49,6 +58,24 @@ AVPixelFormat CVideoBuffer::GetFormat()
   return m_pixFormat;
 }
 
+CVideoBuffer::CopyStats CVideoBuffer::GetCopyStats()
+{
+  CopyStats stats;
+  stats.pictures = uploadedPictures;
+  stats.bytes = copiedBytes;
+  return stats;
+}
+
+void CVideoBuffer::CountUpload()
+{
+  uploadedPictures++;
+}
+
+void CVideoBuffer::CountCopy(size_t bytes)
+{
+  copiedBytes += bytes;
+}
+
 bool CVideoBuffer::CopyPicture(YuvImage* pDst, YuvImage *pSrc)
 {
   uint8_t *s = pSrc->plane[0];
@@ -100,6 +127,7 @@ bool CVideoBuffer::CopyPicture(YuvImage* pDst, YuvImage *pSrc)
       d += pDst->stride[2];
     }
   }
+  CountCopy(pDst->width * pDst->bpp * pDst->height + 2 * w * h);
   return true;
 }
 
@@ -144,6 +172,7 @@ bool CVideoBuffer::CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc)
     }
   }
 
+  CountCopy(pDst->width * pDst->height + w * h);
   return true;
 }
 
@@ -169,6 +198,7 @@ bool CVideoBuffer::CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc)
     }
   }
 
+  CountCopy(w * h * 2);
   return true;
 }
 
@@ -182,7 +212,7 @@ CVideoBufferSysMem::CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFo
 
 CVideoBufferSysMem::~CVideoBufferSysMem()
 {
-  delete[] m_data;
+  KODI::MEMORY::AlignedFree(m_data);
 }
 
 uint8_t* CVideoBufferSysMem::GetMemPtr()
@@ -219,13 +249,14 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
   m_image.bpp = 1;
 
   if (m_pixFormat == AV_PIX_FMT_YUV420P ||
+      m_pixFormat == AV_PIX_FMT_YUVJ420P ||
       m_pixFormat == AV_PIX_FMT_YUV420P16 ||
       m_pixFormat == AV_PIX_FMT_YUV420P14 ||
       m_pixFormat == AV_PIX_FMT_YUV420P12 ||
       m_pixFormat == AV_PIX_FMT_YUV420P10 ||
       m_pixFormat == AV_PIX_FMT_YUV420P9)
   {
-    if (m_pixFormat != AV_PIX_FMT_YUV420P)
+    if (m_pixFormat != AV_PIX_FMT_YUV420P && m_pixFormat != AV_PIX_FMT_YUVJ420P)
       m_image.bpp = 2;
 
     m_image.planesize[0] = m_image.stride[0] * m_image.height;
@@ -268,8 +299,43 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
 
 bool CVideoBufferSysMem::Alloc()
 {
-  m_data = new uint8_t[m_size];
-  return true;
+  // aligned_alloc wants a multiple of the alignment
+  const size_t size = (m_size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+  m_data = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(size, ALIGNMENT));
+  return m_data != nullptr;
+}
+
+int CVideoBufferSysMem::GetAlignedSize(AVPixelFormat format, int width, int height,
+                                       int (&strides)[YuvImage::MAX_PLANES])
+{
+  // chroma planes start after height / 2 rows
+  height = (height + 1) & ~1;
+
+  switch (format)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+    case AV_PIX_FMT_YUV420P9:
+    case AV_PIX_FMT_YUV420P10:
+    case AV_PIX_FMT_YUV420P12:
+    case AV_PIX_FMT_YUV420P14:
+    case AV_PIX_FMT_YUV420P16:
+    {
+      const int bpp = (format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P) ? 1 : 2;
+      // chroma strides are half the luma stride, ffmpeg relies on that
+      strides[0] = (width * bpp + 2 * ALIGNMENT - 1) & ~(2 * ALIGNMENT - 1);
+      strides[1] = strides[0] / 2;
+      strides[2] = strides[0] / 2;
+      return strides[0] * height * 3 / 2;
+    }
+    case AV_PIX_FMT_NV12:
+      strides[0] = (width + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+      strides[1] = strides[0];
+      strides[2] = 0;
+      return strides[0] * height * 3 / 2;
+    default:
+      return 0;
+  }
 }
 
 
@@ -103,6 +103,16 @@ public:
   static bool CopyNV12Picture(YuvImage* pDst, YuvImage *pSrc);
   static bool CopyYUV422PackedPicture(YuvImage* pDst, YuvImage *pSrc);
 
+  // pictures uploaded by the renderers and the bytes copied on the way, since start
+  struct CopyStats
+  {
+    uint64_t pictures = 0;
+    uint64_t bytes = 0;
+  };
+  static CopyStats GetCopyStats();
+  static void CountUpload();
+  static void CountCopy(size_t bytes);
+
 protected:
   explicit CVideoBuffer(int id);
   AVPixelFormat m_pixFormat = AV_PIX_FMT_NONE;
@@ -123,6 +133,14 @@ public:
   void SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES], const int (&planeOffsets)[YuvImage::MAX_PLANES]) override;
   bool Alloc();
 
+  // alignment of the memory and the strides the renderers can upload without repacking
+  static constexpr int ALIGNMENT = 64;
+
+  // strides and buffer size of a picture in one of the formats of SetDimensions,
+  // returns 0 if the format is not supported
+  static int GetAlignedSize(AVPixelFormat format, int width, int height,
+                            int (&strides)[YuvImage::MAX_PLANES]);
+
 protected:
   int m_width = 0;
   int m_height = 0;
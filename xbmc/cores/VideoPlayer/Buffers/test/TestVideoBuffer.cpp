@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/Buffers/VideoBuffer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+bool IsAligned(const void* ptr)
+{
+  return reinterpret_cast<uintptr_t>(ptr) % CVideoBufferSysMem::ALIGNMENT == 0;
+}
+
+} // namespace
+
+TEST(TestVideoBuffer, AlignedSize)
+{
+  int strides[YuvImage::MAX_PLANES];
+
+  EXPECT_EQ(1920 * 1080 * 3 / 2,
+            CVideoBufferSysMem::GetAlignedSize(AV_PIX_FMT_YUV420P, 1910, 1080, strides));
+  EXPECT_EQ(1920, strides[0]);
+  EXPECT_EQ(960, strides[1]);
+  EXPECT_EQ(960, strides[2]);
+
+  // odd heights get a full chroma row
+  EXPECT_EQ(128 * 10 * 3 / 2,
+            CVideoBufferSysMem::GetAlignedSize(AV_PIX_FMT_YUV420P10, 33, 9, strides));
+  EXPECT_EQ(128, strides[0]);
+  EXPECT_EQ(64, strides[1]);
+
+  EXPECT_EQ(1920 * 1080 * 3 / 2,
+            CVideoBufferSysMem::GetAlignedSize(AV_PIX_FMT_NV12, 1910, 1080, strides));
+  EXPECT_EQ(1920, strides[0]);
+  EXPECT_EQ(1920, strides[1]);
+  EXPECT_EQ(0, strides[2]);
+
+  EXPECT_EQ(0, CVideoBufferSysMem::GetAlignedSize(AV_PIX_FMT_RGB24, 1920, 1080, strides));
+}
+
+TEST(TestVideoBuffer, SysMemPool)
+{
+  CVideoBufferManager manager;
+  int strides[YuvImage::MAX_PLANES];
+  const int size = CVideoBufferSysMem::GetAlignedSize(AV_PIX_FMT_YUVJ420P, 720, 576, strides);
+
+  CVideoBuffer* buffer = manager.Get(AV_PIX_FMT_YUVJ420P, size, nullptr);
+  ASSERT_NE(nullptr, dynamic_cast<CVideoBufferSysMem*>(buffer));
+  EXPECT_TRUE(IsAligned(buffer->GetMemPtr()));
+
+  uint8_t* planes[YuvImage::MAX_PLANES];
+  buffer->SetDimensions(720, 576, strides);
+  buffer->GetPlanes(planes);
+  EXPECT_EQ(buffer->GetMemPtr(), planes[0]);
+  EXPECT_EQ(planes[0] + strides[0] * 576, planes[1]);
+  EXPECT_EQ(planes[1] + strides[1] * 288, planes[2]);
+  for (uint8_t* plane : planes)
+    EXPECT_TRUE(IsAligned(plane));
+
+  // released buffers are handed out again
+  uint8_t* mem = buffer->GetMemPtr();
+  buffer->Release();
+  buffer = manager.Get(AV_PIX_FMT_YUVJ420P, size, nullptr);
+  EXPECT_EQ(mem, buffer->GetMemPtr());
+  buffer->Release();
+}
+
+TEST(TestVideoBuffer, CopyStats)
+{
+  YuvImage src = {};
+  src.width = 64;
+  src.height = 32;
+  src.cshift_x = 1;
+  src.cshift_y = 1;
+  src.bpp = 1;
+  src.stride[0] = 128;
+  src.stride[1] = 64;
+  src.stride[2] = 64;
+  std::vector<uint8_t> srcData(128 * 32 * 2);
+  src.plane[0] = srcData.data();
+  src.plane[1] = src.plane[0] + 128 * 32;
+  src.plane[2] = src.plane[1] + 64 * 16;
+
+  YuvImage dst = src;
+  dst.stride[0] = 64;
+  dst.stride[1] = 32;
+  dst.stride[2] = 32;
+  std::vector<uint8_t> dstData(64 * 32 * 3 / 2);
+  dst.plane[0] = dstData.data();
+  dst.plane[1] = dst.plane[0] + 64 * 32;
+  dst.plane[2] = dst.plane[1] + 32 * 16;
+
+  const CVideoBuffer::CopyStats before = CVideoBuffer::GetCopyStats();
+  EXPECT_TRUE(CVideoBuffer::CopyPicture(&dst, &src));
+  CVideoBuffer::CountUpload();
+  const CVideoBuffer::CopyStats after = CVideoBuffer::GetCopyStats();
+
+  EXPECT_EQ(1u, after.pictures - before.pictures);
+  EXPECT_EQ(64u * 32 * 3 / 2, after.bytes - before.bytes);
+}
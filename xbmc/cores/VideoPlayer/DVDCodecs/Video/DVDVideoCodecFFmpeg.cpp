@@ -61,6 +61,19 @@ enum EFilterFlags {
   FILTER_ROTATE              = 0x40,  //< rotate image according to the codec hints
 };
 
+namespace
+{
+
+// libavcodec may access a few bytes past the last plane
+constexpr int SYSMEM_BUFFER_PADDING = 16 + CVideoBufferSysMem::ALIGNMENT;
+
+void ReleaseSysMemBuffer(void* opaque, uint8_t* data)
+{
+  static_cast<CVideoBuffer*>(opaque)->Release();
+}
+
+} // unnamed namespace
+
 //------------------------------------------------------------------------------
 // Video Buffers
 //------------------------------------------------------------------------------
@@ -270,7 +283,7 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = GetBuffer;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -304,6 +317,68 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel* cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  if (!ctx->m_sysMemBuffers || avctx->hw_frames_ctx ||
+      !(avctx->codec->capabilities & AV_CODEC_CAP_DR1))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  const AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+  int width = frame->width;
+  int height = frame->height;
+  int linesizeAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, linesizeAlign);
+  height = (height + 1) & ~1;
+
+  int strides[YuvImage::MAX_PLANES];
+  const int size = CVideoBufferSysMem::GetAlignedSize(format, width, height, strides);
+  if (size == 0)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  for (int i = 0; i < YuvImage::MAX_PLANES; i++)
+  {
+    if (strides[i] % linesizeAlign[i])
+      return avcodec_default_get_buffer2(avctx, frame, flags);
+  }
+
+  // decode into the buffers the renderer uploads from, instead of ffmpeg's own pool
+  CVideoBuffer* buffer =
+      ctx->m_processInfo.GetVideoBufferManager().Get(format, size + SYSMEM_BUFFER_PADDING, nullptr);
+  CVideoBufferSysMem* sysMemBuffer = dynamic_cast<CVideoBufferSysMem*>(buffer);
+  if (!sysMemBuffer || !sysMemBuffer->GetMemPtr())
+  {
+    // the platform registered a pool of its own
+    if (buffer)
+      buffer->Release();
+    ctx->m_sysMemBuffers = false;
+    CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg::GetBuffer - no system memory buffers, using ffmpeg's");
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+  }
+
+  frame->buf[0] = av_buffer_create(sysMemBuffer->GetMemPtr(), size + SYSMEM_BUFFER_PADDING,
+                                   ReleaseSysMemBuffer, sysMemBuffer, 0);
+  if (!frame->buf[0])
+  {
+    sysMemBuffer->Release();
+    return AVERROR(ENOMEM);
+  }
+
+  uint8_t* planes[YuvImage::MAX_PLANES];
+  sysMemBuffer->SetDimensions(width, height, strides);
+  sysMemBuffer->GetPlanes(planes);
+  for (int i = 0; i < YuvImage::MAX_PLANES; i++)
+  {
+    frame->data[i] = strides[i] ? planes[i] : nullptr;
+    frame->linesize[i] = strides[i];
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 : CDVDVideoCodec(processInfo), m_postProc(processInfo)
 {
@@ -358,7 +433,9 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->debug = 0;
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
+  m_pCodecContext->get_buffer2 = GetBuffer;
   m_pCodecContext->codec_tag = hints.codec_tag;
+  m_sysMemBuffers = true;
 
   // setup threading model
   if (!(hints.codecOptions & CODEC_FORCE_SOFTWARE))
@@ -369,12 +446,15 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      m_threading.Configure(hints, CServiceBroker::GetCPUInfo()->GetCPUCount());
+      const CDVDVideoCodecFFmpegThreading::Config& threading = m_threading.GetConfig();
+      m_pCodecContext->thread_type = threading.threadType;
+      m_pCodecContext->thread_count = threading.threadCount;
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open {} threaded with {} threads",
+                threading.threadType == FF_THREAD_FRAME ? "frame" : "slice",
+                threading.threadCount);
     }
   }
   else
@@ -553,6 +633,8 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   if (m_eof)
   {
     Reset();
+    if (!m_pCodecContext)
+      return true;
   }
 
   if (packet.recoveryPoint)
@@ -570,7 +652,9 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
 
+  const auto start = CDVDVideoCodecFFmpegThreading::Clock::now();
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
+  m_threading.AddDecodeTime(CDVDVideoCodecFFmpegThreading::Clock::now() - start);
 
   // try again
   if (ret == AVERROR(EAGAIN))
@@ -658,11 +742,19 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::GetPicture(VideoPicture* pVideoPi
     avcodec_send_packet(m_pCodecContext, &avpkt);
   }
 
+  const auto start = CDVDVideoCodecFFmpegThreading::Clock::now();
   int ret = avcodec_receive_frame(m_pCodecContext, m_pDecodedFrame);
+  m_threading.AddDecodeTime(CDVDVideoCodecFFmpegThreading::Clock::now() - start);
 
   if (m_decoderState == STATE_HW_FAILED && !m_pHardware)
     return VC_REOPEN;
 
+  // use more threads if decoding is too slow for the frame rate. The codec has to be opened again
+  // for that, which waits for the next flush instead of dropping the frames in flight now.
+  if (ret == 0 && m_decoderState == STATE_SW_MULTI && !m_threadingRaised &&
+      m_threading.AddPicture())
+    m_threadingRaised = true;
+
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
 
@@ -882,6 +974,19 @@ void CDVDVideoCodecFFmpeg::Reset()
   m_skippedDeint = 0;
   m_droppedFrames = 0;
   m_eof = false;
+
+  // the frames in flight are dropped anyway, a good time to apply the raised threading
+  if (m_threadingRaised)
+  {
+    m_threadingRaised = false;
+    Reopen();
+    if (!m_pCodecContext)
+    {
+      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::Reset - failed to reopen with more threads");
+      return;
+    }
+  }
+
   m_iLastKeyframe = m_pCodecContext->has_b_frames;
   avcodec_flush_buffers(m_pCodecContext);
   av_frame_unref(m_pFrame);
@@ -11,7 +11,9 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoCodecFFmpegThreading.h"
 #include "DVDVideoPPFFmpeg.h"
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -48,6 +50,7 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -98,6 +101,9 @@ protected:
   double m_DAR = 1.0;
   CDVDStreamInfo m_hints;
   CDVDCodecOptions m_options;
+  CDVDVideoCodecFFmpegThreading m_threading;
+  bool m_threadingRaised = false; // applied when the codec is reset
+  std::atomic<bool> m_sysMemBuffers{true};
 
   struct CDropControl
   {
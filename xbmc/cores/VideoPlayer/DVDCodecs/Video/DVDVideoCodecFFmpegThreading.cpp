@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoCodecFFmpegThreading.h"
+
+#include "DVDStreamInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// pixels per second one core decodes comfortably, about 1080p30 h264
+constexpr double PIXELS_PER_THREAD = 1920.0 * 1080.0 * 30.0;
+
+// below this share of a core, slice threading adds no latency and is fast enough
+constexpr double SLICE_THREADING_WORK = 0.5;
+
+// pictures per measurement, the first measurement after opening is dropped
+constexpr unsigned int MEASURE_PICTURES = 120;
+
+// share of the frame duration the decoder may spend in ffmpeg
+constexpr double MAX_DECODE_LOAD = 0.85;
+
+double CodecComplexity(AVCodecID codec)
+{
+  switch (codec)
+  {
+    case AV_CODEC_ID_HEVC:
+    case AV_CODEC_ID_VP9:
+    case AV_CODEC_ID_AV1:
+      return 2.0;
+    case AV_CODEC_ID_MPEG1VIDEO:
+    case AV_CODEC_ID_MPEG2VIDEO:
+      return 0.5;
+    default:
+      return 1.0;
+  }
+}
+
+int MaxThreads(int cpuCount)
+{
+  return std::max(1, std::min(cpuCount * 3 / 2, 16));
+}
+
+} // unnamed namespace
+
+void CDVDVideoCodecFFmpegThreading::Configure(const CDVDStreamInfo& hints, int cpuCount)
+{
+  const double fps = (hints.fpsrate > 0 && hints.fpsscale > 0)
+                         ? static_cast<double>(hints.fpsrate) / hints.fpsscale
+                         : 0.0;
+
+  const bool sameStream = hints.codec == m_codec && hints.width == m_width &&
+                          hints.height == m_height && fps == m_fps && cpuCount == m_cpuCount;
+  if (!sameStream)
+  {
+    m_codec = hints.codec;
+    m_width = hints.width;
+    m_height = hints.height;
+    m_fps = fps;
+    m_cpuCount = cpuCount;
+    m_config = SelectConfig(m_codec, m_width, m_height, m_fps, m_cpuCount);
+  }
+
+  m_decodeTime = Clock::duration::zero();
+  m_pictures = 0;
+  m_warmup = true;
+}
+
+bool CDVDVideoCodecFFmpegThreading::AddPicture()
+{
+  if (++m_pictures < MEASURE_PICTURES)
+    return false;
+
+  const double decodeTime = std::chrono::duration<double>(m_decodeTime).count();
+  const double load = m_fps > 0.0 ? decodeTime * m_fps / m_pictures : 0.0;
+  const bool warmup = m_warmup;
+
+  m_decodeTime = Clock::duration::zero();
+  m_pictures = 0;
+  m_warmup = false;
+
+  if (warmup || load < MAX_DECODE_LOAD)
+    return false;
+
+  const Config config = RaiseConfig(m_config, m_cpuCount);
+  if (config == m_config)
+    return false;
+
+  CLog::Log(LOGINFO,
+            "CDVDVideoCodecFFmpegThreading - decoder load {:.2f}, raising to {} {} threads", load,
+            config.threadType == FF_THREAD_FRAME ? "frame" : "slice", config.threadCount);
+  m_config = config;
+  m_warmup = true;
+  return true;
+}
+
+CDVDVideoCodecFFmpegThreading::Config CDVDVideoCodecFFmpegThreading::SelectConfig(
+    AVCodecID codec, int width, int height, double fps, int cpuCount)
+{
+  // demuxers don't always know, assume something that usually needs threads
+  if (width <= 0 || height <= 0)
+  {
+    width = 1920;
+    height = 1080;
+  }
+  if (fps <= 0.0)
+    fps = 25.0;
+
+  const double work = width * height * fps * CodecComplexity(codec) / PIXELS_PER_THREAD;
+  const int maxThreads = MaxThreads(cpuCount);
+
+  Config config;
+  if (work <= SLICE_THREADING_WORK || maxThreads == 1)
+  {
+    config.threadType = FF_THREAD_SLICE;
+    config.threadCount = std::min(maxThreads, 4);
+  }
+  else
+  {
+    // leave room for the references frame threads wait for
+    config.threadType = FF_THREAD_FRAME;
+    config.threadCount =
+        std::max(2, std::min(static_cast<int>(std::ceil(work * 4.0)), maxThreads));
+  }
+  return config;
+}
+
+CDVDVideoCodecFFmpegThreading::Config CDVDVideoCodecFFmpegThreading::RaiseConfig(
+    const Config& config, int cpuCount)
+{
+  const int maxThreads = MaxThreads(cpuCount);
+  if (maxThreads == 1)
+    return config;
+
+  Config raised;
+  raised.threadType = FF_THREAD_FRAME;
+  if (config.threadType != FF_THREAD_FRAME)
+    raised.threadCount = std::max(2, maxThreads / 2);
+  else
+    raised.threadCount = maxThreads;
+  return raised;
+}
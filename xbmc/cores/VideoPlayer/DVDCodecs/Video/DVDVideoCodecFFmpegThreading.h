@@ -0,0 +1,84 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+class CDVDStreamInfo;
+
+/**
+ * Threading of the ffmpeg software decoder.
+ *
+ * Frame threading scales best, but every thread delays the output by one frame. Streams that a
+ * single core decodes easily use slice threading, heavy streams get enough frame threads for
+ * their resolution, frame rate and codec. While decoding, the time spent in ffmpeg is compared
+ * to the frame rate, and if the decoder can't keep up the threading is raised.
+ */
+class CDVDVideoCodecFFmpegThreading
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Config
+  {
+    int threadType = 0; // FF_THREAD_FRAME or FF_THREAD_SLICE
+    int threadCount = 1;
+
+    bool operator==(const Config& other) const
+    {
+      return threadType == other.threadType && threadCount == other.threadCount;
+    }
+  };
+
+  /**
+   * Select the threading for a stream.
+   * Keeps a raised threading if the decoder is reopened for the same stream.
+   */
+  void Configure(const CDVDStreamInfo& hints, int cpuCount);
+
+  const Config& GetConfig() const { return m_config; }
+
+  /**
+   * Account the time the decoder spent in ffmpeg.
+   */
+  void AddDecodeTime(Clock::duration time) { m_decodeTime += time; }
+
+  /**
+   * Account a decoded picture. Returns true if the decoder couldn't keep up with the frame rate
+   * and was moved to more threads, it has to be reopened to use them. The caller does that at
+   * the next flush, so the frames in flight aren't dropped.
+   */
+  bool AddPicture();
+
+  /**
+   * The threading for a stream, before any decoding was measured.
+   */
+  static Config SelectConfig(AVCodecID codec, int width, int height, double fps, int cpuCount);
+
+  /**
+   * The next threading if the decoder is too slow, returns config if there is none.
+   */
+  static Config RaiseConfig(const Config& config, int cpuCount);
+
+private:
+  AVCodecID m_codec = AV_CODEC_ID_NONE;
+  int m_width = 0;
+  int m_height = 0;
+  double m_fps = 0.0;
+  int m_cpuCount = 1;
+  Config m_config;
+
+  Clock::duration m_decodeTime = Clock::duration::zero();
+  unsigned int m_pictures = 0;
+  bool m_warmup = true;
+};
@@ -0,0 +1,279 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpegThreading.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Interface/DemuxPacket.h"
+#include "cores/VideoPlayer/Interface/TimingConstants.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "utils/CPUInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+using Threading = CDVDVideoCodecFFmpegThreading;
+
+namespace
+{
+
+CDVDStreamInfo VideoHints(AVCodecID codec, int width, int height, int fps)
+{
+  CDVDStreamInfo hints;
+  hints.type = STREAM_VIDEO;
+  hints.codec = codec;
+  hints.width = width;
+  hints.height = height;
+  hints.fpsrate = fps;
+  hints.fpsscale = 1;
+  return hints;
+}
+
+// decodes each picture in the given time
+unsigned int DecodePictures(Threading& threading,
+                            unsigned int pictures,
+                            std::chrono::milliseconds time)
+{
+  unsigned int raised = 0;
+  for (unsigned int i = 0; i < pictures; ++i)
+  {
+    threading.AddDecodeTime(time);
+    if (threading.AddPicture())
+      raised++;
+  }
+  return raised;
+}
+
+} // namespace
+
+TEST(TestDVDVideoCodecFFmpegThreading, SelectConfig)
+{
+  // SD is decoded by a single core, slice threads don't delay the output
+  auto config = Threading::SelectConfig(AV_CODEC_ID_H264, 720, 576, 25.0, 8);
+  EXPECT_EQ(FF_THREAD_SLICE, config.threadType);
+  EXPECT_EQ(4, config.threadCount);
+
+  config = Threading::SelectConfig(AV_CODEC_ID_MPEG2VIDEO, 1920, 1080, 25.0, 8);
+  EXPECT_EQ(FF_THREAD_SLICE, config.threadType);
+
+  config = Threading::SelectConfig(AV_CODEC_ID_H264, 1920, 1080, 30.0, 8);
+  EXPECT_EQ(FF_THREAD_FRAME, config.threadType);
+  EXPECT_EQ(4, config.threadCount);
+
+  // heavy streams get all threads there are
+  config = Threading::SelectConfig(AV_CODEC_ID_HEVC, 3840, 2160, 60.0, 8);
+  EXPECT_EQ(FF_THREAD_FRAME, config.threadType);
+  EXPECT_EQ(12, config.threadCount);
+
+  config = Threading::SelectConfig(AV_CODEC_ID_HEVC, 3840, 2160, 60.0, 64);
+  EXPECT_EQ(16, config.threadCount);
+
+  config = Threading::SelectConfig(AV_CODEC_ID_HEVC, 3840, 2160, 60.0, 1);
+  EXPECT_EQ(FF_THREAD_SLICE, config.threadType);
+  EXPECT_EQ(1, config.threadCount);
+
+  // unknown size and frame rate
+  config = Threading::SelectConfig(AV_CODEC_ID_H264, 0, 0, 0.0, 4);
+  EXPECT_EQ(FF_THREAD_FRAME, config.threadType);
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, RaiseConfig)
+{
+  Threading::Config slice;
+  slice.threadType = FF_THREAD_SLICE;
+  slice.threadCount = 4;
+
+  auto config = Threading::RaiseConfig(slice, 8);
+  EXPECT_EQ(FF_THREAD_FRAME, config.threadType);
+  EXPECT_EQ(6, config.threadCount);
+
+  config = Threading::RaiseConfig(config, 8);
+  EXPECT_EQ(FF_THREAD_FRAME, config.threadType);
+  EXPECT_EQ(12, config.threadCount);
+
+  EXPECT_EQ(config, Threading::RaiseConfig(config, 8));
+
+  slice.threadCount = 1;
+  EXPECT_EQ(slice, Threading::RaiseConfig(slice, 1));
+}
+
+TEST(TestDVDVideoCodecFFmpegThreading, RaiseIfTooSlow)
+{
+  Threading threading;
+  const CDVDStreamInfo hints = VideoHints(AV_CODEC_ID_H264, 720, 576, 25);
+  threading.Configure(hints, 8);
+  ASSERT_EQ(FF_THREAD_SLICE, threading.GetConfig().threadType);
+
+  // 10ms per frame of 40ms is fast enough, over whole measurements
+  EXPECT_EQ(0u, DecodePictures(threading, 960, std::chrono::milliseconds(10)));
+  EXPECT_EQ(FF_THREAD_SLICE, threading.GetConfig().threadType);
+
+  // 38ms are not, after the measurement that is dropped
+  EXPECT_EQ(0u, DecodePictures(threading, 119, std::chrono::milliseconds(38)));
+  EXPECT_EQ(1u, DecodePictures(threading, 1, std::chrono::milliseconds(38)));
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetConfig().threadType);
+  EXPECT_EQ(6, threading.GetConfig().threadCount);
+
+  // reopening for the same stream keeps the raised threading
+  threading.Configure(hints, 8);
+  EXPECT_EQ(FF_THREAD_FRAME, threading.GetConfig().threadType);
+
+  // the first measurement after reopening is dropped
+  EXPECT_EQ(0u, DecodePictures(threading, 120, std::chrono::milliseconds(38)));
+  EXPECT_EQ(1u, DecodePictures(threading, 120, std::chrono::milliseconds(38)));
+  EXPECT_EQ(12, threading.GetConfig().threadCount);
+
+  // nothing left to raise
+  threading.Configure(hints, 8);
+  EXPECT_EQ(0u, DecodePictures(threading, 1000, std::chrono::milliseconds(38)));
+
+  // a different stream starts over
+  threading.Configure(VideoHints(AV_CODEC_ID_H264, 640, 360, 25), 8);
+  EXPECT_EQ(FF_THREAD_SLICE, threading.GetConfig().threadType);
+}
+
+/*!
+ * Decodes the video of the file in KODI_DECODE_BENCHMARK_FILE with the threading selected by
+ * the decoder and with fixed threading for comparison, and reports the decoded frames per second.
+ */
+TEST(TestDVDVideoCodecFFmpegThreading, DISABLED_Decode)
+{
+  const char* file = getenv("KODI_DECODE_BENCHMARK_FILE");
+  ASSERT_NE(nullptr, file) << "KODI_DECODE_BENCHMARK_FILE is not set";
+
+  const std::string threads = std::to_string(CServiceBroker::GetCPUInfo()->GetCPUCount());
+  const std::vector<std::pair<const char*, std::vector<CDVDCodecOption>>> runs = {
+      {"Auto", {}},
+      {"Single", {{"threads", "1"}}},
+      {"Slice", {{"thread_type", "slice"}, {"threads", threads}}},
+      {"Frame", {{"thread_type", "frame"}, {"threads", threads}}}};
+
+  for (const auto& run : runs)
+  {
+    SCOPED_TRACE(run.first);
+
+    AVFormatContext* format = nullptr;
+    ASSERT_EQ(0, avformat_open_input(&format, file, nullptr, nullptr));
+    ASSERT_GE(avformat_find_stream_info(format, nullptr), 0);
+    const int index = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    ASSERT_GE(index, 0);
+    const AVStream* stream = format->streams[index];
+
+    CDVDStreamInfo hints;
+    hints.type = STREAM_VIDEO;
+    hints.codec = stream->codecpar->codec_id;
+    hints.width = stream->codecpar->width;
+    hints.height = stream->codecpar->height;
+    hints.fpsrate = stream->avg_frame_rate.num;
+    hints.fpsscale = stream->avg_frame_rate.den;
+    if (stream->codecpar->extradata_size > 0)
+    {
+      // owned by the stream info
+      hints.extrasize = stream->codecpar->extradata_size;
+      hints.extradata = malloc(hints.extrasize);
+      memcpy(hints.extradata, stream->codecpar->extradata, hints.extrasize);
+    }
+
+    std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+    CDVDVideoCodecFFmpeg codec(*processInfo);
+    CDVDCodecOptions options;
+    options.m_keys = run.second;
+    ASSERT_TRUE(codec.Open(hints, options));
+
+    VideoPicture picture;
+    unsigned int pictures = 0;
+    unsigned int reopens = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    // returns false if the file has to be decoded from the start
+    auto getPictures = [&]() {
+      while (true)
+      {
+        const CDVDVideoCodec::VCReturn ret = codec.GetPicture(&picture);
+        if (ret == CDVDVideoCodec::VC_PICTURE)
+        {
+          pictures++;
+          picture.videoBuffer->Release();
+          picture.videoBuffer = nullptr;
+        }
+        else if (ret == CDVDVideoCodec::VC_REOPEN)
+        {
+          codec.Reopen();
+          reopens++;
+          // the hw decoder failed at the start, the player does the same
+          if (pictures == 0)
+            return false;
+        }
+        else if (ret != CDVDVideoCodec::VC_NONE)
+          return true;
+      }
+    };
+
+    AVPacket avpkt;
+    bool eof = false;
+    while (!eof)
+    {
+      eof = av_read_frame(format, &avpkt) < 0;
+      if (eof)
+      {
+        codec.SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+        getPictures();
+        break;
+      }
+
+      if (avpkt.stream_index == index)
+      {
+        DemuxPacket packet;
+        packet.pData = avpkt.data;
+        packet.iSize = avpkt.size;
+        packet.iStreamId = index;
+        const double timeBase = av_q2d(stream->time_base) * DVD_TIME_BASE;
+        if (avpkt.pts != AV_NOPTS_VALUE)
+          packet.pts = avpkt.pts * timeBase;
+        if (avpkt.dts != AV_NOPTS_VALUE)
+          packet.dts = avpkt.dts * timeBase;
+
+        bool restart = false;
+        while (!codec.AddData(packet) && !restart)
+          restart = !getPictures();
+        if (!restart)
+          restart = !getPictures();
+
+        if (restart)
+        {
+          av_seek_frame(format, index, 0, AVSEEK_FLAG_BACKWARD);
+          start = std::chrono::steady_clock::now();
+        }
+      }
+      av_packet_unref(&avpkt);
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_GT(pictures, 0u);
+    RecordProperty(std::string(run.first) + "_FramesPerSecond",
+                   std::to_string(pictures / std::max(seconds, 1e-9)));
+    RecordProperty(std::string(run.first) + "_Reopens", std::to_string(reopens));
+
+    codec.Reset();
+    avformat_close_input(&format);
+  }
+}
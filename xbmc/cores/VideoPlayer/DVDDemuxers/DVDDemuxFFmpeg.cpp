@@ -235,6 +235,7 @@ bool CDVDDemuxFFmpeg::Open(const std::shared_ptr<CDVDInputStream>& pInput, bool
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_seekToKeyFrame = false;
+  m_zeroCopy = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDemuxZeroCopy;
 
   const AVIOInterruptCB int_cb = { interrupt_cb, this };
 
@@ -1070,7 +1071,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if (m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = CreatePacket(&m_pkt.pkt);
               break;
             }
           }
@@ -1079,7 +1080,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = CreatePacket(&m_pkt.pkt);
       }
       else
         bReturnEmpty = true;
@@ -1093,13 +1094,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
@@ -2148,6 +2142,25 @@ std::string CDVDDemuxFFmpeg::ConvertCodecToInternalStereoMode(const std::string
   return "";
 }
 
+DemuxPacket* CDVDDemuxFFmpeg::CreatePacket(AVPacket* pkt)
+{
+  // share the buffer of ffmpeg's packet instead of copying it
+  if (m_zeroCopy)
+  {
+    DemuxPacket* packet = CDVDDemuxUtils::WrapDemuxPacket(pkt);
+    if (packet)
+      return packet;
+  }
+
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(pkt->size);
+  if (packet && pkt->data)
+  {
+    memcpy(packet->pData, pkt->data, pkt->size);
+    packet->iSize = pkt->size;
+  }
+  return packet;
+}
+
 void CDVDDemuxFFmpeg::ParsePacket(AVPacket* pkt)
 {
   AVStream* st = m_pFormatContext->streams[pkt->stream_index];
@@ -9,55 +9,204 @@
 #include "DVDDemuxUtils.h"
 
 #include "cores/VideoPlayer/Interface/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/MemUtils.h"
 #include "utils/log.h"
 
+#include <atomic>
+#include <vector>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+namespace
+{
+
+std::atomic<uint64_t> packetsAllocated{0};
+std::atomic<uint64_t> packetsPooled{0};
+std::atomic<uint64_t> packetsWrapped{0};
+std::atomic<uint64_t> packetsFreed{0};
+std::atomic<uint64_t> bytesAllocated{0};
+
+/*!
+ * Freed packets, kept with their buffer for the next packet of the same size class.
+ *
+ * There are four size classes per power of two, so a buffer is at most a quarter larger than
+ * needed. Packets are allocated by the demuxer and freed by the stream players, the pool is
+ * shared by all of them.
+ */
+class CDemuxPacketPool
+{
+public:
+  ~CDemuxPacketPool()
+  {
+    for (auto& packets : m_packets)
+    {
+      for (DemuxPacket* packet : packets)
+      {
+        KODI::MEMORY::AlignedFree(packet->pData);
+        delete packet;
+      }
+    }
+  }
+
+  //! the buffer size of the class of a packet of size bytes, 0 if too large to be pooled
+  static size_t BufferSize(size_t size)
+  {
+    const unsigned int sizeClass = SizeClass(size);
+    return sizeClass < CLASSES ? ClassSize(sizeClass) : 0;
+  }
+
+  DemuxPacket* Get(size_t bufferSize)
+  {
+    const unsigned int sizeClass = bufferSize ? SizeClass(bufferSize) : CLASSES;
+    CSingleLock lock(m_section);
+    std::vector<DemuxPacket*>& packets = m_packets[sizeClass];
+    if (packets.empty())
+      return nullptr;
+
+    DemuxPacket* packet = packets.back();
+    packets.pop_back();
+    m_pooledBytes -= packet->bufferSize;
+    return packet;
+  }
+
+  //! takes a cleared packet, returns false if the pool is full
+  bool Put(DemuxPacket* packet)
+  {
+    const unsigned int sizeClass = packet->bufferSize ? SizeClass(packet->bufferSize) : CLASSES;
+    if (sizeClass > CLASSES)
+      return false;
+
+    CSingleLock lock(m_section);
+    std::vector<DemuxPacket*>& packets = m_packets[sizeClass];
+    if (m_pooledBytes + packet->bufferSize > MAX_POOLED_BYTES || packets.size() >= MAX_PACKETS)
+      return false;
+
+    packets.push_back(packet);
+    m_pooledBytes += packet->bufferSize;
+    return true;
+  }
+
+private:
+  static constexpr unsigned int MIN_SHIFT = 8; // 256 bytes
+  static constexpr unsigned int MAX_SHIFT = 24; // 16 MiB
+  static constexpr unsigned int CLASSES = (MAX_SHIFT - MIN_SHIFT) * 4;
+  static constexpr size_t MAX_POOLED_BYTES = 32 * 1024 * 1024;
+  static constexpr size_t MAX_PACKETS = 1024;
+
+  static size_t ClassSize(unsigned int sizeClass)
+  {
+    const unsigned int shift = sizeClass / 4 + MIN_SHIFT;
+    return (static_cast<size_t>(4 + sizeClass % 4) << shift) / 4;
+  }
+
+  static unsigned int SizeClass(size_t size)
+  {
+    if (size <= (1u << MIN_SHIFT))
+      return 0;
+
+    unsigned int shift = MIN_SHIFT;
+    while ((static_cast<size_t>(2) << shift) < size)
+      shift++;
+    const size_t quarter = (static_cast<size_t>(1) << shift) / 4;
+    const size_t step = (size - (static_cast<size_t>(1) << shift) + quarter - 1) / quarter;
+    return (shift - MIN_SHIFT) * 4 + static_cast<unsigned int>(step);
+  }
+
+  CCriticalSection m_section;
+  // the last list holds packets without buffer
+  std::vector<DemuxPacket*> m_packets[CLASSES + 1];
+  size_t m_pooledBytes = 0;
+};
+
+CDemuxPacketPool& GetPool()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+void FreeSideData(DemuxPacket* pPacket)
+{
+  AVPacket avPkt;
+  av_init_packet(&avPkt);
+  avPkt.side_data = static_cast<AVPacketSideData*>(pPacket->pSideData);
+  avPkt.side_data_elems = pPacket->iSideDataElems;
+  av_packet_free_side_data(&avPkt);
+}
+
+} // unnamed namespace
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
-    if (pPacket->iSideDataElems)
+    if (pPacket->bufferRef)
     {
-      AVPacket avPkt;
-      av_init_packet(&avPkt);
-      avPkt.side_data = static_cast<AVPacketSideData*>(pPacket->pSideData);
-      avPkt.side_data_elems = pPacket->iSideDataElems;
-      av_packet_free_side_data(&avPkt);
+      av_buffer_unref(&pPacket->bufferRef);
+      pPacket->pData = nullptr;
     }
+    if (pPacket->iSideDataElems)
+      FreeSideData(pPacket);
     if (pPacket->cryptoInfo)
       delete pPacket->cryptoInfo;
+    packetsFreed.fetch_add(1, std::memory_order_relaxed);
+
+    // keep the buffer, unless it was allocated by someone else
+    uint8_t* data = pPacket->pData;
+    const size_t bufferSize = data ? pPacket->bufferSize : 0;
+    *pPacket = DemuxPacket();
+    pPacket->pData = data;
+    pPacket->bufferSize = bufferSize;
+    if ((!data || bufferSize) && GetPool().Put(pPacket))
+      return;
+
+    if (data)
+      KODI::MEMORY::AlignedFree(data);
     delete pPacket;
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  packetsAllocated.fetch_add(1, std::memory_order_relaxed);
+
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+   * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+   * this is mainly needed because some optimized bitstream readers read
+   * 32 or 64 bit at once and could read over the end<br>
+   * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+   * MPEG bitstreams could cause overread and segfault
+   */
+  const size_t size = iDataSize > 0 ? iDataSize + AV_INPUT_BUFFER_PADDING_SIZE : 0;
+  const size_t bufferSize = size ? CDemuxPacketPool::BufferSize(size) : 0;
 
-  if (iDataSize > 0)
+  DemuxPacket* pPacket = GetPool().Get(bufferSize);
+  if (pPacket)
+    packetsPooled.fetch_add(1, std::memory_order_relaxed);
+  else
+    pPacket = new DemuxPacket();
+
+  if (size > 0 && !pPacket->pData)
   {
-    // need to allocate a few bytes more.
-    // From avcodec.h (ffmpeg)
-    /**
-     * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-     * this is mainly needed because some optimized bitstream readers read
-     * 32 or 64 bit at once and could read over the end<br>
-     * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-     * MPEG bitstreams could cause overread and segfault
-     */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    // packets too large to be pooled get a buffer of their size
+    const size_t allocSize = bufferSize ? bufferSize : size;
+    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(allocSize, 16));
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
       return NULL;
     }
+    pPacket->bufferSize = bufferSize;
+    bytesAllocated.fetch_add(allocSize, std::memory_order_relaxed);
+  }
 
+  if (size > 0)
+  {
     // reset the last 8 bytes to 0;
     memset(pPacket->pData + iDataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
   }
@@ -73,6 +222,27 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::WrapDemuxPacket(AVPacket* src)
+{
+  // the padding ffmpeg adds to its packets has to be there
+  if (!src->buf || !src->data || src->data < src->buf->data ||
+      src->data + src->size + AV_INPUT_BUFFER_PADDING_SIZE > src->buf->data + src->buf->size)
+    return nullptr;
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(0);
+  pPacket->bufferRef = av_buffer_ref(src->buf);
+  if (!pPacket->bufferRef)
+  {
+    FreeDemuxPacket(pPacket);
+    return nullptr;
+  }
+
+  pPacket->pData = src->data;
+  pPacket->iSize = src->size;
+  packetsWrapped.fetch_add(1, std::memory_order_relaxed);
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
@@ -81,3 +251,14 @@ void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
   pkt->pSideData = avPkt.side_data;
   pkt->iSideDataElems = avPkt.side_data_elems;
 }
+
+CDVDDemuxUtils::PacketStats CDVDDemuxUtils::GetPacketStats()
+{
+  PacketStats stats;
+  stats.allocated = packetsAllocated.load(std::memory_order_relaxed);
+  stats.pooled = packetsPooled.load(std::memory_order_relaxed);
+  stats.wrapped = packetsWrapped.load(std::memory_order_relaxed);
+  stats.freed = packetsFreed.load(std::memory_order_relaxed);
+  stats.bytes = bytesAllocated.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -9,6 +9,9 @@
 #pragma once
 
 #include "cores/VideoPlayer/Interface/DemuxPacket.h"
+
+#include <stdint.h>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
@@ -16,9 +19,27 @@ extern "C" {
 class CDVDDemuxUtils
 {
 public:
+  /**
+   * Counters of all packets allocated by the process, to track the cost of demuxing.
+   */
+  struct PacketStats
+  {
+    uint64_t allocated = 0; //!< packets allocated
+    uint64_t pooled = 0; //!< packets reused from the pool
+    uint64_t wrapped = 0; //!< packets wrapping ffmpeg buffers
+    uint64_t freed = 0; //!< packets freed
+    uint64_t bytes = 0; //!< payload bytes allocated
+  };
+
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /**
+   * Allocate a packet that references the data of src instead of a copy.
+   * Returns nullptr if the data of src isn't reference counted.
+   */
+  static DemuxPacket* WrapDemuxPacket(AVPacket* src);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
+  static PacketStats GetPacketStats();
 };
 
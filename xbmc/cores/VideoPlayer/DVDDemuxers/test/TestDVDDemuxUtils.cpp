@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+namespace
+{
+void ExpectPadding(const DemuxPacket* packet)
+{
+  for (int i = 0; i < AV_INPUT_BUFFER_PADDING_SIZE; ++i)
+    EXPECT_EQ(0, packet->pData[packet->iSize + i]) << "at " << i;
+}
+} // namespace
+
+TEST(TestDVDDemuxUtils, ReusePackets)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(1100);
+  ASSERT_NE(nullptr, packet);
+  ASSERT_NE(nullptr, packet->pData);
+  packet->iSize = 1100;
+  memset(packet->pData, 0xff, 1100 + AV_INPUT_BUFFER_PADDING_SIZE);
+  packet->pts = 1.0;
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // a packet of the same size class is taken from the pool, cleared
+  const CDVDDemuxUtils::PacketStats before = CDVDDemuxUtils::GetPacketStats();
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(1050);
+  const CDVDDemuxUtils::PacketStats after = CDVDDemuxUtils::GetPacketStats();
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(before.pooled + 1, after.pooled);
+  EXPECT_EQ(before.bytes, after.bytes);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->pts);
+  EXPECT_EQ(0, packet->iSize);
+  EXPECT_GE(packet->bufferSize, 1050u + AV_INPUT_BUFFER_PADDING_SIZE);
+  packet->iSize = 1050;
+  ExpectPadding(packet);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // so are empty ones
+  CDVDDemuxUtils::FreeDemuxPacket(CDVDDemuxUtils::AllocateDemuxPacket(0));
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(0);
+  EXPECT_EQ(after.pooled + 1, CDVDDemuxUtils::GetPacketStats().pooled);
+  EXPECT_EQ(nullptr, packet->pData);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxUtils, SizeClasses)
+{
+  // all sizes up to a few MiB fit the buffers of their class
+  for (int size = 1; size < 8 * 1024 * 1024; size = size * 5 / 4 + 1)
+  {
+    DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_GE(packet->bufferSize, static_cast<size_t>(size) + AV_INPUT_BUFFER_PADDING_SIZE);
+    EXPECT_LE(packet->bufferSize, (size + AV_INPUT_BUFFER_PADDING_SIZE) * 5 / 4 + 256);
+    packet->iSize = size;
+    memset(packet->pData, 0xff, size);
+    ExpectPadding(packet);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  // larger ones are not pooled
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(32 * 1024 * 1024);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(0u, packet->bufferSize);
+  packet->iSize = 32 * 1024 * 1024;
+  ExpectPadding(packet);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
+
+TEST(TestDVDDemuxUtils, WrapPacket)
+{
+  AVPacket avpkt;
+  av_init_packet(&avpkt);
+  avpkt.data = nullptr;
+  avpkt.size = 0;
+  ASSERT_EQ(0, av_new_packet(&avpkt, 1000));
+  memset(avpkt.data, 0x55, avpkt.size);
+
+  DemuxPacket* packet = CDVDDemuxUtils::WrapDemuxPacket(&avpkt);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(avpkt.data, packet->pData);
+  EXPECT_EQ(1000, packet->iSize);
+  ExpectPadding(packet);
+
+  // the data stays when ffmpeg is done with its packet
+  av_packet_unref(&avpkt);
+  EXPECT_EQ(0x55, packet->pData[999]);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // data that isn't reference counted has to be copied
+  uint8_t data[16 + AV_INPUT_BUFFER_PADDING_SIZE] = {};
+  av_init_packet(&avpkt);
+  avpkt.data = data;
+  avpkt.size = 16;
+  EXPECT_EQ(nullptr, CDVDDemuxUtils::WrapDemuxPacket(&avpkt));
+}
+
+TEST(TestDVDDemuxUtils, CountPackets)
+{
+  const CDVDDemuxUtils::PacketStats before = CDVDDemuxUtils::GetPacketStats();
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(100, 2);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_NE(nullptr, packet->cryptoInfo);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  const CDVDDemuxUtils::PacketStats after = CDVDDemuxUtils::GetPacketStats();
+  EXPECT_EQ(before.allocated + 1, after.allocated);
+  EXPECT_EQ(before.freed + 1, after.freed);
+
+  // a reused packet starts without crypto info
+  packet = CDVDDemuxUtils::AllocateDemuxPacket(100);
+  EXPECT_EQ(nullptr, packet->cryptoInfo);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
@@ -15,7 +15,54 @@
 
 #include <math.h>
 
-CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
+// initial number of message slots, enough for a few seconds of video and audio packets
+#define MSGQ_INITIAL_SLOTS 256
+
+CDVDMessageRing::CDVDMessageRing(size_t capacity)
+{
+  size_t slots = 1;
+  while (slots < capacity)
+    slots <<= 1;
+  m_slots.resize(slots);
+  m_mask = slots - 1;
+}
+
+void CDVDMessageRing::emplace_front(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_slots.size())
+    Grow();
+  m_slots[(m_first + m_size) & m_mask] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::emplace_back(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_slots.size())
+    Grow();
+  m_first = (m_first - 1) & m_mask;
+  m_slots[m_first] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::pop_back()
+{
+  m_slots[m_first] = DVDMessageListItem();
+  m_first = (m_first + 1) & m_mask;
+  m_size--;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> slots(m_slots.size() * 2);
+  for (size_t i = 0; i < m_size; i++)
+    slots[i] = std::move(m_slots[(m_first + i) & m_mask]);
+  m_slots.swap(slots);
+  m_mask = m_slots.size() - 1;
+  m_first = 0;
+}
+
+CDVDMessageQueue::CDVDMessageQueue(const std::string &owner)
+  : m_hEvent(true), m_owner(owner), m_messages(MSGQ_INITIAL_SLOTS)
 {
   m_iDataSize     = 0;
   m_bAbortRequest = false;
@@ -57,6 +104,7 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
+    m_packetCount = 0;
     m_iDataSize = 0;
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
@@ -137,6 +185,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
       m_messages.emplace_back(pMsg, priority);
   }
 
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    m_packetCount++;
+
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
     DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
@@ -174,15 +225,30 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    if (priority > 0 || !m_prioMessages.empty())
+    {
+      if (!m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
+      {
+        DVDMessageListItem& item(m_prioMessages.back());
+        priority = item.priority;
+        if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+          m_packetCount--;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+        *pMsg = item.message->Acquire();
+        m_prioMessages.pop_back();
+        UpdateTimeBack();
+        ret = MSGQ_OK;
+        break;
+      }
+    }
+    else if (!m_messages.empty())
     {
-      DVDMessageListItem& item(msgs.back());
+      DVDMessageListItem& item(m_messages.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
       {
+        m_packetCount--;
         DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
         if (packet)
         {
@@ -190,13 +256,16 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
         }
       }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      // hand the reference of the queue to the caller
+      *pMsg = item.message;
+      item.message = NULL;
+      m_messages.pop_back();
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
     }
-    else if (!iTimeoutInMilliSeconds)
+
+    if (!iTimeoutInMilliSeconds)
     {
       ret = MSGQ_TIMEOUT;
       break;
@@ -271,10 +340,13 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
   if (!m_bInitialized)
     return 0;
 
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    return m_packetCount;
+
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  for (size_t i = 0; i < m_messages.size(); i++)
   {
-    if(item.message->IsType(type))
+    if(m_messages[i].message->IsType(type))
       count++;
   }
   for (const auto &item : m_prioMessages)
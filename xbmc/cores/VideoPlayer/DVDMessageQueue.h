@@ -16,6 +16,8 @@
 #include <atomic>
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct DVDMessageListItem
 {
@@ -30,6 +32,11 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other) noexcept
+    : message(other.message), priority(other.priority)
+  {
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -37,11 +44,70 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other) noexcept
+  {
+    std::swap(message, other.message);
+    std::swap(priority, other.priority);
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
 };
 
+/*!
+ * \brief Messages queued in the preallocated slots of a ring buffer
+ *
+ * Like the std::list it replaces, new messages are added at the front and the oldest one is
+ * taken from the back, and messages can be put back there. The slots are reused, so queueing
+ * a message doesn't allocate memory unless more messages are queued than ever before.
+ */
+class CDVDMessageRing
+{
+public:
+  explicit CDVDMessageRing(size_t capacity);
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+
+  //! the message that was queued last
+  DVDMessageListItem& front() { return m_slots[(m_first + m_size - 1) & m_mask]; }
+  //! the message that is taken next
+  DVDMessageListItem& back() { return m_slots[m_first]; }
+  //! the message at position, 0 being the back
+  const DVDMessageListItem& operator[](size_t position) const
+  {
+    return m_slots[(m_first + position) & m_mask];
+  }
+
+  void emplace_front(CDVDMsg* msg, int priority);
+  void emplace_back(CDVDMsg* msg, int priority);
+  void pop_back();
+
+  template<typename Predicate>
+  void remove_if(Predicate predicate)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+      DVDMessageListItem& item = m_slots[(m_first + i) & m_mask];
+      if (predicate(item))
+        item = DVDMessageListItem();
+      else if (kept++ != i)
+        m_slots[(m_first + kept - 1) & m_mask] = std::move(item);
+    }
+    m_size = kept;
+  }
+
+private:
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_slots;
+  size_t m_mask;
+  size_t m_first = 0;
+  size_t m_size = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -118,7 +184,8 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  CDVDMessageRing m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+  unsigned int m_packetCount = 0; ///< number of DEMUXER_PACKET messages in both queues
 };
 
@@ -11,6 +11,8 @@
 #include "TimingConstants.h"
 #include "addons/kodi-dev-kit/include/kodi/c-api/addon-instance/inputstream/demux_packet.h"
 
+#include <stddef.h>
+
 #define DMX_SPECIALID_STREAMINFO DEMUX_SPECIALID_STREAMINFO
 #define DMX_SPECIALID_STREAMCHANGE DEMUX_SPECIALID_STREAMCHANGE
 
@@ -19,6 +21,8 @@ extern "C"
 {
 #endif /* __cplusplus */
 
+  struct AVBufferRef;
+
   struct DemuxPacket : DEMUX_PACKET
   {
     DemuxPacket()
@@ -39,7 +43,17 @@ extern "C"
       recoveryPoint = false;
 
       cryptoInfo = nullptr;
+
+      bufferRef = nullptr;
+      bufferSize = 0;
     }
+
+    // not part of the add-on interface, managed by CDVDDemuxUtils
+
+    //! the ffmpeg buffer pData points into, if the packet wraps one instead of a copy
+    struct AVBufferRef* bufferRef;
+    //! allocated size of pData, if it is owned by the packet
+    size_t bufferSize;
   };
 
 #ifdef __cplusplus
@@ -174,6 +174,7 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
 
   m_ptsTracker.ResetVFRDetection();
   ResetFrameRateCalc();
+  m_copyStats = CVideoBuffer::GetCopyStats();
 
   m_iDroppedRequest = 0;
   m_iLateFrames = 0;
@@ -942,6 +943,11 @@ std::string CVideoPlayerVideo::GetPlayerInfo()
   s << ", drop:" << m_iDroppedFrames;
   s << ", skip:" << m_renderManager.GetSkippedFrames();
 
+  // bytes the renderer copied per uploaded picture since the stream was opened
+  const CVideoBuffer::CopyStats copyStats = CVideoBuffer::GetCopyStats();
+  const uint64_t pictures = copyStats.pictures - m_copyStats.pictures;
+  s << ", cp:" << (pictures ? (copyStats.bytes - m_copyStats.bytes) / pictures / 1024 : 0) << "kB";
+
   int pc = m_ptsTracker.GetPatternLength();
   if (pc > 0)
     s << ", pc:" << pc;
@@ -133,6 +133,7 @@ protected:
   CDVDStreamInfo m_hints;
   CDVDVideoCodec* m_pVideoCodec;
   CPtsTracker m_ptsTracker;
+  CVideoBuffer::CopyStats m_copyStats;
   std::list<DVDMessageListItem> m_packets;
   CDroppingStats m_droppingStats;
   CRenderManager& m_renderManager;
@@ -217,10 +217,11 @@ bool CRendererVAAPI::UploadTexture(int index)
       pic->GetStrides(src.stride);
       UnBindPbo(m_buffers[index]);
       CVideoBuffer::CopyNV12Picture(&dst, &src);
+      CVideoBuffer::CountUpload();
       BindPbo(m_buffers[index]);
     }
     CalculateTextureSourceRects(index, 3);
-    return UploadNV12Texture(index);
+    return UploadNV12Texture(index, m_buffers[index].image);
   }
 
   m_vaapiTextures[index]->Map(pic);
@@ -1762,34 +1762,48 @@ bool CLinuxRendererGL::UploadTexture(int index)
     ret = false;
 
     YuvImage &dst = m_buffers[index].image;
-    YuvImage src;
+    YuvImage src = dst;
     m_buffers[index].videoBuffer->GetPlanes(src.plane);
     m_buffers[index].videoBuffer->GetStrides(src.stride);
 
+    // without pbos the copy only repacks the picture, textures load from the decoded planes
+    // if their rows are whole texels
+    bool direct = !m_buffers[index].pbo[0];
+
     UnBindPbo(m_buffers[index]);
 
     if (m_format == AV_PIX_FMT_NV12)
     {
-      CVideoBuffer::CopyNV12Picture(&dst, &src);
+      direct = direct && src.stride[1] % 2 == 0;
+      if (!direct)
+        CVideoBuffer::CopyNV12Picture(&dst, &src);
       BindPbo(m_buffers[index]);
-      ret = UploadNV12Texture(index);
+      ret = UploadNV12Texture(index, direct ? src : dst);
     }
     else if (m_format == AV_PIX_FMT_YUYV422 ||
              m_format == AV_PIX_FMT_UYVY422)
     {
-      CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
+      direct = direct && src.stride[0] % 4 == 0;
+      if (!direct)
+        CVideoBuffer::CopyYUV422PackedPicture(&dst, &src);
       BindPbo(m_buffers[index]);
-      ret = UploadYUV422PackedTexture(index);
+      ret = UploadYUV422PackedTexture(index, direct ? src : dst);
     }
     else
     {
-      CVideoBuffer::CopyPicture(&dst, &src);
+      direct = direct && src.stride[0] % dst.bpp == 0 && src.stride[1] % dst.bpp == 0 &&
+               src.stride[2] % dst.bpp == 0;
+      if (!direct)
+        CVideoBuffer::CopyPicture(&dst, &src);
       BindPbo(m_buffers[index]);
-      ret = UploadYV12Texture(index);
+      ret = UploadYV12Texture(index, direct ? src : dst);
     }
 
     if (ret)
+    {
       m_buffers[index].loaded = true;
+      CVideoBuffer::CountUpload();
+    }
   }
 
   if (ret)
@@ -1952,10 +1966,10 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
   return true;
 }
 
-bool CLinuxRendererGL::UploadYV12Texture(int source)
+bool CLinuxRendererGL::UploadYV12Texture(int source, const YuvImage& image)
 {
   CPictureBuffer& buf = m_buffers[source];
-  YuvImage* im = &buf.image;
+  const YuvImage* im = &image;
 
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
@@ -2070,10 +2084,10 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
 //********************************************************************************************************
 // NV12 Texture loading, creation and deletion
 //********************************************************************************************************
-bool CLinuxRendererGL::UploadNV12Texture(int source)
+bool CLinuxRendererGL::UploadNV12Texture(int source, const YuvImage& image)
 {
   CPictureBuffer& buf = m_buffers[source];
-  YuvImage* im = &buf.image;
+  const YuvImage* im = &image;
 
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
@@ -2309,10 +2323,10 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
   }
 }
 
-bool CLinuxRendererGL::UploadYUV422PackedTexture(int source)
+bool CLinuxRendererGL::UploadYUV422PackedTexture(int source, const YuvImage& image)
 {
   CPictureBuffer& buf = m_buffers[source];
-  YuvImage* im = &buf.image;
+  const YuvImage* im = &image;
 
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
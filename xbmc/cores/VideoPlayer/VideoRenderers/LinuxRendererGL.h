@@ -111,15 +111,15 @@ protected:
   virtual void DeleteTexture(int index);
   virtual bool CreateTexture(int index);
 
-  bool UploadYV12Texture(int index);
+  bool UploadYV12Texture(int index, const YuvImage& im);
   void DeleteYV12Texture(int index);
   bool CreateYV12Texture(int index);
 
-  bool UploadNV12Texture(int index);
+  bool UploadNV12Texture(int index, const YuvImage& im);
   void DeleteNV12Texture(int index);
   bool CreateNV12Texture(int index);
 
-  bool UploadYUV422PackedTexture(int index);
+  bool UploadYUV422PackedTexture(int index, const YuvImage& im);
   void DeleteYUV422PackedTexture(int index);
   bool CreateYUV422PackedTexture(int index);
 
@@ -309,6 +309,7 @@ void CLinuxRendererGLES::LoadPlane(CYuvPlane& plane, int type,
 
       for (unsigned int y = 0; y < height; ++y, src += stride, dst += width * bps)
         memcpy(dst, src, width * bps);
+      CVideoBuffer::CountCopy(planeSize);
 
       pixelData = m_planeBuffer;
     }
@@ -778,6 +779,7 @@ bool CLinuxRendererGLES::UploadTexture(int index)
   if (ret)
   {
     m_buffers[index].loaded = true;
+    CVideoBuffer::CountUpload();
   }
 
   return ret;
@@ -0,0 +1,199 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessage.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+int GetValue(const DVDMessageListItem& item)
+{
+  return static_cast<CDVDMsgInt*>(item.message)->m_value;
+}
+
+std::vector<int> GetValues(const CDVDMessageRing& ring)
+{
+  std::vector<int> values;
+  for (size_t i = 0; i < ring.size(); i++)
+    values.push_back(GetValue(ring[i]));
+  return values;
+}
+
+void Put(CDVDMessageRing& ring, int value, bool front = true)
+{
+  CDVDMsg* msg = new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, value);
+  if (front)
+    ring.emplace_front(msg, 0);
+  else
+    ring.emplace_back(msg, 0);
+  msg->Release();
+}
+
+int Get(CDVDMessageQueue& queue, int& priority)
+{
+  CDVDMsg* msg = nullptr;
+  priority = 0;
+  if (queue.Get(&msg, 0, priority) != MSGQ_OK || !msg)
+    return -1;
+  const int value = msg->IsType(CDVDMsg::DEMUXER_PACKET)
+                        ? 1000
+                        : static_cast<CDVDMsgInt*>(msg)->m_value;
+  msg->Release();
+  return value;
+}
+
+CDVDMsg* CreatePacket(int size)
+{
+  return new CDVDMsgDemuxerPacket(CDVDDemuxUtils::AllocateDemuxPacket(size), false);
+}
+
+} // namespace
+
+TEST(TestDVDMessageRing, WrapAround)
+{
+  CDVDMessageRing ring(4);
+
+  // move the back around the ring a few times
+  int next = 0;
+  int expected = 0;
+  for (int round = 0; round < 8; round++)
+  {
+    Put(ring, next++);
+    Put(ring, next++);
+    Put(ring, next++);
+    ASSERT_EQ(3u, ring.size());
+    EXPECT_EQ(next - 1, GetValue(ring.front()));
+    for (int i = 0; i < 3; i++)
+    {
+      EXPECT_EQ(expected++, GetValue(ring.back()));
+      ring.pop_back();
+    }
+    EXPECT_TRUE(ring.empty());
+  }
+
+  // put back wraps around to the last slot
+  Put(ring, 1);
+  Put(ring, 2);
+  Put(ring, 0, false);
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), GetValues(ring));
+}
+
+TEST(TestDVDMessageRing, GrowWrapped)
+{
+  CDVDMessageRing ring(4);
+  Put(ring, 0);
+  Put(ring, 1);
+  ring.pop_back();
+  ring.pop_back();
+
+  // the messages wrap around the end of the slots when the ring grows
+  for (int i = 0; i < 4; i++)
+    Put(ring, i);
+  Put(ring, 4);
+  Put(ring, -1, false);
+  EXPECT_EQ(std::vector<int>({-1, 0, 1, 2, 3, 4}), GetValues(ring));
+
+  for (int i = 5; i < 20; i++)
+    Put(ring, i);
+  ASSERT_EQ(21u, ring.size());
+  for (int i = -1; i < 20; i++)
+  {
+    EXPECT_EQ(i, GetValue(ring.back()));
+    ring.pop_back();
+  }
+}
+
+TEST(TestDVDMessageRing, RemoveIf)
+{
+  CDVDMessageRing ring(4);
+  Put(ring, 0);
+  Put(ring, 1);
+  ring.pop_back();
+  ring.pop_back();
+  for (int i = 0; i < 8; i++)
+    Put(ring, i);
+
+  ring.remove_if([](const DVDMessageListItem& item) { return GetValue(item) % 3 == 0; });
+  EXPECT_EQ(std::vector<int>({1, 2, 4, 5, 7}), GetValues(ring));
+
+  // the freed slots are reused
+  Put(ring, 8);
+  Put(ring, 9, false);
+  EXPECT_EQ(std::vector<int>({9, 1, 2, 4, 5, 7, 8}), GetValues(ring));
+}
+
+TEST(TestDVDMessageQueue, PriorityInsertion)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 11), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 2), 2);
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 12), 1);
+  // put back goes before the messages of the same priority
+  queue.PutBack(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 10), 1);
+
+  int priority;
+  EXPECT_EQ(2, Get(queue, priority));
+  EXPECT_EQ(2, priority);
+  EXPECT_EQ(10, Get(queue, priority));
+  EXPECT_EQ(1, priority);
+  EXPECT_EQ(11, Get(queue, priority));
+  EXPECT_EQ(12, Get(queue, priority));
+  EXPECT_EQ(0, Get(queue, priority));
+  EXPECT_EQ(0, priority);
+  EXPECT_EQ(-1, Get(queue, priority));
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, FlushByType)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  for (int i = 0; i < 300; i++)
+  {
+    queue.Put(CreatePacket(100));
+    if (i % 100 == 0)
+      queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, i));
+  }
+  queue.Put(CreatePacket(100), 1);
+  EXPECT_EQ(301u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(300 * 100, queue.GetDataSize());
+
+  // other messages keep the packets
+  queue.Flush(CDVDMsg::GENERAL_RESYNC);
+  EXPECT_EQ(301u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.Flush(CDVDMsg::DEMUXER_PACKET);
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(0, queue.GetDataSize());
+
+  int priority;
+  EXPECT_EQ(0, Get(queue, priority));
+  EXPECT_EQ(100, Get(queue, priority));
+  EXPECT_EQ(200, Get(queue, priority));
+  EXPECT_EQ(-1, Get(queue, priority));
+
+  // everything
+  queue.Put(CreatePacket(100));
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 1), 1);
+  queue.Flush(CDVDMsg::NONE);
+  EXPECT_EQ(-1, Get(queue, priority));
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.End();
+}
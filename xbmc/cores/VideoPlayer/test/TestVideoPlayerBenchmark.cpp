@@ -0,0 +1,332 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDMessage.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct Stage
+{
+  Clock::duration busy = Clock::duration::zero();
+  uint64_t items = 0;
+  uint64_t bytes = 0;
+
+  void Report(const std::string& name, const std::string& unit) const
+  {
+    const double seconds = std::max(std::chrono::duration<double>(busy).count(), 1e-9);
+    ::testing::Test::RecordProperty(name + "_" + unit, std::to_string(items));
+    ::testing::Test::RecordProperty(name + "_" + unit + "PerSecond",
+                                    std::to_string(items / seconds));
+    ::testing::Test::RecordProperty(name + "_MBytesPerSecond",
+                                    std::to_string(bytes / seconds / 1000000.0));
+  }
+};
+
+struct QueueLevel
+{
+  uint64_t sum = 0;
+  uint64_t samples = 0;
+  int max = 0;
+
+  void Sample(const CDVDMessageQueue& queue)
+  {
+    const int level = queue.GetLevel();
+    sum += level;
+    samples++;
+    max = std::max(max, level);
+  }
+
+  void Report(const std::string& name) const
+  {
+    ::testing::Test::RecordProperty(name + "_MeanLevel",
+                                    std::to_string(samples ? sum / samples : 0));
+    ::testing::Test::RecordProperty(name + "_MaxLevel", std::to_string(max));
+  }
+};
+
+// takes packets from the queue until the demuxer signals eof, like CVideoPlayerVideo
+void DecodeVideo(CDVDMessageQueue& queue, CDVDVideoCodec& codec, Stage& stage)
+{
+  VideoPicture picture;
+  // the last packets, sent again if the codec has to be reopened
+  std::deque<DVDMessageListItem> packets;
+
+  // returns false if the codec was reopened
+  auto getPictures = [&]() {
+    while (true)
+    {
+      const CDVDVideoCodec::VCReturn ret = codec.GetPicture(&picture);
+      if (ret == CDVDVideoCodec::VC_PICTURE)
+      {
+        stage.items++;
+        picture.videoBuffer->Release();
+        picture.videoBuffer = nullptr;
+      }
+      else if (ret == CDVDVideoCodec::VC_REOPEN)
+      {
+        for (auto& packet : packets)
+          queue.Put(packet.message->Acquire(), 10);
+        packets.clear();
+        codec.Reopen();
+        return false;
+      }
+      else if (ret != CDVDVideoCodec::VC_NONE)
+        return true;
+    }
+  };
+
+  while (true)
+  {
+    CDVDMsg* msg;
+    const MsgQueueReturnCode ret = queue.Get(&msg, 1000);
+    if (ret == MSGQ_TIMEOUT)
+      continue;
+    if (MSGQ_IS_ERROR(ret))
+      break;
+
+    const auto start = Clock::now();
+    if (msg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      codec.SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+      getPictures();
+      stage.busy += Clock::now() - start;
+      msg->Release();
+      break;
+    }
+
+    const DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+    packets.emplace_back(msg, 0);
+    if (packets.size() > codec.GetConvergeCount())
+      packets.pop_front();
+
+    bool reopened = false;
+    while (!reopened && !codec.AddData(*packet))
+      reopened = !getPictures();
+    if (!reopened)
+      getPictures();
+    stage.busy += Clock::now() - start;
+    stage.bytes += packet->iSize;
+    msg->Release();
+  }
+}
+
+// like CVideoPlayerAudio, without an audio sink
+void DecodeAudio(CDVDMessageQueue& queue, CDVDAudioCodec& codec, Stage& stage)
+{
+  DVDAudioFrame frame;
+  auto getFrames = [&]() {
+    while (true)
+    {
+      codec.GetData(frame);
+      if (frame.nb_frames == 0)
+        return;
+      stage.items += frame.nb_frames;
+    }
+  };
+
+  while (true)
+  {
+    CDVDMsg* msg;
+    const MsgQueueReturnCode ret = queue.Get(&msg, 1000);
+    if (ret == MSGQ_TIMEOUT)
+      continue;
+    if (MSGQ_IS_ERROR(ret))
+      break;
+
+    if (msg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      msg->Release();
+      break;
+    }
+
+    const auto start = Clock::now();
+    const DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+    while (!codec.AddData(*packet))
+      getFrames();
+    getFrames();
+    stage.busy += Clock::now() - start;
+    stage.bytes += packet->iSize;
+    msg->Release();
+  }
+}
+
+} // namespace
+
+/*!
+ * Demuxes the file in KODI_DECODE_BENCHMARK_FILE through the input stream and demuxer the player
+ * would use, queues the packets of the first video and audio stream and decodes them with the
+ * ffmpeg codecs on their own threads as fast as possible, without renderer or audio sink.
+ * Reports throughput and busy time of each stage, the levels of the queues and the allocated
+ * demux packets. Run with --gtest_output=json to track them.
+ */
+TEST(TestVideoPlayerBenchmark, DISABLED_DemuxDecode)
+{
+  const char* file = getenv("KODI_DECODE_BENCHMARK_FILE");
+  ASSERT_NE(nullptr, file) << "KODI_DECODE_BENCHMARK_FILE is not set";
+
+  CFileItem item(file, false);
+  std::shared_ptr<CDVDInputStream> input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  ASSERT_TRUE(input);
+  ASSERT_TRUE(input->Open());
+  std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input));
+  ASSERT_TRUE(demuxer);
+
+  CDemuxStream* videoStream = nullptr;
+  CDemuxStream* audioStream = nullptr;
+  for (CDemuxStream* stream : demuxer->GetStreams())
+  {
+    if (stream->type == STREAM_VIDEO && !videoStream)
+      videoStream = stream;
+    else if (stream->type == STREAM_AUDIO && !audioStream)
+      audioStream = stream;
+  }
+  ASSERT_TRUE(videoStream || audioStream);
+
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  CDVDCodecOptions options;
+
+  CDVDMessageQueue videoQueue("video");
+  videoQueue.SetMaxDataSize(40 * 1024 * 1024);
+  videoQueue.SetMaxTimeSize(8.0);
+  videoQueue.Init();
+  CDVDMessageQueue audioQueue("audio");
+  audioQueue.SetMaxDataSize(6 * 1024 * 1024);
+  audioQueue.SetMaxTimeSize(8.0);
+  audioQueue.Init();
+
+  Stage demux, video, audio;
+  QueueLevel videoLevel, audioLevel;
+  Clock::duration demuxWait = Clock::duration::zero();
+
+  std::unique_ptr<CDVDVideoCodecFFmpeg> videoCodec;
+  std::thread videoThread;
+  if (videoStream)
+  {
+    CDVDStreamInfo hints(*videoStream, true);
+    videoCodec.reset(new CDVDVideoCodecFFmpeg(*processInfo));
+    ASSERT_TRUE(videoCodec->Open(hints, options));
+    videoThread = std::thread(DecodeVideo, std::ref(videoQueue), std::ref(*videoCodec),
+                              std::ref(video));
+  }
+
+  std::unique_ptr<CDVDAudioCodecFFmpeg> audioCodec;
+  std::thread audioThread;
+  if (audioStream)
+  {
+    CDVDStreamInfo hints(*audioStream, true);
+    audioCodec.reset(new CDVDAudioCodecFFmpeg(*processInfo));
+    if (audioCodec->Open(hints, options))
+      audioThread = std::thread(DecodeAudio, std::ref(audioQueue), std::ref(*audioCodec),
+                                std::ref(audio));
+    else
+      audioStream = nullptr;
+  }
+
+  const CDVDDemuxUtils::PacketStats startStats = CDVDDemuxUtils::GetPacketStats();
+  const auto start = Clock::now();
+
+  while (true)
+  {
+    const auto readStart = Clock::now();
+    DemuxPacket* packet = demuxer->Read();
+    demux.busy += Clock::now() - readStart;
+    if (!packet)
+      break;
+
+    demux.items++;
+    demux.bytes += packet->iSize;
+
+    CDVDMessageQueue* queue = nullptr;
+    QueueLevel* level = nullptr;
+    if (videoStream && packet->iStreamId == videoStream->uniqueId &&
+        packet->demuxerId == videoStream->demuxerId)
+    {
+      queue = &videoQueue;
+      level = &videoLevel;
+    }
+    else if (audioStream && packet->iStreamId == audioStream->uniqueId &&
+             packet->demuxerId == audioStream->demuxerId)
+    {
+      queue = &audioQueue;
+      level = &audioLevel;
+    }
+
+    if (!queue)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+
+    // the player stops reading while a queue is full
+    const auto waitStart = Clock::now();
+    while (queue->IsFull())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    demuxWait += Clock::now() - waitStart;
+
+    queue->Put(new CDVDMsgDemuxerPacket(packet));
+    level->Sample(*queue);
+  }
+
+  videoQueue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  audioQueue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  if (videoThread.joinable())
+    videoThread.join();
+  if (audioThread.joinable())
+    audioThread.join();
+
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  const CDVDDemuxUtils::PacketStats stats = CDVDDemuxUtils::GetPacketStats();
+
+  EXPECT_GT(demux.items, 0u);
+  if (videoStream)
+    EXPECT_GT(video.items, 0u);
+  // every packet is freed once decoded
+  EXPECT_EQ(stats.allocated - startStats.allocated, stats.freed - startStats.freed);
+
+  RecordProperty("Seconds", std::to_string(seconds));
+  demux.Report("Demux", "Packets");
+  video.Report("Video", "Frames");
+  audio.Report("Audio", "Samples");
+  videoLevel.Report("VideoQueue");
+  audioLevel.Report("AudioQueue");
+  RecordProperty("Demux_WaitMs",
+                 std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(demuxWait)
+                                    .count()));
+  RecordProperty("Packets_Allocated", std::to_string(stats.allocated - startStats.allocated));
+  RecordProperty("Packets_Pooled", std::to_string(stats.pooled - startStats.pooled));
+  RecordProperty("Packets_Wrapped", std::to_string(stats.wrapped - startStats.wrapped));
+  RecordProperty("Packets_BytesAllocated", std::to_string(stats.bytes - startStats.bytes));
+
+  videoQueue.End();
+  audioQueue.End();
+}
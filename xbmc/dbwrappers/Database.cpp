@@ -27,6 +27,8 @@
 #include "platform/posix/ConvUtils.h"
 #endif
 
+#include <algorithm>
+
 using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
@@ -388,6 +390,41 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
         __FUNCTION__, strQuery.c_str());
   }
 
+  if (bReturn)
+    OnBatchedWrite();
+
+  return bReturn;
+}
+
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const dbiplus::sql_record &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (nullptr == m_pDB)
+      return bReturn;
+    if (nullptr == m_pDS)
+      return bReturn;
+
+    if (m_multipleExecute)
+    {
+      m_multipleQueries.push_back(m_pDB->bind(strQuery, params));
+      return true;
+    }
+
+    m_pDS->exec(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  if (bReturn)
+    OnBatchedWrite();
+
   return bReturn;
 }
 
@@ -415,6 +452,89 @@ bool CDatabase::ResultQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ResultQuery(const std::string &strQuery, const dbiplus::sql_record &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (nullptr == m_pDB)
+      return bReturn;
+    if (nullptr == m_pDS)
+      return bReturn;
+
+    bReturn = m_pDS->query(strQuery, params);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
+bool CDatabase::BeginBatchedWrites(unsigned int rowsPerTransaction /* = 1000 */,
+                                   unsigned int millisPerTransaction /* = 1000 */)
+{
+  if (nullptr == m_pDB || m_batchedWritesPerTransaction > 0 || m_pDB->in_transaction())
+    return false;
+
+  BeginTransaction();
+  m_batchedWritesPerTransaction = std::max(rowsPerTransaction, 1u);
+  m_batchedWritesMillis = millisPerTransaction;
+  m_batchedWrites = 0;
+  m_batchedSavepoints = 0;
+  return true;
+}
+
+bool CDatabase::CommitBatchedWrites()
+{
+  if (m_batchedWritesPerTransaction == 0)
+    return false;
+
+  m_batchedWritesPerTransaction = 0;
+  m_batchedWrites = 0;
+  m_batchedSavepoints = 0;
+  return CommitTransaction();
+}
+
+void CDatabase::RollbackBatchedWrites()
+{
+  if (m_batchedWritesPerTransaction == 0)
+    return;
+
+  m_batchedWritesPerTransaction = 0;
+  m_batchedWrites = 0;
+  m_batchedSavepoints = 0;
+  RollbackTransaction();
+}
+
+void CDatabase::OnBatchedWrite()
+{
+  // writes within a nested transaction count once, when it is committed
+  if (m_batchedWritesPerTransaction == 0 || m_batchedSavepoints > 0)
+    return;
+
+  // the database is locked for other writers from the first write of the batch on
+  if (++m_batchedWrites == 1)
+    m_batchedWritesEnd.Set(m_batchedWritesMillis);
+
+  if (m_batchedWrites < m_batchedWritesPerTransaction && !m_batchedWritesEnd.IsTimePast())
+    return;
+
+  m_batchedWrites = 0;
+  try
+  {
+    m_pDB->commit_transaction();
+    m_pDB->start_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "{} - failed to commit the batched writes", __FUNCTION__);
+  }
+}
+
 bool CDatabase::QueueInsertQuery(const std::string &strQuery)
 {
   if (strQuery.empty())
@@ -683,6 +803,9 @@ void CDatabase::Close()
 
   m_openCount = 0;
   m_multipleExecute = false;
+  m_batchedWritesPerTransaction = 0;
+  m_batchedWrites = 0;
+  m_batchedSavepoints = 0;
 
   if (nullptr == m_pDB)
     return;
@@ -741,7 +864,16 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    // nested in batched writes, so use a savepoint that can be released or rolled back on its own
+    if (m_batchedWritesPerTransaction > 0)
+    {
+      m_pDS->exec(StringUtils::Format("SAVEPOINT batch{}", m_batchedSavepoints + 1));
+      m_batchedSavepoints++;
+    }
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -754,7 +886,19 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return true;
+
+    // the batched writes are committed by OnBatchedWrite() and CommitBatchedWrites()
+    if (m_batchedWritesPerTransaction > 0)
+    {
+      if (m_batchedSavepoints == 0)
+        return true;
+      m_pDS->exec(StringUtils::Format("RELEASE SAVEPOINT batch{}", m_batchedSavepoints));
+      if (--m_batchedSavepoints == 0)
+        OnBatchedWrite();
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -769,7 +913,23 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (nullptr != m_pDB)
+    if (nullptr == m_pDB)
+      return;
+
+    if (m_batchedWritesPerTransaction > 0 && m_batchedSavepoints > 0)
+    {
+      const std::string savepoint = StringUtils::Format("batch{}", m_batchedSavepoints--);
+      m_pDS->exec("ROLLBACK TO SAVEPOINT " + savepoint);
+      m_pDS->exec("RELEASE SAVEPOINT " + savepoint);
+    }
+    else if (m_batchedWritesPerTransaction > 0)
+    {
+      // only the writes since the last batch was committed are lost
+      m_batchedWrites = 0;
+      m_pDB->rollback_transaction();
+      m_pDB->start_transaction();
+    }
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -8,15 +8,19 @@
 
 #pragma once
 
-namespace dbiplus {
-  class Database;
-  class Dataset;
-}
+#include "threads/SystemClock.h"
 
 #include <memory>
 #include <string>
 #include <vector>
 
+namespace dbiplus {
+  class Database;
+  class Dataset;
+  class field_value;
+  typedef std::vector<field_value> sql_record;
+}
+
 class DatabaseSettings; // forward
 class CDbUrl;
 class CProfileManager;
@@ -169,6 +173,18 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query that does not return any result, with its '?'
+   *        placeholders bound to the given values.
+   *        The compiled query is cached by the connection, so executing the
+   *        same query again only binds the new values.
+   * @param strQuery The query to execute, without any values formatted into it.
+   * @param params The values for the placeholders, in order of appearance.
+   * @return True if the query was executed successfully, false otherwise.
+   * @sa ExecuteQuery, BeginBatchedWrites
+   */
+  bool ExecuteQuery(const std::string &strQuery, const dbiplus::sql_record &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -177,6 +193,46 @@ public:
    */
   bool ResultQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query that returns a result, with its '?' placeholders
+   *        bound to the given values. The compiled query is cached by the connection.
+   * @remarks Call m_pDS->close(); to clean up the dataset when done.
+   * @param strQuery The query to execute, without any values formatted into it.
+   * @param params The values for the placeholders, in order of appearance.
+   * @return True if the query was executed successfully, false otherwise.
+   */
+  bool ResultQuery(const std::string &strQuery, const dbiplus::sql_record &params);
+
+  /*!
+   * @brief Group the following ExecuteQuery() calls and transactions into larger transactions.
+   *        Unlike with BeginMultipleExecute() the queries are executed right
+   *        away, so later queries can rely on them, but they are only committed
+   *        every rowsPerTransaction queries or transactions and by CommitBatchedWrites().
+   *        A batch is also committed by the first write after it has been open for
+   *        millisPerTransaction, as SQLite locks out other writers until then.
+   *        Transactions begun meanwhile become savepoints, so RollbackTransaction()
+   *        still only undoes their own writes.
+   * @param rowsPerTransaction The number of queries or transactions to commit at once.
+   * @param millisPerTransaction The time after the first write of a batch it is committed.
+   * @return True if batching was started, false if a transaction is already open.
+   * @sa CommitBatchedWrites, RollbackBatchedWrites, ExecuteQuery
+   */
+  bool BeginBatchedWrites(unsigned int rowsPerTransaction = 1000,
+                          unsigned int millisPerTransaction = 1000);
+
+  /*!
+   * @brief Commit the remaining batched queries and stop batching.
+   * @return True if the transaction was committed successfully, false otherwise.
+   * @sa BeginBatchedWrites
+   */
+  bool CommitBatchedWrites();
+
+  /*!
+   * @brief Roll back the batched queries that are not committed yet and stop batching.
+   * @sa BeginBatchedWrites
+   */
+  void RollbackBatchedWrites();
+
   /*!
    * @brief Start a multiple execution queue. Any ExecuteQuery() function
    *        following this call will be queued rather than executed until
@@ -304,4 +360,12 @@ private:
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  unsigned int m_batchedWritesPerTransaction = 0; ///< 0 unless BeginBatchedWrites() was called
+  unsigned int m_batchedWrites = 0; ///< queries executed in the current batched transaction
+  unsigned int m_batchedSavepoints = 0; ///< transactions nested in the batched transaction
+  unsigned int m_batchedWritesMillis = 0; ///< time a batched transaction is kept open for
+  XbmcThreads::EndTime m_batchedWritesEnd; ///< when the current batched transaction is due
+
+  void OnBatchedWrite();
 };
@@ -68,6 +68,62 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+std::string Database::bind(const std::string &sql, const sql_record &params)
+{
+  std::string result;
+  result.reserve(sql.size() + params.size() * 16);
+
+  size_t param = 0;
+  char quote = 0;
+  for (const char c : sql)
+  {
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '\'' || c == '"')
+      quote = c;
+    else if (c == '?')
+    {
+      if (param >= params.size())
+        throw DbErrors("Missing value for parameter %u\nQuery: %s", static_cast<unsigned int>(param + 1), sql.c_str());
+
+      const field_value &value = params[param++];
+      if (value.get_isNull())
+        result += "NULL";
+      else
+      {
+        switch (value.get_fType())
+        {
+        case ft_Boolean:
+        case ft_Short:
+        case ft_UShort:
+        case ft_Int:
+        case ft_UInt:
+        case ft_Int64:
+          result += std::to_string(value.get_asInt64());
+          break;
+        case ft_Float:
+        case ft_Double:
+          result += prepare("%.17g", value.get_asDouble());
+          break;
+        default:
+          result += prepare("'%s'", value.get_asString().c_str());
+          break;
+        }
+      }
+      continue;
+    }
+    result += c;
+  }
+
+  if (param != params.size())
+    throw DbErrors("Too many parameter values (%u)\nQuery: %s", static_cast<unsigned int>(params.size()), sql.c_str());
+
+  return result;
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -200,6 +256,18 @@ void Dataset::close(void) {
 }
 
 
+int Dataset::exec(const std::string &sql, const sql_record &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return exec(db->bind(sql, params));
+}
+
+
+bool Dataset::query(const std::string &sql, const sql_record &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+  return query(db->bind(sql, params));
+}
+
+
 bool Dataset::seek(int pos) {
   frecno = (pos<num_rows()-1)? pos: num_rows()-1;
   frecno = (frecno<0)? 0: frecno;
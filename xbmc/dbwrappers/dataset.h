@@ -148,6 +148,14 @@ public:
    */
   virtual std::string vprepare(const char *format, va_list args) = 0;
 
+  /*! \brief Substitute the '?' placeholders of a SQL statement with escaped values.
+   Used by datasets that can't bind parameters to a prepared statement themselves.
+   \param sql - SQL statement, '?' inside quoted literals is not treated as a placeholder.
+   \param params - values for the placeholders, in order of appearance.
+   \return the SQL statement with the values substituted.
+   */
+  virtual std::string bind(const std::string &sql, const sql_record &params);
+
   virtual bool in_transaction() {return false;};
 
 };
@@ -293,6 +301,9 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as exec/query, with the '?' placeholders of sql bound to params */
+  virtual int exec(const std::string &sql, const sql_record &params);
+  virtual bool query(const std::string &sql, const sql_record &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
@@ -138,9 +138,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  using Dataset::exec;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  using Dataset::query;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
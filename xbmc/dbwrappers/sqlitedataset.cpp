@@ -16,11 +16,14 @@
 #include "utils/XTimeUtils.h"
 #include "utils/log.h"
 
+#include <cctype>
 #include <iostream>
 #include <map>
 #include <sstream>
 #include <string>
 
+#define SQLITE_STATEMENT_CACHE_SIZE 64
+
 namespace {
 #define X(VAL) std::make_pair(VAL, #VAL)
 //!@todo Remove ifdefs when sqlite version requirement has been bumped to at least 3.26.0
@@ -362,6 +365,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
 }
@@ -520,6 +524,47 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for prepared statements
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::getStatement(const std::string &sql) {
+  if (!active) throw DbErrors("No Database Connection");
+
+  auto it = statement_index.find(sql);
+  if (it != statement_index.end()) {
+    statements.splice(statements.begin(), statements, it->second);
+    return it->second->second;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  const char *tail = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, &tail), sql.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", getErrorMsg());
+
+  while (tail && (isspace(static_cast<unsigned char>(*tail)) || *tail == ';'))
+    tail++;
+  if (stmt == NULL || (tail && *tail)) {
+    sqlite3_finalize(stmt);
+    throw DbErrors("Exactly one statement can be prepared\nQuery: %s", sql.c_str());
+  }
+
+  if (statements.size() >= SQLITE_STATEMENT_CACHE_SIZE) {
+    statement_index.erase(statements.back().first);
+    sqlite3_finalize(statements.back().second);
+    statements.pop_back();
+  }
+  statements.emplace_front(sql, stmt);
+  statement_index.emplace(sql, statements.begin());
+  return stmt;
+}
+
+void SqliteDatabase::clearStatements() {
+  for (const auto &statement : statements)
+    sqlite3_finalize(statement.second);
+  statements.clear();
+  statement_index.clear();
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -602,6 +647,59 @@ std::string SqliteDatabase::vprepare(const char *format, va_list args)
 
 //************* SqliteDataset implementation ***************
 
+namespace {
+/* resets a cached statement and its bindings when it goes out of scope,
+   so that it can be reused even if the dataset threw an exception */
+class StatementReset {
+public:
+  explicit StatementReset(sqlite3_stmt *stmt) : stmt(stmt) {}
+  ~StatementReset() {
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+  }
+
+private:
+  sqlite3_stmt *stmt;
+};
+
+int bind_params(sqlite3_stmt *stmt, const sql_record &params) {
+  if (sqlite3_bind_parameter_count(stmt) != static_cast<int>(params.size()))
+    return SQLITE_RANGE;
+
+  for (size_t i = 0; i < params.size(); i++) {
+    const field_value &value = params[i];
+    const int index = static_cast<int>(i) + 1;
+    int rc;
+    if (value.get_isNull())
+      rc = sqlite3_bind_null(stmt, index);
+    else {
+      switch (value.get_fType()) {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        rc = sqlite3_bind_int64(stmt, index, value.get_asInt64());
+        break;
+      case ft_Float:
+      case ft_Double:
+        rc = sqlite3_bind_double(stmt, index, value.get_asDouble());
+        break;
+      default: {
+        const std::string str = value.get_asString();
+        rc = sqlite3_bind_text(stmt, index, str.c_str(), static_cast<int>(str.size()), SQLITE_TRANSIENT);
+        break;
+      }
+      }
+    }
+    if (rc != SQLITE_OK)
+      return rc;
+  }
+  return SQLITE_OK;
+}
+}
+
 SqliteDataset::SqliteDataset():Dataset() {
   haveError = false;
   db = NULL;
@@ -806,20 +904,7 @@ const void* SqliteDataset::getExecRes() {
 }
 
 
-bool SqliteDataset::query(const std::string &query) {
-    if(!handle()) throw DbErrors("No Database Connection");
-    const std::string& qry = query;
-    int fs = qry.find("select");
-    int fS = qry.find("SELECT");
-    if (!( fs >= 0 || fS >=0))
-         throw DbErrors("MUST be select SQL!");
-
-  close();
-
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors("%s", db->getErrorMsg());
-
+int SqliteDataset::fill_result(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -827,7 +912,8 @@ bool SqliteDataset::query(const std::string &query) {
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
@@ -857,6 +943,43 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
+  return rc;
+}
+
+int SqliteDataset::exec(const std::string &sql, const sql_record &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(sql);
+  StatementReset reset(stmt);
+
+  int res = db->setErr(bind_params(stmt, params), sql.c_str());
+  if (res == SQLITE_OK) {
+    while ((res = sqlite3_step(stmt)) == SQLITE_ROW)
+      ;
+    res = db->setErr(sqlite3_reset(stmt), sql.c_str());
+  }
+  if (res != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+  return res;
+}
+
+bool SqliteDataset::query(const std::string &query) {
+    if(!handle()) throw DbErrors("No Database Connection");
+    const std::string& qry = query;
+    int fs = qry.find("select");
+    int fS = qry.find("SELECT");
+    if (!( fs >= 0 || fS >=0))
+         throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  fill_result(stmt);
+
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -870,6 +993,28 @@ bool SqliteDataset::query(const std::string &query) {
   }
 }
 
+bool SqliteDataset::query(const std::string &query, const sql_record &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(query);
+  StatementReset reset(stmt);
+
+  if (db->setErr(bind_params(stmt, params), query.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  fill_result(stmt);
+
+  if (db->setErr(sqlite3_reset(stmt), query.c_str()) != SQLITE_OK)
+    throw DbErrors("%s", db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
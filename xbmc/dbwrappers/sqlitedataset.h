@@ -14,7 +14,11 @@
 
 #include "dataset.h"
 
+#include <list>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <sqlite3.h>
 
@@ -31,6 +35,11 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* prepared statements, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList statements;
+  std::unordered_map<std::string, StatementList::iterator> statement_index;
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -82,6 +91,12 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
 
+/* func. returns the prepared statement for a single SQL statement. The statement is compiled on
+   first use and kept until it becomes one of the least recently used or the connection is
+   closed, the caller has to reset it after use. */
+  sqlite3_stmt *getStatement(const std::string &sql);
+/* func. finalizes all cached prepared statements */
+  void clearStatements();
 };
 
 
@@ -110,6 +125,9 @@ protected:
 /* This function works only with MySQL database
   Filling the fields information from select statement */
   void fill_fields() override;
+/* Reads the column headers and all rows of a statement into the result set,
+   returns the result of the last step */
+  int fill_result(sqlite3_stmt *stmt);
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
@@ -131,9 +149,11 @@ or insert() operations default = false) */
 /* func. executes a query without results to return */
   int  exec () override;
   int  exec (const std::string &sql) override;
+  int  exec (const std::string &sql, const sql_record &params) override;
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+  bool query(const std::string &query, const sql_record &params) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,170 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using dbiplus::field_value;
+
+namespace
+{
+const char* ITEM_INSERT = "INSERT INTO item (value) VALUES (?)";
+
+class CTestDatabase : public CDatabase
+{
+public:
+  bool Insert(int value) { return ExecuteQuery(ITEM_INSERT, {field_value(value)}); }
+  int Count() { return GetSingleValueInt("SELECT COUNT(*) FROM item"); }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY, value INTEGER)");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char* GetBaseDBName() const override { return "databasetest"; }
+};
+} // namespace
+
+class TestDatabase : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    // the second connection only sees what was committed
+    ASSERT_TRUE(m_database.Connect("databasetest", settings, true));
+    ASSERT_TRUE(m_committed.Connect("databasetest", settings, false));
+  }
+
+  void TearDown() override
+  {
+    m_database.Close();
+    m_committed.Close();
+    XFILE::CFile::Delete("special://temp/databasetest.db");
+  }
+
+  CTestDatabase m_database;
+  CTestDatabase m_committed;
+};
+
+TEST_F(TestDatabase, BatchedWrites)
+{
+  ASSERT_TRUE(m_database.BeginBatchedWrites(3));
+  EXPECT_FALSE(m_database.BeginBatchedWrites(3));
+
+  for (int i = 0; i < 7; i++)
+    ASSERT_TRUE(m_database.Insert(i));
+  EXPECT_EQ(7, m_database.Count());
+  EXPECT_EQ(6, m_committed.Count());
+
+  EXPECT_TRUE(m_database.CommitBatchedWrites());
+  EXPECT_EQ(7, m_committed.Count());
+
+  // not batching anymore
+  EXPECT_FALSE(m_database.CommitBatchedWrites());
+  ASSERT_TRUE(m_database.Insert(7));
+  EXPECT_EQ(8, m_committed.Count());
+
+  // an open transaction is not batched
+  m_database.BeginTransaction();
+  EXPECT_FALSE(m_database.BeginBatchedWrites(3));
+  EXPECT_TRUE(m_database.CommitTransaction());
+}
+
+TEST_F(TestDatabase, BatchedWritesTimeout)
+{
+  ASSERT_TRUE(m_database.BeginBatchedWrites(100, 50));
+  ASSERT_TRUE(m_database.Insert(0));
+  ASSERT_TRUE(m_database.Insert(1));
+  EXPECT_EQ(0, m_committed.Count());
+
+  // the first write after the batch is due commits it
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_EQ(0, m_committed.Count());
+  ASSERT_TRUE(m_database.Insert(2));
+  EXPECT_EQ(3, m_committed.Count());
+
+  // and the next batch starts with the next write
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  ASSERT_TRUE(m_database.Insert(3));
+  EXPECT_EQ(3, m_committed.Count());
+
+  EXPECT_TRUE(m_database.CommitBatchedWrites());
+  EXPECT_EQ(4, m_committed.Count());
+}
+
+TEST_F(TestDatabase, BatchedTransactions)
+{
+  ASSERT_TRUE(m_database.BeginBatchedWrites(2));
+
+  // a nested transaction counts as one write
+  m_database.BeginTransaction();
+  ASSERT_TRUE(m_database.Insert(1));
+  ASSERT_TRUE(m_database.Insert(2));
+  ASSERT_TRUE(m_database.Insert(3));
+  EXPECT_TRUE(m_database.CommitTransaction());
+  EXPECT_EQ(3, m_database.Count());
+  EXPECT_EQ(0, m_committed.Count());
+
+  // and is rolled back on its own
+  m_database.BeginTransaction();
+  ASSERT_TRUE(m_database.Insert(4));
+  m_database.RollbackTransaction();
+  EXPECT_EQ(3, m_database.Count());
+  EXPECT_EQ(0, m_committed.Count());
+
+  m_database.BeginTransaction();
+  m_database.BeginTransaction();
+  ASSERT_TRUE(m_database.Insert(5));
+  m_database.RollbackTransaction();
+  ASSERT_TRUE(m_database.Insert(6));
+  EXPECT_TRUE(m_database.CommitTransaction());
+  EXPECT_EQ(4, m_database.Count());
+  EXPECT_EQ(4, m_committed.Count());
+
+  EXPECT_TRUE(m_database.CommitBatchedWrites());
+  EXPECT_EQ(0, m_database.GetSingleValueInt("SELECT COUNT(*) FROM item WHERE value IN (4, 5)"));
+}
+
+TEST_F(TestDatabase, RollbackBatchedWrites)
+{
+  ASSERT_TRUE(m_database.BeginBatchedWrites(3));
+  for (int i = 0; i < 5; i++)
+    ASSERT_TRUE(m_database.Insert(i));
+  EXPECT_EQ(3, m_committed.Count());
+
+  // only the writes since the last commit are lost
+  m_database.RollbackBatchedWrites();
+  EXPECT_EQ(3, m_database.Count());
+  EXPECT_EQ(3, m_committed.Count());
+
+  ASSERT_TRUE(m_database.Insert(5));
+  EXPECT_EQ(4, m_committed.Count());
+
+  // a rollback outside a nested transaction drops the current batch, but keeps batching
+  ASSERT_TRUE(m_database.BeginBatchedWrites(3));
+  ASSERT_TRUE(m_database.Insert(6));
+  m_database.RollbackTransaction();
+  ASSERT_TRUE(m_database.Insert(7));
+  EXPECT_TRUE(m_database.CommitBatchedWrites());
+  EXPECT_EQ(5, m_committed.Count());
+  EXPECT_EQ(0, m_committed.GetSingleValueInt("SELECT COUNT(*) FROM item WHERE value = 6"));
+}
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace dbiplus;
+
+namespace
+{
+const char* TRACK_TABLE = "CREATE TABLE song (idSong INTEGER PRIMARY KEY, idAlbum INTEGER, "
+                          "strTitle TEXT, iTrack INTEGER, iDuration INTEGER, fRating FLOAT, "
+                          "strFileName TEXT, comment TEXT)";
+const char* TRACK_INSERT = "INSERT INTO song (idAlbum, strTitle, iTrack, iDuration, fRating, "
+                           "strFileName, comment) VALUES (?, ?, ?, ?, ?, ?, ?)";
+
+field_value NullValue()
+{
+  field_value value;
+  value.set_isNull();
+  return value;
+}
+
+sql_record CreateTrack(int track)
+{
+  const int album = track / 10;
+  sql_record values;
+  values.emplace_back(album);
+  values.emplace_back(("Track " + std::to_string(track) + " of 'album' " + std::to_string(album)).c_str());
+  values.emplace_back(track % 10 + 1);
+  values.emplace_back(180 + track % 240);
+  values.emplace_back(static_cast<double>(track % 11) / 2);
+  values.emplace_back(("/music/artist " + std::to_string(album / 8) + "/album " +
+                       std::to_string(album) + "/" + std::to_string(track) + ".flac").c_str());
+  values.push_back(NullValue());
+  return values;
+}
+}
+
+class TestSqliteDataset : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    m_db.setDatabase("sqlitedatasettest");
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("DROP TABLE IF EXISTS song");
+    m_ds->exec(TRACK_TABLE);
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    XFILE::CFile::Delete("special://temp/sqlitedatasettest.db");
+  }
+
+  int CountTracks()
+  {
+    m_ds->query("SELECT COUNT(*) FROM song");
+    const int count = m_ds->fv(0).get_asInt();
+    m_ds->close();
+    return count;
+  }
+
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestSqliteDataset, BindParameters)
+{
+  m_ds->exec("CREATE TABLE bound (iValue INTEGER, strValue TEXT, iBig INTEGER, fValue FLOAT, "
+             "nullValue TEXT, bValue BOOL, comment TEXT)");
+  m_ds->exec("INSERT INTO bound VALUES (?, ?, ?, ?, ?, ?, ?)",
+             {field_value(7), field_value("it's \"quoted\" ?"), field_value(static_cast<int64_t>(1) << 40),
+              field_value(2.5), NullValue(), field_value(true), field_value("comment")});
+
+  ASSERT_TRUE(m_ds->query("SELECT * FROM bound WHERE iValue = ? AND strValue = ?",
+                          {field_value(7), field_value("it's \"quoted\" ?")}));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(7, m_ds->fv("iValue").get_asInt());
+  EXPECT_EQ("it's \"quoted\" ?", m_ds->fv("strValue").get_asString());
+  EXPECT_EQ(static_cast<int64_t>(1) << 40, m_ds->fv("iBig").get_asInt64());
+  EXPECT_DOUBLE_EQ(2.5, m_ds->fv("fValue").get_asDouble());
+  EXPECT_TRUE(m_ds->fv("nullValue").get_isNull());
+  EXPECT_EQ(1, m_ds->fv("bValue").get_asInt());
+  EXPECT_EQ("comment", m_ds->fv("comment").get_asString());
+  m_ds->close();
+
+  // the cached statement is reset, so it can be run again right away
+  ASSERT_TRUE(m_ds->query("SELECT * FROM bound WHERE iValue = ? AND strValue = ?",
+                          {field_value(8), field_value("it's \"quoted\" ?")}));
+  EXPECT_EQ(0, m_ds->num_rows());
+  m_ds->close();
+
+  EXPECT_THROW(m_ds->exec("INSERT INTO bound (iValue) VALUES (?)", {}), DbErrors);
+  EXPECT_THROW(m_ds->exec("INSERT INTO bound (iValue) VALUES (?); DELETE FROM bound", {field_value(1)}), DbErrors);
+  EXPECT_THROW(m_ds->exec("INSERT INTO missing VALUES (?)", {field_value(1)}), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, BindFormatted)
+{
+  // the fallback for databases that can't bind parameters themselves
+  EXPECT_EQ("SELECT 'it''s', '?', 3, NULL FROM t WHERE a = 'x' AND b = 1.5",
+            m_db.bind("SELECT ?, '?', ?, ? FROM t WHERE a = 'x' AND b = ?",
+                      {field_value("it's"), field_value(3), NullValue(), field_value(1.5)}));
+  EXPECT_THROW(m_db.bind("SELECT ?", {}), DbErrors);
+  EXPECT_THROW(m_db.bind("SELECT 1", {field_value(1)}), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, StatementCache)
+{
+  // more distinct statements than are cached, the evicted ones are compiled again
+  for (int i = 0; i < 200; i++)
+    m_ds->exec("INSERT INTO song (idAlbum, iTrack) VALUES (?, " + std::to_string(i % 100) + ")",
+               {field_value(i)});
+  EXPECT_EQ(200, CountTracks());
+
+  // the cache is released with the connection and the schema may change in between
+  m_db.disconnect();
+  ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(false));
+  m_ds->exec("ALTER TABLE song ADD COLUMN iYear INTEGER");
+  m_ds->exec("INSERT INTO song (idAlbum, iTrack) VALUES (?, 0)", {field_value(1)});
+  EXPECT_EQ(201, CountTracks());
+}
+
+/*!
+ * Imports 100000 tracks with formatted and with bound statements, committing per album of 10
+ * tracks, and with bound statements committed per 1000 tracks, so that the gain of the binding
+ * and of the larger transactions are reported separately.
+ */
+TEST_F(TestSqliteDataset, DISABLED_ImportBenchmark)
+{
+  const int tracks = 100000;
+
+  auto import = [this, tracks](bool bound, int tracksPerTransaction) {
+    m_ds->exec("DELETE FROM song");
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < tracks; i++)
+    {
+      if (i % tracksPerTransaction == 0)
+        m_db.start_transaction();
+      if (bound)
+        m_ds->exec(TRACK_INSERT, CreateTrack(i));
+      else
+        m_ds->exec(m_db.bind(TRACK_INSERT, CreateTrack(i)));
+      if (i % tracksPerTransaction == tracksPerTransaction - 1)
+        m_db.commit_transaction();
+    }
+    const auto time = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(tracks, CountTracks());
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(time).count());
+  };
+
+  RecordProperty("FormattedMs", import(false, 10));
+  RecordProperty("BoundMs", import(true, 10));
+  RecordProperty("BoundBatchedMs", import(true, 1000));
+}
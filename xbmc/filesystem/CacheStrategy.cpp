@@ -46,6 +46,15 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+int CCacheStrategy::PeekFromCache(const char** pData, size_t iMaxSize)
+{
+  return CACHE_RC_ERROR;
+}
+
+void CCacheStrategy::ConsumeFromCache(size_t iSize)
+{
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -312,6 +321,16 @@ int64_t CDoubleCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
   return m_pCache->WaitForData(iMinAvail, iMillis);
 }
 
+int CDoubleCache::PeekFromCache(const char** pData, size_t iMaxSize)
+{
+  return m_pCache->PeekFromCache(pData, iMaxSize);
+}
+
+void CDoubleCache::ConsumeFromCache(size_t iSize)
+{
+  m_pCache->ConsumeFromCache(iSize);
+}
+
 int64_t CDoubleCache::Seek(int64_t iFilePosition)
 {
   /* Check whether position is NOT in our current cache but IS in our old cache.
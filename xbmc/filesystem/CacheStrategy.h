@@ -34,6 +34,23 @@ public:
   virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
   virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
+  /*!
+   \brief Get direct access to the cached data at the current read position without copying it
+   \param pData [out] set to the first readable byte on success
+   \param iMaxSize maximum number of bytes the caller is interested in
+   \return Number of contiguous bytes available at pData, 0 on end of input, or a CACHE_RC_* error.
+   CACHE_RC_ERROR is returned by strategies that don't support zero-copy access.
+   \sa ConsumeFromCache
+   */
+  virtual int PeekFromCache(const char** pData, size_t iMaxSize);
+
+  /*!
+   \brief Advance the read position past data previously returned by PeekFromCache
+   \param iSize number of bytes to consume, must not exceed what PeekFromCache returned
+   \sa PeekFromCache
+   */
+  virtual void ConsumeFromCache(size_t iSize);
+
   virtual int64_t Seek(int64_t iFilePosition) = 0;
 
   /*!
@@ -109,6 +126,8 @@ public:
   int WriteToCache(const char *pBuffer, size_t iSize) override;
   int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
   int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+  int PeekFromCache(const char** pData, size_t iMaxSize) override;
+  void ConsumeFromCache(size_t iSize) override;
 
   int64_t Seek(int64_t iFilePosition) override;
   bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
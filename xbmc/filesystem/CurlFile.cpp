@@ -8,6 +8,7 @@
 
 #include "CurlFile.h"
 
+#include "CurlRangeReader.h"
 #include "File.h"
 #include "ServiceBroker.h"
 #include "URL.h"
@@ -441,6 +442,8 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  // the range reader's handles reference the header lists of m_state
+  m_rangeReader.reset();
   m_state->Disconnect();
   delete m_oldState;
   m_oldState = NULL;
@@ -1388,6 +1391,13 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_rangeReader)
+  {
+    m_rangeReader->Seek(nextPos);
+    m_state->m_filePos = nextPos;
+    return nextPos;
+  }
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1603,6 +1613,50 @@ int CCurlFile::Stat(const CURL& url, struct __stat64* buffer)
   return 0;
 }
 
+ssize_t CCurlFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  if (!m_rangeReader)
+    return m_state->Read(lpBuf, uiBufSize);
+
+  const ssize_t read = m_rangeReader->Read(lpBuf, uiBufSize);
+  m_state->m_filePos = m_rangeReader->GetPosition();
+  return read;
+}
+
+void CCurlFile::EnableRangeReadAhead()
+{
+  const std::shared_ptr<CAdvancedSettings> advancedSettings =
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const int connections = advancedSettings->m_curlParallelConnections;
+  const int chunkSize = advancedSettings->m_curlParallelChunkSize;
+
+  // only worth it for seekable http(s) files spanning several chunks, on servers
+  // that announce range support
+  if (m_rangeReader || connections <= 1 || !m_opened || m_forWrite || !m_seekable ||
+      !m_multisession || m_state->m_fileSize <= chunkSize || !m_state->m_easyHandle ||
+      !StringUtils::EqualsNoCase(m_state->m_httpheader.GetValue("Accept-Ranges"), "bytes"))
+    return;
+
+  auto reader = std::make_unique<CCurlRangeReader>(m_state->m_easyHandle, m_state->m_fileSize,
+                                                   connections, chunkSize,
+                                                   advancedSettings->m_curlretries);
+  if (!reader->Init())
+  {
+    CLog::Log(LOGWARNING, "CCurlFile::{} - failed to set up parallel read-ahead", __FUNCTION__);
+    return;
+  }
+
+  // stop the single connection transfer, its options and header lists stay with m_state
+  g_curlInterface.multi_remove_handle(m_state->m_multiHandle, m_state->m_easyHandle);
+  m_state->m_buffer.Clear();
+
+  reader->Seek(m_state->m_filePos);
+  m_rangeReader = std::move(reader);
+
+  CLog::Log(LOGDEBUG, "CCurlFile::{} - reading with {} connections in chunks of {} bytes",
+            __FUNCTION__, connections, chunkSize);
+}
+
 ssize_t CCurlFile::CReadState::Read(void* lpBuf, size_t uiBufSize)
 {
   /* only request 1 byte, for truncated reads (only if not eof) */
@@ -2040,6 +2094,13 @@ int CCurlFile::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  // CFileCache reads sequentially in big chunks, fetch ahead in parallel if configured
+  if (request == IOCTRL_SET_CACHE)
+  {
+    EnableRangeReadAhead();
+    return 0;
+  }
+
   return -1;
 }
 
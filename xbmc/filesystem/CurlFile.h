@@ -13,6 +13,7 @@
 #include "utils/RingBuffer.h"
 
 #include <map>
+#include <memory>
 #include <string>
 
 typedef void CURL_HANDLE;
@@ -21,6 +22,8 @@ struct curl_slist;
 
 namespace XFILE
 {
+  class CCurlRangeReader;
+
   class CCurlFile : public IFile
   {
     private:
@@ -46,7 +49,7 @@ namespace XFILE
       int Stat(const CURL& url, struct __stat64* buffer) override;
       void Close() override;
       bool ReadString(char *szLine, int iLineLength) override { return m_state->ReadString(szLine, iLineLength); }
-      ssize_t Read(void* lpBuf, size_t uiBufSize) override { return m_state->Read(lpBuf, uiBufSize); }
+      ssize_t Read(void* lpBuf, size_t uiBufSize) override;
       ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
       const std::string GetProperty(XFILE::FileProperty type, const std::string &name = "") const override;
       const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string &name = "") const override;
@@ -144,10 +147,12 @@ namespace XFILE
       void SetCorrectHeaders(CReadState* state);
       bool Service(const std::string& strURL, std::string& strHTML);
       std::string GetInfoString(int infoType);
+      void EnableRangeReadAhead();
 
     protected:
       CReadState* m_state;
       CReadState* m_oldState;
+      std::unique_ptr<CCurlRangeReader> m_rangeReader; // parallel read-ahead, replaces m_state for reading
       unsigned int m_bufferSize;
       int64_t m_writeOffset = 0;
 
@@ -0,0 +1,271 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CurlRangeReader.h"
+
+#include "DllLibCurl.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+using namespace XCURL;
+
+CCurlRangeReader::CCurlRangeReader(CURL_HANDLE* easyTemplate,
+                                   int64_t fileSize,
+                                   unsigned int connections,
+                                   unsigned int chunkSize,
+                                   int maxRetries)
+  : m_easyTemplate(easyTemplate),
+    m_fileSize(fileSize),
+    m_connections(std::max(connections, 1u)),
+    m_chunkSize(chunkSize),
+    m_maxRetries(maxRetries)
+{
+}
+
+CCurlRangeReader::~CCurlRangeReader()
+{
+  for (auto& chunk : m_chunks)
+    StopTransfer(*chunk);
+
+  // the handles are private copies, not part of the session pool
+  for (CURL_HANDLE* easy : m_easyHandles)
+    g_curlInterface.easy_cleanup(easy);
+
+  if (m_multiHandle)
+    g_curlInterface.multi_cleanup(m_multiHandle);
+}
+
+bool CCurlRangeReader::Init()
+{
+  m_multiHandle = g_curlInterface.multi_init();
+  if (!m_multiHandle)
+    return false;
+
+  for (unsigned int i = 0; i < m_connections; i++)
+  {
+    CURL_HANDLE* easy = g_curlInterface.DllLibCurl::easy_duphandle(m_easyTemplate);
+    if (!easy)
+      return false;
+
+    // the template is set up for a single open ended transfer into its read state
+    g_curlInterface.easy_setopt(easy, CURLOPT_WRITEFUNCTION, WriteCallback);
+    g_curlInterface.easy_setopt(easy, CURLOPT_HEADERFUNCTION, nullptr);
+    g_curlInterface.easy_setopt(easy, CURLOPT_HEADERDATA, nullptr);
+    g_curlInterface.easy_setopt(easy, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(0));
+
+    m_easyHandles.push_back(easy);
+    m_freeHandles.push_back(easy);
+  }
+
+  return true;
+}
+
+size_t CCurlRangeReader::WriteCallback(char* buffer, size_t size, size_t nitems, void* userp)
+{
+  Chunk* chunk = static_cast<Chunk*>(userp);
+  const size_t amount = size * nitems;
+
+  // anything but partial content, like the whole file from a server that ignores the
+  // range, would be served from the wrong offset
+  if (!chunk->validated)
+  {
+    long httpCode = 0;
+    g_curlInterface.easy_getinfo(chunk->easyHandle, CURLINFO_RESPONSE_CODE, &httpCode);
+    if (httpCode != 206)
+      return 0;
+    chunk->validated = true;
+  }
+
+  if (chunk->data.size() + amount > static_cast<size_t>(chunk->end - chunk->start))
+    return 0;
+
+  chunk->data.insert(chunk->data.end(), buffer, buffer + amount);
+  return amount;
+}
+
+bool CCurlRangeReader::StartTransfer(Chunk& chunk)
+{
+  if (!chunk.easyHandle)
+  {
+    if (m_freeHandles.empty())
+      return false;
+    chunk.easyHandle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  }
+
+  // resume after what a failed attempt already delivered
+  const std::string range = StringUtils::Format("{}-{}",
+                                                chunk.start + static_cast<int64_t>(chunk.data.size()),
+                                                chunk.end - 1);
+  g_curlInterface.easy_setopt(chunk.easyHandle, CURLOPT_RANGE, range.c_str());
+  g_curlInterface.easy_setopt(chunk.easyHandle, CURLOPT_WRITEDATA, &chunk);
+  chunk.validated = false;
+
+  if (g_curlInterface.multi_add_handle(m_multiHandle, chunk.easyHandle) != CURLM_OK)
+  {
+    chunk.failed = true;
+    return false;
+  }
+
+  chunk.running = true;
+  return true;
+}
+
+void CCurlRangeReader::StopTransfer(Chunk& chunk)
+{
+  if (chunk.running)
+    g_curlInterface.multi_remove_handle(m_multiHandle, chunk.easyHandle);
+  chunk.running = false;
+
+  if (chunk.easyHandle)
+    m_freeHandles.push_back(chunk.easyHandle);
+  chunk.easyHandle = nullptr;
+}
+
+void CCurlRangeReader::OnTransferDone(Chunk& chunk, int result)
+{
+  g_curlInterface.multi_remove_handle(m_multiHandle, chunk.easyHandle);
+  chunk.running = false;
+
+  long httpCode = 0;
+  g_curlInterface.easy_getinfo(chunk.easyHandle, CURLINFO_RESPONSE_CODE, &httpCode);
+
+  if (result == CURLE_OK && chunk.IsComplete())
+  {
+    // keep the connection for the next chunk
+    StopTransfer(chunk);
+    return;
+  }
+
+  // any response but partial content means the range isn't supported, retrying won't help
+  if ((httpCode != 0 && httpCode != 206) || chunk.retries >= m_maxRetries)
+  {
+    CLog::Log(LOGERROR, "CCurlRangeReader::{} - range {}-{} failed: {}({}), HTTP {}",
+              __FUNCTION__, chunk.start, chunk.end - 1,
+              g_curlInterface.easy_strerror(static_cast<CURLcode>(result)), result, httpCode);
+    chunk.failed = true;
+    StopTransfer(chunk);
+    return;
+  }
+
+  chunk.retries++;
+  CLog::Log(LOGWARNING, "CCurlRangeReader::{} - range {}-{} incomplete, (re)try {}", __FUNCTION__,
+            chunk.start, chunk.end - 1, chunk.retries);
+  StartTransfer(chunk);
+}
+
+void CCurlRangeReader::Schedule()
+{
+  while (m_chunks.size() < m_connections && m_nextChunk < m_fileSize)
+  {
+    auto chunk = std::make_unique<Chunk>();
+    chunk->start = m_nextChunk;
+    chunk->end = std::min(m_nextChunk + m_chunkSize, m_fileSize);
+    chunk->data.reserve(chunk->end - chunk->start);
+
+    if (!StartTransfer(*chunk))
+      break;
+
+    m_nextChunk = chunk->end;
+    m_chunks.push_back(std::move(chunk));
+  }
+}
+
+bool CCurlRangeReader::Perform()
+{
+  int running = 0;
+  CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &running);
+  if (result != CURLM_OK && result != CURLM_CALL_MULTI_PERFORM)
+  {
+    CLog::Log(LOGERROR, "CCurlRangeReader::{} - multi perform failed with code {}", __FUNCTION__,
+              result);
+    return false;
+  }
+
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    auto it = std::find_if(m_chunks.begin(), m_chunks.end(), [msg](const auto& chunk) {
+      return chunk->running && chunk->easyHandle == msg->easy_handle;
+    });
+    if (it != m_chunks.end())
+      OnTransferDone(**it, msg->data.result);
+  }
+
+  if (running > 0 && result == CURLM_OK)
+    g_curlInterface.multi_wait(m_multiHandle, nullptr, 0, 200, nullptr);
+
+  return true;
+}
+
+void CCurlRangeReader::Seek(int64_t position)
+{
+  // still inside what the current chunk has delivered, no need to restart anything
+  if (!m_chunks.empty())
+  {
+    Chunk& chunk = *m_chunks.front();
+    if (position >= chunk.start &&
+        position <= chunk.start + static_cast<int64_t>(chunk.data.size()))
+    {
+      chunk.readPos = position - chunk.start;
+      m_position = position;
+      return;
+    }
+  }
+
+  for (auto& chunk : m_chunks)
+    StopTransfer(*chunk);
+  m_chunks.clear();
+
+  m_position = position;
+  m_nextChunk = position;
+}
+
+ssize_t CCurlRangeReader::Read(void* buffer, size_t size)
+{
+  while (m_position < m_fileSize)
+  {
+    Schedule();
+    if (m_chunks.empty())
+      return -1;
+
+    Chunk& chunk = *m_chunks.front();
+    if (chunk.failed)
+      return -1;
+
+    if (chunk.readPos < chunk.data.size())
+    {
+      const size_t amount = std::min(size, chunk.data.size() - chunk.readPos);
+      memcpy(buffer, chunk.data.data() + chunk.readPos, amount);
+      chunk.readPos += amount;
+      m_position += amount;
+      return amount;
+    }
+
+    if (!chunk.running && chunk.IsComplete())
+    {
+      // fully consumed, frees a slot for the next chunk
+      StopTransfer(chunk);
+      m_chunks.pop_front();
+      continue;
+    }
+
+    if (!Perform())
+      return -1;
+  }
+
+  return 0;
+}
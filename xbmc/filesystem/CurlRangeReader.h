@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+typedef void CURL_HANDLE;
+typedef void CURLM;
+
+namespace XFILE
+{
+
+/*!
+ \brief Sequential reader that fetches a file over several concurrent HTTP range requests
+
+ The file is split in chunks of fixed size which are requested on up to the configured
+ number of connections in parallel, and handed out in file order. This gets around the
+ throughput limit of a single TCP connection on high latency links. At most as many
+ chunks as there are connections are buffered at any time.
+
+ All requests are set up as copies of an already configured easy handle, so they share
+ its headers, credentials and proxy settings. The header lists referenced by that handle
+ must outlive the reader.
+ */
+class CCurlRangeReader
+{
+public:
+  CCurlRangeReader(CURL_HANDLE* easyTemplate,
+                   int64_t fileSize,
+                   unsigned int connections,
+                   unsigned int chunkSize,
+                   int maxRetries);
+  ~CCurlRangeReader();
+
+  bool Init();
+  void Seek(int64_t position);
+  ssize_t Read(void* buffer, size_t size);
+  int64_t GetPosition() const { return m_position; }
+
+private:
+  CCurlRangeReader(const CCurlRangeReader&) = delete;
+  CCurlRangeReader& operator=(const CCurlRangeReader&) = delete;
+
+  struct Chunk
+  {
+    CURL_HANDLE* easyHandle = nullptr;
+    int64_t start = 0;
+    int64_t end = 0; ///< exclusive
+    std::vector<char> data;
+    size_t readPos = 0;
+    int retries = 0;
+    bool running = false;
+    bool validated = false; ///< the current response is the requested partial content
+    bool failed = false;
+
+    bool IsComplete() const { return static_cast<int64_t>(data.size()) == end - start; }
+  };
+
+  static size_t WriteCallback(char* buffer, size_t size, size_t nitems, void* userp);
+
+  bool StartTransfer(Chunk& chunk);
+  void StopTransfer(Chunk& chunk);
+  void OnTransferDone(Chunk& chunk, int result);
+  void Schedule();
+  bool Perform();
+
+  CURL_HANDLE* m_easyTemplate;
+  CURLM* m_multiHandle = nullptr;
+  std::vector<CURL_HANDLE*> m_easyHandles;
+  std::vector<CURL_HANDLE*> m_freeHandles;
+  std::deque<std::unique_ptr<Chunk>> m_chunks;
+  int64_t m_fileSize;
+  int64_t m_position = 0;
+  int64_t m_nextChunk = 0;
+  unsigned int m_connections;
+  unsigned int m_chunkSize;
+  int m_maxRetries;
+};
+
+} // namespace XFILE
@@ -10,24 +10,43 @@
 
 #include "Directory.h"
 #include "FileItem.h"
+#include "ServiceBroker.h"
 #include "URL.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
-#include <algorithm>
-#include <climits>
+#include <functional>
+#include <limits>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
+// Maximum (estimated) memory used by the listings in our cache
+#define MAX_CACHED_BYTES (64 * 1024 * 1024)
 
 using namespace XFILE;
 
+namespace
+{
+size_t EstimateSize(const CFileItem& item)
+{
+  return sizeof(CFileItem) + item.GetPath().capacity() + item.GetDynPath().capacity() +
+         item.GetLabel().capacity() + item.GetLabel2().capacity();
+}
+
+size_t EstimateSize(const CFileItemList& items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); ++i)
+    size += EstimateSize(*items[i]);
+  return size;
+}
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
@@ -38,45 +57,48 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
-{
-  m_lastAccess = accessCounter++;
-}
-
 CDirectoryCache::CDirectoryCache(void)
 {
   m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
+  m_dirs = 0;
+  m_bytes = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+std::string CDirectoryCache::NormalizePath(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
+}
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const std::string& storedPath)
+{
+  return m_shards[std::hash<std::string>()(storedPath) % SHARDS];
+}
+
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
+  const std::string storedPath = NormalizePath(strPath);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
-    CDir* dir = i->second;
+    CDir* dir = i->second.get();
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      Touch(shard, *dir);
+      shard.m_cacheHits++;
       return true;
     }
   }
+  shard.m_cacheMisses++;
   return false;
 }
 
@@ -96,20 +118,34 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
+  const std::string storedPath = NormalizePath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  // copy outside of the lock, listings can be large
+  std::unique_ptr<CDir> dir(new CDir(cacheType));
+  dir->m_Items->Copy(items);
+  dir->m_size = EstimateSize(*dir->m_Items);
 
-  ClearDirectory(storedPath);
+  {
+    CShard& shard = GetShard(storedPath);
+    CSingleLock lock (shard.m_cs);
 
-  CheckIfFull();
+    iCache i = shard.m_cache.find(storedPath);
+    if (i != shard.m_cache.end())
+      Delete(shard, i);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    if (cacheType != DIR_CACHE_ALWAYS)
+    {
+      shard.m_lru.push_front(storedPath);
+      dir->m_lruPosition = shard.m_lru.begin();
+      dir->m_lastAccess = ++m_accessCounter;
+      m_dirs++;
+      m_bytes += dir->m_size;
+    }
+    shard.m_cache.emplace(storedPath, std::move(dir));
+  }
+
+  // evicting may lock the other shards, so do it without holding this one
+  CheckIfFull(storedPath);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -123,55 +159,65 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
+  const std::string storedPath = NormalizePath(strPath);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
-
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (CShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
   {
-    CDir *dir = i->second;
+    CShard& shard = GetShard(strPath);
+    CSingleLock lock (shard.m_cs);
+
+    ciCache i = shard.m_cache.find(strPath);
+    if (i == shard.m_cache.end())
+      return;
+
+    CDir *dir = i->second.get();
     CFileItemPtr item(new CFileItem(strFile, false));
+    const size_t size = EstimateSize(*item);
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    dir->m_size += size;
+    if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+      m_bytes += size;
+    Touch(shard, *dir);
   }
+
+  // the listing grew, which may take the cache over its byte limit
+  CheckIfFull(strPath);
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -180,31 +226,33 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     bInCache = true;
-    CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
+    CDir *dir = i->second.get();
+    Touch(shard, *dir);
+    shard.m_cacheHits++;
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
+  shard.m_cacheMisses++;
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (CShard& shard : m_shards)
+  {
+    CSingleLock lock (shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end() )
+      Delete(shard, i++);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -219,60 +267,104 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (const std::string& dir : dirs)
+    ClearDirectory(dir);
+}
+
+void CDirectoryCache::Touch(CShard& shard, CDir& dir)
+{
+  // move to the front of the LRU list, dirs that are always cached aren't in it
+  if (dir.m_cacheType != DIR_CACHE_ALWAYS)
   {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, dir.m_lruPosition);
+    dir.m_lastAccess = ++m_accessCounter;
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(const std::string& addedPath)
 {
-  CSingleLock lock (m_cs);
+  bool evicted = false;
+  while (m_dirs > MAX_CACHED_DIRS || m_bytes > MAX_CACHED_BYTES)
+  {
+    if (!EvictOldest(addedPath))
+      break;
+    evicted = true;
+  }
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  if (evicted && CServiceBroker::GetLogging().IsLogLevelLogged(LOGDEBUG))
+    PrintStats();
+}
+
+bool CDirectoryCache::EvictOldest(const std::string& addedPath)
+{
+  // the least recently used folder of all shards is at the back of one of their LRU lists.
+  // Shards are locked one at a time, so another thread may have used it in between; that
+  // only makes the eviction less exact.
+  CShard* oldest = nullptr;
+  uint64_t oldestAccess = std::numeric_limits<uint64_t>::max();
+  for (CShard& shard : m_shards)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    CSingleLock lock (shard.m_cs);
+    if (shard.m_lru.empty() || shard.m_lru.back() == addedPath)
+      continue;
+    ciCache i = shard.m_cache.find(shard.m_lru.back());
+    if (i != shard.m_cache.end() && i->second->m_lastAccess < oldestAccess)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      oldest = &shard;
+      oldestAccess = i->second->m_lastAccess;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
+  if (!oldest)
+    return false;
+
+  // never remove the one just added
+  CSingleLock lock (oldest->m_cs);
+  if (oldest->m_lru.empty() || oldest->m_lru.back() == addedPath)
+    return false;
+  iCache lastAccessed = oldest->m_cache.find(oldest->m_lru.back());
+  if (lastAccessed == oldest->m_cache.end())
+    return false; // can't happen
+  Delete(*oldest, lastAccessed);
+  oldest->m_cacheEvictions++;
+  return true;
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Delete(CShard& shard, iCache it)
 {
-  CDir* dir = it->second;
-  delete dir;
-  m_cache.erase(it);
+  CDir* dir = it->second.get();
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+  {
+    shard.m_lru.erase(dir->m_lruPosition);
+    m_dirs--;
+    m_bytes -= dir->m_size;
+  }
+  shard.m_cache.erase(it);
 }
 
-#ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  // run through and find the number of items cached
+  unsigned int cacheHits = 0;
+  unsigned int cacheMisses = 0;
+  unsigned int cacheEvictions = 0;
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  size_t numBytes = 0;
+  for (const CShard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock (shard.m_cs);
+    cacheHits += shard.m_cacheHits;
+    cacheMisses += shard.m_cacheMisses;
+    cacheEvictions += shard.m_cacheEvictions;
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+    {
+      numItems += i->second->m_Items->Size();
+      numBytes += i->second->m_size;
+    }
+    numDirs += shard.m_cache.size();
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "{} - total of {} cache hits, {} cache misses and {} evictions", __FUNCTION__,
+            cacheHits, cacheMisses, cacheEvictions);
+  CLog::Log(LOGDEBUG, "{} - {} folders cached, with {} items total using about {} KiB", __FUNCTION__,
+            numDirs, numItems, numBytes / 1024);
 }
-#endif
@@ -11,13 +11,27 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings, keyed on the path without URL options
+
+   The cache is split in shards by path hash, each with its own lock and least recently
+   used list, so lookups of different directories don't contend. The limits on the number
+   of listings and their bytes apply to the whole cache: once they are exceeded the least
+   recently used listing of all shards is evicted. DIR_CACHE_ALWAYS listings are never
+   evicted and don't count towards the limits.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -26,16 +40,32 @@ namespace XFILE
       explicit CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
-
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_size = 0; ///< estimated memory used by m_Items
+      uint64_t m_lastAccess = 0; ///< value of m_accessCounter when last used
+      std::list<std::string>::iterator m_lruPosition; ///< only valid if not DIR_CACHE_ALWAYS
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
     };
+
+    typedef std::unordered_map<std::string, std::unique_ptr<CDir>> Cache;
+    typedef Cache::iterator iCache;
+    typedef Cache::const_iterator ciCache;
+
+    struct CShard
+    {
+      Cache m_cache;
+      std::list<std::string> m_lru; ///< most recently used first
+      mutable CCriticalSection m_cs;
+
+      // statistics, counted per shard under m_cs so that lookups don't share a cache line
+      unsigned int m_cacheHits = 0;
+      unsigned int m_cacheMisses = 0;
+      unsigned int m_cacheEvictions = 0;
+    };
+
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
@@ -47,27 +77,24 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
-#ifdef _DEBUG
     void PrintStats() const;
-#endif
   protected:
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
-
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
 
-    mutable CCriticalSection m_cs;
+    static std::string NormalizePath(const std::string& strPath);
+    CShard& GetShard(const std::string& storedPath);
+    void CheckIfFull(const std::string& addedPath);
+    bool EvictOldest(const std::string& addedPath);
+    void Touch(CShard& shard, CDir& dir);
+    void Delete(CShard& shard, iCache i);
 
-    unsigned int m_accessCounter;
+    static constexpr size_t SHARDS = 8;
+    CShard m_shards[SHARDS];
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<uint64_t> m_accessCounter;
+    std::atomic<size_t> m_dirs; ///< number of listings in the LRU lists of all shards
+    std::atomic<size_t> m_bytes; ///< estimated memory used by the listings in the LRU lists
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
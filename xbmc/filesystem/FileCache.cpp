@@ -14,6 +14,8 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "LockFreeCircularCache.h"
+#include "PersistentFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -145,7 +147,24 @@ bool CFileCache::Open(const CURL& url)
 
   if (!m_pCache)
   {
-    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
+    const uint64_t persistentSize =
+        static_cast<uint64_t>(
+            CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePersistentSize) *
+        1024 * 1024;
+    if (persistentSize > 0 && m_seekPossible > 0 && m_fileSize > 0 &&
+        static_cast<uint64_t>(m_fileSize) <= persistentSize)
+    {
+      // Use persistent cache on disk, keyed by modification time too so changed files aren't served stale
+      struct __stat64 st = {};
+      const int64_t modificationTime = m_source.Stat(&st) == 0 ? st.st_mtime : 0;
+
+      CPersistentFileCache::Prune(persistentSize - m_fileSize);
+      m_pCache = std::unique_ptr<CPersistentFileCache>(new CPersistentFileCache(url.Get(), m_fileSize, modificationTime)); // C++14 - Replace with std::make_unique
+      m_forwardCacheSize = 0;
+
+      CLog::Log(LOGDEBUG, "{} - <{}> using persistent disk cache", __FUNCTION__, m_sourcePath);
+    }
+    else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
     {
       // Use cache on disk
       m_pCache = std::unique_ptr<CSimpleFileCache>(new CSimpleFileCache()); // C++14 - Replace with std::make_unique
@@ -190,11 +209,15 @@ bool CFileCache::Open(const CURL& url)
       const size_t back = cacheSize / 4;
       const size_t front = cacheSize - back;
 
-      m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
+      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLockFree)
+        m_pCache = std::unique_ptr<CLockFreeCircularCache>(new CLockFreeCircularCache(front, back)); // C++14 - Replace with std::make_unique
+      else
+        m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    // The persistent cache keeps every fetched range already, no need for double buffering
+    if ((m_flags & READ_MULTI_STREAM) && !dynamic_cast<CPersistentFileCache*>(m_pCache.get()))
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = std::unique_ptr<CDoubleCache>(new CDoubleCache(m_pCache.release())); // C++14 - Replace with std::make_unique
@@ -211,6 +234,24 @@ bool CFileCache::Open(const CURL& url)
 
   m_readPos = 0;
   m_writePos = 0;
+
+  // A persistent cache may already hold the beginning of the file, continue fetching after it
+  const int64_t cachedEnd = m_pCache->CachedDataEndPos();
+  if (cachedEnd > 0 && cachedEnd < m_fileSize)
+  {
+    if (m_source.Seek(cachedEnd, SEEK_SET) == cachedEnd)
+      m_writePos = cachedEnd;
+    else
+    {
+      CLog::Log(LOGWARNING, "{} - <{}> failed to seek source past cached data", __FUNCTION__,
+                m_sourcePath);
+      m_pCache->Reset(0);
+      m_source.Seek(0, SEEK_SET);
+    }
+  }
+  else
+    m_writePos = cachedEnd;
+
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
   m_bFilling = true;
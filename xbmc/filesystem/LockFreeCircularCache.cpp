@@ -0,0 +1,328 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LockFreeCircularCache.h"
+
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#if defined(TARGET_POSIX)
+#include "platform/posix/utils/SharedMemory.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <string.h>
+
+using namespace XFILE;
+
+CLockFreeCircularCache::CLockFreeCircularCache(size_t front, size_t back)
+  : CCacheStrategy(),
+    m_beg(0),
+    m_end(0),
+    m_cur(0),
+    m_size(front + back),
+    m_size_front(front),
+    m_size_back(back)
+{
+}
+
+CLockFreeCircularCache::~CLockFreeCircularCache()
+{
+  Close();
+}
+
+bool CLockFreeCircularCache::MapMirrored()
+{
+#if defined(TARGET_POSIX)
+  const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  const size_t size = (m_size_front + m_size_back + pageSize - 1) / pageSize * pageSize;
+
+  try
+  {
+    // the shared memory object only needs to live until both views are mapped
+    KODI::UTILS::POSIX::CSharedMemory memory(size);
+
+    // reserve address space for both views first so nobody else can grab the second half
+    void* addr = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+      return false;
+
+    uint8_t* base = static_cast<uint8_t*>(addr);
+    if (mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memory.Fd(), 0) ==
+            MAP_FAILED ||
+        mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, memory.Fd(), 0) ==
+            MAP_FAILED)
+    {
+      munmap(base, 2 * size);
+      return false;
+    }
+
+    // rounding up to page size only adds to the front buffer
+    m_size = size;
+    m_buf = base;
+    return true;
+  }
+  catch (const std::exception& e)
+  {
+    CLog::Log(LOGDEBUG, "CLockFreeCircularCache::{} - unable to create mirrored buffer: {}",
+              __FUNCTION__, e.what());
+  }
+#endif
+  return false;
+}
+
+int CLockFreeCircularCache::Open()
+{
+  m_mirrored = MapMirrored();
+  if (!m_mirrored)
+  {
+    m_size = m_size_front + m_size_back;
+    m_buf = new (std::nothrow) uint8_t[m_size];
+  }
+  if (m_buf == nullptr)
+    return CACHE_RC_ERROR;
+
+  m_beg = 0;
+  m_end = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CLockFreeCircularCache::Close()
+{
+#if defined(TARGET_POSIX)
+  if (m_mirrored && m_buf != nullptr)
+    munmap(m_buf, 2 * m_size);
+  else
+#endif
+    delete[] m_buf;
+
+  m_buf = nullptr;
+  m_mirrored = false;
+}
+
+size_t CLockFreeCircularCache::GetWriteLimit(int64_t beg, int64_t end, int64_t cur) const
+{
+  size_t back = static_cast<size_t>(cur - beg); // Backbuffer size
+  size_t front = static_cast<size_t>(end - cur); // Frontbuffer size
+  return m_size - std::min(back, m_size_back) - front;
+}
+
+size_t CLockFreeCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  const int64_t beg = m_beg.load();
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+  const int64_t cur = m_cur.load();
+
+  // reader is in the middle of a failing seek, retry later
+  if (cur < beg)
+    return 0;
+
+  // Never return more than limit and size requested by caller
+  return std::min(iRequestSize, GetWriteLimit(beg, end, cur));
+}
+
+/**
+ * Same rules as CCircularCache::WriteToCache, except that with a mirrored
+ * buffer the write doesn't have to stop at the wrap point.
+ *
+ * Before overwriting back buffer data, the new start of valid data is
+ * published and the read position is checked again afterwards. Together with
+ * the reverse order in Seek() this guarantees that either the reader notices
+ * the data is gone or we notice the reader moved onto it and back off.
+ */
+int CLockFreeCircularCache::WriteToCache(const char* buf, size_t len)
+{
+  if (m_buf == nullptr)
+    return 0;
+
+  const int64_t beg = m_beg.load();
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+  const int64_t cur = m_cur.load();
+
+  if (cur < beg)
+    return 0;
+
+  const size_t pos = end % m_size;
+
+  // limit by max forward size
+  len = std::min(len, GetWriteLimit(beg, end, cur));
+
+  // limit to wrap point
+  if (!m_mirrored)
+    len = std::min(len, m_size - pos);
+
+  if (len == 0)
+    return 0;
+
+  // drop history that will be overwritten
+  const int64_t newBeg = std::max(beg, end + static_cast<int64_t>(len) - static_cast<int64_t>(m_size));
+  if (newBeg != beg)
+  {
+    m_beg.store(newBeg);
+    if (m_cur.load() < newBeg)
+    {
+      m_beg.store(beg);
+      return 0;
+    }
+  }
+
+  memcpy(m_buf + pos, buf, len);
+  m_end.store(end + len, std::memory_order_release);
+
+  m_written.Set();
+
+  return len;
+}
+
+int CLockFreeCircularCache::PeekFromCache(const char** data, size_t len)
+{
+  if (m_buf == nullptr)
+    return 0;
+
+  const int64_t cur = m_cur.load(std::memory_order_relaxed);
+  const size_t pos = cur % m_size;
+  size_t avail = static_cast<size_t>(m_end.load(std::memory_order_acquire) - cur);
+  if (!m_mirrored)
+    avail = std::min(m_size - pos, avail);
+
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  *data = reinterpret_cast<const char*>(m_buf + pos);
+  return static_cast<int>(std::min(len, avail));
+}
+
+void CLockFreeCircularCache::ConsumeFromCache(size_t len)
+{
+  m_cur.store(m_cur.load(std::memory_order_relaxed) + len);
+  m_space.Set();
+}
+
+int CLockFreeCircularCache::ReadFromCache(char* buf, size_t len)
+{
+  const char* data;
+  int ret = PeekFromCache(&data, len);
+  if (ret <= 0)
+    return ret;
+
+  memcpy(buf, data, ret);
+  ConsumeFromCache(ret);
+
+  return ret;
+}
+
+/* Wait "millis" milliseconds for "minimum" amount of data to come in.
+ * Note that caller needs to make sure there's sufficient space in the forward
+ * buffer for "minimum" bytes else we may block the full timeout time
+ */
+int64_t CLockFreeCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  int64_t avail = m_end.load(std::memory_order_acquire) - m_cur.load();
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    avail = m_end.load(std::memory_order_acquire) - m_cur.load();
+  }
+
+  return avail;
+}
+
+int64_t CLockFreeCircularCache::Seek(int64_t pos)
+{
+  int64_t end = m_end.load(std::memory_order_acquire);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos >= end && pos < end + 100000)
+  {
+    /* Make everything in the cache (back & forward) back-cache, to make sure
+     * there's sufficient forward space.
+     */
+    m_cur.store(end);
+    m_space.Set();
+    WaitForData(static_cast<unsigned int>(pos - end), 5000);
+    end = m_end.load(std::memory_order_acquire);
+  }
+
+  if (pos > end)
+    return CACHE_RC_ERROR;
+
+  const int64_t cur = m_cur.load(std::memory_order_relaxed);
+  if (pos >= cur)
+  {
+    // forward seeks stay clear of anything the writer may overwrite
+    m_cur.store(pos);
+    m_space.Set();
+    return pos;
+  }
+
+  // backward seek, see WriteToCache for the counterpart
+  m_cur.store(pos);
+  if (pos < m_beg.load())
+  {
+    m_cur.store(cur);
+    return CACHE_RC_ERROR;
+  }
+
+  return pos;
+}
+
+bool CLockFreeCircularCache::Reset(int64_t pos, bool clearAnyway)
+{
+  if (!clearAnyway && IsCachedPosition(pos))
+  {
+    m_cur = pos;
+    return false;
+  }
+  m_end = pos;
+  m_beg = pos;
+  m_cur = pos;
+
+  return true;
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  if (IsCachedPosition(iFilePosition))
+    return m_end;
+  return iFilePosition;
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPos()
+{
+  return m_end;
+}
+
+bool CLockFreeCircularCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return iFilePosition >= m_beg && iFilePosition <= m_end;
+}
+
+CCacheStrategy* CLockFreeCircularCache::CreateNew()
+{
+  return new CLockFreeCircularCache(m_size_front, m_size_back);
+}
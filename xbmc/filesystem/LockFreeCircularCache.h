@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <stdint.h>
+
+namespace XFILE
+{
+
+/*!
+ \brief Single producer / single consumer variant of CCircularCache
+
+ Same front/back buffer semantics as CCircularCache, but the write path (CFileCache fill
+ thread) and the read path (demuxer) synchronize through atomics only. Where the platform
+ allows it the buffer is mapped twice back to back in virtual memory, so reads and writes
+ crossing the end of the buffer are still contiguous and PeekFromCache can hand out any
+ amount of buffered data without copying.
+
+ Reset() must only be called while the reading side is idle, which CFileCache guarantees
+ by holding its lock while waiting for a seek to finish.
+ */
+class CLockFreeCircularCache : public CCacheStrategy
+{
+public:
+  CLockFreeCircularCache(size_t front, size_t back);
+  ~CLockFreeCircularCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char* buf, size_t len) override;
+  int ReadFromCache(char* buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+  int PeekFromCache(const char** data, size_t len) override;
+  void ConsumeFromCache(size_t len) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway = true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy* CreateNew() override;
+
+  /*!
+   \brief Whether the buffer is mirrored, i.e. accesses never have to stop at the wrap point
+   */
+  bool IsMirrored() const { return m_mirrored; }
+
+protected:
+  bool MapMirrored();
+  size_t GetWriteLimit(int64_t beg, int64_t end, int64_t cur) const;
+
+  std::atomic<int64_t> m_beg; /**< index in file of beginning of valid data, owned by writer */
+  std::atomic<int64_t> m_end; /**< index in file of end of valid data, owned by writer */
+  std::atomic<int64_t> m_cur; /**< current reading index in file, owned by reader */
+  uint8_t* m_buf = nullptr; /**< buffer holding data, mapped twice if m_mirrored is set */
+  size_t m_size; /**< size of data buffer (m_buf), page aligned if mirrored */
+  size_t m_size_front; /**< requested front buffer size */
+  size_t m_size_back; /**< guaranteed size of back buffer */
+  bool m_mirrored = false;
+  CEvent m_written;
+};
+
+} // namespace XFILE
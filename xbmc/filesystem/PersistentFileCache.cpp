@@ -0,0 +1,610 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentFileCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IFile.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Digest.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <map>
+#include <string.h>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+
+constexpr const char* CACHE_PATH = "special://temp/filecache/";
+constexpr const char* INDEX_EXTENSION = ".idx";
+constexpr const char* DATA_EXTENSION = ".dat";
+
+constexpr char INDEX_MAGIC[4] = {'K', 'P', 'F', 'C'};
+constexpr uint32_t INDEX_VERSION = 1;
+
+struct IndexHeader
+{
+  char magic[4];
+  uint32_t version;
+  int64_t fileSize;
+  uint32_t blockSize;
+  uint32_t reserved;
+  int64_t cachedBytes;
+};
+
+bool ReadIndexHeader(const std::string& path, IndexHeader& header)
+{
+  CFile file;
+  if (!file.Open(path))
+    return false;
+
+  return file.Read(&header, sizeof(header)) == sizeof(header) &&
+         memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+         header.version == INDEX_VERSION;
+}
+
+} // unnamed namespace
+
+namespace XFILE
+{
+
+/*!
+ \brief Block index of a cached file, shared by all strategies caching the same file
+
+ The sizes of all entries are tracked in memory once the cache directory was listed, so
+ opening a file doesn't need to look at every index on disk.
+ */
+class CPersistentCacheEntry
+{
+public:
+  CPersistentCacheEntry(const std::string& hash, int64_t fileSize)
+    : m_hash(hash),
+      m_fileSize(fileSize),
+      m_blocks((fileSize + CPersistentFileCache::BLOCK_SIZE - 1) / CPersistentFileCache::BLOCK_SIZE),
+      m_saveTimer(CPersistentFileCache::INDEX_SAVE_INTERVAL)
+  {
+  }
+
+  ~CPersistentCacheEntry() { Save(); }
+
+  static std::shared_ptr<CPersistentCacheEntry> Get(const std::string& hash, int64_t fileSize);
+  static void Release(std::shared_ptr<CPersistentCacheEntry>& entry);
+  static void Prune(uint64_t maxBytes);
+
+  std::string GetIndexPath() const { return CACHE_PATH + m_hash + INDEX_EXTENSION; }
+  std::string GetDataPath() const { return CACHE_PATH + m_hash + DATA_EXTENSION; }
+
+  void Load();
+  void Save();
+
+  void SetWritten(int64_t runStart, int64_t begin, int64_t end);
+  int64_t GetCompleteEnd(int64_t position) const;
+  int64_t GetFileSize() const { return m_fileSize; }
+
+private:
+  struct EntryInfo
+  {
+    std::weak_ptr<CPersistentCacheEntry> entry;
+    uint64_t cachedBytes = 0;
+    uint64_t lastUse = 0;
+  };
+
+  static void LoadEntries();
+  static void AddCachedBytes(const std::string& hash, int64_t bytes);
+
+  std::string m_hash;
+  int64_t m_fileSize;
+  mutable CCriticalSection m_sync;
+  std::vector<bool> m_blocks;
+  int64_t m_cachedBytes = 0;
+  int64_t m_unsavedBytes = 0;
+  XbmcThreads::EndTime m_saveTimer;
+
+  static CCriticalSection m_entriesSync;
+  static std::map<std::string, EntryInfo> m_entries;
+  static bool m_entriesLoaded;
+  static uint64_t m_totalBytes;
+  static uint64_t m_useCount;
+};
+
+CCriticalSection CPersistentCacheEntry::m_entriesSync;
+std::map<std::string, CPersistentCacheEntry::EntryInfo> CPersistentCacheEntry::m_entries;
+bool CPersistentCacheEntry::m_entriesLoaded = false;
+uint64_t CPersistentCacheEntry::m_totalBytes = 0;
+uint64_t CPersistentCacheEntry::m_useCount = 0;
+
+} // namespace XFILE
+
+std::shared_ptr<CPersistentCacheEntry> CPersistentCacheEntry::Get(const std::string& hash,
+                                                                  int64_t fileSize)
+{
+  CSingleLock lock(m_entriesSync);
+  LoadEntries();
+
+  EntryInfo& info = m_entries[hash];
+  std::shared_ptr<CPersistentCacheEntry> entry = info.entry.lock();
+  if (!entry)
+  {
+    entry = std::make_shared<CPersistentCacheEntry>(hash, fileSize);
+    entry->Load();
+    info.entry = entry;
+
+    // the index on disk is what counts, it may have been removed or replaced meanwhile
+    m_totalBytes = m_totalBytes - info.cachedBytes + entry->m_cachedBytes;
+    info.cachedBytes = entry->m_cachedBytes;
+  }
+  info.lastUse = ++m_useCount;
+  return entry;
+}
+
+void CPersistentCacheEntry::Release(std::shared_ptr<CPersistentCacheEntry>& entry)
+{
+  // the last user saves the index on destruction, which must be finished before
+  // the entry can be loaded again
+  CSingleLock lock(m_entriesSync);
+  entry.reset();
+}
+
+void CPersistentCacheEntry::LoadEntries()
+{
+  if (m_entriesLoaded)
+    return;
+  m_entriesLoaded = true;
+
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(CACHE_PATH, items, INDEX_EXTENSION,
+                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  // least recently used first, entries used from now on are more recent than all of them
+  items.Sort(SortByDate, SortOrderAscending);
+
+  for (const auto& item : items)
+  {
+    std::string hash = URIUtils::GetFileName(item->GetPath());
+    URIUtils::RemoveExtension(hash);
+
+    IndexHeader header;
+    EntryInfo& info = m_entries[hash];
+    info.cachedBytes = ReadIndexHeader(item->GetPath(), header) ? header.cachedBytes : 0;
+    info.lastUse = ++m_useCount;
+    m_totalBytes += info.cachedBytes;
+  }
+}
+
+void CPersistentCacheEntry::AddCachedBytes(const std::string& hash, int64_t bytes)
+{
+  CSingleLock lock(m_entriesSync);
+  m_entries[hash].cachedBytes += bytes;
+  m_totalBytes += bytes;
+}
+
+void CPersistentCacheEntry::Prune(uint64_t maxBytes)
+{
+  CSingleLock lock(m_entriesSync);
+  LoadEntries();
+
+  if (m_totalBytes <= maxBytes)
+    return;
+
+  // least recently used first
+  std::vector<std::pair<uint64_t, std::string>> candidates;
+  for (const auto& it : m_entries)
+  {
+    if (it.second.entry.expired())
+      candidates.emplace_back(it.second.lastUse, it.first);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  for (const auto& candidate : candidates)
+  {
+    if (m_totalBytes <= maxBytes)
+      break;
+
+    const std::string& hash = candidate.second;
+    const uint64_t size = m_entries[hash].cachedBytes;
+    CFile::Delete(CACHE_PATH + hash + DATA_EXTENSION);
+    CFile::Delete(CACHE_PATH + hash + INDEX_EXTENSION);
+    m_entries.erase(hash);
+    m_totalBytes -= size;
+
+    CLog::Log(LOGDEBUG, "CPersistentCacheEntry::{} - evicted {} ({} bytes)", __FUNCTION__, hash,
+              size);
+  }
+}
+
+void CPersistentCacheEntry::Load()
+{
+  CSingleLock lock(m_sync);
+
+  IndexHeader header;
+  if (!ReadIndexHeader(GetIndexPath(), header) || header.fileSize != m_fileSize ||
+      header.blockSize != CPersistentFileCache::BLOCK_SIZE)
+    return;
+
+  CFile file;
+  if (!file.Open(GetIndexPath()) || file.Seek(sizeof(header), SEEK_SET) != sizeof(header))
+    return;
+
+  std::vector<uint8_t> bitmap((m_blocks.size() + 7) / 8);
+  if (file.Read(bitmap.data(), bitmap.size()) != static_cast<ssize_t>(bitmap.size()))
+    return;
+
+  for (size_t block = 0; block < m_blocks.size(); block++)
+    m_blocks[block] = (bitmap[block / 8] & (1 << (block % 8))) != 0;
+  m_cachedBytes = header.cachedBytes;
+}
+
+void CPersistentCacheEntry::Save()
+{
+  CSingleLock lock(m_sync);
+
+  IndexHeader header = {};
+  memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.version = INDEX_VERSION;
+  header.fileSize = m_fileSize;
+  header.blockSize = CPersistentFileCache::BLOCK_SIZE;
+  header.cachedBytes = m_cachedBytes;
+
+  std::vector<uint8_t> bitmap((m_blocks.size() + 7) / 8);
+  for (size_t block = 0; block < m_blocks.size(); block++)
+  {
+    if (m_blocks[block])
+      bitmap[block / 8] |= 1 << (block % 8);
+  }
+
+  m_unsavedBytes = 0;
+  m_saveTimer.Set(CPersistentFileCache::INDEX_SAVE_INTERVAL);
+
+  // always rewritten, the modification time of the index is what eviction is based on
+  // in the next session
+  CFile file;
+  if (!file.OpenForWrite(GetIndexPath(), true) ||
+      file.Write(&header, sizeof(header)) != sizeof(header) ||
+      file.Write(bitmap.data(), bitmap.size()) != static_cast<ssize_t>(bitmap.size()))
+    CLog::Log(LOGWARNING, "CPersistentCacheEntry::{} - failed to write index {}", __FUNCTION__,
+              GetIndexPath());
+}
+
+void CPersistentCacheEntry::SetWritten(int64_t runStart, int64_t begin, int64_t end)
+{
+  int64_t completed = 0;
+  bool save;
+  {
+    CSingleLock lock(m_sync);
+
+    // a block is only complete if it was written in one go, the data of partially
+    // written blocks is left in the data file but never trusted
+    for (int64_t block = begin / CPersistentFileCache::BLOCK_SIZE;
+         block < static_cast<int64_t>(m_blocks.size()); block++)
+    {
+      const int64_t blockStart = block * CPersistentFileCache::BLOCK_SIZE;
+      const int64_t blockEnd = std::min(blockStart + CPersistentFileCache::BLOCK_SIZE, m_fileSize);
+      if (blockEnd > end)
+        break;
+      if (blockStart >= runStart && !m_blocks[block])
+      {
+        m_blocks[block] = true;
+        completed += blockEnd - blockStart;
+      }
+    }
+    m_cachedBytes += completed;
+    m_unsavedBytes += completed;
+
+    // don't lose more than that when Kodi doesn't get to close the file
+    save = m_unsavedBytes >= CPersistentFileCache::INDEX_SAVE_BYTES ||
+           (m_unsavedBytes > 0 && m_saveTimer.IsTimePast());
+  }
+
+  if (completed > 0)
+    AddCachedBytes(m_hash, completed);
+  if (save)
+    Save();
+}
+
+int64_t CPersistentCacheEntry::GetCompleteEnd(int64_t position) const
+{
+  CSingleLock lock(m_sync);
+
+  int64_t block = position / CPersistentFileCache::BLOCK_SIZE;
+  while (block < static_cast<int64_t>(m_blocks.size()) && m_blocks[block])
+    block++;
+
+  return std::max(position, std::min(block * CPersistentFileCache::BLOCK_SIZE, m_fileSize));
+}
+
+CPersistentFileCache::CPersistentFileCache(const std::string& url,
+                                           int64_t fileSize,
+                                           int64_t modificationTime)
+  : m_url(url),
+    m_fileSize(fileSize),
+    m_modificationTime(modificationTime),
+    m_cacheFileRead(new CacheLocalFile()),
+    m_cacheFileWrite(new CacheLocalFile())
+{
+}
+
+CPersistentFileCache::~CPersistentFileCache()
+{
+  Close();
+}
+
+int CPersistentFileCache::Open()
+{
+  Close();
+
+  if (!CDirectory::Exists(CACHE_PATH) && !CDirectory::Create(CACHE_PATH))
+  {
+    CLog::LogF(LOGERROR, "failed to create cache directory {}", CACHE_PATH);
+    return CACHE_RC_ERROR;
+  }
+
+  const std::string hash =
+      CDigest::Calculate(CDigest::Type::MD5, m_url + "|" + std::to_string(m_fileSize) + "|" +
+                                                 std::to_string(m_modificationTime));
+
+  m_entry = CPersistentCacheEntry::Get(hash, m_fileSize);
+
+  const CURL fileURL(CSpecialProtocol::TranslatePath(m_entry->GetDataPath()));
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, false))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"{}\" for writing", fileURL.Get());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"{}\" for reading", fileURL.Get());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+  m_readPosition = 0;
+  m_runStart = 0;
+  m_writePosition = 0;
+  m_writePosition = m_runStart = GetCachedEnd(0);
+
+  if (m_writePosition > 0)
+    CLog::LogF(LOGDEBUG, "resuming from {} cached bytes", m_writePosition);
+
+  return CACHE_RC_OK;
+}
+
+void CPersistentFileCache::Close()
+{
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (m_entry)
+    CPersistentCacheEntry::Release(m_entry);
+}
+
+size_t CPersistentFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return iRequestSize; // Can always write since it's on disk
+}
+
+int CPersistentFileCache::WriteToCache(const char* pBuffer, size_t iSize)
+{
+  int64_t position;
+  int64_t runStart;
+  {
+    CSingleLock lock(m_sync);
+    position = m_writePosition;
+    runStart = m_runStart;
+  }
+
+  if (m_cacheFileWrite->Seek(position, SEEK_SET) != position)
+  {
+    CLog::LogF(LOGERROR, "failed to seek in file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t written = 0;
+  while (iSize > 0)
+  {
+    const ssize_t lastWritten =
+        m_cacheFileWrite->Write(pBuffer + written, std::min(iSize, static_cast<size_t>(SSIZE_MAX)));
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+    iSize -= lastWritten;
+    written += lastWritten;
+  }
+
+  m_entry->SetWritten(runStart, position, position + written);
+
+  {
+    CSingleLock lock(m_sync);
+    m_writePosition = position + written;
+  }
+
+  // when reader waits for data it will wait on the event.
+  m_dataAvailEvent.Set();
+
+  return written;
+}
+
+int CPersistentFileCache::ReadFromCache(char* pBuffer, size_t iMaxSize)
+{
+  int64_t position;
+  int64_t available;
+  {
+    CSingleLock lock(m_sync);
+    position = m_readPosition;
+    available = GetCachedEnd(position) - position;
+  }
+
+  if (available <= 0)
+    return m_bEndOfInput ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  if (m_cacheFileRead->Seek(position, SEEK_SET) != position)
+  {
+    CLog::LogF(LOGERROR, "failed to seek in file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t toRead = std::min(iMaxSize, static_cast<size_t>(available));
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes,
+                                                   std::min(toRead, static_cast<size_t>(SSIZE_MAX)));
+
+    if (lastRead == 0)
+      break;
+    if (lastRead < 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  CSingleLock lock(m_sync);
+  m_readPosition += readBytes;
+
+  return readBytes;
+}
+
+int64_t CPersistentFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  auto getAvailable = [this]() {
+    CSingleLock lock(m_sync);
+    return GetCachedEnd(m_readPosition) - m_readPosition;
+  };
+
+  if (iMillis == 0 || IsEndOfInput())
+    return getAvailable();
+
+  XbmcThreads::EndTime endTime(iMillis);
+  while (!IsEndOfInput())
+  {
+    const int64_t iAvail = getAvailable();
+    if (iAvail >= iMinAvail)
+      return iAvail;
+
+    if (!m_dataAvailEvent.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+  return getAvailable();
+}
+
+int64_t CPersistentFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (!IsCachedPositionInternal(iFilePosition))
+    return CACHE_RC_ERROR;
+
+  m_readPosition = iFilePosition;
+  return iFilePosition;
+}
+
+bool CPersistentFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  m_readPosition = iSourcePosition;
+
+  if (!clearAnyway && IsCachedPositionInternal(iSourcePosition))
+  {
+    // continue writing after the cached range, which may be a different one than before
+    const int64_t end = GetCachedEnd(iSourcePosition);
+    if (end != m_writePosition)
+      m_writePosition = m_runStart = end;
+    return false;
+  }
+
+  m_writePosition = m_runStart = iSourcePosition;
+  return true;
+}
+
+void CPersistentFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_dataAvailEvent.Set();
+}
+
+int64_t CPersistentFileCache::GetCachedEnd(int64_t iFilePosition) const
+{
+  if (!m_entry)
+    return iFilePosition;
+
+  // alternate between complete blocks and the range currently being written,
+  // until neither extends the contiguous range any further
+  int64_t end = iFilePosition;
+  while (true)
+  {
+    int64_t next = m_entry->GetCompleteEnd(end);
+    if (next >= m_runStart && next < m_writePosition)
+      next = m_writePosition;
+    if (next == end)
+      return end;
+    end = next;
+  }
+}
+
+bool CPersistentFileCache::IsCachedPositionInternal(int64_t iFilePosition) const
+{
+  return (iFilePosition >= m_runStart && iFilePosition <= m_writePosition) ||
+         GetCachedEnd(iFilePosition) > iFilePosition;
+}
+
+int64_t CPersistentFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  if (IsCachedPositionInternal(iFilePosition))
+    return GetCachedEnd(iFilePosition);
+  return iFilePosition;
+}
+
+int64_t CPersistentFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_writePosition;
+}
+
+bool CPersistentFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return IsCachedPositionInternal(iFilePosition);
+}
+
+CCacheStrategy* CPersistentFileCache::CreateNew()
+{
+  return new CPersistentFileCache(m_url, m_fileSize, m_modificationTime);
+}
+
+void CPersistentFileCache::Prune(uint64_t maxBytes)
+{
+  CPersistentCacheEntry::Prune(maxBytes);
+}
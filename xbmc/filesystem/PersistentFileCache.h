@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+
+class CPersistentCacheEntry;
+
+/*!
+ \brief Disk cache strategy that keeps downloaded data across seeks and playback sessions
+
+ Data is stored in a sparse file under special://temp/filecache/, together with an index
+ of which fixed size blocks are complete. Entries are keyed by URL, file size and
+ modification time, so a changed source never serves stale data. When a seek lands in
+ a range that was fetched before (in this or an earlier session) it's served locally and
+ the source is only asked for what follows the cached range.
+
+ The total size of all entries is capped by the advancedsettings <cache><persistentsize>
+ value (MiB), least recently used entries are evicted first.
+ */
+class CPersistentFileCache : public CCacheStrategy
+{
+public:
+  static constexpr unsigned int BLOCK_SIZE = 1024 * 1024;
+  //! the index is saved once this many bytes were completed since it was last saved
+  static constexpr int64_t INDEX_SAVE_BYTES = 16 * BLOCK_SIZE;
+  //! or when any were completed and this many milliseconds passed
+  static constexpr unsigned int INDEX_SAVE_INTERVAL = 10000;
+
+  CPersistentFileCache(const std::string& url, int64_t fileSize, int64_t modificationTime);
+  ~CPersistentFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char* pBuffer, size_t iSize) override;
+  int ReadFromCache(char* pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway = true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy* CreateNew() override;
+
+  /*!
+   \brief Evict least recently used cache entries not in use until the cache fits
+   \param maxBytes size all entries together may use on disk
+
+   The cache directory is only listed on the first call, later calls use the sizes
+   tracked while writing.
+   */
+  static void Prune(uint64_t maxBytes);
+
+private:
+  int64_t GetCachedEnd(int64_t iFilePosition) const;
+  bool IsCachedPositionInternal(int64_t iFilePosition) const;
+
+  std::string m_url;
+  int64_t m_fileSize;
+  int64_t m_modificationTime;
+  std::shared_ptr<CPersistentCacheEntry> m_entry;
+  std::unique_ptr<IFile> m_cacheFileRead;
+  std::unique_ptr<IFile> m_cacheFileWrite;
+  CEvent m_dataAvailEvent;
+  mutable CCriticalSection m_sync;
+  int64_t m_readPosition = 0;
+  int64_t m_writePosition = 0;
+  int64_t m_runStart = 0; ///< start of the range written contiguously up to m_writePosition
+};
+
+} // namespace XFILE
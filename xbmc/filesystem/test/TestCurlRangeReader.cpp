@@ -0,0 +1,303 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CurlRangeReader.h"
+#include "filesystem/DllLibCurl.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+
+/*!
+ * Minimal HTTP server for a single file, answering every request on its own connection. It can
+ * ignore ranges and answer with the whole file, or cut the first response for every range end
+ * after half of its content. A latency can be added to every response, like a distant server
+ * would have.
+ */
+class CRangeServer
+{
+public:
+  CRangeServer(const std::string& content,
+               bool honorRanges,
+               bool truncateFirst,
+               std::chrono::milliseconds latency = std::chrono::milliseconds(0))
+    : m_content(content),
+      m_honorRanges(honorRanges),
+      m_truncateFirst(truncateFirst),
+      m_latency(latency)
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(m_socket, 16) != 0 ||
+        getsockname(m_socket, reinterpret_cast<sockaddr*>(&addr), &length) != 0)
+      return;
+    m_port = ntohs(addr.sin_port);
+    m_thread = std::thread([this]() { Accept(); });
+  }
+
+  ~CRangeServer()
+  {
+    m_stop = true;
+    shutdown(m_socket, SHUT_RDWR);
+    if (m_thread.joinable())
+      m_thread.join();
+    close(m_socket);
+    for (auto& thread : m_connections)
+      thread.join();
+  }
+
+  std::string GetUrl() const { return StringUtils::Format("http://127.0.0.1:{}/file", m_port); }
+  bool IsRunning() const { return m_port != 0; }
+
+  std::vector<std::string> GetRanges() const
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_ranges;
+  }
+
+private:
+  void Accept()
+  {
+    while (!m_stop)
+    {
+      const int connection = accept(m_socket, nullptr, nullptr);
+      if (connection < 0)
+        break;
+      m_connections.emplace_back([this, connection]() { Serve(connection); });
+    }
+  }
+
+  void Serve(int connection)
+  {
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos)
+    {
+      const ssize_t read = recv(connection, buffer, sizeof(buffer), 0);
+      if (read <= 0)
+      {
+        close(connection);
+        return;
+      }
+      request.append(buffer, read);
+    }
+
+    size_t start = 0;
+    size_t end = m_content.size() - 1;
+    bool ranged = false;
+    bool truncate = false;
+    const size_t header = request.find("Range: bytes=");
+    if (header != std::string::npos)
+    {
+      const std::string range =
+          request.substr(header + 13, request.find("\r\n", header) - header - 13);
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_ranges.push_back(range);
+      if (m_honorRanges)
+      {
+        ranged = true;
+        sscanf(range.c_str(), "%zu-%zu", &start, &end);
+        truncate = m_truncateFirst && m_truncated.insert(end).second;
+      }
+    }
+
+    const size_t length = end - start + 1;
+    std::string response;
+    if (ranged)
+      response = StringUtils::Format("HTTP/1.1 206 Partial Content\r\nContent-Range: bytes "
+                                     "{}-{}/{}\r\n",
+                                     start, end, m_content.size());
+    else
+      response = "HTTP/1.1 200 OK\r\n";
+    response += StringUtils::Format("Content-Length: {}\r\nConnection: close\r\n\r\n", length);
+    response += m_content.substr(start, truncate ? length / 2 : length);
+    std::this_thread::sleep_for(m_latency);
+    send(connection, response.data(), response.size(), MSG_NOSIGNAL);
+    close(connection);
+  }
+
+  const std::string m_content;
+  const bool m_honorRanges;
+  const bool m_truncateFirst;
+  const std::chrono::milliseconds m_latency;
+  int m_socket = -1;
+  uint16_t m_port = 0;
+  std::atomic<bool> m_stop{false};
+  std::thread m_thread;
+  std::vector<std::thread> m_connections; // only used by the accept thread until it stops
+  mutable std::mutex m_lock;
+  std::vector<std::string> m_ranges;
+  std::set<size_t> m_truncated;
+};
+
+std::string CreateContent(size_t size)
+{
+  std::string content(size, 0);
+  for (size_t i = 0; i < size; i++)
+    content[i] = static_cast<char>(i * 7 % 251);
+  return content;
+}
+
+class TestCurlRangeReader : public testing::Test
+{
+protected:
+  void SetUp() override { m_easy = g_curlInterface.easy_init(); }
+  void TearDown() override { g_curlInterface.easy_cleanup(m_easy); }
+
+  std::unique_ptr<CCurlRangeReader> CreateReader(const CRangeServer& server,
+                                                 size_t size,
+                                                 int maxRetries,
+                                                 unsigned int chunkSize = 1000,
+                                                 unsigned int connections = 3)
+  {
+    g_curlInterface.easy_setopt(m_easy, CURLOPT_URL, server.GetUrl().c_str());
+    auto reader =
+        std::make_unique<CCurlRangeReader>(m_easy, size, connections, chunkSize, maxRetries);
+    if (!reader->Init())
+      return {};
+    return reader;
+  }
+
+  static std::string ReadAll(CCurlRangeReader& reader, ssize_t& result)
+  {
+    std::string data;
+    char buffer[777];
+    while ((result = reader.Read(buffer, sizeof(buffer))) > 0)
+      data.append(buffer, result);
+    return data;
+  }
+
+  CURL_HANDLE* m_easy = nullptr;
+};
+
+} // namespace
+
+TEST_F(TestCurlRangeReader, Read)
+{
+  const std::string content = CreateContent(10000);
+  CRangeServer server(content, true, false);
+  ASSERT_TRUE(server.IsRunning());
+  auto reader = CreateReader(server, content.size(), 0);
+  ASSERT_TRUE(reader);
+
+  ssize_t result;
+  EXPECT_TRUE(content == ReadAll(*reader, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(10u, server.GetRanges().size());
+
+  // restarts from the new position
+  reader->Seek(5500);
+  EXPECT_TRUE(content.substr(5500) == ReadAll(*reader, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ("5500-6499", server.GetRanges()[10]);
+}
+
+TEST_F(TestCurlRangeReader, ServerIgnoresRange)
+{
+  // large enough chunks that the start of the whole file fits into them
+  const std::string content = CreateContent(1000000);
+  CRangeServer server(content, false, false);
+  ASSERT_TRUE(server.IsRunning());
+  auto reader = CreateReader(server, content.size(), 2, 200000);
+  ASSERT_TRUE(reader);
+
+  // nothing of the full responses is served, and they are not retried
+  ssize_t result;
+  EXPECT_EQ(0u, ReadAll(*reader, result).size());
+  EXPECT_EQ(-1, result);
+  EXPECT_GE(3u, server.GetRanges().size());
+}
+
+TEST_F(TestCurlRangeReader, RetryResumes)
+{
+  const std::string content = CreateContent(10000);
+  CRangeServer server(content, true, true);
+  ASSERT_TRUE(server.IsRunning());
+  auto reader = CreateReader(server, content.size(), 1);
+  ASSERT_TRUE(reader);
+
+  ssize_t result;
+  EXPECT_TRUE(content == ReadAll(*reader, result));
+  EXPECT_EQ(0, result);
+
+  // every chunk is requested again after what the cut response delivered
+  const std::vector<std::string> ranges = server.GetRanges();
+  EXPECT_EQ(20u, ranges.size());
+  for (int i = 0; i < 10; i++)
+  {
+    const std::string resumed = StringUtils::Format("{}-{}", i * 1000 + 500, i * 1000 + 999);
+    EXPECT_NE(ranges.end(), std::find(ranges.begin(), ranges.end(), resumed)) << resumed;
+  }
+}
+
+TEST_F(TestCurlRangeReader, RetriesExhausted)
+{
+  const std::string content = CreateContent(10000);
+  CRangeServer server(content, true, true);
+  ASSERT_TRUE(server.IsRunning());
+  auto reader = CreateReader(server, content.size(), 0);
+  ASSERT_TRUE(reader);
+
+  // only the validated part of the first chunk is handed out before the error
+  ssize_t result;
+  const std::string data = ReadAll(*reader, result);
+  EXPECT_EQ(-1, result);
+  EXPECT_GE(500u, data.size());
+  EXPECT_TRUE(content.compare(0, data.size(), data) == 0);
+}
+
+/*!
+ * Reads 32 MiB in chunks of 1 MiB, the default chunk size, from a server answering every request
+ * after 50 ms, over 1, 2 and 4 connections. The throughput with a single connection is bound by
+ * the latency, more connections hide it, so the absolute figures depend on the latency chosen.
+ */
+TEST_F(TestCurlRangeReader, DISABLED_Throughput)
+{
+  const std::string content = CreateContent(32 * 1024 * 1024);
+  CRangeServer server(content, true, false, std::chrono::milliseconds(50));
+  ASSERT_TRUE(server.IsRunning());
+
+  auto read = [this, &server, &content](unsigned int connections) {
+    auto reader = CreateReader(server, content.size(), 0, 1024 * 1024, connections);
+    if (!reader)
+      return 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    ssize_t result;
+    const std::string data = ReadAll(*reader, result);
+    const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(0, result);
+    EXPECT_TRUE(content == data);
+    return data.size() / (1024.0 * 1024.0) / time.count();
+  };
+
+  RecordProperty("Connections1MiBps", StringUtils::Format("{:.1f}", read(1)));
+  RecordProperty("Connections2MiBps", StringUtils::Format("{:.1f}", read(2)));
+  RecordProperty("Connections4MiBps", StringUtils::Format("{:.1f}", read(4)));
+}
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/StringUtils.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+std::string DirPath(int i)
+{
+  return StringUtils::Format("smb://server/share/dir{}/", i);
+}
+
+void FillListing(const std::string& path, CFileItemList& items, int count = 3)
+{
+  items.Clear();
+  items.SetPath(path);
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("{}file{}.mkv", path, i), false));
+    items.Add(item);
+  }
+}
+} // namespace
+
+TEST(TestDirectoryCache, SetGetDirectory)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillListing(DirPath(0), items);
+  cache.SetDirectory(DirPath(0), items, DIR_CACHE_ALWAYS);
+
+  // trailing slash and URL options don't matter
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/dir0|user-agent=test", cached));
+  EXPECT_EQ(3, cached.Size());
+
+  EXPECT_FALSE(cache.GetDirectory(DirPath(1), cached));
+
+  cache.ClearDirectory(DirPath(0));
+  EXPECT_FALSE(cache.GetDirectory(DirPath(0), cached));
+}
+
+TEST(TestDirectoryCache, CacheOnce)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillListing(DirPath(0), items);
+  cache.SetDirectory(DirPath(0), items, DIR_CACHE_ONCE);
+
+  CFileItemList cached;
+  EXPECT_FALSE(cache.GetDirectory(DirPath(0), cached));
+  EXPECT_TRUE(cache.GetDirectory(DirPath(0), cached, true));
+  EXPECT_EQ(3, cached.Size());
+}
+
+TEST(TestDirectoryCache, FileExists)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillListing(DirPath(0), items);
+  cache.SetDirectory(DirPath(0), items, DIR_CACHE_ONCE);
+
+  bool inCache = false;
+  EXPECT_TRUE(cache.FileExists(DirPath(0) + "file1.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists(DirPath(0) + "new.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  cache.AddFile(DirPath(0) + "new.mkv");
+  EXPECT_TRUE(cache.FileExists(DirPath(0) + "new.mkv", inCache));
+
+  EXPECT_FALSE(cache.FileExists(DirPath(1) + "file1.mkv", inCache));
+  EXPECT_FALSE(inCache);
+}
+
+TEST(TestDirectoryCache, EvictLeastRecentlyUsed)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  CFileItemList cached;
+
+  FillListing(DirPath(0), items);
+  cache.SetDirectory(DirPath(0), items, DIR_CACHE_ALWAYS);
+  FillListing(DirPath(1), items);
+  cache.SetDirectory(DirPath(1), items, DIR_CACHE_ONCE);
+
+  for (int i = 2; i < 500; i++)
+  {
+    // keep dir1 in use
+    EXPECT_TRUE(cache.GetDirectory(DirPath(1), cached, true));
+    FillListing(DirPath(i), items);
+    cache.SetDirectory(DirPath(i), items, DIR_CACHE_ONCE);
+  }
+
+  // always cached and recently used dirs survive, old ones are gone
+  EXPECT_TRUE(cache.GetDirectory(DirPath(0), cached));
+  EXPECT_TRUE(cache.GetDirectory(DirPath(1), cached, true));
+  EXPECT_TRUE(cache.GetDirectory(DirPath(499), cached, true));
+  EXPECT_FALSE(cache.GetDirectory(DirPath(2), cached, true));
+  EXPECT_FALSE(cache.GetDirectory(DirPath(100), cached, true));
+}
+
+TEST(TestDirectoryCache, ClearSubPaths)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  CFileItemList cached;
+
+  FillListing("smb://server/share/", items);
+  cache.SetDirectory("smb://server/share/", items, DIR_CACHE_ALWAYS);
+  FillListing(DirPath(0), items);
+  cache.SetDirectory(DirPath(0), items, DIR_CACHE_ALWAYS);
+  FillListing("smb://other/share/", items);
+  cache.SetDirectory("smb://other/share/", items, DIR_CACHE_ALWAYS);
+
+  cache.ClearSubPaths("smb://server/share/");
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/", cached));
+  EXPECT_FALSE(cache.GetDirectory(DirPath(0), cached));
+  EXPECT_TRUE(cache.GetDirectory("smb://other/share/", cached));
+
+  cache.Clear();
+  EXPECT_FALSE(cache.GetDirectory("smb://other/share/", cached));
+}
+
+TEST(TestDirectoryCache, GlobalLimit)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  CFileItemList cached;
+
+  // the limit applies to the whole cache, not to each of its shards
+  for (int i = 0; i < 50; i++)
+  {
+    FillListing(DirPath(i), items);
+    cache.SetDirectory(DirPath(i), items, DIR_CACHE_ONCE);
+  }
+  for (int i = 0; i < 50; i++)
+    EXPECT_TRUE(cache.GetDirectory(DirPath(i), cached, true)) << DirPath(i);
+
+  // dir0 was used first, so it goes first whichever shard it is in
+  FillListing(DirPath(50), items);
+  cache.SetDirectory(DirPath(50), items, DIR_CACHE_ONCE);
+  EXPECT_FALSE(cache.GetDirectory(DirPath(0), cached, true));
+  for (int i = 1; i <= 50; i++)
+    EXPECT_TRUE(cache.GetDirectory(DirPath(i), cached, true)) << DirPath(i);
+}
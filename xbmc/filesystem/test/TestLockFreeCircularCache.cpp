@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/LockFreeCircularCache.h"
+
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+// sizes are deliberately not page aligned
+constexpr size_t CACHE_FRONT = 3000;
+constexpr size_t CACHE_BACK = 1000;
+
+void FillPattern(char* buf, size_t len, int64_t filePos)
+{
+  for (size_t i = 0; i < len; i++)
+    buf[i] = static_cast<char>((filePos + i) % 251);
+}
+} // namespace
+
+TEST(TestLockFreeCircularCache, ReadWrite)
+{
+  CLockFreeCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char in[100];
+  char out[100];
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(out, sizeof(out)));
+
+  FillPattern(in, sizeof(in), 0);
+  EXPECT_EQ(100, cache.WriteToCache(in, sizeof(in)));
+  EXPECT_EQ(100, cache.WaitForData(0, 0));
+  EXPECT_EQ(100, cache.ReadFromCache(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+  EXPECT_EQ(0, cache.WaitForData(0, 0));
+
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(out, sizeof(out)));
+}
+
+TEST(TestLockFreeCircularCache, Wrap)
+{
+  CLockFreeCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char in[700];
+  char out[700];
+  int64_t writePos = 0;
+  int64_t readPos = 0;
+
+  // push several buffer sizes worth of data through the cache
+  while (readPos < 20 * static_cast<int64_t>(CACHE_FRONT + CACHE_BACK))
+  {
+    FillPattern(in, sizeof(in), writePos);
+    const int written = cache.WriteToCache(in, sizeof(in));
+    ASSERT_GE(written, 0);
+    writePos += written;
+
+    int read = cache.ReadFromCache(out, sizeof(out));
+    while (read > 0)
+    {
+      char expected[sizeof(out)];
+      FillPattern(expected, read, readPos);
+      ASSERT_EQ(0, memcmp(expected, out, read));
+      readPos += read;
+      read = cache.ReadFromCache(out, sizeof(out));
+    }
+    ASSERT_EQ(CACHE_RC_WOULD_BLOCK, read);
+  }
+  EXPECT_EQ(writePos, readPos);
+}
+
+TEST(TestLockFreeCircularCache, PeekConsume)
+{
+  CLockFreeCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char in[CACHE_FRONT];
+  FillPattern(in, sizeof(in), 0);
+  ASSERT_EQ(static_cast<int>(sizeof(in)), cache.WriteToCache(in, sizeof(in)));
+
+  const char* data = nullptr;
+  EXPECT_EQ(10, cache.PeekFromCache(&data, 10));
+  ASSERT_NE(nullptr, data);
+  EXPECT_EQ(0, memcmp(in, data, 10));
+
+  // peeking doesn't move the read position
+  EXPECT_EQ(static_cast<int64_t>(sizeof(in)), cache.WaitForData(0, 0));
+  cache.ConsumeFromCache(10);
+  EXPECT_EQ(static_cast<int64_t>(sizeof(in) - 10), cache.WaitForData(0, 0));
+
+  EXPECT_EQ(5, cache.PeekFromCache(&data, 5));
+  EXPECT_EQ(0, memcmp(in + 10, data, 5));
+}
+
+TEST(TestLockFreeCircularCache, Seek)
+{
+  CLockFreeCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char in[CACHE_FRONT];
+  char out[100];
+  FillPattern(in, sizeof(in), 0);
+  ASSERT_EQ(static_cast<int>(sizeof(in)), cache.WriteToCache(in, sizeof(in)));
+
+  EXPECT_EQ(2000, cache.Seek(2000));
+  ASSERT_EQ(100, cache.ReadFromCache(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(in + 2000, out, sizeof(out)));
+
+  // back into already read data
+  EXPECT_EQ(500, cache.Seek(500));
+  ASSERT_EQ(100, cache.ReadFromCache(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(in + 500, out, sizeof(out)));
+
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_FALSE(cache.IsCachedPosition(200000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(200000));
+
+  EXPECT_TRUE(cache.Reset(100000));
+  EXPECT_EQ(100000, cache.CachedDataEndPos());
+  EXPECT_FALSE(cache.IsCachedPosition(0));
+}
@@ -0,0 +1,239 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/PersistentFileCache.h"
+#include "utils/Digest.h"
+
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+
+constexpr int64_t BLOCK = CPersistentFileCache::BLOCK_SIZE;
+constexpr int64_t MODIFICATION_TIME = 1600000000;
+
+// layout of the index header written by the cache
+constexpr size_t INDEX_HEADER_SIZE = 32;
+constexpr size_t INDEX_CACHED_BYTES_OFFSET = 24;
+
+std::string CreateContent(size_t size)
+{
+  std::string content(size, 0);
+  for (size_t i = 0; i < size; i++)
+    content[i] = static_cast<char>(i * 7 % 251);
+  return content;
+}
+
+std::string GetIndexPath(const std::string& url, int64_t fileSize, int64_t modificationTime)
+{
+  return "special://temp/filecache/" +
+         CDigest::Calculate(CDigest::Type::MD5, url + "|" + std::to_string(fileSize) + "|" +
+                                                    std::to_string(modificationTime)) +
+         ".idx";
+}
+
+std::string ReadIndex(const std::string& path)
+{
+  CFile file;
+  auto_buffer buffer;
+  if (file.LoadFile(path, buffer) <= 0)
+    return {};
+  return std::string(buffer.get(), buffer.size());
+}
+
+void WriteIndex(const std::string& path, const std::string& data)
+{
+  CFile file;
+  ASSERT_TRUE(file.OpenForWrite(path, true));
+  if (!data.empty())
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), file.Write(data.data(), data.size()));
+}
+
+int64_t GetIndexCachedBytes(const std::string& path)
+{
+  const std::string index = ReadIndex(path);
+  int64_t cachedBytes = -1;
+  if (index.size() >= INDEX_HEADER_SIZE)
+    memcpy(&cachedBytes, index.data() + INDEX_CACHED_BYTES_OFFSET, sizeof(cachedBytes));
+  return cachedBytes;
+}
+
+void Write(CPersistentFileCache& cache, const std::string& content, int64_t begin, int64_t end)
+{
+  cache.Reset(begin);
+  for (int64_t position = begin; position < end; position += 64 * 1024)
+  {
+    const size_t size = std::min<int64_t>(64 * 1024, end - position);
+    ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(content.data() + position, size));
+  }
+}
+
+std::string ReadAll(CPersistentFileCache& cache)
+{
+  std::string data;
+  char buffer[100000];
+  int read;
+  while ((read = cache.ReadFromCache(buffer, sizeof(buffer))) > 0)
+    data.append(buffer, read);
+  return data;
+}
+
+class TestPersistentFileCache : public testing::Test
+{
+protected:
+  void SetUp() override { CPersistentFileCache::Prune(0); }
+  void TearDown() override { CPersistentFileCache::Prune(0); }
+
+  void CreateEntry(const std::string& url, int64_t blocks)
+  {
+    const std::string content = CreateContent(blocks * BLOCK);
+    CPersistentFileCache cache(url, content.size(), MODIFICATION_TIME);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, content, 0, content.size());
+  }
+};
+
+} // namespace
+
+TEST_F(TestPersistentFileCache, ReopenSparse)
+{
+  const std::string url = "http://127.0.0.1/sparse";
+  const std::string content = CreateContent(8 * BLOCK + 1000);
+  const int64_t size = content.size();
+  {
+    CPersistentFileCache cache(url, size, MODIFICATION_TIME);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, content, 0, 2 * BLOCK);
+    Write(cache, content, 5 * BLOCK, 6 * BLOCK + BLOCK / 2);
+    Write(cache, content, 7 * BLOCK + 10, size);
+  }
+
+  CPersistentFileCache cache(url, size, MODIFICATION_TIME);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // fetching continues after the cached start
+  EXPECT_EQ(2 * BLOCK, cache.CachedDataEndPos());
+  EXPECT_FALSE(cache.IsCachedPosition(3 * BLOCK));
+
+  // only complete blocks are kept, including the shorter last one
+  EXPECT_EQ(6 * BLOCK, cache.CachedDataEndPosIfSeekTo(5 * BLOCK + 100));
+  EXPECT_FALSE(cache.IsCachedPosition(6 * BLOCK + 1));
+  EXPECT_FALSE(cache.IsCachedPosition(7 * BLOCK + 10));
+  EXPECT_EQ(size, cache.CachedDataEndPosIfSeekTo(8 * BLOCK));
+
+  ASSERT_EQ(5 * BLOCK + 100, cache.Seek(5 * BLOCK + 100));
+  EXPECT_TRUE(content.substr(5 * BLOCK + 100, BLOCK - 100) == ReadAll(cache));
+  ASSERT_EQ(8 * BLOCK, cache.Seek(8 * BLOCK));
+  EXPECT_TRUE(content.substr(8 * BLOCK) == ReadAll(cache));
+
+  // a changed file has nothing cached
+  CPersistentFileCache changed(url, size, MODIFICATION_TIME + 1);
+  ASSERT_EQ(CACHE_RC_OK, changed.Open());
+  EXPECT_EQ(0, changed.CachedDataEndPos());
+  EXPECT_EQ(5 * BLOCK, changed.CachedDataEndPosIfSeekTo(5 * BLOCK));
+}
+
+TEST_F(TestPersistentFileCache, SaveWhileWriting)
+{
+  const std::string url = "http://127.0.0.1/save";
+  const std::string content = CreateContent(32 * BLOCK);
+  const std::string indexPath = GetIndexPath(url, content.size(), MODIFICATION_TIME);
+
+  CPersistentFileCache cache(url, content.size(), MODIFICATION_TIME);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  const int64_t saveBlocks = CPersistentFileCache::INDEX_SAVE_BYTES / BLOCK;
+  Write(cache, content, 0, (saveBlocks - 1) * BLOCK);
+  EXPECT_FALSE(CFile::Exists(indexPath));
+
+  // saved before the file is closed
+  Write(cache, content, (saveBlocks - 1) * BLOCK, saveBlocks * BLOCK + BLOCK / 2);
+  EXPECT_EQ(saveBlocks * BLOCK, GetIndexCachedBytes(indexPath));
+}
+
+TEST_F(TestPersistentFileCache, CorruptIndex)
+{
+  const std::string url = "http://127.0.0.1/corrupt";
+  const int64_t size = 4 * BLOCK;
+  const std::string indexPath = GetIndexPath(url, size, MODIFICATION_TIME);
+  CreateEntry(url, 4);
+
+  const std::string index = ReadIndex(indexPath);
+  ASSERT_EQ(INDEX_HEADER_SIZE + 1, index.size());
+
+  std::string badMagic = index;
+  badMagic[0] = 'X';
+  std::string otherSize = index;
+  otherSize[8]++;
+  const std::vector<std::string> corrupted = {badMagic, otherSize, index.substr(0, 10),
+                                              index.substr(0, INDEX_HEADER_SIZE), ""};
+
+  for (const auto& data : corrupted)
+  {
+    WriteIndex(indexPath, data);
+
+    // nothing is trusted, and the index is written again
+    {
+      CPersistentFileCache cache(url, size, MODIFICATION_TIME);
+      ASSERT_EQ(CACHE_RC_OK, cache.Open());
+      EXPECT_EQ(0, cache.CachedDataEndPos());
+      EXPECT_EQ(BLOCK, cache.CachedDataEndPosIfSeekTo(BLOCK));
+      Write(cache, CreateContent(size), 0, size);
+    }
+    EXPECT_EQ(size, GetIndexCachedBytes(indexPath));
+  }
+}
+
+TEST_F(TestPersistentFileCache, Prune)
+{
+  const std::string first = "http://127.0.0.1/first";
+  const std::string second = "http://127.0.0.1/second";
+  const std::string third = "http://127.0.0.1/third";
+  CreateEntry(first, 2);
+  CreateEntry(second, 2);
+  CreateEntry(third, 2);
+
+  // fits
+  CPersistentFileCache::Prune(6 * BLOCK);
+  EXPECT_TRUE(CFile::Exists(GetIndexPath(second, 2 * BLOCK, MODIFICATION_TIME)));
+
+  // the least recently used entry goes first
+  {
+    CPersistentFileCache cache(first, 2 * BLOCK, MODIFICATION_TIME);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  }
+  CPersistentFileCache::Prune(5 * BLOCK);
+  EXPECT_TRUE(CFile::Exists(GetIndexPath(first, 2 * BLOCK, MODIFICATION_TIME)));
+  EXPECT_FALSE(CFile::Exists(GetIndexPath(second, 2 * BLOCK, MODIFICATION_TIME)));
+  EXPECT_TRUE(CFile::Exists(GetIndexPath(third, 2 * BLOCK, MODIFICATION_TIME)));
+
+  // entries in use are kept
+  {
+    CPersistentFileCache cache(third, 2 * BLOCK, MODIFICATION_TIME);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    CPersistentFileCache::Prune(0);
+    EXPECT_FALSE(CFile::Exists(GetIndexPath(first, 2 * BLOCK, MODIFICATION_TIME)));
+    EXPECT_EQ(2 * BLOCK, cache.CachedDataEndPos());
+  }
+  EXPECT_TRUE(CFile::Exists(GetIndexPath(third, 2 * BLOCK, MODIFICATION_TIME)));
+
+  // the size written since is counted
+  CreateEntry(second, 3);
+  CPersistentFileCache::Prune(3 * BLOCK);
+  EXPECT_FALSE(CFile::Exists(GetIndexPath(third, 2 * BLOCK, MODIFICATION_TIME)));
+  EXPECT_TRUE(CFile::Exists(GetIndexPath(second, 3 * BLOCK, MODIFICATION_TIME)));
+}
@@ -46,7 +46,6 @@ struct ThumbDataManagement
   uint8_t* intermediateBuffer = nullptr; // gets av_alloced
   AVFrame* frame_input = nullptr;
   AVFrame* frame_temporary = nullptr;
-  SwsContext* sws = nullptr;
   AVCodecContext* avOutctx = nullptr;
   AVCodec* codec = nullptr;
   ~ThumbDataManagement()
@@ -59,8 +58,6 @@ struct ThumbDataManagement
     frame_temporary = nullptr;
     avcodec_free_context(&avOutctx);
     avOutctx = nullptr;
-    sws_freeContext(sws);
-    sws = nullptr;
   }
 };
 
@@ -139,7 +136,7 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
                                       unsigned int width, unsigned int height)
 {
 
-  if (!Initialize(buffer, bufSize))
+  if (!Initialize(buffer, bufSize, width, height))
   {
     //log
     return false;
@@ -151,7 +148,76 @@ bool CFFmpegImage::LoadImageFromMemory(unsigned char* buffer, unsigned int bufSi
   return !(m_pFrame == nullptr);
 }
 
-bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
+bool CFFmpegImage::GetJpegSize(const unsigned char* buffer, size_t bufSize,
+                               unsigned int& width, unsigned int& height)
+{
+  if (bufSize < 4 || buffer[0] != 0xFF || buffer[1] != 0xD8)
+    return false;
+
+  size_t pos = 2;
+  while (pos + 2 <= bufSize)
+  {
+    if (buffer[pos] != 0xFF)
+      return false;
+    // markers may be preceded by any number of fill bytes
+    while (pos + 1 < bufSize && buffer[pos + 1] == 0xFF)
+      pos++;
+    if (pos + 1 >= bufSize)
+      return false;
+
+    const unsigned char marker = buffer[pos + 1];
+    pos += 2;
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8))
+      continue; // no segment
+    if (marker == 0xD9 || marker == 0xDA)
+      return false; // end of image or start of scan
+
+    if (pos + 2 > bufSize)
+      return false;
+    const size_t length = (buffer[pos] << 8) | buffer[pos + 1];
+
+    // SOF0 to SOF15 except DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+    {
+      if (length < 7 || pos + 7 > bufSize)
+        return false;
+      height = (buffer[pos + 3] << 8) | buffer[pos + 4];
+      width = (buffer[pos + 5] << 8) | buffer[pos + 6];
+      return width > 0 && height > 0;
+    }
+
+    if (length < 2)
+      return false;
+    pos += length;
+  }
+  return false;
+}
+
+int CFFmpegImage::GetReducedScale(unsigned int width, unsigned int height,
+                                  unsigned int idealWidth, unsigned int idealHeight, int maxScale)
+{
+  if (width == 0 || height == 0 || idealWidth == 0 || idealHeight == 0)
+    return 0;
+
+  const double fit =
+      std::max(std::min(static_cast<double>(idealWidth) / width,
+                        static_cast<double>(idealHeight) / height),
+               std::min(static_cast<double>(idealHeight) / width,
+                        static_cast<double>(idealWidth) / height));
+  if (fit >= 1.0)
+    return 0;
+
+  // the decoders round the scaled size up
+  int scale = 0;
+  while (scale < maxScale &&
+         ((width + (2u << scale) - 1) >> (scale + 1)) >= fit * width &&
+         ((height + (2u << scale) - 1) >> (scale + 1)) >= fit * height)
+    scale++;
+  return scale;
+}
+
+bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize,
+                              unsigned int width, unsigned int height)
 {
   int bufferSize = 4096;
   uint8_t* fbuffer = (uint8_t*)av_malloc(bufferSize + AV_INPUT_BUFFER_PADDING_SIZE);
@@ -249,6 +315,20 @@ bool CFFmpegImage::Initialize(unsigned char* buffer, size_t bufSize)
     return false;
   }
 
+  // JPEG decoders can skip most of the inverse DCT of an image that is scaled down anyway
+  unsigned int jpegWidth, jpegHeight;
+  if (is_jpeg && codec && codec->max_lowres > 0 &&
+      GetJpegSize(buffer, bufSize, jpegWidth, jpegHeight))
+  {
+    m_codec_ctx->lowres =
+        GetReducedScale(jpegWidth, jpegHeight, width, height, codec->max_lowres);
+    if (m_codec_ctx->lowres > 0)
+    {
+      m_originalWidth = jpegWidth;
+      m_originalHeight = jpegHeight;
+    }
+  }
+
   if (avcodec_open2(m_codec_ctx, codec, NULL) < 0)
   {
     avformat_close_input(&m_fctx);
@@ -293,8 +373,11 @@ AVFrame* CFFmpegImage::ExtractFrame()
   frame->pkt_duration = av_rescale_q(frame->pkt_duration, m_fctx->streams[0]->time_base, AVRational{ 1, 1000 });
   m_height = frame->height;
   m_width = frame->width;
-  m_originalWidth = m_width;
-  m_originalHeight = m_height;
+  if (m_codec_ctx->lowres == 0)
+  {
+    m_originalWidth = m_width;
+    m_originalHeight = m_height;
+  }
 
   const AVPixFmtDescriptor* pixDescriptor = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
   if (pixDescriptor && ((pixDescriptor->flags & (AV_PIX_FMT_FLAG_ALPHA | AV_PIX_FMT_FLAG_PAL)) != 0))
@@ -467,9 +550,9 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
   AVPixelFormat pixFormat = ConvertFormats(frame);
 
   // assumption quadratic maximums e.g. 2048x2048
-  float ratio = m_width / (float)m_height;
-  unsigned int nHeight = m_originalHeight;
-  unsigned int nWidth = m_originalWidth;
+  float ratio = frame->width / (float)frame->height;
+  unsigned int nHeight = frame->height;
+  unsigned int nWidth = frame->width;
   if (nHeight > height)
   {
     nHeight = height;
@@ -481,22 +564,18 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
-    nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
-
-  if (range == AVCOL_RANGE_JPEG)
+  struct SwsContext* context =
+      ff_get_cached_sws_context(frame->width, frame->height, pixFormat, nWidth, nHeight,
+                                AV_PIX_FMT_RGB32, SWS_BICUBIC, range == AVCOL_RANGE_JPEG ? 1 : -1);
+  if (!context)
   {
-    int* inv_table = nullptr;
-    int* table = nullptr;
-    int srcRange, dstRange, brightness, contrast, saturation;
-    sws_getColorspaceDetails(context, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation);
-    srcRange = 1;
-    sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
+    CLog::LogF(LOGERROR, "Could not get a scaler for %i x %i pixels", frame->width, frame->height);
+    av_frame_free(&pictureRGB);
+    return false;
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
+  sws_scale(context, frame->data, frame->linesize, 0, frame->height,
     pictureRGB->data, pictureRGB->linesize);
-  sws_freeContext(context);
 
   if (needsCopy)
   {
@@ -637,38 +716,18 @@ bool CFFmpegImage::CreateThumbnailFromSurface(unsigned char* bufferin, unsigned
   int srcStride[] = { (int) pitch, 0, 0, 0};
 
   //input size == output size which means only pix_fmt conversion
-  tdm.sws = sws_getContext(width, height, AV_PIX_FMT_RGB32, width, height, jpg_output ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_RGBA, 0, 0, 0, 0);
-  if (!tdm.sws)
+  // jpeg full range yuv420p output from full range RGB32 input
+  SwsContext* sws = ff_get_cached_sws_context(
+      width, height, AV_PIX_FMT_RGB32, width, height,
+      jpg_output ? AV_PIX_FMT_YUV420P : AV_PIX_FMT_RGBA, 0, jpg_output ? 0 : -1, jpg_output ? 1 : -1);
+  if (!sws)
   {
     CLog::Log(LOGERROR, "Could not setup scaling context for thumbnail: %s", destFile.c_str());
     CleanupLocalOutputBuffer();
     return false;
   }
 
-  // Setup jpeg range for sws
-  if (jpg_output)
-  {
-    int* inv_table = nullptr;
-    int* table = nullptr;
-    int srcRange, dstRange, brightness, contrast, saturation;
-
-    if (sws_getColorspaceDetails(tdm.sws, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation) < 0)
-    {
-      CLog::Log(LOGERROR, "SWS_SCALE failed to get ColorSpaceDetails for thumbnail: %s", destFile.c_str());
-      CleanupLocalOutputBuffer();
-      return false;
-    }
-    dstRange = 1; // jpeg full range yuv420p output
-    srcRange = 0; // full range RGB32 input
-    if (sws_setColorspaceDetails(tdm.sws, inv_table, srcRange, table, dstRange, brightness, contrast, saturation) < 0)
-    {
-      CLog::Log(LOGERROR, "SWS_SCALE failed to set ColorSpace Details for thumbnail: %s", destFile.c_str());
-      CleanupLocalOutputBuffer();
-      return false;
-    }
-  }
-
-  if (sws_scale(tdm.sws, src, srcStride, 0, height, tdm.frame_temporary->data, tdm.frame_temporary->linesize) < 0)
+  if (sws_scale(sws, src, srcStride, 0, height, tdm.frame_temporary->data, tdm.frame_temporary->linesize) < 0)
   {
     CLog::Log(LOGERROR, "SWS_SCALE failed for thumbnail: %s", destFile.c_str());
     CleanupLocalOutputBuffer();
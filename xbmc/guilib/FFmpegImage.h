@@ -69,7 +69,28 @@ public:
                                   unsigned int &bufferoutSize) override;
   void ReleaseThumbnailBuffer() override;
 
-  bool Initialize(unsigned char* buffer, size_t bufSize);
+  /*!
+   \brief Open the image for decoding
+   \param width The ideal width, 0 to decode at full scale. JPEGs much larger than the ideal size
+   are decoded at a reduced scale.
+   \param height The ideal height
+   */
+  bool Initialize(unsigned char* buffer, size_t bufSize, unsigned int width = 0, unsigned int height = 0);
+
+  /*!
+   \brief Get the size of a JPEG from its frame header
+   \return false if no frame header precedes the image data
+   */
+  static bool GetJpegSize(const unsigned char* buffer, size_t bufSize,
+                          unsigned int& width, unsigned int& height);
+
+  /*!
+   \brief Get by how many powers of two an image can be scaled down while it still covers its fit
+   into the ideal size, in either orientation as the EXIF rotation is applied after scaling
+   \param maxScale the largest power of two the decoder supports
+   */
+  static int GetReducedScale(unsigned int width, unsigned int height,
+                             unsigned int idealWidth, unsigned int idealHeight, int maxScale);
 
   std::shared_ptr<Frame> ReadFrame();
 
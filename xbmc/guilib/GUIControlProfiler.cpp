@@ -12,6 +12,8 @@
 #include "utils/TimeUtils.h"
 #include "utils/XBMCTinyXML.h"
 
+#include <algorithm>
+
 bool CGUIControlProfiler::m_bIsRunning = false;
 
 CGUIControlProfilerItem::CGUIControlProfilerItem(CGUIControlProfiler *pProfiler, CGUIControlProfilerItem *pParent, CGUIControl *pControl)
@@ -238,6 +240,8 @@ bool CGUIControlProfiler::IsRunning(void)
 void CGUIControlProfiler::Start(void)
 {
   m_iFrameCount = 0;
+  m_infoBoolsEvaluated = 0;
+  m_infoBoolsSkipped = 0;
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
@@ -295,6 +299,15 @@ CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pCon
   return m_pLastItem;
 }
 
+void CGUIControlProfiler::AddInfoBool(bool evaluated)
+{
+  // skipped info bools were refreshed without their inputs having changed
+  if (evaluated)
+    m_infoBoolsEvaluated++;
+  else
+    m_infoBoolsSkipped++;
+}
+
 void CGUIControlProfiler::EndFrame(void)
 {
   m_iFrameCount++;
@@ -329,6 +342,13 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  // per frame
+  TiXmlElement *infoBools = new TiXmlElement("infobools");
+  const int frames = std::max(m_iFrameCount, 1);
+  infoBools->SetAttribute("evaluated", StringUtils::Format("%.1f", static_cast<float>(m_infoBoolsEvaluated) / frames).c_str());
+  infoBools->SetAttribute("skipped", StringUtils::Format("%.1f", static_cast<float>(m_infoBoolsSkipped) / frames).c_str());
+  root->LinkEndChild(infoBools);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
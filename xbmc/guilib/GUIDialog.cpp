@@ -172,7 +172,11 @@ void CGUIDialog::Open_Internal(bool bProcessRenderLoop, const std::string &param
   // could show it as well if we are in a different thread from the main rendering
   // thread (this should really be handled via a thread message though IMO)
   m_active = true;
-  m_closing = false;
+  if (m_closing)
+  {
+    m_closing = false;
+    CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
+  }
   CServiceBroker::GetGUI()->GetWindowManager().RegisterDialog(this);
 
   // active this window
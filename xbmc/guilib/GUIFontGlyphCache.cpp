@@ -0,0 +1,267 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontGlyphCache.h"
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/auto_buffer.h"
+#include "utils/log.h"
+
+#include <cstring>
+
+namespace
+{
+
+constexpr uint32_t FILE_MAGIC = 0x4B474331; // "KGC1"
+
+class CWriter
+{
+public:
+  template<typename T>
+  void Write(T value)
+  {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&value);
+    m_data.insert(m_data.end(), data, data + sizeof(T));
+  }
+
+  void WriteBytes(const uint8_t* data, size_t size)
+  {
+    m_data.insert(m_data.end(), data, data + size);
+  }
+
+  const std::vector<uint8_t>& GetData() const { return m_data; }
+
+private:
+  std::vector<uint8_t> m_data;
+};
+
+class CReader
+{
+public:
+  CReader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+  template<typename T>
+  bool Read(T& value)
+  {
+    if (m_size - m_pos < sizeof(T))
+      return false;
+    memcpy(&value, m_data + m_pos, sizeof(T));
+    m_pos += sizeof(T);
+    return true;
+  }
+
+  const uint8_t* ReadBytes(size_t size)
+  {
+    if (m_size - m_pos < size)
+      return nullptr;
+    const uint8_t* data = m_data + m_pos;
+    m_pos += size;
+    return data;
+  }
+
+private:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_pos = 0;
+};
+
+} // unnamed namespace
+
+CGUIFontGlyphCache::CGUIFontGlyphCache(size_t maxBytes) : m_maxBytes(maxBytes)
+{
+}
+
+CGUIFontGlyphCache& CGUIFontGlyphCache::GetInstance()
+{
+  static CGUIFontGlyphCache glyphCache;
+  return glyphCache;
+}
+
+unsigned int CGUIFontGlyphCache::GetFaceId(const std::string& face)
+{
+  CSingleLock lock(m_critSection);
+  auto it = m_faceIds.find(face);
+  if (it != m_faceIds.end())
+    return it->second;
+
+  const unsigned int id = static_cast<unsigned int>(m_faces.size());
+  m_faces.emplace_back(face);
+  m_faceIds.emplace(face, id);
+  return id;
+}
+
+CGUIFontGlyphCache::GlyphPtr CGUIFontGlyphCache::Get(unsigned int faceId,
+                                                     uint32_t style,
+                                                     uint32_t glyphIndex)
+{
+  CSingleLock lock(m_critSection);
+  auto it = m_glyphs.find(GetKey(faceId, style, glyphIndex));
+  if (it == m_glyphs.end())
+  {
+    m_misses++;
+    return nullptr;
+  }
+
+  m_hits++;
+  return it->second;
+}
+
+void CGUIFontGlyphCache::Add(unsigned int faceId,
+                             uint32_t style,
+                             uint32_t glyphIndex,
+                             const GlyphPtr& glyph)
+{
+  CSingleLock lock(m_critSection);
+  AddInternal(GetKey(faceId, style, glyphIndex), glyph);
+  m_modified = true;
+}
+
+void CGUIFontGlyphCache::AddInternal(uint64_t key, const GlyphPtr& glyph)
+{
+  const size_t size = sizeof(Glyph) + glyph->pixels.size();
+  if (m_bytes + size > m_maxBytes)
+  {
+    // fonts keep their copies in their textures, start over
+    CLog::Log(LOGDEBUG, "CGUIFontGlyphCache: dropping {} glyphs of {} bytes", m_glyphs.size(),
+              m_bytes);
+    m_glyphs.clear();
+    m_bytes = 0;
+  }
+
+  auto res = m_glyphs.emplace(key, glyph);
+  if (!res.second)
+  {
+    m_bytes -= sizeof(Glyph) + res.first->second->pixels.size();
+    res.first->second = glyph;
+  }
+  m_bytes += size;
+}
+
+CGUIFontGlyphCache::Stats CGUIFontGlyphCache::GetStats() const
+{
+  CSingleLock lock(m_critSection);
+  Stats stats;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.glyphs = m_glyphs.size();
+  stats.bytes = m_bytes;
+  return stats;
+}
+
+void CGUIFontGlyphCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_glyphs.clear();
+  m_bytes = 0;
+}
+
+bool CGUIFontGlyphCache::Save(const std::string& path)
+{
+  CWriter writer;
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_modified)
+      return true;
+
+    writer.Write(FILE_MAGIC);
+    writer.Write(static_cast<uint32_t>(m_faces.size()));
+    for (const auto& face : m_faces)
+    {
+      writer.Write(static_cast<uint32_t>(face.size()));
+      writer.WriteBytes(reinterpret_cast<const uint8_t*>(face.data()), face.size());
+    }
+
+    writer.Write(static_cast<uint32_t>(m_glyphs.size()));
+    for (const auto& it : m_glyphs)
+    {
+      const Glyph& glyph = *it.second;
+      writer.Write(it.first);
+      writer.Write(static_cast<int32_t>(glyph.left));
+      writer.Write(static_cast<int32_t>(glyph.top));
+      writer.Write(static_cast<uint32_t>(glyph.width));
+      writer.Write(static_cast<uint32_t>(glyph.rows));
+      writer.Write(static_cast<int64_t>(glyph.advance));
+      writer.WriteBytes(glyph.pixels.data(), glyph.pixels.size());
+    }
+    m_modified = false;
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(writer.GetData().data(), writer.GetData().size()) !=
+          static_cast<ssize_t>(writer.GetData().size()))
+  {
+    CLog::Log(LOGWARNING, "CGUIFontGlyphCache: unable to save glyphs to {}", path);
+    return false;
+  }
+  return true;
+}
+
+bool CGUIFontGlyphCache::Load(const std::string& path)
+{
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(path) || file.LoadFile(path, buffer) <= 0)
+    return false;
+
+  CReader reader(reinterpret_cast<const uint8_t*>(buffer.get()), buffer.size());
+  uint32_t magic;
+  uint32_t faceCount;
+  if (!reader.Read(magic) || magic != FILE_MAGIC || !reader.Read(faceCount))
+  {
+    CLog::Log(LOGWARNING, "CGUIFontGlyphCache: {} is no glyph cache", path);
+    return false;
+  }
+
+  // faces get the ids of this process
+  std::vector<unsigned int> faceIds;
+  for (uint32_t i = 0; i < faceCount; ++i)
+  {
+    uint32_t size;
+    const uint8_t* face = reader.Read(size) ? reader.ReadBytes(size) : nullptr;
+    if (!face)
+      return false;
+    faceIds.push_back(GetFaceId(std::string(reinterpret_cast<const char*>(face), size)));
+  }
+
+  uint32_t glyphCount;
+  if (!reader.Read(glyphCount))
+    return false;
+
+  CSingleLock lock(m_critSection);
+  for (uint32_t i = 0; i < glyphCount; ++i)
+  {
+    uint64_t key;
+    int32_t left, top;
+    uint32_t width, rows;
+    int64_t advance;
+    if (!reader.Read(key) || !reader.Read(left) || !reader.Read(top) || !reader.Read(width) ||
+        !reader.Read(rows) || !reader.Read(advance))
+      return false;
+
+    const uint32_t faceId = static_cast<uint32_t>(key >> 40);
+    const uint8_t* pixels = reader.ReadBytes(static_cast<size_t>(width) * rows);
+    if (faceId >= faceIds.size() || !pixels)
+      return false;
+
+    auto glyph = std::make_shared<Glyph>();
+    glyph->left = left;
+    glyph->top = top;
+    glyph->width = width;
+    glyph->rows = rows;
+    glyph->advance = static_cast<long>(advance);
+    glyph->pixels.assign(pixels, pixels + static_cast<size_t>(width) * rows);
+    AddInternal(GetKey(faceIds[faceId], static_cast<uint32_t>(key >> 32) & 0xff,
+                       static_cast<uint32_t>(key)),
+                glyph);
+  }
+
+  CLog::Log(LOGDEBUG, "CGUIFontGlyphCache: loaded {} glyphs from {}", glyphCount, path);
+  return true;
+}
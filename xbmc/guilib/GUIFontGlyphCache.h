@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Process wide cache of rasterized glyphs.
+
+ Fonts rasterize each glyph they use into their own texture. The bitmaps are kept here, so that
+ fonts loaded again for the same face and size, e.g. on a skin reload or by another font
+ definition of the skin, copy them instead of rasterizing them again. The cache can be saved to
+ and loaded from a file to survive restarts.
+ */
+class CGUIFontGlyphCache
+{
+public:
+  struct Glyph
+  {
+    int left = 0;                ///< offset of the bitmap from the pen position
+    int top = 0;                 ///< offset of the top row from the base line, upwards
+    unsigned int width = 0;
+    unsigned int rows = 0;
+    long advance = 0;            ///< horizontal advance in 26.6 fixed point
+    std::vector<uint8_t> pixels; ///< 8bit alpha, width bytes per row
+  };
+  typedef std::shared_ptr<const Glyph> GlyphPtr;
+
+  struct Stats
+  {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t glyphs = 0;
+    size_t bytes = 0;
+  };
+
+  static constexpr size_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+  explicit CGUIFontGlyphCache(size_t maxBytes = DEFAULT_MAX_BYTES);
+
+  static CGUIFontGlyphCache& GetInstance();
+
+  /*! \brief Get the id of a face
+   \param face identifies the font file and everything else the bitmaps depend on, like size and
+   border
+   \return the id, the same for the same face as long as the process runs
+   */
+  unsigned int GetFaceId(const std::string& face);
+
+  /*! \brief Get a cached glyph
+   \return the glyph, or nullptr if it wasn't cached
+   */
+  GlyphPtr Get(unsigned int faceId, uint32_t style, uint32_t glyphIndex);
+
+  /*! \brief Add a rasterized glyph
+   Drops all glyphs first if the cache would exceed its size.
+   */
+  void Add(unsigned int faceId, uint32_t style, uint32_t glyphIndex, const GlyphPtr& glyph);
+
+  Stats GetStats() const;
+
+  /*! \brief Drop all glyphs, face ids stay valid
+   */
+  void Clear();
+
+  /*! \brief Save the glyphs if any were added since the last Load() or Save()
+   */
+  bool Save(const std::string& path);
+
+  /*! \brief Add the glyphs saved to a file
+   */
+  bool Load(const std::string& path);
+
+private:
+  static uint64_t GetKey(unsigned int faceId, uint32_t style, uint32_t glyphIndex)
+  {
+    return (static_cast<uint64_t>(faceId) << 40) | (static_cast<uint64_t>(style & 0xff) << 32) |
+           glyphIndex;
+  }
+
+  void AddInternal(uint64_t key, const GlyphPtr& glyph);
+
+  mutable CCriticalSection m_critSection;
+  std::vector<std::string> m_faces;
+  std::unordered_map<std::string, unsigned int> m_faceIds;
+  std::unordered_map<uint64_t, GlyphPtr> m_glyphs;
+  size_t m_maxBytes;
+  size_t m_bytes = 0;
+  bool m_modified = false;
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+};
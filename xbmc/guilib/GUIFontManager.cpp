@@ -18,10 +18,13 @@
 #include "GUIFontTTFGL.h"
 #endif
 #include "GUIFont.h"
+#include "GUIFontGlyphCache.h"
 #include "utils/XMLUtils.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
 #include "settings/lib/SettingDefinitions.h"
 #include "utils/log.h"
@@ -37,6 +40,11 @@
 
 using namespace ADDON;
 
+namespace
+{
+const std::string GLYPH_CACHE_FILE = "special://temp/glyphcache.bin";
+}
+
 GUIFontManager::GUIFontManager(void)
 {
   m_canReload = true;
@@ -333,6 +341,16 @@ CGUIFont* GUIFontManager::GetDefaultFont(bool border)
 
 void GUIFontManager::Clear()
 {
+  if (!m_vecFontFiles.empty())
+  {
+    CGUIFontGlyphCache& glyphCache = CGUIFontGlyphCache::GetInstance();
+    const CGUIFontGlyphCache::Stats stats = glyphCache.GetStats();
+    CLog::Log(LOGDEBUG, "GUIFontManager: glyph cache hits {} misses {}, {} glyphs in {} bytes",
+              stats.hits, stats.misses, stats.glyphs, stats.bytes);
+    if (IsGlyphCachePersistent())
+      glyphCache.Save(GLYPH_CACHE_FILE);
+  }
+
   for (int i = 0; i < (int)m_vecFonts.size(); ++i)
   {
     CGUIFont* pFont = m_vecFonts[i];
@@ -350,6 +368,12 @@ void GUIFontManager::Clear()
 
 void GUIFontManager::LoadFonts(const std::string& fontSet)
 {
+  if (!m_glyphCacheLoaded && IsGlyphCachePersistent())
+  {
+    CGUIFontGlyphCache::GetInstance().Load(GLYPH_CACHE_FILE);
+    m_glyphCacheLoaded = true;
+  }
+
   // Get the file to load fonts from:
   const std::string strPath = g_SkinInfo->GetSkinPath("Font.xml", &m_skinResolution);
   CLog::Log(LOGINFO, "Loading fonts from %s", strPath.c_str());
@@ -460,6 +484,13 @@ void GUIFontManager::GetStyle(const TiXmlNode *fontNode, int &iStyle)
   }
 }
 
+bool GUIFontManager::IsGlyphCachePersistent()
+{
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  return settingsComponent && settingsComponent->GetAdvancedSettings() &&
+         settingsComponent->GetAdvancedSettings()->m_guiPersistGlyphCache;
+}
+
 void GUIFontManager::SettingOptionsFontsFiller(const SettingConstPtr& setting,
                                                std::vector<StringSettingOption>& list,
                                                std::string& current,
@@ -77,12 +77,14 @@ protected:
   void LoadFonts(const TiXmlNode* fontNode);
   CGUIFontTTF* GetFontFile(const std::string& strFontFile);
   static void GetStyle(const TiXmlNode *fontNode, int &iStyle);
+  static bool IsGlyphCachePersistent();
 
   std::vector<CGUIFont*> m_vecFonts;
   std::vector<CGUIFontTTF*> m_vecFontFiles;
   std::vector<OrigFontInfo> m_vecFontInfo;
   RESOLUTION_INFO m_skinResolution;
   bool m_canReload;
+  bool m_glyphCacheLoaded = false;
 };
 
 /*!
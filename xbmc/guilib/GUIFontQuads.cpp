@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontQuads.h"
+
+#include "GUIFontTTF.h"
+#include "utils/MathUtils.h"
+#include "utils/TransformMatrix.h"
+
+#if defined(HAS_GL) || defined(HAS_GLES)
+#include "system_gl.h"
+#endif
+
+#if defined(HAS_DX)
+#include "guilib/D3DResource.h"
+#endif
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+
+/*! \brief Transform the corners x1,y1 x2,y1 x2,y2 x1,y2 of a rect at z = 0
+ */
+inline void TransformCorners(
+    const TransformMatrix& m, const CRect& rect, float* x, float* y, float* z)
+{
+#if defined(HAVE_SSE) && defined(__SSE__)
+  const __m128 cornersX = _mm_setr_ps(rect.x1, rect.x2, rect.x2, rect.x1);
+  const __m128 cornersY = _mm_setr_ps(rect.y1, rect.y1, rect.y2, rect.y2);
+  const float* rows[3] = {m.m[0], m.m[1], m.m[2]};
+  float* results[3] = {x, y, z};
+  for (int i = 0; i < 3; ++i)
+  {
+    const __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(rows[i][0]), cornersX),
+                                                _mm_mul_ps(_mm_set1_ps(rows[i][1]), cornersY)),
+                                     _mm_set1_ps(rows[i][3]));
+    _mm_storeu_ps(results[i], result);
+  }
+#else
+  const float cornersX[4] = {rect.x1, rect.x2, rect.x2, rect.x1};
+  const float cornersY[4] = {rect.y1, rect.y1, rect.y2, rect.y2};
+  for (int i = 0; i < 4; ++i)
+  {
+    x[i] = m.TransformXCoord(cornersX[i], cornersY[i], 0);
+    y[i] = m.TransformYCoord(cornersX[i], cornersY[i], 0);
+    z[i] = m.TransformZCoord(cornersX[i], cornersY[i], 0);
+  }
+#endif
+}
+
+} // unnamed namespace
+
+void CGUIFontQuads::GenerateVertices(const TransformMatrix& matrix,
+                                     float textureScaleX,
+                                     float textureScaleY,
+                                     bool roundX,
+                                     std::vector<SVertex>& vertices) const
+{
+  const size_t first = vertices.size();
+  vertices.resize(first + 4 * m_quads.size());
+  SVertex* v = vertices.data() + first;
+
+  for (const auto& quad : m_quads)
+  {
+    float x[4], y[4], z[4];
+    TransformCorners(matrix, quad.vertex, x, y, z);
+
+    if (roundX)
+    {
+      // We only round the "left" side of the character, and then use the direction of rounding to
+      // move the "right" side of the character.  This ensures that a constant width is kept when rendering
+      // the same letter at the same size at different places of the screen, avoiding the problem
+      // of the "left" side rounding one way while the "right" side rounds the other way, thus getting
+      // altering the width of thin characters substantially.  This only really works for positive
+      // coordinates (due to the direction of truncation for negatives) but this is the only case that
+      // really interests us anyway.
+      float rx0 = (float)MathUtils::round_int(x[0]);
+      float rx3 = (float)MathUtils::round_int(x[3]);
+      x[1] = (float)MathUtils::truncate_int(x[1]);
+      x[2] = (float)MathUtils::truncate_int(x[2]);
+      if (x[0] > 0.0f && rx0 > x[0])
+        x[1] += 1;
+      else if (x[0] < 0.0f && rx0 < x[0])
+        x[1] -= 1;
+      if (x[3] > 0.0f && rx3 > x[3])
+        x[2] += 1;
+      else if (x[3] < 0.0f && rx3 < x[3])
+        x[2] -= 1;
+      x[0] = rx0;
+      x[3] = rx3;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+      y[i] = (float)MathUtils::round_int(y[i]);
+      z[i] = (float)MathUtils::round_int(z[i]);
+    }
+
+    // tex coords converted to 0..1 range
+    float tl = quad.texture.x1 * textureScaleX;
+    float tr = quad.texture.x2 * textureScaleX;
+    float tt = quad.texture.y1 * textureScaleY;
+    float tb = quad.texture.y2 * textureScaleY;
+
+#if defined(HAS_DX)
+    for (int i = 0; i < 4; i++)
+    {
+      CD3DHelper::XMStoreColor(&v[i].col, quad.color);
+      v[i].x = x[i];
+      v[i].y = y[i];
+      v[i].z = z[i];
+    }
+
+    v[0].u = tl;
+    v[0].v = tt;
+
+    v[1].u = tr;
+    v[1].v = tt;
+
+    v[2].u = tr;
+    v[2].v = tb;
+
+    v[3].u = tl;
+    v[3].v = tb;
+#else
+    unsigned char r = GET_R(quad.color)
+                , g = GET_G(quad.color)
+                , b = GET_B(quad.color)
+                , a = GET_A(quad.color);
+
+    for (int i = 0; i < 4; i++)
+    {
+      v[i].r = r;
+      v[i].g = g;
+      v[i].b = b;
+      v[i].a = a;
+    }
+
+    // GL / GLES uses triangle strips, not quads, so have to rearrange the vertex order
+    v[0].u = tl;
+    v[0].v = tt;
+    v[0].x = x[0];
+    v[0].y = y[0];
+    v[0].z = z[0];
+
+    v[1].u = tl;
+    v[1].v = tb;
+    v[1].x = x[3];
+    v[1].y = y[3];
+    v[1].z = z[3];
+
+    v[2].u = tr;
+    v[2].v = tt;
+    v[2].x = x[1];
+    v[2].y = y[1];
+    v[2].z = z[1];
+
+    v[3].u = tr;
+    v[3].v = tb;
+    v[3].x = x[2];
+    v[3].y = y[2];
+    v[3].z = z[2];
+#endif
+    v += 4;
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Color.h"
+#include "utils/Geometry.h"
+
+#include <vector>
+
+class TransformMatrix;
+struct SVertex;
+
+/*!
+ \ingroup textures
+ \brief Glyph quads of the text laid out by a font, waiting for their vertices.
+
+ Laying out a string queues a quad per visible character. The vertices of all of them are then
+ generated in one pass with the final transform, instead of transforming each corner of each
+ character separately. The quads are cleared after each string, the memory is kept for the
+ strings that follow.
+ */
+class CGUIFontQuads
+{
+public:
+  struct Quad
+  {
+    CRect vertex;  ///< in GUI coordinates, before the final transform
+    CRect texture; ///< in texels
+    UTILS::Color color;
+  };
+
+  CGUIFontQuads() { m_quads.reserve(1024); }
+
+  void Add(const CRect& vertex, const CRect& texture, UTILS::Color color)
+  {
+    m_quads.push_back({vertex, texture, color});
+  }
+
+  void Clear() { m_quads.clear(); }
+  bool Empty() const { return m_quads.empty(); }
+  size_t Size() const { return m_quads.size(); }
+
+  /*! \brief Append four vertices per quad
+   \param matrix the final transform, like CGraphicContext::GetGUIMatrix()
+   \param textureScaleX converts texels to texture coordinates
+   \param textureScaleY converts texels to texture coordinates
+   \param roundX round the left edge to whole pixels and keep the width of the quad
+   \param vertices the vertices to append to, ordered as the render system draws them
+   */
+  void GenerateVertices(const TransformMatrix& matrix,
+                        float textureScaleX,
+                        float textureScaleY,
+                        bool roundX,
+                        std::vector<SVertex>& vertices) const;
+
+private:
+  std::vector<Quad> m_quads;
+};
@@ -14,6 +14,7 @@
 #include "ServiceBroker.h"
 #include "filesystem/SpecialProtocol.h"
 #include "utils/MathUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
 #include "windowing/WinSystem.h"
@@ -21,9 +22,9 @@
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
 
+#include <cstring>
 #include <math.h>
 #include <memory>
-#include <queue>
 
 // stuff for freetype
 #include <ft2build.h>
@@ -310,6 +311,14 @@ bool CGUIFontTTF::Load(
 
   m_strFilename = strFilename;
 
+  // glyphs are shared with all fonts rendered from the same file, size and border
+  struct __stat64 fileStat = {};
+  XFILE::CFile::Stat(strFilename, &fileStat);
+  m_glyphFaceId = CGUIFontGlyphCache::GetInstance().GetFaceId(StringUtils::Format(
+      "{}|{}|{}|{}|{}|{}|{}.{}.{}", strFilename, static_cast<int>(height * 64 + 0.5f),
+      MathUtils::round_int(72 * aspect), border, static_cast<int64_t>(fileStat.st_size),
+      static_cast<int64_t>(fileStat.st_mtime), FREETYPE_MAJOR, FREETYPE_MINOR, FREETYPE_PATCH));
+
   m_textureHeight = 0;
   m_textureWidth = ((m_cellHeight * CHARS_PER_TEXTURE_LINE) & ~63) + 64;
 
@@ -387,9 +396,9 @@ void CGUIFontTTF::DrawTextInternal(float x,
                             XbmcThreads::SystemClockMillis(),
                             dirtyCache) :
       unusedVertexBuffer;
-  std::shared_ptr<std::vector<SVertex> > tempVertices = std::make_shared<std::vector<SVertex> >();
+  std::shared_ptr<std::vector<SVertex> > unusedVertices;
   std::shared_ptr<std::vector<SVertex> > &vertices = hardwareClipping ?
-      tempVertices :
+      unusedVertices :
       static_cast<std::shared_ptr<std::vector<SVertex> >&>(m_staticCache.Lookup(staticPos,
                            colors, text,
                            alignment, maxPixelWidth,
@@ -457,7 +466,8 @@ void CGUIFontTTF::DrawTextInternal(float x,
     // Collect all the Character info in a first pass, in case any of them
     // are not currently cached and cause the texture to be enlarged, which
     // would invalidate the texture coordinates.
-    std::queue<Character> characters;
+    std::vector<Character>& characters = m_layoutCharacters;
+    characters.clear();
     if (alignment & XBFONT_TRUNCATED)
       GetCharacter(L'.');
     for (const auto& pos : text)
@@ -466,10 +476,10 @@ void CGUIFontTTF::DrawTextInternal(float x,
       if (!ch)
       {
         Character null = { 0 };
-        characters.push(null);
+        characters.push_back(null);
         continue;
       }
-      characters.push(*ch);
+      characters.push_back(*ch);
 
       if (maxPixelWidth > 0 &&
           cursorX + ((alignment & XBFONT_TRUNCATED) ? ch->advance + 3 * m_ellipsesWidth : 0) > maxPixelWidth)
@@ -477,7 +487,9 @@ void CGUIFontTTF::DrawTextInternal(float x,
       cursorX += ch->advance;
     }
     cursorX = 0;
+    m_quads.Clear();
 
+    size_t nextCharacter = 0;
     for (const auto& pos : text)
     {
       // If starting text on a new line, determine justification effects
@@ -488,12 +500,11 @@ void CGUIFontTTF::DrawTextInternal(float x,
       color = colors[color];
 
       // grab the next character
-      Character *ch = &characters.front();
+      if (nextCharacter == characters.size())
+        break;
+      const Character* ch = &characters[nextCharacter++];
       if (ch->letterAndStyle == 0)
-      {
-        characters.pop();
         continue;
-      }
 
       if ( alignment & XBFONT_TRUNCATED )
       {
@@ -508,7 +519,7 @@ void CGUIFontTTF::DrawTextInternal(float x,
 
           for (int i = 0; i < 3; i++)
           {
-            RenderCharacter(startX + cursorX, startY, period, color, !scrolling, *tempVertices);
+            RenderCharacter(startX + cursorX, startY, period, color);
             cursorX += period->advance;
           }
           break;
@@ -517,7 +528,7 @@ void CGUIFontTTF::DrawTextInternal(float x,
       else if (maxPixelWidth > 0 && cursorX > maxPixelWidth)
         break;  // exceeded max allowed width - stop rendering
 
-      RenderCharacter(startX + cursorX, startY, ch, color, !scrolling, *tempVertices);
+      RenderCharacter(startX + cursorX, startY, ch, color);
       if ( alignment & XBFONT_JUSTIFIED )
       {
         if ((pos & 0xffff) == L' ')
@@ -527,8 +538,9 @@ void CGUIFontTTF::DrawTextInternal(float x,
       }
       else
         cursorX += ch->advance;
-      characters.pop();
     }
+
+    const TransformMatrix& matrix = CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIMatrix();
     if (hardwareClipping)
     {
       CVertexBuffer &vertexBuffer = m_dynamicCache.Lookup(dynamicPos,
@@ -537,21 +549,28 @@ void CGUIFontTTF::DrawTextInternal(float x,
                                                           scrolling,
                                                           XbmcThreads::SystemClockMillis(),
                                                           dirtyCache);
-      CVertexBuffer newVertexBuffer = CreateVertexBuffer(*tempVertices);
+      m_layoutVertices.clear();
+      m_quads.GenerateVertices(matrix, m_textureScaleX, m_textureScaleY, !scrolling,
+                               m_layoutVertices);
+      CVertexBuffer newVertexBuffer = CreateVertexBuffer(m_layoutVertices);
       vertexBuffer = newVertexBuffer;
       m_vertexTrans.emplace_back(0, 0, 0, &vertexBuffer,
                                  CServiceBroker::GetWinSystem()->GetGfxContext().GetClipRegion());
     }
     else
     {
+      auto newVertices = std::make_shared<std::vector<SVertex>>();
+      newVertices->reserve(4 * m_quads.Size());
+      m_quads.GenerateVertices(matrix, m_textureScaleX, m_textureScaleY, !scrolling,
+                               *newVertices);
       m_staticCache.Lookup(staticPos,
                            colors, text,
                            rawAlignment, maxPixelWidth,
                            scrolling,
                            XbmcThreads::SystemClockMillis(),
-                           dirtyCache) = *static_cast<CGUIFontCacheStaticValue *>(&tempVertices);
+                           dirtyCache) = *static_cast<CGUIFontCacheStaticValue *>(&newVertices);
       /* Append the new vertices to the set collected since the first Begin() call */
-      m_vertex.insert(m_vertex.end(), tempVertices->begin(), tempVertices->end());
+      m_vertex.insert(m_vertex.end(), newVertices->begin(), newVertices->end());
     }
   }
   else
@@ -701,15 +720,15 @@ CGUIFontTTF::Character* CGUIFontTTF::GetCharacter(character_t chr)
   return m_char + low;
 }
 
-bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
+CGUIFontGlyphCache::GlyphPtr CGUIFontTTF::RenderGlyph(wchar_t letter,
+                                                      uint32_t style,
+                                                      unsigned int glyphIndex)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
-
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (FT_Load_Glyph( m_face, glyphIndex, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    return nullptr;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
@@ -724,7 +743,7 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
   if (FT_Get_Glyph(m_face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    return nullptr;
   }
   if (m_stroker)
     FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
@@ -732,25 +751,61 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, static_cast<uint32_t>(letter));
-    return false;
+    FT_Done_Glyph(glyph);
+    return nullptr;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
+  const FT_Bitmap& bitmap = bitGlyph->bitmap;
+
+  // keep a tightly packed copy of the bitmap
+  auto result = std::make_shared<CGUIFontGlyphCache::Glyph>();
+  result->left = bitGlyph->left;
+  result->top = bitGlyph->top;
+  result->width = bitmap.width;
+  result->rows = bitmap.rows;
+  result->advance = m_face->glyph->advance.x;
+  result->pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+  // negative pitches store the rows bottom up
+  const unsigned char* source = bitmap.buffer;
+  if (bitmap.pitch < 0 && bitmap.rows > 0)
+    source -= static_cast<ptrdiff_t>(bitmap.rows - 1) * bitmap.pitch;
+  for (unsigned int row = 0; row < bitmap.rows; ++row, source += bitmap.pitch)
+    memcpy(result->pixels.data() + row * bitmap.width, source, bitmap.width);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return result;
+}
+
+bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
+{
+  const unsigned int glyphIndex = FT_Get_Char_Index( m_face, letter );
+
+  CGUIFontGlyphCache& glyphCache = CGUIFontGlyphCache::GetInstance();
+  CGUIFontGlyphCache::GlyphPtr glyph = glyphCache.Get(m_glyphFaceId, style, glyphIndex);
+  if (!glyph)
+  {
+    glyph = RenderGlyph(letter, style, glyphIndex);
+    if (!glyph)
+      return false;
+    glyphCache.Add(m_glyphFaceId, style, glyphIndex, glyph);
+  }
+
+  bool isEmptyGlyph = (glyph->width == 0 || glyph->rows == 0);
 
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (glyph->left < 0)
+      m_posX += -glyph->left;
 
     // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
+    if (static_cast<int>(m_posX + glyph->left + glyph->width) > static_cast<int>(m_textureWidth))
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (glyph->left < 0)
+        m_posX += -glyph->left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -760,7 +815,6 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
         if (newHeight > m_renderSystem->GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -768,7 +822,6 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -778,47 +831,52 @@ bool CGUIFontTTF::CacheCharacter(wchar_t letter, uint32_t style, Character* ch)
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
   ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->offsetX = (short)glyph->left;
+  ch->offsetY = (short)m_cellBaseLine - glyph->top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->right = ch->left + glyph->width;
+  ch->bottom = ch->top + glyph->rows;
+  ch->advance = (float)MathUtils::round_int( (float)glyph->advance / 64 );
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
+    // the texture backends copy from a freetype bitmap
+    FT_BitmapGlyphRec bitGlyph = {};
+    bitGlyph.left = glyph->left;
+    bitGlyph.top = glyph->top;
+    bitGlyph.bitmap.width = glyph->width;
+    bitGlyph.bitmap.rows = glyph->rows;
+    bitGlyph.bitmap.pitch = glyph->width;
+    bitGlyph.bitmap.buffer = const_cast<unsigned char*>(glyph->pixels.data());
+    bitGlyph.bitmap.num_grays = 256;
+    bitGlyph.bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
     unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    unsigned int x2 = std::min(x1 + glyph->width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + glyph->rows, m_textureHeight);
+    CopyCharToTexture(&bitGlyph, x1, y1, x2, y2);
 
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
   m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
-
   return true;
 }
 
 void CGUIFontTTF::RenderCharacter(float posX,
                                   float posY,
                                   const Character* ch,
-                                  UTILS::Color color,
-                                  bool roundX,
-                                  std::vector<SVertex>& vertices)
+                                  UTILS::Color color)
 {
   // actual image width isn't same as the character width as that is
   // just baseline width and height should include the descent
@@ -829,134 +887,22 @@ void CGUIFontTTF::RenderCharacter(float posX,
   if (width == 0 || height == 0)
     return;
 
+  CGraphicContext& context = CServiceBroker::GetWinSystem()->GetGfxContext();
+
   // posX and posY are relative to our origin, and the textcell is offset
   // from our (posX, posY).  Plus, these are unscaled quantities compared to the underlying GUI resolution
-  CRect vertex((posX + ch->offsetX) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(),
-               (posY + ch->offsetY) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY(),
-               (posX + ch->offsetX + width) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleX(),
-               (posY + ch->offsetY + height) * CServiceBroker::GetWinSystem()->GetGfxContext().GetGUIScaleY());
+  CRect vertex((posX + ch->offsetX) * context.GetGUIScaleX(),
+               (posY + ch->offsetY) * context.GetGUIScaleY(),
+               (posX + ch->offsetX + width) * context.GetGUIScaleX(),
+               (posY + ch->offsetY + height) * context.GetGUIScaleY());
   vertex += CPoint(m_originX, m_originY);
   CRect texture(ch->left, ch->top, ch->right, ch->bottom);
   if (!m_renderSystem->ScissorsCanEffectClipping())
-    CServiceBroker::GetWinSystem()->GetGfxContext().ClipRect(vertex, texture);
-
-  // transform our positions - note, no scaling due to GUI calibration/resolution occurs
-  float x[4], y[4], z[4];
-
-  x[0] = CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalXCoord(vertex.x1, vertex.y1);
-  x[1] = CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalXCoord(vertex.x2, vertex.y1);
-  x[2] = CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalXCoord(vertex.x2, vertex.y2);
-  x[3] = CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalXCoord(vertex.x1, vertex.y2);
-
-  if (roundX)
-  {
-    // We only round the "left" side of the character, and then use the direction of rounding to
-    // move the "right" side of the character.  This ensures that a constant width is kept when rendering
-    // the same letter at the same size at different places of the screen, avoiding the problem
-    // of the "left" side rounding one way while the "right" side rounds the other way, thus getting
-    // altering the width of thin characters substantially.  This only really works for positive
-    // coordinates (due to the direction of truncation for negatives) but this is the only case that
-    // really interests us anyway.
-    float rx0 = (float)MathUtils::round_int(x[0]);
-    float rx3 = (float)MathUtils::round_int(x[3]);
-    x[1] = (float)MathUtils::truncate_int(x[1]);
-    x[2] = (float)MathUtils::truncate_int(x[2]);
-    if (x[0] > 0.0f && rx0 > x[0])
-      x[1] += 1;
-    else if (x[0] < 0.0f && rx0 < x[0])
-      x[1] -= 1;
-    if (x[3] > 0.0f && rx3 > x[3])
-      x[2] += 1;
-    else if (x[3] < 0.0f && rx3 < x[3])
-      x[2] -= 1;
-    x[0] = rx0;
-    x[3] = rx3;
-  }
-
-  y[0] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalYCoord(vertex.x1, vertex.y1));
-  y[1] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalYCoord(vertex.x2, vertex.y1));
-  y[2] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalYCoord(vertex.x2, vertex.y2));
-  y[3] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalYCoord(vertex.x1, vertex.y2));
-
-  z[0] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalZCoord(vertex.x1, vertex.y1));
-  z[1] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalZCoord(vertex.x2, vertex.y1));
-  z[2] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalZCoord(vertex.x2, vertex.y2));
-  z[3] = (float)MathUtils::round_int(CServiceBroker::GetWinSystem()->GetGfxContext().ScaleFinalZCoord(vertex.x1, vertex.y2));
-
-  // tex coords converted to 0..1 range
-  float tl = texture.x1 * m_textureScaleX;
-  float tr = texture.x2 * m_textureScaleX;
-  float tt = texture.y1 * m_textureScaleY;
-  float tb = texture.y2 * m_textureScaleY;
+    context.ClipRect(vertex, texture);
 
-  vertices.resize(vertices.size() + 4);
-  SVertex* v = &vertices[vertices.size() - 4];
+  // the vertices are generated for all characters of the text at once
+  m_quads.Add(vertex, texture, color);
   m_color = color;
-
-#if !defined(HAS_DX)
-  unsigned char r = GET_R(color)
-              , g = GET_G(color)
-              , b = GET_B(color)
-              , a = GET_A(color);
-#endif
-
-  for(int i = 0; i < 4; i++)
-  {
-#ifdef HAS_DX
-    CD3DHelper::XMStoreColor(&v[i].col, color);
-#else
-    v[i].r = r;
-    v[i].g = g;
-    v[i].b = b;
-    v[i].a = a;
-#endif
-  }
-
-#if defined(HAS_DX)
-  for(int i = 0; i < 4; i++)
-  {
-    v[i].x = x[i];
-    v[i].y = y[i];
-    v[i].z = z[i];
-  }
-
-  v[0].u = tl;
-  v[0].v = tt;
-
-  v[1].u = tr;
-  v[1].v = tt;
-
-  v[2].u = tr;
-  v[2].v = tb;
-
-  v[3].u = tl;
-  v[3].v = tb;
-#else
-  // GL / GLES uses triangle strips, not quads, so have to rearrange the vertex order
-  v[0].u = tl;
-  v[0].v = tt;
-  v[0].x = x[0];
-  v[0].y = y[0];
-  v[0].z = z[0];
-
-  v[1].u = tl;
-  v[1].v = tb;
-  v[1].x = x[3];
-  v[1].y = y[3];
-  v[1].z = z[3];
-
-  v[2].u = tr;
-  v[2].v = tt;
-  v[2].x = x[1];
-  v[2].y = y[1];
-  v[2].z = z[1];
-
-  v[3].u = tr;
-  v[3].v = tb;
-  v[3].x = x[2];
-  v[3].y = y[2];
-  v[3].z = z[2];
-#endif
 }
 
 // Oblique code - original taken from freetype2 (ftsynth.c)
@@ -12,6 +12,8 @@
 #include <stdint.h>
 #include <vector>
 
+#include "GUIFontGlyphCache.h"
+#include "GUIFontQuads.h"
 #include "utils/auto_buffer.h"
 #include "utils/Color.h"
 #include "utils/Geometry.h"
@@ -114,7 +116,8 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
-  void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
+  CGUIFontGlyphCache::GlyphPtr RenderGlyph(wchar_t letter, uint32_t style, unsigned int glyphIndex);
+  void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color);
   void ClearCharacterCache();
 
   virtual CTexture* ReallocTexture(unsigned int& newHeight) = 0;
@@ -155,6 +158,7 @@ protected:
   // freetype stuff
   FT_Face    m_face;
   FT_Stroker m_stroker;
+  unsigned int m_glyphFaceId = 0; // face of our glyphs in the glyph cache
 
   float m_originX;
   float m_originY;
@@ -173,6 +177,11 @@ protected:
   std::vector<CTranslatedVertices> m_vertexTrans;
   std::vector<SVertex> m_vertex;
 
+  // reused while laying out text, to avoid allocations for each string
+  std::vector<Character> m_layoutCharacters;
+  CGUIFontQuads m_quads;
+  std::vector<SVertex> m_layoutVertices;
+
   float    m_textureScaleX;
   float    m_textureScaleY;
 
@@ -138,7 +138,8 @@ void CGUIFontTTFGL::LastEnd()
   {
 
     // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices(6 * (m_vertex.size() / 4));
+    std::vector<SVertex>& vecVertices = m_triangleVertices;
+    vecVertices.resize(6 * (m_vertex.size() / 4));
     SVertex *vertices = &vecVertices[0];
     for (size_t i=0; i<m_vertex.size(); i+=4)
     {
@@ -192,7 +193,8 @@ void CGUIFontTTFGL::LastEnd()
   if (!m_vertex.empty())
   {
     // Deal with vertices that had to use software clipping
-    std::vector<SVertex> vecVertices( 6 * (m_vertex.size() / 4) );
+    std::vector<SVertex>& vecVertices = m_triangleVertices;
+    vecVertices.resize(6 * (m_vertex.size() / 4));
     SVertex *vertices = &vecVertices[0];
 
     for (size_t i=0; i<m_vertex.size(); i+=4)
@@ -50,6 +50,9 @@ private:
 
   TextureStatus m_textureStatus;
 
+  // the software clipped vertices as triangles, kept to avoid an allocation each frame
+  std::vector<SVertex> m_triangleVertices;
+
   static bool m_staticVertexBufferCreated;
 };
 
@@ -388,11 +388,16 @@ void CGUIWindow::Close_Internal(bool forceClose /*= false*/, int nextWindowID /*
       // Perform the window out effect
       QueueAnimation(ANIM_TYPE_WINDOW_CLOSE);
       m_closing = true;
+      CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
     }
     return;
   }
 
-  m_closing = false;
+  if (m_closing)
+  {
+    m_closing = false;
+    CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
+  }
   CGUIMessage msg(GUI_MSG_WINDOW_DEINIT, 0, 0, nextWindowID);
   OnMessage(msg);
 }
@@ -534,7 +539,11 @@ void CGUIWindow::OnInitWindow()
 
   // set our rendered state
   m_hasProcessed = false;
-  m_closing = false;
+  if (m_closing)
+  {
+    m_closing = false;
+    CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
+  }
   m_active = true;
   ResetAnimations();  // we need to reset our animations as those windows that don't dynamically allocate
                       // need their anims reset. An alternative solution is turning off all non-dynamic
@@ -872,6 +881,9 @@ bool CGUIWindow::Animate(unsigned int currentTime)
 void CGUIWindow::DisableAnimations()
 {
   m_animationsEnabled = false;
+  // a closing window isn't animating anymore
+  if (m_closing)
+    CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
 }
 
 // returns true if the control group with id groupID has controlID as
@@ -981,6 +993,8 @@ void CGUIWindow::SetDefaults()
   m_origins.clear();
   m_hasCamera = false;
   m_stereo = 0.f;
+  if (m_closing && !m_animationsEnabled)
+    CServiceBroker::GetGUI()->GetWindowManager().OnStackChanged();
   m_animationsEnabled = true;
   m_clearBackground = 0xff000000; // opaque black -> clear
   m_hitRect.SetRect(0, 0, static_cast<float>(m_coordsRes.iWidth), static_cast<float>(m_coordsRes.iHeight));
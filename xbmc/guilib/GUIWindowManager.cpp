@@ -611,6 +611,7 @@ void CGUIWindowManager::RegisterDialog(CGUIWindow* dialog)
       return;
   }
   m_activeDialogs.emplace_back(dialog);
+  OnStackChanged();
 }
 
 void CGUIWindowManager::Remove(int id)
@@ -630,6 +631,7 @@ void CGUIWindowManager::Remove(int id)
                                          [window](CGUIWindow* w){ return w == window; }),
                           m_activeDialogs.end());
     m_mapWindows.erase(it);
+    OnStackChanged();
   }
   else
   {
@@ -712,6 +714,7 @@ void CGUIWindowManager::PreviousWindow()
 
   // remove the current window off our window stack
   m_windowHistory.pop_back();
+  OnStackChanged();
 
   // ok, initialize the new window
   CLog::Log(LOGDEBUG,"CGUIWindowManager::PreviousWindow: Activate new");
@@ -1354,6 +1357,7 @@ void CGUIWindowManager::DeInitialize()
   // clear our vectors of windows
   m_vecCustomWindows.clear();
   m_activeDialogs.clear();
+  OnStackChanged();
 
   m_initialized = false;
 }
@@ -1367,6 +1371,7 @@ void CGUIWindowManager::RemoveDialog(int id)
                                        m_activeDialogs.end(),
                                        [id](CGUIWindow* dialog) { return dialog->GetID() == id; }),
                          m_activeDialogs.end());
+  OnStackChanged();
 }
 
 bool CGUIWindowManager::HasModalDialog(bool ignoreClosing) const
@@ -1603,6 +1608,7 @@ void CGUIWindowManager::AddToWindowHistory(int newWindowID)
     // didn't find window in history - add it to the stack
     m_windowHistory.emplace_back(newWindowID);
   }
+  OnStackChanged();
 }
 
 void CGUIWindowManager::RemoveFromWindowHistory(int windowID)
@@ -1622,6 +1628,7 @@ void CGUIWindowManager::RemoveFromWindowHistory(int windowID)
   {
     history.pop_back(); // remove window from stack
     m_windowHistory.swap(history);
+    OnStackChanged();
   }
 }
 
@@ -1668,6 +1675,7 @@ void CGUIWindowManager::ClearWindowHistory()
 {
   while (!m_windowHistory.empty())
     m_windowHistory.pop_back();
+  OnStackChanged();
 }
 
 void CGUIWindowManager::CloseWindowSync(CGUIWindow *window, int nextWindowID /*= 0*/)
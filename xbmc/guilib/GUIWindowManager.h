@@ -15,6 +15,7 @@
 #include "guilib/WindowIDs.h"
 #include "messaging/IMessageTarget.h"
 
+#include <atomic>
 #include <list>
 #include <unordered_map>
 #include <utility>
@@ -211,6 +212,17 @@ public:
 
   bool HasVisibleControls();
 
+  /*! \brief Get the version of the window stack
+   \return the version, increased whenever the active window, the active dialogs or whether a
+   dialog is closing may have changed
+   */
+  unsigned int GetStackVersion() const { return m_stackVersion; }
+
+  /*! \brief Called when a window starts or stops closing, to increase the stack version
+   \sa GetStackVersion
+   */
+  void OnStackChanged() { ++m_stackVersion; }
+
 #ifdef _DEBUG
   void DumpTextureUse();
 #endif
@@ -264,6 +276,7 @@ private:
   bool m_initialized;
   mutable bool m_touchGestureActive{false};
   mutable bool m_inhibitTouchGestureEvents{false};
+  std::atomic<unsigned int> m_stackVersion{0};
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
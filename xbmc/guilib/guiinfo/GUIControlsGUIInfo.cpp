@@ -811,3 +811,27 @@ bool CGUIControlsGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int co
 
   return false;
 }
+
+bool CGUIControlsGUIInfo::IsVersioned(const CGUIInfo& info) const
+{
+  // the infos that only depend on the window stack, not on controls or animations
+  switch (info.m_info)
+  {
+    case WINDOW_IS_MEDIA:
+    case WINDOW_IS:
+    case WINDOW_IS_VISIBLE:
+    case WINDOW_IS_ACTIVE:
+    case WINDOW_IS_DIALOG_TOPMOST:
+    case WINDOW_IS_MODAL_DIALOG_TOPMOST:
+    case SYSTEM_HAS_ACTIVE_MODAL_DIALOG:
+    case SYSTEM_HAS_VISIBLE_MODAL_DIALOG:
+      return true;
+  }
+  // WINDOW_NEXT and WINDOW_PREVIOUS are set around the window stack changes
+  return false;
+}
+
+unsigned int CGUIControlsGUIInfo::GetVersion() const
+{
+  return CServiceBroker::GetGUI()->GetWindowManager().GetStackVersion();
+}
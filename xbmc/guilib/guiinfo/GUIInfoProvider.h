@@ -35,6 +35,10 @@ public:
     return false;
   }
 
+  bool IsVersioned(const CGUIInfo& info) const override { return false; }
+
+  unsigned int GetVersion() const override { return 0; }
+
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo) override
   { m_audioInfo = audioInfo, m_videoInfo = videoInfo, m_subtitleInfo = subtitleInfo; }
 
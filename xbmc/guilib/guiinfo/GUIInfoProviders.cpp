@@ -113,6 +113,16 @@ bool CGUIInfoProviders::GetBool(bool& value, const CGUIListItem *item, int conte
   return false;
 }
 
+const IGUIInfoProvider* CGUIInfoProviders::GetVersionedProvider(const CGUIInfo& info) const
+{
+  for (const auto& provider : m_providers)
+  {
+    if (provider->IsVersioned(info))
+      return provider;
+  }
+  return nullptr;
+}
+
 void CGUIInfoProviders::UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo)
 {
   for (const auto& provider : m_providers)
@@ -105,6 +105,13 @@ public:
    */
   void UpdateAVInfo(const AudioStreamInfo& audioInfo, const VideoStreamInfo& videoInfo, const SubtitleStreamInfo& subtitleInfo);
 
+  /*!
+   * @brief Get the registered provider the bool value of a GUI info is versioned by.
+   * @param info The GUI info (label id + additional data).
+   * @return The provider, or nullptr if the value has to be polled.
+   */
+  const IGUIInfoProvider* GetVersionedProvider(const CGUIInfo& info) const;
+
   /*!
    * @brief Get the player guiinfo provider.
    * @return The player guiinfo provider.
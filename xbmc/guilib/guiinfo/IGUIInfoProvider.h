@@ -84,6 +84,21 @@ public:
    */
   virtual bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const = 0;
 
+  /*!
+   * @brief Check whether a GUIInfoManager bool value of this provider only changes together with
+   * the provider's version. Conditions on such values are not evaluated again until the version
+   * changes.
+   * @param info The GUI info (label id + additional data).
+   * @return True if the value is versioned, false if it has to be polled.
+   */
+  virtual bool IsVersioned(const CGUIInfo& info) const = 0;
+
+  /*!
+   * @brief Get the version of the provider's versioned values.
+   * @return The version, increased whenever one of the versioned values may have changed.
+   */
+  virtual unsigned int GetVersion() const = 0;
+
   /*!
    * @brief Set new audio/video stream info data.
    * @param audioInfo New audio stream info.
@@ -595,6 +595,39 @@ bool CPlayerGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int context
   return false;
 }
 
+bool CPlayerGUIInfo::IsVersioned(const CGUIInfo& info) const
+{
+  // what is playing and at which speed, everything else is polled
+  switch (info.m_info)
+  {
+    case PLAYER_HAS_MEDIA:
+    case PLAYER_HAS_AUDIO:
+    case PLAYER_HAS_VIDEO:
+    case PLAYER_HAS_GAME:
+    case PLAYER_PLAYING:
+    case PLAYER_PAUSED:
+    case PLAYER_REWINDING:
+    case PLAYER_FORWARDING:
+    case PLAYER_REWINDING_2x:
+    case PLAYER_REWINDING_4x:
+    case PLAYER_REWINDING_8x:
+    case PLAYER_REWINDING_16x:
+    case PLAYER_REWINDING_32x:
+    case PLAYER_FORWARDING_2x:
+    case PLAYER_FORWARDING_4x:
+    case PLAYER_FORWARDING_8x:
+    case PLAYER_FORWARDING_16x:
+    case PLAYER_FORWARDING_32x:
+      return true;
+  }
+  return false;
+}
+
+unsigned int CPlayerGUIInfo::GetVersion() const
+{
+  return CServiceBroker::GetDataCacheCore().GetPlaybackVersion();
+}
+
 std::string CPlayerGUIInfo::GetContentRanges(int iInfo) const
 {
   std::string values;
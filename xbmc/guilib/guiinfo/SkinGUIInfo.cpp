@@ -115,3 +115,21 @@ bool CSkinGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int contextWi
 
   return false;
 }
+
+bool CSkinGUIInfo::IsVersioned(const CGUIInfo& info) const
+{
+  switch (info.m_info)
+  {
+    case SKIN_BOOL:
+    case SKIN_STRING_IS_EQUAL:
+    case SKIN_STRING:
+      return true;
+  }
+  // SKIN_HAS_THEME depends on the settings of the gui, not the skin
+  return false;
+}
+
+unsigned int CSkinGUIInfo::GetVersion() const
+{
+  return ADDON::CSkinInfo::GetSettingsVersion();
+}
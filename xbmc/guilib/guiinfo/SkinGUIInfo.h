@@ -30,6 +30,8 @@ public:
   bool GetLabel(std::string& value, const CFileItem *item, int contextWindow, const CGUIInfo &info, std::string *fallback) const override;
   bool GetInt(int& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
   bool GetBool(bool& value, const CGUIListItem *item, int contextWindow, const CGUIInfo &info) const override;
+  bool IsVersioned(const CGUIInfo& info) const override;
+  unsigned int GetVersion() const override;
 };
 
 } // namespace GUIINFO
@@ -658,3 +658,20 @@ bool CSystemGUIInfo::GetBool(bool& value, const CGUIListItem *gitem, int context
 
   return false;
 }
+
+bool CSystemGUIInfo::IsVersioned(const CGUIInfo& info) const
+{
+  switch (info.m_info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+      return true;
+  }
+  return false;
+}
+
+unsigned int CSystemGUIInfo::GetVersion() const
+{
+  // constants never change
+  return 0;
+}
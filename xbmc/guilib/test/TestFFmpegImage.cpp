@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/FFmpegImage.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
+#include "utils/MemUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// SOI, an APP0 segment and a baseline frame header of 4000x3000 pixels
+const unsigned char JPEG_HEADER[] = {
+    0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 'J',  'F',  'I',  'F',  0x00, 0x01, 0x01, 0x00,
+    0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0xFF, 0xFF, 0xC0, 0x00, 0x11, 0x08, 0x0B, 0xB8,
+    0x0F, 0xA0, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01};
+
+} // namespace
+
+TEST(TestFFmpegImage, GetJpegSize)
+{
+  unsigned int width = 0;
+  unsigned int height = 0;
+  ASSERT_TRUE(CFFmpegImage::GetJpegSize(JPEG_HEADER, sizeof(JPEG_HEADER), width, height));
+  EXPECT_EQ(4000u, width);
+  EXPECT_EQ(3000u, height);
+
+  // truncated within the frame header
+  EXPECT_FALSE(CFFmpegImage::GetJpegSize(JPEG_HEADER, 26, width, height));
+
+  // no JPEG
+  const unsigned char png[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+  EXPECT_FALSE(CFFmpegImage::GetJpegSize(png, sizeof(png), width, height));
+
+  // the scan starts before a frame header
+  const unsigned char scan[] = {0xFF, 0xD8, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x00};
+  EXPECT_FALSE(CFFmpegImage::GetJpegSize(scan, sizeof(scan), width, height));
+}
+
+TEST(TestFFmpegImage, GetReducedScale)
+{
+  // no ideal size or not larger than it
+  EXPECT_EQ(0, CFFmpegImage::GetReducedScale(4000, 3000, 0, 0, 3));
+  EXPECT_EQ(0, CFFmpegImage::GetReducedScale(1280, 720, 1280, 720, 3));
+
+  // fits 960x720, a quarter is 1000x750
+  EXPECT_EQ(2, CFFmpegImage::GetReducedScale(4000, 3000, 1280, 720, 3));
+  // fits 720x1080 once rotated, a half would be too small
+  EXPECT_EQ(0, CFFmpegImage::GetReducedScale(1000, 1500, 1280, 720, 3));
+  // fits 1620x1080, a quarter is 1500x1000
+  EXPECT_EQ(1, CFFmpegImage::GetReducedScale(6000, 4000, 1920, 1080, 3));
+  // fits 1080x720, an eighth is 750x500
+  EXPECT_EQ(2, CFFmpegImage::GetReducedScale(6000, 4000, 1280, 720, 3));
+  // limited by the decoder
+  EXPECT_EQ(3, CFFmpegImage::GetReducedScale(16000, 12000, 320, 180, 3));
+  EXPECT_EQ(0, CFFmpegImage::GetReducedScale(16000, 12000, 320, 180, 0));
+}
+
+/*!
+ * Caches the images of KODI_TEXTURE_BENCHMARK_DIR like the texture cache does, decoding them at the
+ * image resolution and scaling and encoding them as thumbnails in memory. The images are spread
+ * over KODI_TEXTURE_BENCHMARK_THREADS threads, all cores by default. Reports images per second.
+ */
+TEST(TestFFmpegImage, DISABLED_CacheCorpus)
+{
+  using Clock = std::chrono::steady_clock;
+
+  const char* dir = getenv("KODI_TEXTURE_BENCHMARK_DIR");
+  ASSERT_NE(nullptr, dir) << "set KODI_TEXTURE_BENCHMARK_DIR to a directory of images";
+  const char* threadsEnv = getenv("KODI_TEXTURE_BENCHMARK_THREADS");
+  const unsigned int threadCount =
+      threadsEnv ? atoi(threadsEnv) : std::max(1u, std::thread::hardware_concurrency());
+  ASSERT_GT(threadCount, 0u);
+
+  CFileItemList items;
+  ASSERT_TRUE(
+      XFILE::CDirectory::GetDirectory(dir, items, ".jpg|.jpeg|.png", XFILE::DIR_FLAG_DEFAULTS));
+  ASSERT_GT(items.Size(), 0);
+
+  const unsigned int idealWidth = 1280;
+  const unsigned int idealHeight = 720;
+  std::atomic<int> next{0};
+  std::atomic<int> cached{0};
+  std::mutex timesLock;
+  double decodeSeconds = 0;
+  double resizeSeconds = 0;
+
+  auto worker = [&]() {
+    double decode = 0;
+    double resize = 0;
+    for (int i = next++; i < items.Size(); i = next++)
+    {
+      const std::string path = items[i]->GetPath();
+      XFILE::CFile file;
+      XFILE::auto_buffer buffer;
+      if (file.LoadFile(path, buffer) <= 0)
+        continue;
+
+      const auto start = Clock::now();
+      CFFmpegImage image(items[i]->GetMimeType());
+      if (!image.LoadImageFromMemory(reinterpret_cast<unsigned char*>(buffer.get()),
+                                     buffer.size(), idealWidth, idealHeight))
+        continue;
+      const unsigned int width = image.Width();
+      const unsigned int height = image.Height();
+      const unsigned int pitch = width * 4;
+      uint8_t* pixels =
+          static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(pitch * height, 32));
+      const bool decoded = image.Decode(pixels, width, height, pitch, XB_FMT_A8R8G8B8);
+      const auto decodedAt = Clock::now();
+
+      uint32_t destWidth = idealWidth;
+      uint32_t destHeight = idealHeight;
+      uint8_t* result = nullptr;
+      size_t resultSize = 0;
+      if (decoded && CPicture::ResizeTexture("thumb.jpg", pixels, width, height, pitch, destWidth,
+                                             destHeight, result, resultSize))
+        cached++;
+      delete[] result;
+      KODI::MEMORY::AlignedFree(pixels);
+
+      decode += std::chrono::duration<double>(decodedAt - start).count();
+      resize += std::chrono::duration<double>(Clock::now() - decodedAt).count();
+    }
+
+    std::unique_lock<std::mutex> lock(timesLock);
+    decodeSeconds += decode;
+    resizeSeconds += resize;
+  };
+
+  const auto start = Clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < threadCount; ++i)
+    threads.emplace_back(worker);
+  for (auto& thread : threads)
+    thread.join();
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  const int images = cached;
+  EXPECT_GT(images, 0);
+  RecordProperty("Images", std::to_string(images));
+  RecordProperty("Threads", std::to_string(threadCount));
+  RecordProperty("ImagesPerSecond", std::to_string(images / seconds));
+  RecordProperty("DecodeSecondsPerImage", std::to_string(decodeSeconds / images));
+  RecordProperty("ResizeSecondsPerImage", std::to_string(resizeSeconds / images));
+}
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "guilib/GUIFontGlyphCache.h"
+#include "test/TestUtils.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+CGUIFontGlyphCache::GlyphPtr CreateGlyph(unsigned int width, unsigned int rows, uint8_t value)
+{
+  auto glyph = std::make_shared<CGUIFontGlyphCache::Glyph>();
+  glyph->left = -1;
+  glyph->top = static_cast<int>(rows);
+  glyph->width = width;
+  glyph->rows = rows;
+  glyph->advance = width * 64;
+  glyph->pixels.assign(width * rows, value);
+  return glyph;
+}
+
+} // namespace
+
+TEST(TestGUIFontGlyphCache, GetAndAdd)
+{
+  CGUIFontGlyphCache cache;
+  const unsigned int face = cache.GetFaceId("font.ttf|1280");
+  EXPECT_EQ(face, cache.GetFaceId("font.ttf|1280"));
+  EXPECT_NE(face, cache.GetFaceId("font.ttf|1920"));
+
+  EXPECT_EQ(nullptr, cache.Get(face, 0, 36));
+  const CGUIFontGlyphCache::GlyphPtr glyph = CreateGlyph(8, 12, 0x80);
+  cache.Add(face, 0, 36, glyph);
+  EXPECT_EQ(glyph, cache.Get(face, 0, 36));
+  // styles and faces have glyphs of their own
+  EXPECT_EQ(nullptr, cache.Get(face, 1, 36));
+  EXPECT_EQ(nullptr, cache.Get(cache.GetFaceId("font.ttf|1920"), 0, 36));
+
+  const CGUIFontGlyphCache::Stats stats = cache.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(1u, stats.glyphs);
+
+  cache.Clear();
+  EXPECT_EQ(nullptr, cache.Get(face, 0, 36));
+  EXPECT_EQ(face, cache.GetFaceId("font.ttf|1280"));
+}
+
+TEST(TestGUIFontGlyphCache, MaxBytes)
+{
+  const size_t glyphSize = sizeof(CGUIFontGlyphCache::Glyph) + 16 * 16;
+  CGUIFontGlyphCache cache(glyphSize * 2);
+  const unsigned int face = cache.GetFaceId("font.ttf");
+
+  cache.Add(face, 0, 1, CreateGlyph(16, 16, 1));
+  cache.Add(face, 0, 2, CreateGlyph(16, 16, 2));
+  EXPECT_EQ(2u, cache.GetStats().glyphs);
+  EXPECT_EQ(glyphSize * 2, cache.GetStats().bytes);
+
+  cache.Add(face, 0, 3, CreateGlyph(16, 16, 3));
+  EXPECT_EQ(1u, cache.GetStats().glyphs);
+  EXPECT_NE(nullptr, cache.Get(face, 0, 3));
+}
+
+TEST(TestGUIFontGlyphCache, SaveAndLoad)
+{
+  XFILE::CFile* file = XBMC_CREATETEMPFILE(".bin");
+  ASSERT_NE(nullptr, file);
+  const std::string path = XBMC_TEMPFILEPATH(file);
+
+  CGUIFontGlyphCache cache;
+  cache.GetFaceId("unused.ttf");
+  const unsigned int face = cache.GetFaceId("font.ttf");
+  cache.Add(face, 2, 65, CreateGlyph(5, 7, 0xff));
+  cache.Add(face, 0, 32, CreateGlyph(0, 0, 0));
+  ASSERT_TRUE(cache.Save(path));
+
+  // face ids of the loading process are used
+  CGUIFontGlyphCache loaded;
+  const unsigned int loadedFace = loaded.GetFaceId("font.ttf");
+  const bool result = loaded.Load(path);
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+  ASSERT_TRUE(result);
+
+  const CGUIFontGlyphCache::GlyphPtr glyph = loaded.Get(loadedFace, 2, 65);
+  ASSERT_NE(nullptr, glyph);
+  EXPECT_EQ(-1, glyph->left);
+  EXPECT_EQ(7, glyph->top);
+  EXPECT_EQ(5u, glyph->width);
+  EXPECT_EQ(7u, glyph->rows);
+  EXPECT_EQ(5 * 64, glyph->advance);
+  EXPECT_EQ(std::vector<uint8_t>(5 * 7, 0xff), glyph->pixels);
+  EXPECT_NE(nullptr, loaded.Get(loadedFace, 0, 32));
+  EXPECT_EQ(2u, loaded.GetStats().glyphs);
+
+  // nothing was added since loading
+  EXPECT_TRUE(loaded.Save(path));
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+  EXPECT_FALSE(loaded.Load(path));
+}
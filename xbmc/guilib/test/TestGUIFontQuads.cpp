@@ -0,0 +1,150 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIFontQuads.h"
+#include "guilib/GUIFontTTF.h"
+#include "utils/MathUtils.h"
+#include "utils/TransformMatrix.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+// the corner of the quad at each of its vertices
+#if defined(HAS_DX)
+const int CORNERS[4] = {0, 1, 2, 3};
+#else
+const int CORNERS[4] = {0, 3, 1, 2};
+#endif
+
+TransformMatrix CreateTransform()
+{
+  return TransformMatrix::CreateTranslation(13.3f, -7.1f, 2.0f) *
+         TransformMatrix::CreateZRotation(0.1f, 960.0f, 540.0f) *
+         TransformMatrix::CreateScaler(1.5f, 1.5f);
+}
+
+} // namespace
+
+TEST(TestGUIFontQuads, GenerateVertices)
+{
+  const TransformMatrix matrix = CreateTransform();
+  CGUIFontQuads quads;
+  for (int i = 0; i < 64; ++i)
+  {
+    const float x = 7.3f * i - 40.0f;
+    const float y = 3.7f * i;
+    quads.Add(CRect(x, y, x + 9.6f, y + 21.2f), CRect(i, 2 * i, i + 10, 2 * i + 22), 0x80000000 + i);
+  }
+  ASSERT_EQ(64u, quads.Size());
+
+  const float textureScaleX = 1.0f / 512;
+  const float textureScaleY = 1.0f / 256;
+  for (bool roundX : {false, true})
+  {
+    std::vector<SVertex> vertices(8);
+    quads.GenerateVertices(matrix, textureScaleX, textureScaleY, roundX, vertices);
+    ASSERT_EQ(8u + 4 * 64, vertices.size());
+
+    for (int i = 0; i < 64; ++i)
+    {
+      const float x = 7.3f * i - 40.0f;
+      const float y = 3.7f * i;
+      const float cornersX[4] = {x, x + 9.6f, x + 9.6f, x};
+      const float cornersY[4] = {y, y, y + 21.2f, y + 21.2f};
+      const float texturesU[4] = {i * textureScaleX, (i + 10) * textureScaleX,
+                                  (i + 10) * textureScaleX, i * textureScaleX};
+      const float texturesV[4] = {2 * i * textureScaleY, 2 * i * textureScaleY,
+                                  (2 * i + 22) * textureScaleY, (2 * i + 22) * textureScaleY};
+
+      for (int j = 0; j < 4; ++j)
+      {
+        const SVertex& v = vertices[8 + 4 * i + j];
+        const int corner = CORNERS[j];
+        const float expectedX = matrix.TransformXCoord(cornersX[corner], cornersY[corner], 0);
+        if (roundX)
+          EXPECT_NEAR(expectedX, v.x, 1.0f);
+        else
+          EXPECT_FLOAT_EQ(expectedX, v.x);
+        EXPECT_EQ(MathUtils::round_int(matrix.TransformYCoord(cornersX[corner], cornersY[corner], 0)),
+                  v.y);
+        EXPECT_EQ(MathUtils::round_int(matrix.TransformZCoord(cornersX[corner], cornersY[corner], 0)),
+                  v.z);
+        EXPECT_FLOAT_EQ(texturesU[corner], v.u);
+        EXPECT_FLOAT_EQ(texturesV[corner], v.v);
+#if !defined(HAS_DX)
+        EXPECT_EQ(i, v.b);
+        EXPECT_EQ(0x80, v.a);
+#endif
+      }
+
+      if (roundX)
+      {
+        // the left edge is on whole pixels
+        const SVertex& topLeft = vertices[8 + 4 * i];
+        EXPECT_EQ(MathUtils::round_int(topLeft.x), topLeft.x);
+      }
+    }
+  }
+}
+
+/*!
+ * Generates the vertices of a long list of labels like scrolling through a list does, where no
+ * label is in the font caches, into one vertex array per page of labels. Set
+ * KODI_FONT_BENCHMARK_LABELS to change the number of labels. Reports quads per second.
+ */
+TEST(TestGUIFontQuads, DISABLED_LayoutLabels)
+{
+  using Clock = std::chrono::steady_clock;
+
+  const char* labelsEnv = getenv("KODI_FONT_BENCHMARK_LABELS");
+  const int labels = labelsEnv ? atoi(labelsEnv) : 100000;
+  ASSERT_GT(labels, 0);
+
+  const TransformMatrix matrix = CreateTransform();
+  const std::string text = "The quick brown fox jumps over the lazy dog 0123456789";
+  CGUIFontQuads quads;
+  std::vector<SVertex> vertices;
+  vertices.reserve(4 * text.size() * 64);
+
+  size_t quadCount = 0;
+  const auto start = Clock::now();
+  for (int label = 0; label < labels; ++label)
+  {
+    // a page of labels is drawn each frame
+    if (label % 64 == 0)
+      vertices.clear();
+
+    const float posY = 40.0f * (label % 64);
+    float cursorX = 0;
+    quads.Clear();
+    for (const char c : text)
+    {
+      const float advance = 9.0f + (c & 7);
+      const float glyphX = 100.0f + cursorX + (label % 3) * 0.3f;
+      quads.Add(CRect(glyphX, posY + 4.0f, glyphX + advance - 1.0f, posY + 28.0f),
+                CRect(c * 12.0f, 0, c * 12.0f + advance - 1.0f, 24.0f), 0xffffffff);
+      cursorX += advance;
+    }
+    quads.GenerateVertices(matrix, 1.0f / 2048, 1.0f / 256, true, vertices);
+    quadCount += quads.Size();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  EXPECT_EQ(text.size() * labels, quadCount);
+  RecordProperty("Labels", std::to_string(labels));
+  RecordProperty("Quads", std::to_string(quadCount));
+  RecordProperty("QuadsPerSecond", std::to_string(quadCount / seconds));
+  RecordProperty("LabelsPerSecond", std::to_string(labels / seconds));
+}
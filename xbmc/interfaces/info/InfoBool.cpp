@@ -8,6 +8,7 @@
 
 #include "InfoBool.h"
 
+#include "guilib/GUIControlProfiler.h"
 #include "utils/StringUtils.h"
 
 namespace INFO
@@ -22,4 +23,32 @@ namespace INFO
   {
     StringUtils::ToLower(m_expression);
   }
+
+  void InfoBool::Refresh()
+  {
+    uint64_t version;
+    const bool versioned = GetInputVersion(version);
+    if (versioned && m_versioned && version == m_inputVersion)
+    {
+      if (CGUIControlProfiler::IsRunning())
+        CGUIControlProfiler::Instance().AddInfoBool(false);
+      return;
+    }
+
+    // take the version first, infos changing while updating will be seen on the next refresh
+    Evaluate(nullptr);
+    m_versioned = versioned;
+    m_inputVersion = version;
+  }
+
+  void InfoBool::Evaluate(const CGUIListItem *item)
+  {
+    Update(item);
+    // the value belongs to the item
+    if (item)
+      m_versioned = false;
+
+    if (CGUIControlProfiler::IsRunning())
+      CGUIControlProfiler::Instance().AddInfoBool(true);
+  }
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <memory>
+#include <stdint.h>
 #include <string>
 
 class CGUIListItem;
@@ -34,10 +35,10 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
-      Update(item);
+      Evaluate(item);
     else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
     {
-      Update(NULL);
+      Refresh();
       m_refreshCounter = m_parentRefreshCounter;
     }
     return m_value;
@@ -64,6 +65,14 @@ public:
    */
   virtual void Update(const CGUIListItem *item) {};
 
+  /*! \brief Get the version of the infos this info bool depends on
+   The version increases whenever one of the infos may have changed, the info bool is only updated
+   on a refresh if it did.
+   \param version the version of the infos
+   \return false if the info bool depends on infos without version, it's updated on every refresh
+   */
+  virtual bool GetInputVersion(uint64_t &version) const { return false; }
+
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
 protected:
@@ -74,8 +83,13 @@ protected:
   std::string  m_expression;   ///< original expression
 
 private:
+  void Refresh();
+  void Evaluate(const CGUIListItem *item);
+
   unsigned int m_refreshCounter;
   unsigned int &m_parentRefreshCounter;
+  bool m_versioned = false;    ///< m_value was updated from infos of m_inputVersion
+  uint64_t m_inputVersion = 0;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
@@ -11,8 +11,10 @@
 #include "GUIInfoManager.h"
 #include "ServiceBroker.h"
 #include "guilib/GUIComponent.h"
+#include "guilib/guiinfo/IGUIInfoProvider.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <stack>
@@ -21,7 +23,11 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  // the versioned providers are owned by the info manager and never unregistered
+  if (!m_listItemDependent)
+    m_provider = infoMgr.GetVersionedProvider(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -29,28 +35,69 @@ void InfoSingle::Update(const CGUIListItem *item)
   m_value = CServiceBroker::GetGUI()->GetInfoManager().GetBool(m_condition, m_context, item);
 }
 
+bool InfoSingle::GetInputVersion(uint64_t &version) const
+{
+  if (!m_provider)
+    return false;
+
+  version = m_provider->GetVersion();
+  return true;
+}
+
 void InfoExpression::Initialize()
 {
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    m_leaves.clear();
+    m_program.clear();
+    Compile(InfoLeaf(RegisterOperand("false"), false));
   }
 }
 
+InfoPtr InfoExpression::RegisterOperand(const std::string &operand)
+{
+  return CServiceBroker::GetGUI()->GetInfoManager().Register(operand, m_context);
+}
+
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  int next = 0;
+  do
+  {
+    const Instruction& instruction = m_program[next];
+    if (instruction.invert ^ m_leaves[instruction.leaf]->Get(item))
+      next = instruction.onTrue;
+    else
+      next = instruction.onFalse;
+  } while (next >= 0);
+
+  m_value = next == RESULT_TRUE;
+}
+
+bool InfoExpression::GetInputVersion(uint64_t &version) const
+{
+  // versions only increase, so does their sum
+  version = 0;
+  for (const auto& leaf : m_leaves)
+  {
+    uint64_t leafVersion;
+    if (!leaf->GetInputVersion(leafVersion))
+      return false;
+    version += leafVersion;
+  }
+  return true;
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes, and then compiled into a flat
+ * program of leaf evaluations. Each instruction evaluates one leaf and jumps
+ * straight to the instruction that has to be evaluated next for the value of
+ * the leaf, or to the result of the whole expression. So a true leaf of an OR
+ * group that is itself the last child of an AND group finishes the evaluation
+ * at once, without walking back up the tree. Leaves are evaluated in about the
+ * order they appear in the expression, which lets skins put cheap and decisive
+ * conditions first.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
@@ -61,9 +108,9 @@ void InfoExpression::Update(const CGUIListItem *item)
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+int InfoExpression::InfoLeaf::Compile(InfoExpression &expression, int onTrue, int onFalse) const
 {
-  return m_invert ^ m_info->Get(item);
+  return expression.Emit(m_info, m_invert, onTrue, onFalse);
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -86,27 +133,54 @@ void InfoExpression::InfoAssociativeGroup::Merge(const std::shared_ptr<InfoAssoc
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+int InfoExpression::InfoAssociativeGroup::Compile(InfoExpression &expression, int onTrue, int onFalse) const
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
+  /* The children are compiled from the last one, which continues where the
+   * group does, so every child knows the first instruction of the next one.
+   * A child of an AND group continues with the next child if true and finishes
+   * the group if false, and vice versa for OR.
    */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  int next = m_type == NODE_AND ? onTrue : onFalse;
+  for (auto it = m_children.rbegin(); it != m_children.rend(); ++it)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
+    if (m_type == NODE_AND)
+      next = (*it)->Compile(expression, next, onFalse);
+    else
+      next = (*it)->Compile(expression, onTrue, next);
   }
-  return use_and ^ result;
+  return next;
+}
+
+void InfoExpression::Compile(const InfoSubexpression &tree)
+{
+  tree.Compile(*this, RESULT_TRUE, RESULT_FALSE);
+
+  // instructions were emitted last to first, the first one evaluated was emitted last
+  const int last = static_cast<int>(m_program.size()) - 1;
+  std::reverse(m_program.begin(), m_program.end());
+  for (auto& instruction : m_program)
+  {
+    if (instruction.onTrue >= 0)
+      instruction.onTrue = last - instruction.onTrue;
+    if (instruction.onFalse >= 0)
+      instruction.onFalse = last - instruction.onFalse;
+  }
+}
+
+int InfoExpression::Emit(const InfoPtr &info, bool invert, int onTrue, int onFalse)
+{
+  // the info manager hands out the same info bool for the same operand
+  auto it = std::find(m_leaves.begin(), m_leaves.end(), info);
+  if (it == m_leaves.end())
+    it = m_leaves.insert(m_leaves.end(), info);
+
+  Instruction instruction;
+  instruction.leaf = static_cast<unsigned int>(it - m_leaves.begin());
+  instruction.invert = invert;
+  instruction.onTrue = onTrue;
+  instruction.onFalse = onFalse;
+  m_program.push_back(instruction);
+  return static_cast<int>(m_program.size()) - 1;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -208,8 +282,6 @@ bool InfoExpression::Parse(const std::string &expression)
   bool after_binaryoperator = true;
   int bracket_count = 0;
 
-  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-
   char c;
   // Skip leading whitespace - don't want it to count as an operand if that's all there is
   while (isspace((unsigned char)(c=*s)))
@@ -236,7 +308,7 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = infoMgr.Register(operand, m_context);
+        InfoPtr info = RegisterOperand(operand);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -287,7 +359,7 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = infoMgr.Register(operand, m_context);
+    InfoPtr info = RegisterOperand(operand);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
@@ -300,6 +372,6 @@ bool InfoExpression::Parse(const std::string &expression)
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(*nodes.top());
   return true;
 }
@@ -17,6 +17,17 @@
 
 class CGUIListItem;
 
+namespace KODI
+{
+namespace GUILIB
+{
+namespace GUIINFO
+{
+class IGUIInfoProvider;
+}
+} // namespace GUILIB
+} // namespace KODI
+
 namespace INFO
 {
 /*! \brief Class to wrap active boolean conditions
@@ -29,8 +40,10 @@ public:
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
+  bool GetInputVersion(uint64_t &version) const override;
 private:
   int m_condition;             ///< actual condition this represents
+  const KODI::GUILIB::GUIINFO::IGUIInfoProvider* m_provider = nullptr; ///< provider versioning the condition
 };
 
 /*! \brief Class to wrap active boolean expressions
@@ -45,6 +58,13 @@ public:
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
+  bool GetInputVersion(uint64_t &version) const override;
+protected:
+  /*! \brief Get the info bool of an operand, registered with the info manager
+   \param operand the operand as it appears in the expression
+   \return the info bool, or nullptr if the operand is invalid
+   */
+  virtual InfoPtr RegisterOperand(const std::string &operand);
 private:
   typedef enum
   {
@@ -63,12 +83,26 @@ private:
     NODE_OR,
   } node_type_t;
 
+  // An instruction of the compiled expression, evaluates a leaf and continues with the
+  // instruction for its value, or finishes with RESULT_TRUE or RESULT_FALSE
+  struct Instruction
+  {
+    unsigned int leaf;
+    bool invert;
+    int onTrue;
+    int onFalse;
+  };
+
+  static constexpr int RESULT_TRUE = -1;
+  static constexpr int RESULT_FALSE = -2;
+
   // An abstract base class for nodes in the expression tree
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
+    // Emits the instructions of the node, returns the first one
+    virtual int Compile(InfoExpression &expression, int onTrue, int onFalse) const = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -79,7 +113,7 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(std::move(info)), m_invert(invert){};
-    bool Evaluate(const CGUIListItem *item) override;
+    int Compile(InfoExpression &expression, int onTrue, int onFalse) const override;
     node_type_t Type() const override { return NODE_LEAF; };
   private:
     InfoPtr m_info;
@@ -93,7 +127,7 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(const std::shared_ptr<InfoAssociativeGroup>& other);
-    bool Evaluate(const CGUIListItem *item) override;
+    int Compile(InfoExpression &expression, int onTrue, int onFalse) const override;
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
@@ -103,7 +137,11 @@ private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpression &tree);
+  int Emit(const InfoPtr &info, bool invert, int onTrue, int onFalse);
+
+  std::vector<InfoPtr> m_leaves;
+  std::vector<Instruction> m_program;
 };
 
 };
@@ -0,0 +1,335 @@
+/*
+ *  Copyright (C) 2021 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "addons/Skin.h"
+#include "addons/addoninfo/AddonInfo.h"
+#include "guilib/GUIComponent.h"
+#include "interfaces/info/InfoExpression.h"
+#include "settings/SkinSettings.h"
+#include "utils/StringUtils.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+
+// a condition with a value and version set by the test, which records its evaluation
+class CTestInfoBool : public InfoBool
+{
+public:
+  CTestInfoBool(const std::string& name,
+                unsigned int& refreshCounter,
+                std::vector<std::string>& evaluated)
+    : InfoBool(name, 0, refreshCounter), m_evaluated(evaluated)
+  {
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_evaluated.push_back(m_expression);
+    m_value = m_result;
+  }
+
+  bool GetInputVersion(uint64_t& version) const override
+  {
+    version = m_version;
+    return m_versioned;
+  }
+
+  void SetResult(bool result) { m_result = result; }
+  void SetVersion(uint64_t version)
+  {
+    m_versioned = true;
+    m_version = version;
+  }
+
+private:
+  std::vector<std::string>& m_evaluated;
+  bool m_result = false;
+  bool m_versioned = false;
+  uint64_t m_version = 0;
+};
+
+// an expression of test conditions instead of ones registered with the info manager
+class CTestInfoExpression : public InfoExpression
+{
+public:
+  CTestInfoExpression(const std::string& expression,
+                      unsigned int& refreshCounter,
+                      std::function<InfoPtr(const std::string&)> registerOperand)
+    : InfoExpression(expression, 0, refreshCounter), m_registerOperand(std::move(registerOperand))
+  {
+  }
+
+protected:
+  InfoPtr RegisterOperand(const std::string& operand) override
+  {
+    return m_registerOperand(operand);
+  }
+
+private:
+  std::function<InfoPtr(const std::string&)> m_registerOperand;
+};
+
+class TestInfoExpression : public ::testing::Test
+{
+protected:
+  InfoPtr Create(const std::string& expression)
+  {
+    auto info = std::make_shared<CTestInfoExpression>(
+        expression, m_refreshCounter, [this](const std::string& operand) -> InfoPtr {
+          std::string name = operand;
+          StringUtils::Trim(name);
+          if (name == "bad")
+            return {};
+          return Get(name);
+        });
+    info->Initialize();
+    return info;
+  }
+
+  // the same operand is the same condition, like the info manager does it
+  std::shared_ptr<CTestInfoBool> Get(const std::string& name)
+  {
+    auto& info = m_infos[name];
+    if (!info)
+      info = std::make_shared<CTestInfoBool>(name, m_refreshCounter, m_evaluated);
+    return info;
+  }
+
+  void Set(const std::string& name, bool result) { Get(name)->SetResult(result); }
+
+  // evaluates the info like a new frame does
+  bool Evaluate(const InfoPtr& info)
+  {
+    m_evaluated.clear();
+    ++m_refreshCounter;
+    return info->Get();
+  }
+
+  std::vector<std::string> m_evaluated;
+
+private:
+  unsigned int m_refreshCounter = 0;
+  std::map<std::string, std::shared_ptr<CTestInfoBool>> m_infos;
+};
+
+// counts the evaluations of a condition of the info manager
+class CCountingInfoSingle : public InfoSingle
+{
+public:
+  using InfoSingle::InfoSingle;
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_updates++;
+    InfoSingle::Update(item);
+  }
+
+  unsigned int m_updates = 0;
+};
+
+class TestInfoSingle : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_gui.reset(new CGUIComponent());
+    CServiceBroker::RegisterGUI(m_gui.get());
+
+    m_skin = g_SkinInfo;
+    g_SkinInfo = std::make_shared<ADDON::CSkinInfo>(
+        std::make_shared<ADDON::CAddonInfo>("skin.estuary", ADDON::ADDON_SKIN),
+        RESOLUTION_INFO(1920, 1080, 0, "xml"));
+  }
+
+  void TearDown() override
+  {
+    g_SkinInfo = m_skin;
+    CServiceBroker::UnregisterGUI();
+    m_gui.reset();
+  }
+
+private:
+  std::unique_ptr<CGUIComponent> m_gui;
+  std::shared_ptr<ADDON::CSkinInfo> m_skin;
+};
+
+} // unnamed namespace
+
+TEST_F(TestInfoExpression, ShortCircuit)
+{
+  InfoPtr info = Create("a + [b | c] + !d");
+
+  Set("a", false);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a"}), m_evaluated);
+
+  Set("a", true);
+  Set("b", true);
+  EXPECT_TRUE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "d"}), m_evaluated);
+
+  Set("b", false);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), m_evaluated);
+
+  Set("c", true);
+  Set("d", true);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "d"}), m_evaluated);
+}
+
+TEST_F(TestInfoExpression, NestedGroups)
+{
+  // a true leaf finishes the evaluation without returning to the enclosing groups
+  InfoPtr info = Create("a + [b | [c + d]] | e");
+
+  Set("a", true);
+  Set("b", true);
+  EXPECT_TRUE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), m_evaluated);
+
+  Set("b", false);
+  Set("c", true);
+  Set("e", true);
+  EXPECT_TRUE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "d", "e"}), m_evaluated);
+
+  Set("c", false);
+  Set("e", false);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "e"}), m_evaluated);
+
+  Set("a", false);
+  Set("e", true);
+  EXPECT_TRUE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "e"}), m_evaluated);
+}
+
+TEST_F(TestInfoExpression, Not)
+{
+  // evaluated as c + !a + !b
+  InfoPtr info = Create("c + ![a | b]");
+
+  Set("c", true);
+  Set("b", true);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"c", "a", "b"}), m_evaluated);
+
+  Set("b", false);
+  EXPECT_TRUE(Evaluate(info));
+
+  Set("a", true);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"c", "a"}), m_evaluated);
+
+  EXPECT_FALSE(Evaluate(Create("!!!a")));
+  EXPECT_TRUE(Evaluate(Create("!![!a | c]")));
+}
+
+TEST_F(TestInfoExpression, RepeatedOperand)
+{
+  InfoPtr info = Create("a + [b | !a]");
+
+  Set("a", true);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), m_evaluated);
+
+  Set("b", true);
+  EXPECT_TRUE(Evaluate(info));
+
+  // both operands are one input of the expression
+  Get("a")->SetVersion(1);
+  Get("b")->SetVersion(10);
+  uint64_t version;
+  ASSERT_TRUE(info->GetInputVersion(version));
+  EXPECT_EQ(11u, version);
+}
+
+TEST_F(TestInfoExpression, ParseFailure)
+{
+  Set("a", true);
+  Set("b", true);
+
+  // invalid expressions are always false, without evaluating any of their operands
+  for (const auto& expression : {"a +", "+ a", "a !b", "[a | b", "a ]", "a + bad", "[]"})
+  {
+    InfoPtr info = Create(expression);
+    EXPECT_FALSE(Evaluate(info)) << expression;
+    EXPECT_EQ(std::vector<std::string>({"false"}), m_evaluated) << expression;
+  }
+}
+
+TEST_F(TestInfoExpression, VersionedRefresh)
+{
+  InfoPtr info = Create("a | b");
+  Get("a")->SetVersion(1);
+  Get("b")->SetVersion(1);
+
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), m_evaluated);
+
+  // the inputs didn't change
+  Set("a", true);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_TRUE(m_evaluated.empty());
+
+  Get("a")->SetVersion(2);
+  EXPECT_TRUE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a"}), m_evaluated);
+
+  // an operand without version is evaluated on every refresh, versioned ones only if they changed
+  info = Create("[a + !b] | c");
+  Set("a", false);
+  Get("a")->SetVersion(3);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"a", "c"}), m_evaluated);
+  EXPECT_FALSE(Evaluate(info));
+  EXPECT_EQ(std::vector<std::string>({"c"}), m_evaluated);
+}
+
+TEST_F(TestInfoSingle, SkinSettingsVersion)
+{
+  unsigned int refreshCounter = 1;
+  auto info = std::make_shared<CCountingInfoSingle>("Skin.HasSetting(InfoSingleTest)", 0,
+                                                    refreshCounter);
+  info->Initialize();
+
+  uint64_t version;
+  ASSERT_TRUE(info->GetInputVersion(version));
+  EXPECT_EQ(ADDON::CSkinInfo::GetSettingsVersion(), version);
+
+  EXPECT_FALSE(info->Get());
+  EXPECT_EQ(1u, info->m_updates);
+
+  // skipped until a skin setting changes
+  ++refreshCounter;
+  EXPECT_FALSE(info->Get());
+  EXPECT_EQ(1u, info->m_updates);
+
+  CSkinSettings::GetInstance().SetBool(
+      CSkinSettings::GetInstance().TranslateBool("InfoSingleTest"), true);
+  ASSERT_TRUE(info->GetInputVersion(version));
+  EXPECT_EQ(ADDON::CSkinInfo::GetSettingsVersion(), version);
+
+  // the new value is only taken on the next refresh
+  EXPECT_FALSE(info->Get());
+  ++refreshCounter;
+  EXPECT_TRUE(info->Get());
+  EXPECT_EQ(2u, info->m_updates);
+}
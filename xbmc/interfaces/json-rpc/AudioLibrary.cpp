@@ -26,13 +26,141 @@
 #include "utils/SortUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/Random.h"
 #include "utils/Variant.h"
 
+#include <memory>
+
 using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 
+namespace
+{
+
+// reads the albums or songs of a library query only while the response is written
+class CLibraryItemSource : public IJSONVariantItemSource
+{
+public:
+  CLibraryItemSource(std::unique_ptr<CMusicDatabase> musicdatabase,
+                     const MediaType& type,
+                     const std::set<std::string>& fields)
+    : m_musicdatabase(std::move(musicdatabase)),
+      m_type(type),
+      m_fields(fields),
+      m_fetchArt(fields.find("art") != fields.end()),
+      m_fetchFanart(fields.find("fanart") != fields.end()),
+      m_fetchThumb(type == MediaTypeSong && fields.find("thumbnail") != fields.end())
+  {
+  }
+
+  bool Query(const std::string& baseDir, int& total, const SortDescription& sorting)
+  {
+    if (m_type == MediaTypeAlbum)
+      return m_musicdatabase->QueryAlbumsJSON(m_fields, baseDir, total, sorting);
+    return m_musicdatabase->QuerySongsJSON(m_fields, baseDir, total, sorting);
+  }
+
+  bool GetNext(CVariant& item) override
+  {
+    if (m_type == MediaTypeAlbum ? !m_musicdatabase->GetNextAlbumJSON(item)
+                                 : !m_musicdatabase->GetNextSongJSON(item))
+      return false;
+
+    if (m_fetchArt || m_fetchFanart || m_fetchThumb)
+      FillArt(item);
+    return true;
+  }
+
+private:
+  void FillArt(CVariant& object)
+  {
+    if (!m_thumbLoader)
+    {
+      m_thumbLoader.reset(new CMusicThumbLoader());
+      m_thumbLoader->OnLoaderStart();
+    }
+
+    CFileItem item;
+    if (m_type == MediaTypeAlbum)
+      item.GetMusicInfoTag()->SetDatabaseId(object["albumid"].asInteger32(), MediaTypeAlbum);
+    else
+    {
+      // Only needs song and album id (if we have it) set to get art
+      // Getting art is quicker if "albumid" has been fetched
+      item.GetMusicInfoTag()->SetDatabaseId(object["songid"].asInteger32(), MediaTypeSong);
+      if (object.isMember("albumid"))
+        item.GetMusicInfoTag()->SetAlbumId(object["albumid"].asInteger32());
+      else
+        item.GetMusicInfoTag()->SetAlbumId(-1);
+    }
+
+    // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
+    m_thumbLoader->FillLibraryArt(item);
+
+    if (m_fetchThumb)
+    {
+      if (item.HasArt("thumb"))
+        object["thumbnail"] = CTextureUtils::GetWrappedImageURL(item.GetArt("thumb"));
+      else
+        object["thumbnail"] = "";
+    }
+    if (m_fetchFanart)
+    {
+      if (item.HasArt("fanart"))
+        object["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
+      else
+        object["fanart"] = "";
+    }
+    if (m_fetchArt)
+    {
+      CGUIListItem::ArtMap artMap = item.GetArt();
+      CVariant artObj(CVariant::VariantTypeObject);
+      for (const auto& artIt : artMap)
+      {
+        if (!artIt.second.empty())
+          artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
+      }
+      object["art"] = artObj;
+    }
+  }
+
+  std::unique_ptr<CMusicDatabase> m_musicdatabase;
+  MediaType m_type;
+  std::set<std::string> m_fields;
+  bool m_fetchArt;
+  bool m_fetchFanart;
+  bool m_fetchThumb;
+  std::unique_ptr<CMusicThumbLoader> m_thumbLoader;
+};
+
+// adds the queried items to the result, leaving it untouched when there are none
+void AddLibraryItems(std::unique_ptr<CLibraryItemSource> source,
+                     const SortDescription& sorting,
+                     CVariant& result,
+                     const char* resultname)
+{
+  CVariant item;
+  if (!source->GetNext(item))
+    return;
+  CVariant& items = result[resultname];
+  items.push_back(std::move(item));
+
+  // the rows of a random order may be sorted to combine the joins, so shuffle all of the items
+  if (sorting.sortBy == SortByRandom)
+  {
+    while (source->GetNext(item))
+      items.push_back(std::move(item));
+    KODI::UTILS::RandomShuffle(items.begin_array(), items.end_array());
+    return;
+  }
+
+  CJSONRPC::AddResultItems(items, std::move(source));
+}
+
+} // unnamed namespace
+
 JSONRPC_STATUS CAudioLibrary::GetProperties(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CVariant properties = CVariant(CVariant::VariantTypeObject);
@@ -201,8 +329,8 @@ JSONRPC_STATUS CAudioLibrary::GetArtistDetails(const std::string &method, ITrans
 
 JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  auto musicdatabase = std::make_unique<CMusicDatabase>();
+  if (!musicdatabase->Open())
     return InternalError;
 
   CMusicDbUrl musicUrl;
@@ -256,58 +384,11 @@ JSONRPC_STATUS CAudioLibrary::GetAlbums(const std::string &method, ITransportLay
       fields.insert(field->asString());
   }
 
-  if (!musicdatabase.GetAlbumsByWhereJSON(fields, musicUrl.ToString(), result, total, sorting))
+  auto source = std::make_unique<CLibraryItemSource>(std::move(musicdatabase), MediaTypeAlbum, fields);
+  if (!source->Query(musicUrl.ToString(), total, sorting))
     return InternalError;
 
-  if (!result.isNull())
-  {
-    bool bFetchArt = fields.find("art") != fields.end();
-    bool bFetchFanart = fields.find("fanart") != fields.end();
-    if (bFetchArt || bFetchFanart)
-    {
-      CThumbLoader* thumbLoader = new CMusicThumbLoader();
-      thumbLoader->OnLoaderStart();
-
-      std::set<std::string> artfields;
-      if (bFetchArt)
-        artfields.insert("art");
-      if (bFetchFanart)
-        artfields.insert("fanart");
-
-      for (unsigned int index = 0; index < result["albums"].size(); index++)
-      {
-        CFileItem item;
-        item.GetMusicInfoTag()->SetDatabaseId(result["albums"][index]["albumid"].asInteger32(), MediaTypeAlbum);
-
-        // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
-        // CFileItemPtr itemptr(new CFileItem(item));
-        // FillDetails(item.GetMusicInfoTag(), itemptr, artfields, result["albums"][index], thumbLoader);
-
-        thumbLoader->FillLibraryArt(item);
-
-        if (bFetchFanart)
-        {
-          if (item.HasArt("fanart"))
-            result["albums"][index]["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
-          else
-            result["albums"][index]["fanart"] = "";
-        }
-        if (bFetchArt)
-        {
-          CGUIListItem::ArtMap artMap = item.GetArt();
-          CVariant artObj(CVariant::VariantTypeObject);
-          for (const auto& artIt : artMap)
-          {
-            if (!artIt.second.empty())
-              artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
-          }
-          result["albums"][index]["art"] = artObj;
-        }
-      }
-
-      delete thumbLoader;
-    }
-  }
+  AddLibraryItems(std::move(source), sorting, result, "albums");
 
   int start, end;
   HandleLimits(parameterObject, result, total, start, end);
@@ -345,8 +426,8 @@ JSONRPC_STATUS CAudioLibrary::GetAlbumDetails(const std::string &method, ITransp
 
 JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CMusicDatabase musicdatabase;
-  if (!musicdatabase.Open())
+  auto musicdatabase = std::make_unique<CMusicDatabase>();
+  if (!musicdatabase->Open())
     return InternalError;
 
   CMusicDbUrl musicUrl;
@@ -406,74 +487,11 @@ JSONRPC_STATUS CAudioLibrary::GetSongs(const std::string &method, ITransportLaye
       fields.insert(field->asString());
   }
 
-  if (!musicdatabase.GetSongsByWhereJSON(fields, musicUrl.ToString(), result, total, sorting))
+  auto source = std::make_unique<CLibraryItemSource>(std::move(musicdatabase), MediaTypeSong, fields);
+  if (!source->Query(musicUrl.ToString(), total, sorting))
     return InternalError;
 
-  if (!result.isNull())
-  {
-    bool bFetchArt = fields.find("art") != fields.end();
-    bool bFetchFanart = fields.find("fanart") != fields.end();
-    bool bFetchThumb = fields.find("thumbnail") != fields.end();
-    if (bFetchArt || bFetchFanart || bFetchThumb)
-    {
-      CThumbLoader* thumbLoader = new CMusicThumbLoader();
-      thumbLoader->OnLoaderStart();
-
-      std::set<std::string> artfields;
-      if (bFetchArt)
-        artfields.insert("art");
-      if (bFetchFanart)
-        artfields.insert("fanart");
-      if (bFetchThumb)
-        artfields.insert("thumbnail");
-
-      for (unsigned int index = 0; index < result["songs"].size(); index++)
-      {
-        CFileItem item;
-        // Only needs song and album id (if we have it) set to get art
-        // Getting art is quicker if "albumid" has been fetched
-        item.GetMusicInfoTag()->SetDatabaseId(result["songs"][index]["songid"].asInteger32(), MediaTypeSong);
-        if (result["songs"][index].isMember("albumid"))
-          item.GetMusicInfoTag()->SetAlbumId(result["songs"][index]["albumid"].asInteger32());
-        else
-          item.GetMusicInfoTag()->SetAlbumId(-1);
-
-        // Could use FillDetails, but it does unnecessary serialization of empty MusiInfoTag
-        // CFileItemPtr itemptr(new CFileItem(item));
-        // FillDetails(item.GetMusicInfoTag(), itemptr, artfields, result["songs"][index], thumbLoader);
-
-        thumbLoader->FillLibraryArt(item);
-
-        if (bFetchThumb)
-        {
-          if (item.HasArt("thumb"))
-            result["songs"][index]["thumbnail"] = CTextureUtils::GetWrappedImageURL(item.GetArt("thumb"));
-          else
-            result["songs"][index]["thumbnail"] = "";
-        }
-        if (bFetchFanart)
-        {
-          if (item.HasArt("fanart"))
-            result["songs"][index]["fanart"] = CTextureUtils::GetWrappedImageURL(item.GetArt("fanart"));
-          else
-            result["songs"][index]["fanart"] = "";
-        }
-        if (bFetchArt)
-        {
-          CGUIListItem::ArtMap artMap = item.GetArt();
-          CVariant artObj(CVariant::VariantTypeObject);
-          for (const auto& artIt : artMap)
-          {
-            if (!artIt.second.empty())
-              artObj[artIt.first] = CTextureUtils::GetWrappedImageURL(artIt.second);
-          }
-          result["songs"][index]["art"] = artObj;
-        }
-      }
-
-      delete thumbLoader;
-    }
-  }
+  AddLibraryItems(std::move(source), sorting, result, "songs");
 
   int start, end;
   HandleLimits(parameterObject, result, total, start, end);
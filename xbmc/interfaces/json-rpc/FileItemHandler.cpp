@@ -32,7 +32,9 @@
 #include "video/VideoThumbLoader.h"
 
 #include <map>
+#include <memory>
 #include <string.h>
+#include <vector>
 
 using namespace MUSIC_INFO;
 using namespace JSONRPC;
@@ -228,6 +230,56 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
 }
 
 void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+{
+  AddFileItemList(ID, allowFile, resultname, items, parameterObject, result, size, sortLimit, false);
+}
+
+void CFileItemHandler::StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit /* = true */)
+{
+  AddFileItemList(ID, allowFile, resultname, items, parameterObject, result, size, sortLimit, true);
+}
+
+// creates the objects of the items of a list only when they are written
+class CFileItemHandler::CFileItemSource : public IJSONVariantItemSource
+{
+public:
+  CFileItemSource(const char* ID,
+                  bool allowFile,
+                  std::vector<CFileItemPtr>&& items,
+                  const std::set<std::string>& fields,
+                  std::unique_ptr<CThumbLoader> thumbLoader)
+    : m_ID(ID),
+      m_allowFile(allowFile),
+      m_items(std::move(items)),
+      m_fields(fields),
+      m_thumbLoader(std::move(thumbLoader))
+  {
+  }
+
+  bool GetNext(CVariant& item) override
+  {
+    if (m_next == m_items.size())
+      return false;
+
+    // the file item isn't needed anymore once its object has been created
+    CFileItemPtr fileItem = std::move(m_items[m_next++]);
+    CVariant object;
+    HandleFileItem(m_ID, m_allowFile, "item", fileItem, CVariant::ConstNullVariant, m_fields,
+                   object, false, m_thumbLoader.get());
+    item = std::move(object["item"]);
+    return true;
+  }
+
+private:
+  const char* m_ID;
+  bool m_allowFile;
+  std::vector<CFileItemPtr> m_items;
+  size_t m_next = 0;
+  std::set<std::string> m_fields;
+  std::unique_ptr<CThumbLoader> m_thumbLoader;
+};
+
+void CFileItemHandler::AddFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit, bool stream)
 {
   int start, end;
   HandleLimits(parameterObject, result, size, start, end);
@@ -240,15 +292,15 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
     end = items.Size();
   }
 
-  CThumbLoader *thumbLoader = NULL;
+  std::unique_ptr<CThumbLoader> thumbLoader;
   if (end - start > 0)
   {
     if (items.Get(start)->HasVideoInfoTag())
-      thumbLoader = new CVideoThumbLoader();
+      thumbLoader.reset(new CVideoThumbLoader());
     else if (items.Get(start)->HasMusicInfoTag())
-      thumbLoader = new CMusicThumbLoader();
+      thumbLoader.reset(new CMusicThumbLoader());
 
-    if (thumbLoader != NULL)
+    if (thumbLoader)
       thumbLoader->OnLoaderStart();
   }
 
@@ -259,14 +311,25 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  if (stream)
+  {
+    std::vector<CFileItemPtr> listItems;
+    listItems.reserve(static_cast<size_t>(end - start));
+    for (int i = start; i < end; i++)
+      listItems.push_back(items.Get(i));
+
+    CJSONRPC::AddResultItems(result[resultname],
+                             std::make_unique<CFileItemSource>(ID, allowFile, std::move(listItems),
+                                                               fields, std::move(thumbLoader)));
+    return;
+  }
+
   result[resultname].reserve(static_cast<size_t>(end - start));
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
-    HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
+    HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader.get());
   }
-
-  delete thumbLoader;
 }
 
 void CFileItemHandler::HandleFileItem(const char* ID,
@@ -428,9 +491,9 @@ void CFileItemHandler::HandleFileItem(const char* ID,
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].append(std::move(object));
     else
-      result[resultname] = object;
+      result[resultname] = std::move(object);
   }
 }
 
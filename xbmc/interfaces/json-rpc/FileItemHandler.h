@@ -25,6 +25,12 @@ namespace JSONRPC
     static void FillDetails(const ISerializable *info, const CFileItemPtr &item, std::set<std::string> &fields, CVariant &result, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit = true);
     static void HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit = true);
+    /*!
+     \brief Same as HandleFileItemList(), but the objects of the items are only created while the
+     response is written (see CJSONRPC::AddResultItems()), so result[resultname] must not be
+     changed or copied afterwards. ID must stay valid until then.
+     */
+    static void StreamFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit = true);
     static void HandleFileItem(const char* ID,
                                bool allowFile,
                                const char* resultname,
@@ -46,6 +52,9 @@ namespace JSONRPC
 
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
   private:
+    class CFileItemSource;
+
+    static void AddFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, int size, bool sortLimit, bool stream);
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
     static bool GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader = NULL);
   };
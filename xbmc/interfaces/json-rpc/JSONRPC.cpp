@@ -30,6 +30,12 @@ using namespace JSONRPC;
 
 bool CJSONRPC::m_initialized = false;
 
+namespace
+{
+// item sources of the result of the method called on this thread, if its response is streamed
+thread_local CJSONVariantStreamWriter::ItemSources* currentItemSources = nullptr;
+}
+
 void CJSONRPC::Initialize()
 {
   if (m_initialized)
@@ -230,7 +236,43 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CVariant outputroot;
+  std::string str;
+  if (HandleRequest(inputString, transport, client, outputroot, nullptr))
+    CJSONVariantWriter::Write(outputroot, str, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+
+  return str;
+}
+
+std::unique_ptr<CJSONVariantStreamWriter> CJSONRPC::StreamMethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
+{
+  CVariant outputroot;
+  CJSONVariantStreamWriter::ItemSources itemSources;
+  if (!HandleRequest(inputString, transport, client, outputroot, &itemSources))
+    return {};
+
+  return std::make_unique<CJSONVariantStreamWriter>(std::move(outputroot), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact, std::move(itemSources));
+}
+
+void CJSONRPC::AddResultItems(CVariant &items, std::unique_ptr<IJSONVariantItemSource> source)
+{
+  if (items.isNull())
+    items = CVariant(CVariant::VariantTypeArray);
+
+  if (currentItemSources)
+  {
+    currentItemSources->emplace(&items, std::move(source));
+    return;
+  }
+
+  CVariant item;
+  while (source->GetNext(item))
+    items.push_back(std::move(item));
+}
+
+bool CJSONRPC::HandleRequest(const std::string &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot, CJSONVariantStreamWriter::ItemSources *itemSources)
+{
+  CVariant inputroot;
   bool hasResponse = false;
 
   CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Incoming request: %s", inputString.c_str());
@@ -250,16 +292,16 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
         for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
         {
           CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
+          if (HandleMethodCall(*itr, response, transport, client, itemSources))
           {
-            outputroot.append(response);
+            outputroot.append(std::move(response));
             hasResponse = true;
           }
         }
       }
     }
     else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
+      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client, itemSources);
   }
   else
   {
@@ -268,17 +310,14 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
     hasResponse = true;
   }
 
-  std::string str;
-  if (hasResponse)
-    CJSONVariantWriter::Write(outputroot, str, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
-
-  return str;
+  return hasResponse;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONVariantStreamWriter::ItemSources *itemSources)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
+  CJSONVariantStreamWriter::ItemSources resultItemSources;
   bool isNotification = false;
 
   if (IsProperJSONRPC(request))
@@ -292,7 +331,12 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      CJSONVariantStreamWriter::ItemSources* previousItemSources = currentItemSources;
+      currentItemSources = itemSources ? &resultItemSources : nullptr;
       errorCode = method(methodName, transport, client, params, result);
+      currentItemSources = previousItemSources;
+    }
     else
       result = params;
   }
@@ -305,7 +349,18 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  BuildResponse(request, errorCode, std::move(result), response);
+
+  // the items of the result are only needed if it is sent
+  if (errorCode == OK && !isNotification)
+  {
+    for (auto& itemSource : resultItemSources)
+    {
+      // the result itself has been moved into the response
+      const CVariant* items = itemSource.first == &result ? &response["result"] : itemSource.first;
+      itemSources->emplace(items, std::move(itemSource.second));
+    }
+  }
 
   return !isNotification;
 }
@@ -315,7 +370,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -323,7 +378,8 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      // the result of library calls can be huge, don't copy it
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -336,7 +392,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -10,9 +10,11 @@
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "utils/JSONVariantWriter.h"
 
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdio.h>
 #include <string>
 
@@ -53,6 +55,31 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request, serializing the response while it is read
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \return Writer of the JSON-RPC response to be sent back to the client, nullptr if there is
+     no response (notifications)
+
+     Same as MethodCall() above, for transports which pass large responses on while they are
+     being serialized. The items added with AddResultItems() are only created while the response
+     is read from the writer.
+     */
+    static std::unique_ptr<CJSONVariantStreamWriter> StreamMethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
+
+    /*!
+     \brief Adds the items of a source to an array of the result of the method being called
+     \param items Array in the result object (or the result itself) to append the items to
+     \param source Source of the items
+
+     If the response is streamed, the items are only taken from the source while it is written,
+     otherwise they are appended right away. Either way the array must not be changed or copied
+     anymore afterwards, and it can only have one source.
+     */
+    static void AddResultItems(CVariant &items, std::unique_ptr<IJSONVariantItemSource> source);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -62,10 +89,11 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
 
   private:
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleRequest(const std::string &inputString, ITransportLayer *transport, IClient *client, CVariant &response, CJSONVariantStreamWriter::ItemSources *itemSources);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONVariantStreamWriter::ItemSources *itemSources);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -1107,7 +1107,7 @@ JSONRPC_STATUS CVideoLibrary::HandleItems(const char *idProperty, const char *re
   int size = items.Size();
   if (!limit && items.HasProperty("total") && items.GetProperty("total").asInteger() > size)
     size = (int)items.GetProperty("total").asInteger();
-  HandleFileItemList(idProperty, true, resultName, items, parameterObject, result, size, limit);
+  StreamFileItemList(idProperty, true, resultName, items, parameterObject, result, size, limit);
 
   return OK;
 }
@@ -100,6 +100,20 @@ static void AnnounceUpdate(const std::string& content, int id, bool added = fals
   CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::AudioLibrary, "OnUpdate", data);
 }
 
+struct CMusicDatabase::JSONQuery
+{
+  JSONQuery(const MediaType& type, size_t joinFields) : type(type), joinLayout(joinFields) {}
+
+  MediaType type;
+  DatasetLayout joinLayout;
+  std::vector<int> dbfieldindex;
+  std::vector<std::string> rolefieldlist;
+  std::vector<int> roleidlist;
+  bool bJoinAlbumArtist = false;
+  bool bJoinSongArtist = false;
+  bool bJoinRole = false;
+};
+
 CMusicDatabase::CMusicDatabase(void)
 {
   m_translateBlankArtist = true;
@@ -1008,40 +1022,65 @@ int CMusicDatabase::AddSong(const int idSong, const CDateTime& dtDateNew,
         "strDiscSubtitle, strFileName, dateAdded,  "
         "strMusicBrainzTrackID, strArtistSort, "
         "iTimesPlayed, iStartOffset, iEndOffset, "
-        "lastplayed, rating, userrating, votes, comment, mood, strReplayGain) ";
-
+        "lastplayed, rating, userrating, votes, comment, mood, strReplayGain) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+        "?, ?)";
+
+      // The values are bound rather than formatted into the query, so adding the songs of a scan
+      // reuses the compiled query
+      dbiplus::field_value null;
+      null.set_isNull();
+      dbiplus::sql_record values;
       if (idSong <= 0)
+      {
         // Song ID is autoincremented and dateNew set by trigger
-        strSQL += PrepareSQL("VALUES (NULL, NULL, ");
+        values.push_back(null);
+        values.push_back(null);
+      }
       else
+      {
         //Reuse song Id and original date when the Id added
-        strSQL += PrepareSQL("VALUES (%i, '%s', ", idSong, dtDateNew.GetAsDBDateTime().c_str());
-
-      strSQL +=
-          PrepareSQL("%i, %i, '%s', '%s', %i, %i, '%s', '%s', %i, %i, %i, %i,'%s', '%s', '%s' ",
-                     idAlbum, idPath, artistDisp.c_str(), strTitle.c_str(), iTrack, iDuration,
-                     strRelease.c_str(), strOriginal.c_str(), iBPM, iBitRate, iSampleRate,
-                     iChannels, strDiscSubtitle.c_str(), strFileName.c_str(), strDateMedia.c_str());
-
+        values.emplace_back(idSong);
+        values.emplace_back(dtDateNew.GetAsDBDateTime().c_str());
+      }
+      values.emplace_back(idAlbum);
+      values.emplace_back(idPath);
+      values.emplace_back(artistDisp.c_str());
+      values.emplace_back(strTitle.c_str());
+      values.emplace_back(iTrack);
+      values.emplace_back(iDuration);
+      values.emplace_back(strRelease.c_str());
+      values.emplace_back(strOriginal.c_str());
+      values.emplace_back(iBPM);
+      values.emplace_back(iBitRate);
+      values.emplace_back(iSampleRate);
+      values.emplace_back(iChannels);
+      values.emplace_back(strDiscSubtitle.c_str());
+      values.emplace_back(strFileName.c_str());
+      values.emplace_back(strDateMedia.c_str());
       if (strMusicBrainzTrackID.empty())
-        strSQL += PrepareSQL(",NULL");
+        values.push_back(null);
       else
-        strSQL += PrepareSQL(",'%s'", strMusicBrainzTrackID.c_str());
+        values.emplace_back(strMusicBrainzTrackID.c_str());
       if (artistSort.empty() || artistSort.compare(artistDisp) == 0)
-        strSQL += PrepareSQL(",NULL");
+        values.push_back(null);
       else
-        strSQL += PrepareSQL(",'%s'", artistSort.c_str());
-
+        values.emplace_back(artistSort.c_str());
+      values.emplace_back(iTimesPlayed);
+      values.emplace_back(iStartOffset);
+      values.emplace_back(iEndOffset);
       if (dtLastPlayed.IsValid())
-        strSQL += PrepareSQL(",%i,%i,%i,'%s', %.1f, %i, %i, '%s','%s', '%s')", iTimesPlayed,
-                             iStartOffset, iEndOffset, dtLastPlayed.GetAsDBDateTime().c_str(),
-                             rating, userrating, votes, strComment.c_str(), strMood.c_str(),
-                             replayGain.Get().c_str());
+        values.emplace_back(dtLastPlayed.GetAsDBDateTime().c_str());
       else
-        strSQL += PrepareSQL(",%i,%i,%i,NULL, %.1f, %i, %i,'%s', '%s', '%s')", iTimesPlayed,
-                             iStartOffset, iEndOffset, rating, userrating, votes,
-                             strComment.c_str(), strMood.c_str(), replayGain.Get().c_str());
-      m_pDS->exec(strSQL);
+        values.push_back(null);
+      values.emplace_back(StringUtils::Format("%.1f", rating).c_str());
+      values.emplace_back(userrating);
+      values.emplace_back(votes);
+      values.emplace_back(strComment.c_str());
+      values.emplace_back(strMood.c_str());
+      values.emplace_back(replayGain.Get().c_str());
+      if (!ExecuteQuery(strSQL, values))
+        return -1;
       if (idSong <= 0)
         idNew = (int)m_pDS->lastinsertid();
       else
@@ -6692,9 +6731,10 @@ static const translateJSONField JSONtoDBAlbum[] = {
 
 static const size_t NUM_ALBUM_FIELDS = sizeof(JSONtoDBAlbum) / sizeof(translateJSONField);
 
-bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,  
-  CVariant& result, int& total, const SortDescription &sortDescription /* = SortDescription() */)
+bool CMusicDatabase::QueryAlbumsJSON(const std::set<std::string>& fields, const std::string &baseDir,
+  int& total, const SortDescription &sortDescription /* = SortDescription() */)
 {
+  m_jsonQuery.reset();
 
   if (nullptr == m_pDB)
     return false;
@@ -6705,7 +6745,6 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
   {
     total = -1;
 
-    size_t resultcount = 0;
     Filter extFilter;
     CMusicDbUrl musicUrl;
     // sorting passed into GetFilter() but not used as we only want to use the Const sortDescription
@@ -6725,7 +6764,6 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
     // (includes xsp limits from filter, but not sort limits)
     // Use albumview as filter rules in where clause may use scalar query fields
     total = GetSingleValueInt("SELECT COUNT(1) FROM albumview " + strSQLExtra, m_pDS);
-    resultcount = static_cast<size_t>(total);
 
     // Get order by (and any scalar query artist fields
     int iAddedFields = GetOrderFilter(MediaTypeAlbum, sortDescription, extFilter);
@@ -6749,9 +6787,10 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
       }
     }   
     Filter joinFilter;
-    DatasetLayout joinLayout(static_cast<size_t>(joinToAlbum_enumCount));
+    auto query = std::make_unique<JSONQuery>(MediaTypeAlbum, static_cast<size_t>(joinToAlbum_enumCount));
+    DatasetLayout& joinLayout = query->joinLayout;
     extFilter.AppendField("albumview.idAlbum");  // ID "albumid" in JSON
-    std::vector<int> dbfieldindex;
+    std::vector<int>& dbfieldindex = query->dbfieldindex;
     // JSON "label" field is strAlbum which may also be requested as "title", query field once output twice
     extFilter.AppendField(JSONtoDBAlbum[0].fieldDB);
     if (fields.find(JSONtoDBAlbum[0].fieldJSON) != fields.end())
@@ -6814,13 +6853,10 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
     {
       strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
-      resultcount = std::min(
-          DatabaseUtils::GetLimitCount(sortDescription.limitEnd, sortDescription.limitStart),
-          resultcount);
     }
 
     // Setup multivalue JOINs, GROUP BY and ORDER BY
-    bool bJoinAlbumArtist(false);
+    bool& bJoinAlbumArtist = query->bJoinAlbumArtist;
     if (sortDescription.sortBy != SortByRandom)
     {
       // Repeat inline view order (that always includes idAlbum) on join query
@@ -6896,88 +6932,97 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
       return true;
     }
 
-    // Get albums from returned rows. Joins means there can be many rows per album
-    int albumId = -1;
+    // The albums are read from the rows by GetNextAlbumJSON()
+    m_jsonQuery = std::move(query);
+    return true;
+  }
+  catch (...)
+  {
+    m_pDS->close();
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetNextAlbumJSON(CVariant& album)
+{
+  if (!m_jsonQuery || m_jsonQuery->type != MediaTypeAlbum)
+    return false;
+  if (nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    if (m_pDS->eof())
+    {
+      m_pDS->close(); // cleanup recordset data
+      m_jsonQuery.reset();
+      return false;
+    }
+
+    DatasetLayout& joinLayout = m_jsonQuery->joinLayout;
+    const std::vector<int>& dbfieldindex = m_jsonQuery->dbfieldindex;
+
+    // Get album from returned rows. Joins means there can be many rows per album
+    const dbiplus::sql_record* record = m_pDS->get_sql_record();
+    const int albumId = record->at(0).get_asInt();
     int artistId = -1;
     CVariant albumObj;
-    result["albums"].reserve(resultcount);
-    while (!m_pDS->eof() || !albumObj.empty())
-    {
-      const dbiplus::sql_record* const record = m_pDS->get_sql_record();
 
-      if (m_pDS->eof() || albumId != record->at(0).get_asInt())
-      { 
-        // Store previous or last album
-        if (!albumObj.empty())
+    albumObj["albumid"] = albumId;
+    albumObj["label"] = record->at(1).get_asString();
+    for (size_t i = 0; i < dbfieldindex.size(); i++)
+      if (dbfieldindex[i] > -1)
+      {
+        if (JSONtoDBAlbum[dbfieldindex[i]].fieldDB == "songgenres")
         {
-          // Split sources string into int array
-          if (albumObj.isMember("sourceid"))
+          // Convert "20,Jazz,54,New Age,65,Rock" into array of objects
+          std::vector<std::string> values =
+              StringUtils::Split(record->at(1 + i).get_asString(), ",");
+          if (values.size() % 2 == 0) // Must contain an even number of entries
           {
-            std::vector<std::string> sources = StringUtils::Split(albumObj["sourceid"].asString(), ";");
-            albumObj["sourceid"] = CVariant(CVariant::VariantTypeArray);
-            for (size_t i = 0; i < sources.size(); i++)
-              albumObj["sourceid"].append(atoi(sources[i].c_str()));
-          }
-          result["albums"].append(albumObj);
-          albumObj.clear();          
-          artistId = -1;
-        }
-        if (m_pDS->eof())
-          continue; // Having saved last album stop
-
-        // New album
-        albumId = record->at(0).get_asInt();
-        albumObj["albumid"] = albumId;
-        albumObj["label"] = record->at(1).get_asString();
-        for (size_t i = 0; i < dbfieldindex.size(); i++)
-          if (dbfieldindex[i] > -1)
-          {
-            if (JSONtoDBAlbum[dbfieldindex[i]].fieldDB == "songgenres")
+            for (size_t i = 0; i + 1 < values.size(); i += 2)
             {
-              // Convert "20,Jazz,54,New Age,65,Rock" into array of objects
-              std::vector<std::string> values =
-                  StringUtils::Split(record->at(1 + i).get_asString(), ",");
-              if (values.size() % 2 == 0) // Must contain an even number of entries
+              int idGenre = atoi(values[i].c_str());
+              if (idGenre > 0)
               {
-                for (size_t i = 0; i + 1 < values.size(); i += 2)
-                {
-                  int idGenre = atoi(values[i].c_str());
-                  if (idGenre > 0)
-                  {
-                    CVariant genreObj;
-                    genreObj["genreid"] = idGenre;
-                    genreObj["title"] = values[i + 1];
-                    albumObj["songgenres"].append(genreObj);
-                  }
-                }
+                CVariant genreObj;
+                genreObj["genreid"] = idGenre;
+                genreObj["title"] = values[i + 1];
+                albumObj["songgenres"].append(genreObj);
               }
-              // Ensure albums with null songgenres get empty array
-              if (!albumObj.isMember("songgenres"))
-                albumObj["songgenres"] = CVariant(CVariant::VariantTypeArray);
-            }
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "integer")
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asInt();
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "unsigned")
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asInt(), 0);
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "float")
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asFloat(), 0.f);
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "array")
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = StringUtils::Split(record->at(1 + i).get_asString(),
-                CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "boolean")
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asBool();
-            else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "image")
-            {
-              std::string url = record->at(1 + i).get_asString();
-              if (!url.empty())
-                url = CTextureUtils::GetWrappedImageURL(url);
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = url;
             }
-            else
-              albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asString();
           }
+          // Ensure albums with null songgenres get empty array
+          if (!albumObj.isMember("songgenres"))
+            albumObj["songgenres"] = CVariant(CVariant::VariantTypeArray);
+        }
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "integer")
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asInt();
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "unsigned")
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asInt(), 0);
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "float")
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asFloat(), 0.f);
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "array")
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = StringUtils::Split(record->at(1 + i).get_asString(),
+            CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "boolean")
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asBool();
+        else if (JSONtoDBAlbum[dbfieldindex[i]].formatJSON == "image")
+        {
+          std::string url = record->at(1 + i).get_asString();
+          if (!url.empty())
+            url = CTextureUtils::GetWrappedImageURL(url);
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = url;
+        }
+        else
+          albumObj[JSONtoDBAlbum[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asString();
       }
-      if (bJoinAlbumArtist && joinLayout.GetRecNo(joinToAlbum_idArtist) > -1)
+
+    do
+    {
+      record = m_pDS->get_sql_record();
+      if (m_jsonQuery->bJoinAlbumArtist && joinLayout.GetRecNo(joinToAlbum_idArtist) > -1)
       {
         if (artistId != record->at(joinLayout.GetRecNo(joinToAlbum_idArtist)).get_asInt())
         {
@@ -7001,18 +7046,24 @@ bool CMusicDatabase::GetAlbumsByWhereJSON(const std::set<std::string>& fields, c
         }        
       }
       m_pDS->next();
-    }
-    m_pDS->close(); // cleanup recordset data
+    } while (!m_pDS->eof() && m_pDS->get_sql_record()->at(0).get_asInt() == albumId);
 
-    // Ensure random order of output when results set is sorted to process multi-value joins
-    if (sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields())
-      KODI::UTILS::RandomShuffle(result["albums"].begin_array(), result["albums"].end_array());
+    // Split sources string into int array
+    if (albumObj.isMember("sourceid"))
+    {
+      std::vector<std::string> sources = StringUtils::Split(albumObj["sourceid"].asString(), ";");
+      albumObj["sourceid"] = CVariant(CVariant::VariantTypeArray);
+      for (size_t i = 0; i < sources.size(); i++)
+        albumObj["sourceid"].append(atoi(sources[i].c_str()));
+    }
 
+    album = std::move(albumObj);
     return true;
   }
   catch (...)
   {
     m_pDS->close();
+    m_jsonQuery.reset();
     CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
   return false;
@@ -7101,9 +7152,10 @@ static const translateJSONField JSONtoDBSong[] = {
 
 static const size_t NUM_SONG_FIELDS = sizeof(JSONtoDBSong) / sizeof(translateJSONField);
 
-bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string &baseDir,
-  CVariant& result, int& total, const SortDescription &sortDescription /* = SortDescription() */)
+bool CMusicDatabase::QuerySongsJSON(const std::set<std::string>& fields, const std::string &baseDir,
+  int& total, const SortDescription &sortDescription /* = SortDescription() */)
 {
+  m_jsonQuery.reset();
 
   if (nullptr == m_pDB)
     return false;
@@ -7114,7 +7166,6 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
   {
     total = -1;
 
-    size_t resultcount = 0;
     Filter extFilter;
     CMusicDbUrl musicUrl;
     // sorting passed into GetFilter() but not used as we only want to use the Const sortDescription
@@ -7150,7 +7201,6 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
     // Count number of songs that satisfy selection criteria 
     // (includes xsp limits from filter, but not sort limits)
     total = GetSingleValueInt("SELECT COUNT(1) FROM song " + strSQLExtra, m_pDS);
-    resultcount = static_cast<size_t>(total);
 
     int iAddedFields = GetOrderFilter(MediaTypeSong, sortDescription, extFilter);
     // Replace songview field names in order by with song, album path table field names
@@ -7188,17 +7238,18 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
       }
     }    
     Filter joinFilter;
-    DatasetLayout joinLayout(static_cast<size_t>(joinToSongs_enumCount));
+    auto query = std::make_unique<JSONQuery>(MediaTypeSong, static_cast<size_t>(joinToSongs_enumCount));
+    DatasetLayout& joinLayout = query->joinLayout;
     extFilter.AppendField("song.idSong");  // ID "songid" in JSON
-    std::vector<int> dbfieldindex;
+    std::vector<int>& dbfieldindex = query->dbfieldindex;
     // JSON "label" field is strTitle which may also be requested as "title", query field once output twice
     extFilter.AppendField(JSONtoDBSong[0].fieldDB);
     if (fields.find(JSONtoDBSong[0].fieldJSON) != fields.end())
       dbfieldindex.emplace_back(0); // Output "title"
     else
       dbfieldindex.emplace_back(-1); // Fetch but not output
-    std::vector<std::string> rolefieldlist;
-    std::vector<int> roleidlist;
+    std::vector<std::string>& rolefieldlist = query->rolefieldlist;
+    std::vector<int>& roleidlist = query->roleidlist;
     // Check each optional db field that could be retrieved (not label)
     for (unsigned int i = 1; i < NUM_SONG_FIELDS; i++)
     {
@@ -7281,15 +7332,12 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
       (sortDescription.limitStart > 0 || sortDescription.limitEnd > 0))
     {
       strSQLExtra += DatabaseUtils::BuildLimitClause(sortDescription.limitEnd, sortDescription.limitStart);
-      resultcount = std::min(
-        DatabaseUtils::GetLimitCount(sortDescription.limitEnd, sortDescription.limitStart),
-        resultcount);
     }
     
     // Setup multivalue JOINs, GROUP BY and ORDER BY
-    bool bJoinSongArtist(false);
-    bool bJoinAlbumArtist(false);
-    bool bJoinRole(false);
+    bool& bJoinSongArtist = query->bJoinSongArtist;
+    bool& bJoinAlbumArtist = query->bJoinAlbumArtist;
+    bool& bJoinRole = query->bJoinRole;
     if (sortDescription.sortBy != SortByRandom)
     {
       // Repeat inline view order (that always includes idSong) on join query
@@ -7460,106 +7508,85 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
       return true;
     }
 
+    // The songs are read from the rows by GetNextSongJSON()
+    m_jsonQuery = std::move(query);
+    return true;
+  }
+  catch (...)
+  {
+    m_pDS->close();
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetNextSongJSON(CVariant& song)
+{
+  if (!m_jsonQuery || m_jsonQuery->type != MediaTypeSong)
+    return false;
+  if (nullptr == m_pDS)
+    return false;
+
+  try
+  {
+    if (m_pDS->eof())
+    {
+      m_pDS->close(); // cleanup recordset data
+      m_jsonQuery.reset();
+      return false;
+    }
+
+    DatasetLayout& joinLayout = m_jsonQuery->joinLayout;
+    const std::vector<int>& dbfieldindex = m_jsonQuery->dbfieldindex;
+    const std::vector<std::string>& rolefieldlist = m_jsonQuery->rolefieldlist;
+    const std::vector<int>& roleidlist = m_jsonQuery->roleidlist;
+
     // Get song from returned rows. Joins mean there can be many rows per song
-    int songId = -1;
+    const dbiplus::sql_record* record = m_pDS->get_sql_record();
+    const int songId = record->at(0).get_asInt();
     int albumartistId = -1;
     int artistId = -1;
     int roleId = -1;
     bool bSongGenreDone(false);
     bool bSongArtistDone(false);
-    bool bHaveSong(false);
     CVariant songObj;
-    result["songs"].reserve(resultcount);
-    while (!m_pDS->eof() || bHaveSong)
-    {
-      const dbiplus::sql_record* const record = m_pDS->get_sql_record();
 
-      if (m_pDS->eof() || songId != record->at(0).get_asInt())
-      {
-        // Store previous or last song
-        if (bHaveSong)
-        {
-          // Check empty role fields get returned, and format
-          if (!rolefieldlist.empty())
-          {
-            for (const auto& displayXXX : rolefieldlist)
-            {
-              if (!StringUtils::StartsWith(displayXXX, "display"))
-              {
-                // "contributors"
-                if (!songObj.isMember(displayXXX))
-                  songObj[displayXXX] = CVariant(CVariant::VariantTypeArray);
-              }
-              else if (songObj.isMember(displayXXX) && songObj[displayXXX].isArray())
-              {
-                // Convert "displaycomposer", "displayconductor", "displayorchestra",
-                // and "displaylyricist" arrays into strings
-                std::vector<std::string> names;
-                for (CVariant::const_iterator_array field = songObj[displayXXX].begin_array();
-                     field != songObj[displayXXX].end_array(); field++)
-                  names.emplace_back(field->asString());
-
-                std::string role = StringUtils::Join(names, CServiceBroker::GetSettingsComponent()
-                                                                ->GetAdvancedSettings()
-                                                                ->m_musicItemSeparator);
-                songObj[displayXXX] = role;
-              }
-              else
-                songObj[displayXXX] = "";
-            }
-          }
-          result["songs"].append(songObj);
-          bHaveSong = false;
-          songObj.clear();
-        }
-        if (songObj.empty())
-        {
-          // Initialise fields, ensure those with possible null values are set to correct empty variant type
-          if (joinLayout.GetOutput(joinToSongs_idGenre))
-            songObj["genreid"] = CVariant(CVariant::VariantTypeArray); //"genre" set [] by split of array
+    // Initialise fields, ensure those with possible null values are set to correct empty variant type
+    if (joinLayout.GetOutput(joinToSongs_idGenre))
+      songObj["genreid"] = CVariant(CVariant::VariantTypeArray); //"genre" set [] by split of array
 
-          albumartistId = -1;
-          artistId = -1;
-          roleId = -1;
-          bSongGenreDone = false;
-          bSongArtistDone = false;
-        }
-        if (m_pDS->eof())
-          continue;  // Having saved the last song stop
-
-        // New song
-        songId = record->at(0).get_asInt();
-        bHaveSong = true;
-        songObj["songid"] = songId;
-        songObj["label"] = record->at(1).get_asString();
-        for (size_t i = 0; i < dbfieldindex.size(); i++)
-          if (dbfieldindex[i] > -1)
-          {
-            if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "integer")
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asInt();
-            else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "unsigned")
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asInt(), 0);
-            else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "float")
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asFloat(), 0.f);
-            else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "array")
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = StringUtils::Split(record->at(1 + i).get_asString(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
-            else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "boolean")
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asBool();
-            else
-              songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asString();
-          }
-
-        // Split sources string into int array
-        if (songObj.isMember("sourceid"))
-        {
-          std::vector<std::string> sources = StringUtils::Split(songObj["sourceid"].asString(), ";");
-          songObj["sourceid"] = CVariant(CVariant::VariantTypeArray);
-          for (size_t i = 0; i < sources.size(); i++)
-            songObj["sourceid"].append(atoi(sources[i].c_str()));
-        }
+    songObj["songid"] = songId;
+    songObj["label"] = record->at(1).get_asString();
+    for (size_t i = 0; i < dbfieldindex.size(); i++)
+      if (dbfieldindex[i] > -1)
+      {
+        if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "integer")
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asInt();
+        else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "unsigned")
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asInt(), 0);
+        else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "float")
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = std::max(record->at(1 + i).get_asFloat(), 0.f);
+        else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "array")
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = StringUtils::Split(record->at(1 + i).get_asString(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
+        else if (JSONtoDBSong[dbfieldindex[i]].formatJSON == "boolean")
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asBool();
+        else
+          songObj[JSONtoDBSong[dbfieldindex[i]].fieldJSON] = record->at(1 + i).get_asString();
       }
 
-      if (bJoinAlbumArtist)
+    // Split sources string into int array
+    if (songObj.isMember("sourceid"))
+    {
+      std::vector<std::string> sources = StringUtils::Split(songObj["sourceid"].asString(), ";");
+      songObj["sourceid"] = CVariant(CVariant::VariantTypeArray);
+      for (size_t i = 0; i < sources.size(); i++)
+        songObj["sourceid"].append(atoi(sources[i].c_str()));
+    }
+
+    do
+    {
+      record = m_pDS->get_sql_record();
+      if (m_jsonQuery->bJoinAlbumArtist)
       {
         if (albumartistId != record->at(joinLayout.GetRecNo(joinToSongs_idAlbumArtist)).get_asInt())
         {
@@ -7586,7 +7613,7 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
           }
         }
       }
-      if (bJoinSongArtist && !bSongArtistDone)
+      if (m_jsonQuery->bJoinSongArtist && !bSongArtistDone)
       {
         if (artistId != record->at(joinLayout.GetRecNo(joinToSongs_idArtist)).get_asInt())
         {
@@ -7621,7 +7648,7 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
           roleId = record->at(joinLayout.GetRecNo(joinToSongs_idRole)).get_asInt();
           if (roleId > 1)
           {
-            if (bJoinRole)
+            if (m_jsonQuery->bJoinRole)
             {  //Contributors
                CVariant contributor;
                contributor["name"] = record->at(joinLayout.GetRecNo(joinToSongs_strArtist)).get_asString();
@@ -7648,18 +7675,45 @@ bool CMusicDatabase::GetSongsByWhereJSON(const std::set<std::string>& fields, co
         songObj["genreid"].append(record->at(joinLayout.GetRecNo(joinToSongs_idGenre)).get_asInt());
       }
       m_pDS->next();
-    }
-    m_pDS->close(); // cleanup recordset data
+    } while (!m_pDS->eof() && m_pDS->get_sql_record()->at(0).get_asInt() == songId);
 
-    // Ensure random order of output when results set is sorted to process multi-value joins
-    if (sortDescription.sortBy == SortByRandom && joinLayout.HasFilterFields())
-      KODI::UTILS::RandomShuffle(result["songs"].begin_array(), result["songs"].end_array());
+    // Check empty role fields get returned, and format
+    if (!rolefieldlist.empty())
+    {
+      for (const auto& displayXXX : rolefieldlist)
+      {
+        if (!StringUtils::StartsWith(displayXXX, "display"))
+        {
+          // "contributors"
+          if (!songObj.isMember(displayXXX))
+            songObj[displayXXX] = CVariant(CVariant::VariantTypeArray);
+        }
+        else if (songObj.isMember(displayXXX) && songObj[displayXXX].isArray())
+        {
+          // Convert "displaycomposer", "displayconductor", "displayorchestra",
+          // and "displaylyricist" arrays into strings
+          std::vector<std::string> names;
+          for (CVariant::const_iterator_array field = songObj[displayXXX].begin_array();
+               field != songObj[displayXXX].end_array(); field++)
+            names.emplace_back(field->asString());
+
+          std::string role = StringUtils::Join(names, CServiceBroker::GetSettingsComponent()
+                                                          ->GetAdvancedSettings()
+                                                          ->m_musicItemSeparator);
+          songObj[displayXXX] = role;
+        }
+        else
+          songObj[displayXXX] = "";
+      }
+    }
 
+    song = std::move(songObj);
     return true;
   }
   catch (...)
   {
     m_pDS->close();
+    m_jsonQuery.reset();
     CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
   return false;
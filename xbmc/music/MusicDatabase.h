@@ -13,6 +13,7 @@
 \brief
 */
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -532,10 +533,38 @@ public:
   bool GetGenresJSON(CFileItemList& items, bool bSources = false);
   bool GetArtistsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
     CVariant& result, int& total, const SortDescription& sortDescription = SortDescription());
-  bool GetAlbumsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
-    CVariant& result, int& total, const SortDescription& sortDescription = SortDescription());
-  bool GetSongsByWhereJSON(const std::set<std::string>& fields, const std::string& baseDir,
-    CVariant& result, int& total, const SortDescription& sortDescription = SortDescription());
+  /*! \brief Queries the albums of a JSON-RPC request, to be read one at a time by GetNextAlbumJSON.
+  The albums are read from the rows of the database's dataset, so the database must not be used
+  otherwise until all of them are read. A random sort order is not shuffled again.
+  \param fields the JSON fields of the albums
+  \param baseDir the music db url with the filter of the request
+  \param total [out] the number of albums matching the filter, without the limits
+  \param sortDescription the sort order and limits
+  \return true if the query succeeded, even when there are no albums
+  */
+  bool QueryAlbumsJSON(const std::set<std::string>& fields, const std::string& baseDir,
+    int& total, const SortDescription& sortDescription = SortDescription());
+  /*! \brief Gets the next album queried by QueryAlbumsJSON
+  \param album [out] the JSON object of the album
+  \return true if there was another album, false when all of them are read
+  */
+  bool GetNextAlbumJSON(CVariant& album);
+  /*! \brief Queries the songs of a JSON-RPC request, to be read one at a time by GetNextSongJSON.
+  The songs are read from the rows of the database's dataset, so the database must not be used
+  otherwise until all of them are read. A random sort order is not shuffled again.
+  \param fields the JSON fields of the songs
+  \param baseDir the music db url with the filter of the request
+  \param total [out] the number of songs matching the filter, without the limits
+  \param sortDescription the sort order and limits
+  \return true if the query succeeded, even when there are no songs
+  */
+  bool QuerySongsJSON(const std::set<std::string>& fields, const std::string& baseDir,
+    int& total, const SortDescription& sortDescription = SortDescription());
+  /*! \brief Gets the next song queried by QuerySongsJSON
+  \param song [out] the JSON object of the song
+  \return true if there was another song, false when all of them are read
+  */
+  bool GetNextSongJSON(CVariant& song);
 
   /////////////////////////////////////////////////
   // Scraper
@@ -808,6 +837,10 @@ private:
 
   bool m_translateBlankArtist;
 
+  // The JSON-RPC query whose rows are read by GetNextAlbumJSON or GetNextSongJSON
+  struct JSONQuery;
+  std::unique_ptr<JSONQuery> m_jsonQuery;
+
   // Fields should be ordered as they
   // appear in the songview
   static enum _SongFields
@@ -962,7 +995,7 @@ private:
     joinToArtist_enumCount // end of the enum, do not add past here
   } JoinToArtistFields;
 
-  // Fields fetched by GetAlbumsByWhereJSON,  order same as in JSONtoDBAlbum
+  // Fields fetched by QueryAlbumsJSON,  order same as in JSONtoDBAlbum
   static enum _JoinToAlbumFields
   {
     joinToAlbum_idArtist = 0,
@@ -971,10 +1004,10 @@ private:
     joinToAlbum_enumCount // end of the enum, do not add past here
   } JoinToAlbumFields;
 
-  // Fields fetched by GetSongsByWhereJSON,  order same as in JSONtoDBSong
+  // Fields fetched by QuerySongsJSON,  order same as in JSONtoDBSong
   static enum _JoinToSongFields
   {
-    // Used by GetSongsByWhereJSON 
+    // Used by QuerySongsJSON 
     joinToSongs_idAlbumArtist = 0,
     joinToSongs_strAlbumArtist,
     joinToSongs_strAlbumArtistMBID,
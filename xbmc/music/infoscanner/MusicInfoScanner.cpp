@@ -141,7 +141,11 @@ void CMusicInfoScanner::Process()
 
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
+        // Commit the albums of many folders at once, rather than each album on its own, but
+        // at least every second so that other writers aren't locked out for the whole scan
+        m_musicDatabase.BeginBatchedWrites(100, 1000);
         bool scancomplete = DoScan(it);
+        m_musicDatabase.CommitBatchedWrites();
         if (scancomplete)
         {
           if (m_albumsAdded.size() > 0)
@@ -18,6 +18,7 @@
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
 #include "websocket/WebSocketManager.h"
@@ -49,6 +50,7 @@ static const bdaddr_t bt_bdaddr_local = {{0, 0, 0, 0xff, 0xff, 0xff}};
 using namespace JSONRPC;
 
 #define RECEIVEBUFFER 1024
+#define SENDCHUNKSIZE (64 * 1024)
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -537,6 +539,21 @@ void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
   } while (sent < size);
 }
 
+void CTCPServer::CTCPClient::SendResponse(CJSONVariantStreamWriter& response)
+{
+  // announcements from other threads must not end up between the chunks of the response
+  CSingleLock lock(m_critSection);
+
+  // send the response while it's being serialized instead of building it all in memory first
+  std::vector<char> chunk(SENDCHUNKSIZE);
+  ssize_t length;
+  while ((length = response.Read(chunk.data(), chunk.size())) > 0)
+    Send(chunk.data(), static_cast<unsigned int>(length));
+
+  if (length < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to serialize response");
+}
+
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   m_new = false;
@@ -600,8 +617,11 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
       }
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        std::unique_ptr<CJSONVariantStreamWriter> response = CJSONRPC::StreamMethodCall(m_buffer, host, this);
+        if (response)
+          SendResponse(*response);
+        else
+          Send("", 0);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -676,6 +696,47 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendResponse(CJSONVariantStreamWriter& response)
+{
+  // no other message may be sent between the fragments of the response
+  CSingleLock lock(m_critSection);
+
+  // send the response as one fragmented message while it's being serialized. A chunk is only
+  // sent once the next one has been read, so the last fragment can be marked as final.
+  std::vector<char> chunk(SENDCHUNKSIZE);
+  std::vector<char> nextChunk(SENDCHUNKSIZE);
+  ssize_t length = response.Read(chunk.data(), chunk.size());
+  bool first = true;
+  while (length > 0)
+  {
+    const ssize_t nextLength = response.Read(nextChunk.data(), nextChunk.size());
+    if (!SendFragment(chunk.data(), static_cast<uint32_t>(length), first, nextLength <= 0))
+      return;
+
+    first = false;
+    chunk.swap(nextChunk);
+    length = nextLength;
+  }
+
+  if (length < 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to serialize response");
+    // the fragments already sent have to be finished as a message
+    if (!first)
+      SendFragment(nullptr, 0, false, true);
+  }
+}
+
+bool CTCPServer::CWebSocketClient::SendFragment(const char *data, uint32_t size, bool first, bool final)
+{
+  std::unique_ptr<CWebSocketFrame> frame(m_websocket->Fragment(WebSocketTextFrame, data, size, first, final));
+  if (!frame)
+    return false;
+
+  CTCPClient::Send(frame->GetFrameData(), static_cast<unsigned int>(frame->GetFrameLength()));
+  return true;
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
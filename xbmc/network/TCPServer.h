@@ -21,6 +21,7 @@
 
 #include "PlatformDefs.h"
 
+class CJSONVariantStreamWriter;
 class CVariant;
 
 namespace JSONRPC
@@ -65,6 +66,7 @@ namespace JSONRPC
       bool SetAnnouncementFlags(int flags) override;
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendResponse(CJSONVariantStreamWriter& response);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -96,6 +98,7 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendResponse(CJSONVariantStreamWriter& response) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -103,6 +106,8 @@ namespace JSONRPC
       bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
     private:
+      bool SendFragment(const char *data, uint32_t size, bool first, bool final);
+
       CWebSocket *m_websocket;
     };
 
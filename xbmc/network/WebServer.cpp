@@ -367,6 +367,10 @@ MHD_RESULT CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>&
       ret = CreateMemoryDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPError:
       ret =
           CreateErrorResponse(request.connection, responseDetails.status, request.method, response);
@@ -944,6 +948,40 @@ MHD_RESULT CWebServer::CreateFileDownloadResponse(
   return MHD_YES;
 }
 
+MHD_RESULT CWebServer::CreateStreamDownloadResponse(
+    const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response*& response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest& request = handler->GetRequest();
+  if (request.method == HEAD)
+  {
+    response = create_response(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      m_logger->error("failed to create a HTTP HEAD response for {}", request.pathUrl);
+      return MHD_NO;
+    }
+
+    return MHD_YES;
+  }
+
+  // the handler has to stay around until MHD is done reading from it
+  auto context = std::make_unique<std::shared_ptr<IHTTPRequestHandler>>(handler);
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 64 * 1024,
+                                               &CWebServer::StreamReaderCallback, context.get(),
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    m_logger->error("failed to create a HTTP stream response for {}", request.pathUrl);
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+  return MHD_YES;
+}
+
 MHD_RESULT CWebServer::CreateErrorResponse(struct MHD_Connection* connection,
                                            int responseType,
                                            HTTPMethod method,
@@ -1147,6 +1185,32 @@ void CWebServer::ContentReaderFreeCallback(void* cls)
     s_logger->debug("[OUT] done");
 }
 
+ssize_t CWebServer::StreamReaderCallback(void* cls, uint64_t pos, char* buf, size_t max)
+{
+  auto handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr)
+    return -1;
+
+  ssize_t read = (*handler)->ReadResponseData(buf, max);
+  if (read == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+  if (read < 0)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    s_logger->debug("[OUT] write {} bytes at position {}", read, pos);
+
+  return read;
+}
+
+void CWebServer::StreamReaderFreeCallback(void* cls)
+{
+  delete static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+
+  if (CServiceBroker::GetLogging().CanLogComponent(LOGWEBSERVER))
+    s_logger->debug("[OUT] done");
+}
+
 // static logger for libmicrohttpd
 static Logger GetMhdLogger()
 {
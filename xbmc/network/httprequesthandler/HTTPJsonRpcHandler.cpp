@@ -20,8 +20,17 @@
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <string.h>
+
 #define MAX_HTTP_POST_SIZE 65536
 
+CHTTPJsonRpcHandler::CHTTPJsonRpcHandler(const HTTPRequest &request)
+  : IHTTPRequestHandler(request)
+{ }
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler() = default;
+
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request) const
 {
   return (request.pathUrl.compare("/jsonrpc") == 0);
@@ -74,10 +83,19 @@ MHD_RESULT CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
-
-    if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+    // serialize the response while it's being sent
+    m_responseWriter =
+        JSONRPC::CJSONRPC::StreamMethodCall(m_requestData, &m_transportLayer, &client);
+    if (m_responseWriter)
+    {
+      if (!jsonpCallback.empty())
+      {
+        m_responseData = jsonpCallback + "(";
+        m_responseSuffix = ");";
+      }
+    }
+    else if (!jsonpCallback.empty())
+      m_responseData = jsonpCallback + "();";
   }
   else if (jsonpCallback.empty())
   {
@@ -102,6 +120,15 @@ MHD_RESULT CHTTPJsonRpcHandler::HandleRequest()
 
   m_requestData.clear();
 
+  if (m_responseWriter)
+  {
+    m_response.type = HTTPStreamDownload;
+    m_response.status = MHD_HTTP_OK;
+    m_response.contentType = "application/json";
+
+    return MHD_YES;
+  }
+
   m_responseRange.SetData(m_responseData.c_str(), m_responseData.size());
 
   m_response.type = HTTPMemoryDownloadNoFreeCopy;
@@ -120,6 +147,31 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+ssize_t CHTTPJsonRpcHandler::ReadResponseData(char* buffer, size_t size)
+{
+  if (m_responsePosition < m_responseData.size())
+  {
+    const size_t length = std::min(size, m_responseData.size() - m_responsePosition);
+    memcpy(buffer, m_responseData.c_str() + m_responsePosition, length);
+    m_responsePosition += length;
+    return length;
+  }
+
+  if (!m_responseWriter)
+    return 0;
+
+  ssize_t read = m_responseWriter->Read(buffer, size);
+  if (read != 0)
+    return read;
+
+  // the response is complete, only the end of the JSONP wrapper is left
+  m_responseWriter.reset();
+  m_responseData = std::move(m_responseSuffix);
+  m_responsePosition = 0;
+
+  return ReadResponseData(buffer, size);
+}
+
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 {
   if (m_requestData.size() + size > MAX_HTTP_POST_SIZE)
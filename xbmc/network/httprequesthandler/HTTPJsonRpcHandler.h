@@ -12,13 +12,16 @@
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 
+#include <memory>
 #include <string>
 
+class CJSONVariantStreamWriter;
+
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
   CHTTPJsonRpcHandler() = default;
-  ~CHTTPJsonRpcHandler() override = default;
+  ~CHTTPJsonRpcHandler() override;
 
   // implementations of IHTTPRequestHandler
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPJsonRpcHandler(request); }
@@ -27,13 +30,12 @@ public:
   MHD_RESULT HandleRequest() override;
 
   HttpResponseRanges GetResponseData() const override;
+  ssize_t ReadResponseData(char* buffer, size_t size) override;
 
   int GetPriority() const override { return 5; }
 
 protected:
-  explicit CHTTPJsonRpcHandler(const HTTPRequest &request)
-    : IHTTPRequestHandler(request)
-  { }
+  explicit CHTTPJsonRpcHandler(const HTTPRequest &request);
 
   bool appendPostData(const char *data, size_t size) override;
 
@@ -42,6 +44,11 @@ private:
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
 
+  // JSON-RPC responses are streamed, with m_responseData and m_responseSuffix (JSONP) around them
+  std::unique_ptr<CJSONVariantStreamWriter> m_responseWriter;
+  std::string m_responseSuffix;
+  size_t m_responsePosition = 0;
+
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
   public:
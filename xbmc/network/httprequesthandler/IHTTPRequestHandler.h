@@ -60,7 +60,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length which is filled while it is being sent
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -153,6 +155,19 @@ public:
    */
   virtual HttpResponseRanges GetResponseData() const { return HttpResponseRanges(); };
 
+  /*!
+   * \brief Reads the next part of the response data.
+   *
+   * \details This is only used if the response type is HTTPStreamDownload. It is called from
+   * the connection's thread after HandleRequest() until it returns 0 (end of the response) or
+   * -1 (error).
+   *
+   * \param buffer Buffer to fill with response data
+   * \param size Size of the buffer
+   * \return Number of bytes written to the buffer, 0 at the end of the response or -1 on error
+   */
+  virtual ssize_t ReadResponseData(char* buffer, size_t size) { return -1; }
+
   /*!
   * \brief Returns the URL to which the request should be redirected.
   *
@@ -116,6 +116,16 @@ public:
   virtual bool Handshake(const char* data, size_t length, std::string &response) = 0;
   virtual const CWebSocketMessage* Handle(const char* &buffer, size_t &length, bool &send);
   virtual const CWebSocketMessage* Send(WebSocketFrameOpcode opcode, const char* data = NULL, uint32_t length = 0);
+  /*!
+   \brief Creates a frame of a message which is sent in fragments as its data becomes available
+   \param opcode Opcode of the message, only set in its first fragment
+   \param data Data of the fragment
+   \param length Length of the data
+   \param first Whether this is the first fragment of the message
+   \param final Whether this is the last fragment of the message
+   \return Frame to send, owned by the caller, or NULL if it could not be created
+   */
+  CWebSocketFrame* Fragment(WebSocketFrameOpcode opcode, const char* data, uint32_t length, bool first, bool final);
   virtual const CWebSocketFrame* Ping(const char* data = NULL) const = 0;
   virtual const CWebSocketFrame* Pong(const char* data = NULL) const = 0;
   virtual const CWebSocketFrame* Close(WebSocketCloseReason reason = WebSocketCloseNormal, const std::string &message = "") = 0;
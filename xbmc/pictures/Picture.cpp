@@ -11,6 +11,7 @@
 #include "Picture.h"
 #include "URL.h"
 #include "ServiceBroker.h"
+#include "cores/FFmpeg.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
@@ -335,9 +336,9 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch,
                           CPictureScalingAlgorithm::Algorithm scalingAlgorithm /* = CPictureScalingAlgorithm::NoAlgorithm */)
 {
-  struct SwsContext *context = sws_getContext(in_width, in_height, AV_PIX_FMT_BGRA,
-                                                         out_width, out_height, AV_PIX_FMT_BGRA,
-                                                         CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm), NULL, NULL, NULL);
+  struct SwsContext* context = ff_get_cached_sws_context(
+      in_width, in_height, AV_PIX_FMT_BGRA, out_width, out_height, AV_PIX_FMT_BGRA,
+      CPictureScalingAlgorithm::ToSwscale(scalingAlgorithm));
 
   uint8_t *src[] = { in_pixels, 0, 0, 0 };
   int     srcStride[] = { (int)in_pitch, 0, 0, 0 };
@@ -347,7 +348,6 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
   if (context)
   {
     sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
-    sws_freeContext(context);
     return true;
   }
   return false;
@@ -8,6 +8,7 @@
 
 #include "PlatformLinux.h"
 
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "utils/StringUtils.h"
 
 #include "platform/linux/powermanagement/LinuxPowerSyscall.h"
@@ -94,6 +95,10 @@ bool CPlatformLinux::Init()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else if (StringUtils::EqualsNoCase(envSink, "ALSA+PULSE"))
   {
     OPTIONALS::ALSARegister();
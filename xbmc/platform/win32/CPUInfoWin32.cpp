@@ -146,6 +146,19 @@ CCPUInfoWin32::CCPUInfoWin32()
       m_cpuFeatures |= CPU_FEATURE_SSE4;
     if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX registers are only usable if the OS saves them on context switches
+    if ((CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_OSXSAVE) &&
+        (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_AVX) &&
+        (_xgetbv(0) & XCR0_YMM_STATE) == XCR0_YMM_STATE)
+      m_cpuFeatures |= CPU_FEATURE_AVX;
+  }
+
+  if ((m_cpuFeatures & CPU_FEATURE_AVX) && MaxStdInfoType >= CPUID_INFOTYPE_STRUCTURED_EXTENDED)
+  {
+    __cpuidex(CPUInfo, CPUID_INFOTYPE_STRUCTURED_EXTENDED, 0);
+    if (CPUInfo[CPUINFO_EBX] & CPUID_00000007_EBX_AVX2)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
   }
 
   __cpuid(CPUInfo, CPUID_INFOTYPE_EXTENDED_IMPLEMENTED);
@@ -68,6 +68,7 @@ void CPVREpg::Clear()
 {
   CSingleLock lock(m_critSection);
   m_tags.Clear();
+  ++m_iTagsVersion;
 }
 
 void CPVREpg::Cleanup(int iPastDays)
@@ -80,6 +81,7 @@ void CPVREpg::Cleanup(const CDateTime& time)
 {
   CSingleLock lock(m_critSection);
   m_tags.Cleanup(time);
+  ++m_iTagsVersion;
 }
 
 std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagNow(bool bUpdateIfNeeded /* = true */) const
@@ -148,7 +150,10 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpg::GetTagBetween(const CDateTime& beginTim
       tag = tmpEpg->GetTagBetween(beginTime, endTime, false);
 
     if (tag)
+    {
       m_tags.UpdateEntry(tag);
+      ++m_iTagsVersion;
+    }
   }
 
   return tag;
@@ -170,6 +175,7 @@ bool CPVREpg::UpdateEntries(const CPVREpg& epg)
 
   /* copy over tags */
   m_tags.UpdateEntries(epg.m_tags);
+  ++m_iTagsVersion;
 
   /* update the last scan time of this table */
   m_lastScanTime = CDateTime::GetUTCDateTime();
@@ -202,7 +208,11 @@ bool CPVREpg::UpdateEntry(const EPG_TAG* data, int iClientId)
   const std::shared_ptr<CPVREpgInfoTag> tag =
       std::make_shared<CPVREpgInfoTag>(*data, iClientId, m_channelData, m_iEpgID);
 
-  return !IsTagExpired(tag) && m_tags.UpdateEntry(tag);
+  if (IsTagExpired(tag) || !m_tags.UpdateEntry(tag))
+    return false;
+
+  ++m_iTagsVersion;
+  return true;
 }
 
 bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, EPG_EVENT_STATE newState)
@@ -242,7 +252,10 @@ bool CPVREpg::UpdateEntry(const std::shared_ptr<CPVREpgInfoTag>& tag, EPG_EVENT_
   }
 
   if (bRet && bNotify)
+  {
+    ++m_iTagsVersion;
     m_events.Publish(PVREvent::EpgItemUpdate);
+  }
 
   return bRet;
 }
@@ -356,6 +369,11 @@ bool CPVREpg::QueuePersistQuery(const std::shared_ptr<CPVREpgDatabase>& database
   return true;
 }
 
+void CPVREpg::OnPersisted(bool bSuccess)
+{
+  m_tags.OnPersisted(bSuccess);
+}
+
 bool CPVREpg::QueueDeleteQueries(const std::shared_ptr<CPVREpgDatabase>& database)
 {
   if (!database)
@@ -502,6 +520,7 @@ void CPVREpg::SetChannelData(const std::shared_ptr<CPVREpgChannelData>& data)
   CSingleLock lock(m_critSection);
   m_channelData = data;
   m_tags.SetChannelData(data);
+  ++m_iTagsVersion;
 }
 
 int CPVREpg::ChannelID() const
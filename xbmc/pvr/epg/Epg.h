@@ -94,6 +94,12 @@ namespace PVR
      */
     bool UpdatePending() const;
 
+    /*!
+     * @brief Get the version of the tags of this EPG.
+     * @return The version, increased whenever tags may have been added, changed or removed.
+     */
+    unsigned int GetTagsVersion() const { return m_iTagsVersion; }
+
     /*!
      * @brief Clear the current tags and schedule manual update
      */
@@ -217,6 +223,13 @@ namespace PVR
      */
     bool QueuePersistQuery(const std::shared_ptr<CPVREpgDatabase>& database);
 
+    /*!
+     * @brief Update the in-memory state after the queries written by QueuePersistQuery were
+     * committed to the database. Like QueuePersistQuery, this EPG must be locked by the caller.
+     * @param bSuccess True if the queries were committed, false otherwise.
+     */
+    void OnPersisted(bool bSuccess);
+
     /*!
      * @brief Write the delete queries into the given database's queue
      * @param database The database.
@@ -312,6 +325,7 @@ namespace PVR
 
     bool m_bChanged = false; /*!< true if anything changed that needs to be persisted, false otherwise */
     std::atomic<bool> m_bUpdatePending = {false}; /*!< true if manual update is pending */
+    std::atomic<unsigned int> m_iTagsVersion = {0}; /*!< increased whenever the tags change */
     int m_iEpgID = 0; /*!< the database ID of this table */
     std::string m_strName; /*!< the name of this table */
     std::string m_strScraperName; /*!< the name of the scraper to use */
@@ -282,35 +282,48 @@ bool CPVREpgContainer::PersistAll(unsigned int iMaxTimeslice) const
     // Note: We must lock the db the whole time, otherwise races may occur.
     database->Lock();
 
+    // EPGs with queued queries stay locked until they learned whether these were committed
+    std::vector<std::pair<std::shared_ptr<CPVREpg>, bool>> queuedEpgs;
+    const auto commitQueries = [&database, &queuedEpgs]() {
+      bool bCommitted = database->CommitDeleteQueries();
+      bCommitted &= database->CommitInsertQueries();
+
+      for (const auto& queuedEpg : queuedEpgs)
+      {
+        queuedEpg.first->OnPersisted(bCommitted && queuedEpg.second);
+        queuedEpg.first->Unlock();
+      }
+      queuedEpgs.clear();
+    };
+
     XbmcThreads::EndTime processTimeslice(iMaxTimeslice);
     for (const auto& epg : changedEpgs)
     {
-      if (!processTimeslice.IsTimePast())
+      if (processTimeslice.IsTimePast())
       {
-        CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: Persisting events for channel '{}'...",
-                    epg->GetChannelData()->ChannelName());
+        epg->Unlock();
+        continue;
+      }
 
-        bReturn &= epg->QueuePersistQuery(database);
+      CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: Persisting events for channel '{}'...",
+                  epg->GetChannelData()->ChannelName());
 
-        size_t queryCount = database->GetInsertQueriesCount() + database->GetDeleteQueriesCount();
-        if (queryCount > EPG_COMMIT_QUERY_COUNT_LIMIT)
-        {
-          CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committing {} queries in loop.",
-                      queryCount);
-          database->CommitDeleteQueries();
-          database->CommitInsertQueries();
-          CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committed {} queries in loop.", queryCount);
-        }
-      }
+      const bool bQueued = epg->QueuePersistQuery(database);
+      bReturn &= bQueued;
+      queuedEpgs.emplace_back(epg, bQueued);
 
-      epg->Unlock();
+      size_t queryCount = database->GetInsertQueriesCount() + database->GetDeleteQueriesCount();
+      if (queryCount > EPG_COMMIT_QUERY_COUNT_LIMIT)
+      {
+        CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committing {} queries in loop.", queryCount);
+        commitQueries();
+        CLog::LogFC(LOGDEBUG, LOGEPG, "EPG Container: committed {} queries in loop.", queryCount);
+      }
     }
 
-    if (bReturn)
-    {
-      database->CommitDeleteQueries();
-      database->CommitInsertQueries();
-    }
+    // also commit if queueing failed for an EPG, like in the loop. Queries left in the queue
+    // would be committed along with a later batch, behind the back of the EPGs' tag indexes.
+    commitQueries();
 
     database->Unlock();
   }
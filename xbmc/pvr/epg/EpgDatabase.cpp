@@ -16,8 +16,10 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -36,6 +38,7 @@ void CPVREpgDatabase::Close()
 {
   CSingleLock lock(m_critSection);
   CDatabase::Close();
+  m_searchIndex = SearchIndex::UNKNOWN;
 }
 
 void CPVREpgDatabase::Lock()
@@ -97,6 +100,8 @@ void CPVREpgDatabase::CreateTables()
       ")"
   );
 
+  CreateSearchIndex();
+
   CLog::LogFC(LOGDEBUG, LOGEPG, "Creating table 'lastepgscan'");
   m_pDS->exec("CREATE TABLE lastepgscan ("
         "idEpg integer primary key, "
@@ -112,6 +117,65 @@ void CPVREpgDatabase::CreateAnalytics()
   CSingleLock lock(m_critSection);
   m_pDS->exec("CREATE UNIQUE INDEX idx_epg_idEpg_iStartTime on epgtags(idEpg, iStartTime desc);");
   m_pDS->exec("CREATE INDEX idx_epg_iEndTime on epgtags(iEndTime);");
+
+  if (HasSearchIndex())
+  {
+    CLog::LogFC(LOGDEBUG, LOGEPG, "Creating EPG search index triggers");
+
+    // REPLACE INTO does not fire the delete trigger for the rows it replaces
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_replace BEFORE INSERT ON epgtags FOR EACH ROW BEGIN "
+                "DELETE FROM epgtags_fts WHERE rowid IN (SELECT idBroadcast FROM epgtags "
+                "WHERE idBroadcast = NEW.idBroadcast OR "
+                "(idEpg = NEW.idEpg AND iStartTime = NEW.iStartTime)); "
+                "END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_insert AFTER INSERT ON epgtags FOR EACH ROW BEGIN "
+                "INSERT INTO epgtags_fts (rowid, sTitle, sPlotOutline, sPlot, sEpisodeName, sGenre) "
+                "VALUES (NEW.idBroadcast, NEW.sTitle, NEW.sPlotOutline, NEW.sPlot, NEW.sEpisodeName, "
+                "NEW.sGenre); "
+                "END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_update AFTER UPDATE OF sTitle, sPlotOutline, sPlot, "
+                "sEpisodeName, sGenre ON epgtags FOR EACH ROW BEGIN "
+                "UPDATE epgtags_fts SET sTitle = NEW.sTitle, sPlotOutline = NEW.sPlotOutline, "
+                "sPlot = NEW.sPlot, sEpisodeName = NEW.sEpisodeName, sGenre = NEW.sGenre "
+                "WHERE rowid = NEW.idBroadcast; "
+                "END");
+    m_pDS->exec("CREATE TRIGGER epgtags_fts_delete AFTER DELETE ON epgtags FOR EACH ROW BEGIN "
+                "DELETE FROM epgtags_fts WHERE rowid = OLD.idBroadcast; "
+                "END");
+  }
+}
+
+void CPVREpgDatabase::CreateSearchIndex()
+{
+  // full-text search needs sqlite built with FTS5, the search falls back to LIKE without it
+  if (!m_sqlite)
+    return;
+
+  CLog::LogFC(LOGDEBUG, LOGEPG, "Creating table 'epgtags_fts'");
+  try
+  {
+    // trigrams, so that terms are found anywhere, also inside words, like with LIKE
+    m_pDS->exec("CREATE VIRTUAL TABLE epgtags_fts USING fts5("
+                "sTitle, sPlotOutline, sPlot, sEpisodeName, sGenre, tokenize = 'trigram')");
+  }
+  catch (...)
+  {
+    CLog::Log(LOGWARNING, "EPG search index not supported by sqlite, EPG search will be slow");
+  }
+  m_searchIndex = SearchIndex::UNKNOWN;
+}
+
+bool CPVREpgDatabase::HasSearchIndex()
+{
+  if (m_searchIndex == SearchIndex::UNKNOWN)
+  {
+    const bool bExists =
+        m_sqlite && !GetSingleValue("SELECT name FROM sqlite_master "
+                                    "WHERE type = 'table' AND name = 'epgtags_fts'")
+                         .empty();
+    m_searchIndex = bExists ? SearchIndex::EXISTS : SearchIndex::MISSING;
+  }
+  return m_searchIndex == SearchIndex::EXISTS;
 }
 
 void CPVREpgDatabase::UpdateTables(int iVersion)
@@ -258,6 +322,17 @@ void CPVREpgDatabase::UpdateTables(int iVersion)
     m_pDS->exec("DROP TABLE epgtags");
     m_pDS->exec("ALTER TABLE epgtags_new RENAME TO epgtags");
   }
+
+  if (iVersion < 15)
+  {
+    // version 14 indexed whole words, which doesn't find terms inside words
+    if (m_sqlite && HasSearchIndex())
+      m_pDS->exec("DROP TABLE epgtags_fts");
+    CreateSearchIndex();
+    if (HasSearchIndex())
+      m_pDS->exec("INSERT INTO epgtags_fts (rowid, sTitle, sPlotOutline, sPlot, sEpisodeName, sGenre) "
+                  "SELECT idBroadcast, sTitle, sPlotOutline, sPlot, sEpisodeName, sGenre FROM epgtags");
+  }
 }
 
 bool CPVREpgDatabase::DeleteEpg()
@@ -498,9 +573,39 @@ CDateTime ConvertLocalTimeToUTC(const CDateTime& local)
 
 class CSearchTermConverter
 {
+  enum class FTSToken
+  {
+    NONE,
+    TERM,
+    AND,
+    OR,
+    NOT
+  };
+
 public:
   CSearchTermConverter(const std::string& strSearchTerm) { Parse(strSearchTerm); }
 
+  /*!
+   * @brief Get the search term as FTS5 query over the given columns of the search index.
+   * @param columns The columns to search, matches in any of them are returned.
+   * @param strMatch The query for the MATCH operator.
+   * @return False if the search term can't be expressed as FTS5 query.
+   */
+  bool ToFTS(const std::vector<std::string>& columns, std::string& strMatch) const
+  {
+    if (!m_bFTSCompatible || m_ftsExpression.empty())
+      return false;
+
+    strMatch.clear();
+    for (const auto& column : columns)
+    {
+      if (!strMatch.empty())
+        strMatch += " OR ";
+      strMatch += column + " : (" + m_ftsExpression + ")";
+    }
+    return true;
+  }
+
   std::string ToSQL(const std::string& strFieldName) const
   {
     std::string result = "(";
@@ -532,29 +637,32 @@ private:
     {
       StringUtils::TrimLeft(strParsedSearchTerm);
 
-      if (StringUtils::StartsWith(strParsedSearchTerm, "!") ||
-          StringUtils::StartsWithNoCase(strParsedSearchTerm, "not"))
+      if (CutOperator(strParsedSearchTerm, '!', "not"))
       {
-        std::string strDummy;
-        GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " NOT ";
         bNextOR = false;
+
+        // FTS5 only knows the binary "a NOT b", so "a AND NOT b" is fine but a leading NOT isn't
+        if (m_lastFTSToken == FTSToken::AND)
+          m_ftsExpression.erase(m_ftsExpression.size() - 5);
+        else if (m_lastFTSToken != FTSToken::TERM)
+          m_bFTSCompatible = false;
+        m_ftsExpression += " NOT ";
+        m_lastFTSToken = FTSToken::NOT;
       }
-      else if (StringUtils::StartsWith(strParsedSearchTerm, "+") ||
-               StringUtils::StartsWithNoCase(strParsedSearchTerm, "and"))
+      else if (CutOperator(strParsedSearchTerm, '+', "and"))
       {
-        std::string strDummy;
-        GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " AND ";
         bNextOR = false;
+
+        AppendFTSOperator(" AND ", FTSToken::AND);
       }
-      else if (StringUtils::StartsWith(strParsedSearchTerm, "|") ||
-               StringUtils::StartsWithNoCase(strParsedSearchTerm, "or"))
+      else if (CutOperator(strParsedSearchTerm, '|', "or"))
       {
-        std::string strDummy;
-        GetAndCutNextTerm(strParsedSearchTerm, strDummy);
         strFragment += " OR ";
         bNextOR = false;
+
+        AppendFTSOperator(" OR ", FTSToken::OR);
       }
       else
       {
@@ -563,7 +671,11 @@ private:
         if (!strTerm.empty())
         {
           if (bNextOR && !m_fragments.empty())
+          {
             strFragment += " OR "; // default operator
+            AppendFTSOperator(" OR ", FTSToken::OR);
+          }
+          AppendFTSTerm(strTerm);
 
           strFragment += "(UPPER(";
 
@@ -588,6 +700,53 @@ private:
 
     if (!strFragment.empty())
       m_fragments.emplace_back(strFragment);
+
+    if (m_lastFTSToken != FTSToken::TERM)
+      m_bFTSCompatible = false;
+  }
+
+  void AppendFTSOperator(const char* strOperator, FTSToken token)
+  {
+    if (m_lastFTSToken != FTSToken::TERM)
+      m_bFTSCompatible = false;
+
+    m_ftsExpression += strOperator;
+    m_lastFTSToken = token;
+  }
+
+  void AppendFTSTerm(const std::string& strTerm)
+  {
+    // the trigram index can't find terms shorter than three characters
+    if (std::count_if(strTerm.begin(), strTerm.end(),
+                      [](unsigned char c) { return (c & 0xC0) != 0x80; }) < 3)
+      m_bFTSCompatible = false;
+
+    // a phrase of trigrams matches anywhere, like 'man' matches 'Batman'
+    std::string strPhrase(strTerm);
+    StringUtils::Replace(strPhrase, "\"", "\"\"");
+    m_ftsExpression += "\"" + strPhrase + "\"";
+    m_lastFTSToken = FTSToken::TERM;
+  }
+
+  /*!
+   * @brief Remove a leading operator from the search term. The symbol may be directly followed by
+   * the next term, like in '!news', but the word has to stand on its own, so 'Andrew' is a term.
+   */
+  static bool CutOperator(std::string& strSearchTerm, char symbol, const std::string& strWord)
+  {
+    if (!strSearchTerm.empty() && strSearchTerm[0] == symbol)
+    {
+      strSearchTerm.erase(0, 1);
+      return true;
+    }
+
+    if (StringUtils::StartsWithNoCase(strSearchTerm, strWord) &&
+        (strSearchTerm.size() == strWord.size() || strSearchTerm[strWord.size()] == ' '))
+    {
+      strSearchTerm.erase(0, strWord.size());
+      return true;
+    }
+    return false;
   }
 
   static void GetAndCutNextTerm(std::string& strSearchTerm, std::string& strNextTerm)
@@ -614,6 +773,10 @@ private:
   }
 
   std::vector<std::string> m_fragments;
+
+  std::string m_ftsExpression;
+  FTSToken m_lastFTSToken = FTSToken::NONE;
+  bool m_bFTSCompatible = true;
 };
 
 } // unnamed namespace
@@ -673,21 +836,28 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgDatabase::GetEpgTags(
   {
     const CSearchTermConverter conv(searchData.m_strSearchTerm);
 
-    // title
-    std::string strWhere = conv.ToSQL("sTitle");
-
-    // plot outline
-    strWhere += " OR ";
-    strWhere += conv.ToSQL("sPlotOutline");
-
+    std::vector<std::string> columns = {"sTitle", "sPlotOutline", "sEpisodeName", "sGenre"};
     if (searchData.m_bSearchInDescription)
+      columns.emplace_back("sPlot");
+
+    std::string strMatch;
+    if (conv.ToFTS(columns, strMatch) && HasSearchIndex())
     {
-      // plot
-      strWhere += " OR ";
-      strWhere += conv.ToSQL("sPlot");
+      filter.AppendWhere(PrepareSQL("idBroadcast IN (SELECT rowid FROM epgtags_fts "
+                                    "WHERE epgtags_fts MATCH '%s')",
+                                    strMatch.c_str()));
+    }
+    else
+    {
+      std::string strWhere;
+      for (const auto& column : columns)
+      {
+        if (!strWhere.empty())
+          strWhere += " OR ";
+        strWhere += conv.ToSQL(column);
+      }
+      filter.AppendWhere(strWhere);
     }
-
-    filter.AppendWhere(strWhere);
   }
 
   if (BuildSQL(strQuery, filter, strQuery))
@@ -65,7 +65,7 @@ namespace PVR
      * @brief Get the minimal database version that is required to operate correctly.
      * @return The minimal database version.
      */
-    int GetSchemaVersion() const override { return 13; }
+    int GetSchemaVersion() const override { return 15; }
 
     /*!
      * @brief Get the default sqlite database filename.
@@ -306,8 +306,28 @@ namespace PVR
 
     int GetMinSchemaVersion() const override { return 4; }
 
+    /*!
+     * @brief Create the full-text search index of the EPG tags, if sqlite supports it.
+     */
+    void CreateSearchIndex();
+
+    /*!
+     * @brief Check whether the full-text search index of the EPG tags exists. Only looked up
+     * once after the database was opened.
+     * @return True if it exists, false otherwise.
+     */
+    bool HasSearchIndex();
+
     std::shared_ptr<CPVREpgInfoTag> CreateEpgTag(const std::unique_ptr<dbiplus::Dataset>& pDS);
 
     CCriticalSection m_critSection;
+
+    enum class SearchIndex
+    {
+      UNKNOWN,
+      EXISTS,
+      MISSING
+    };
+    SearchIndex m_searchIndex = SearchIndex::UNKNOWN;
   };
 }
@@ -551,6 +551,45 @@ bool CPVREpgInfoTag::Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId /
   return bChanged;
 }
 
+std::shared_ptr<CPVREpgInfoTag> CPVREpgInfoTag::Clone() const
+{
+  // the default constructor is private, so std::make_shared can't be used
+  const std::shared_ptr<CPVREpgInfoTag> tag(new CPVREpgInfoTag());
+
+  CSingleLock lock(m_critSection);
+  tag->m_iDatabaseID = m_iDatabaseID;
+  tag->m_iGenreType = m_iGenreType;
+  tag->m_iGenreSubType = m_iGenreSubType;
+  tag->m_iParentalRating = m_iParentalRating;
+  tag->m_iStarRating = m_iStarRating;
+  tag->m_iSeriesNumber = m_iSeriesNumber;
+  tag->m_iEpisodeNumber = m_iEpisodeNumber;
+  tag->m_iEpisodePart = m_iEpisodePart;
+  tag->m_iUniqueBroadcastID = m_iUniqueBroadcastID;
+  tag->m_strTitle = m_strTitle;
+  tag->m_strPlotOutline = m_strPlotOutline;
+  tag->m_strPlot = m_strPlot;
+  tag->m_strOriginalTitle = m_strOriginalTitle;
+  tag->m_cast = m_cast;
+  tag->m_directors = m_directors;
+  tag->m_writers = m_writers;
+  tag->m_iYear = m_iYear;
+  tag->m_strIMDBNumber = m_strIMDBNumber;
+  tag->m_genre = m_genre;
+  tag->m_strEpisodeName = m_strEpisodeName;
+  tag->m_strIconPath = m_strIconPath;
+  tag->m_strFileNameAndPath = m_strFileNameAndPath;
+  tag->m_startTime = m_startTime;
+  tag->m_endTime = m_endTime;
+  tag->m_firstAired = m_firstAired;
+  tag->m_iFlags = m_iFlags;
+  tag->m_strSeriesLink = m_strSeriesLink;
+  tag->m_bIsGapTag = m_bIsGapTag;
+  tag->m_channelData = m_channelData;
+  tag->m_iEpgID = m_iEpgID;
+  return tag;
+}
+
 bool CPVREpgInfoTag::QueuePersistQuery(const std::shared_ptr<CPVREpgDatabase>& database)
 {
   if (!database)
@@ -356,6 +356,12 @@ namespace PVR
      */
     bool Update(const CPVREpgInfoTag& tag, bool bUpdateBroadcastId = true);
 
+    /*!
+     * @brief Create a copy of this tag, sharing its channel data.
+     * @return The copy.
+     */
+    std::shared_ptr<CPVREpgInfoTag> Clone() const;
+
     /*!
      * @brief Retrieve the edit decision list (EDL) of an EPG tag.
      * @return The edit decision list (empty on error)
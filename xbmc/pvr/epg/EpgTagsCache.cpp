@@ -12,8 +12,8 @@
 #include "pvr/PVRManager.h"
 #include "pvr/PVRPlaybackState.h"
 #include "pvr/epg/EpgChannelData.h"
-#include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgTagsIndex.h"
 #include "utils/log.h"
 
 using namespace PVR;
@@ -91,10 +91,10 @@ void CPVREpgTagsCache::Refresh(bool bUpdateIfNeeded)
       }
     }
 
-    if (!m_nowActiveTag && m_database)
+    if (!m_nowActiveTag)
     {
       const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags =
-          m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, activeTime + ONE_SECOND, activeTime);
+          m_tagsIndex.GetTagsByMinEndMaxStartTime(activeTime + ONE_SECOND, activeTime);
       if (!tags.empty())
       {
         if (tags.size() > 1)
@@ -128,12 +128,9 @@ void CPVREpgTagsCache::Refresh(bool bUpdateIfNeeded)
 
 void CPVREpgTagsCache::RefreshLastEndedTag(const CDateTime& activeTime)
 {
-  if (m_database)
-  {
-    m_lastEndedTag = m_database->GetEpgTagByMaxEndTime(m_iEpgID, activeTime);
-    if (m_lastEndedTag)
-      m_lastEndedTag->SetChannelData(m_channelData);
-  }
+  m_lastEndedTag = m_tagsIndex.GetTagByMaxEndTime(activeTime);
+  if (m_lastEndedTag)
+    m_lastEndedTag->SetChannelData(m_channelData);
 
   for (auto it = m_changedTags.rbegin(); it != m_changedTags.rend(); ++it)
   {
@@ -150,12 +147,9 @@ void CPVREpgTagsCache::RefreshLastEndedTag(const CDateTime& activeTime)
 
 void CPVREpgTagsCache::RefreshNextStartingTag(const CDateTime& activeTime)
 {
-  if (m_database)
-  {
-    m_nextStartingTag = m_database->GetEpgTagByMinStartTime(m_iEpgID, activeTime + ONE_SECOND);
-    if (m_nextStartingTag)
-      m_nextStartingTag->SetChannelData(m_channelData);
-  }
+  m_nextStartingTag = m_tagsIndex.GetTagByMinStartTime(activeTime + ONE_SECOND);
+  if (m_nextStartingTag)
+    m_nextStartingTag->SetChannelData(m_channelData);
 
   for (const auto& tag : m_changedTags)
   {
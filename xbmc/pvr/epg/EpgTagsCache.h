@@ -16,18 +16,17 @@
 namespace PVR
 {
 class CPVREpgChannelData;
-class CPVREpgDatabase;
 class CPVREpgInfoTag;
+class CPVREpgTagsIndex;
 
 class CPVREpgTagsCache
 {
 public:
   CPVREpgTagsCache() = delete;
-  CPVREpgTagsCache(int iEpgID,
-                   const std::shared_ptr<CPVREpgChannelData>& channelData,
-                   const std::shared_ptr<CPVREpgDatabase>& database,
+  CPVREpgTagsCache(const std::shared_ptr<CPVREpgChannelData>& channelData,
+                   const CPVREpgTagsIndex& tagsIndex,
                    const std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& changedTags)
-    : m_iEpgID(iEpgID), m_channelData(channelData), m_database(database), m_changedTags(changedTags)
+    : m_channelData(channelData), m_tagsIndex(tagsIndex), m_changedTags(changedTags)
   {
   }
 
@@ -44,9 +43,8 @@ private:
   void RefreshLastEndedTag(const CDateTime& activeTime);
   void RefreshNextStartingTag(const CDateTime& activeTime);
 
-  int m_iEpgID;
   std::shared_ptr<CPVREpgChannelData> m_channelData;
-  std::shared_ptr<CPVREpgDatabase> m_database;
+  const CPVREpgTagsIndex& m_tagsIndex;
   const std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>>& m_changedTags;
 
   std::shared_ptr<CPVREpgInfoTag> m_lastEndedTag;
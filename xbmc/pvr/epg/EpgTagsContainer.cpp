@@ -12,6 +12,7 @@
 #include "pvr/epg/EpgDatabase.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/epg/EpgTagsCache.h"
+#include "pvr/epg/EpgTagsIndex.h"
 #include "utils/log.h"
 
 using namespace PVR;
@@ -27,7 +28,8 @@ CPVREpgTagsContainer::CPVREpgTagsContainer(int iEpgID,
   : m_iEpgID(iEpgID),
     m_channelData(channelData),
     m_database(database),
-    m_tagsCache(new CPVREpgTagsCache(iEpgID, channelData, database, m_changedTags))
+    m_tagsIndex(new CPVREpgTagsIndex(iEpgID, database)),
+    m_tagsCache(new CPVREpgTagsCache(channelData, *m_tagsIndex, m_changedTags))
 {
 }
 
@@ -36,6 +38,7 @@ CPVREpgTagsContainer::~CPVREpgTagsContainer() = default;
 void CPVREpgTagsContainer::SetEpgID(int iEpgID)
 {
   m_iEpgID = iEpgID;
+  m_tagsIndex->SetEpgID(iEpgID);
   for (const auto& tag : m_changedTags)
     tag.second->SetEpgID(iEpgID);
 }
@@ -139,7 +142,7 @@ bool CPVREpgTagsContainer::UpdateEntries(const CPVREpgTagsContainer& tags)
     const CDateTime maxEventStart = (*tags.m_changedTags.crbegin()).second->EndAsUTC();
 
     std::vector<std::shared_ptr<CPVREpgInfoTag>> existingTags =
-        m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, minEventEnd, maxEventStart);
+        m_tagsIndex->GetTagsByMinEndMaxStartTime(minEventEnd, maxEventStart);
 
     if (!m_changedTags.empty())
     {
@@ -320,7 +323,15 @@ void CPVREpgTagsContainer::Cleanup(const CDateTime& time)
   }
 
   if (m_database)
-    m_database->DeleteEpgTags(m_iEpgID, time);
+  {
+    if (m_database->DeleteEpgTags(m_iEpgID, time))
+      m_tagsIndex->EraseByMaxEndTime(time);
+    else
+      m_tagsIndex->Reset();
+  }
+
+  // don't keep the tags of EPGs nobody looked at since the last cleanup in memory
+  m_tagsIndex->ReleaseIfUnused();
 }
 
 void CPVREpgTagsContainer::Clear()
@@ -334,7 +345,7 @@ bool CPVREpgTagsContainer::IsEmpty() const
     return false;
 
   if (m_database)
-    return !m_database->GetFirstStartTime(m_iEpgID).IsValid();
+    return !m_tagsIndex->GetFirstStartTime().IsValid();
 
   return true;
 }
@@ -346,7 +357,7 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTag(const CDateTime& st
     return (*it).second;
 
   if (m_database)
-    return CreateEntry(m_database->GetEpgTagByStartTime(m_iEpgID, startTime));
+    return CreateEntry(m_tagsIndex->GetTagByStartTime(startTime));
 
   return {};
 }
@@ -363,7 +374,7 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTag(unsigned int iUniqu
   }
 
   if (m_database)
-    return CreateEntry(m_database->GetEpgTagByUniqueBroadcastID(m_iEpgID, iUniqueBroadcastID));
+    return CreateEntry(m_tagsIndex->GetTagByUniqueBroadcastID(iUniqueBroadcastID));
 
   return {};
 }
@@ -402,7 +413,7 @@ std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsContainer::GetTagBetween(const CDateT
   if (m_database)
   {
     const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags =
-        CreateEntries(m_database->GetEpgTagsByMinStartMaxEndTime(m_iEpgID, start, end));
+        CreateEntries(m_tagsIndex->GetTagsByMinStartMaxEndTime(start, end));
     if (!tags.empty())
     {
       if (tags.size() > 1)
@@ -446,7 +457,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
   {
     std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
 
-    if (!m_changedTags.empty() && !m_database->GetFirstStartTime(m_iEpgID).IsValid())
+    if (!m_changedTags.empty() && !m_tagsIndex->GetFirstStartTime().IsValid())
     {
       // nothing in the db yet. take what we have in memory.
       for (const auto& tag : m_changedTags)
@@ -460,7 +471,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
     }
     else
     {
-      tags = m_database->GetEpgTagsByMinEndMaxStartTime(m_iEpgID, minEventEnd, maxEventStart);
+      tags = m_tagsIndex->GetTagsByMinEndMaxStartTime(minEventEnd, maxEventStart);
 
       if (!m_changedTags.empty())
       {
@@ -501,11 +512,11 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
     if (result.empty())
     {
       // create single gap tag
-      CDateTime maxEnd = m_database->GetMaxEndTime(m_iEpgID, minEventEnd);
+      CDateTime maxEnd = m_tagsIndex->GetMaxEndTime(minEventEnd);
       if (!maxEnd.IsValid() || maxEnd < timelineStart)
         maxEnd = timelineStart;
 
-      CDateTime minStart = m_database->GetMinStartTime(m_iEpgID, maxEventStart);
+      CDateTime minStart = m_tagsIndex->GetMinStartTime(maxEventStart);
       if (!minStart.IsValid() || minStart > timelineEnd)
         minStart = timelineEnd;
 
@@ -516,7 +527,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
       if (result.front()->StartAsUTC() > minEventEnd)
       {
         // prepend gap tag
-        CDateTime maxEnd = m_database->GetMaxEndTime(m_iEpgID, minEventEnd);
+        CDateTime maxEnd = m_tagsIndex->GetMaxEndTime(minEventEnd);
         if (!maxEnd.IsValid() || maxEnd < timelineStart)
           maxEnd = timelineStart;
 
@@ -526,7 +537,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetTimeline(
       if (result.back()->EndAsUTC() < maxEventStart)
       {
         // append gap tag
-        CDateTime minStart = m_database->GetMinStartTime(m_iEpgID, maxEventStart);
+        CDateTime minStart = m_tagsIndex->GetMinStartTime(maxEventStart);
         if (!minStart.IsValid() || minStart > timelineEnd)
           minStart = timelineEnd;
 
@@ -545,7 +556,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetAllTags()
   if (m_database)
   {
     std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
-    if (!m_changedTags.empty() && !m_database->GetFirstStartTime(m_iEpgID).IsValid())
+    if (!m_changedTags.empty() && !m_tagsIndex->GetFirstStartTime().IsValid())
     {
       // nothing in the db yet. take what we have in memory.
       for (const auto& tag : m_changedTags)
@@ -555,7 +566,7 @@ std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsContainer::GetAllTags()
     }
     else
     {
-      tags = m_database->GetAllEpgTags(m_iEpgID);
+      tags = m_tagsIndex->GetAllTags();
 
       if (!m_changedTags.empty())
       {
@@ -582,7 +593,7 @@ CDateTime CPVREpgTagsContainer::GetFirstStartTime() const
 
   if (m_database)
   {
-    const CDateTime dbResult = m_database->GetFirstStartTime(m_iEpgID);
+    const CDateTime dbResult = m_tagsIndex->GetFirstStartTime();
     if (!result.IsValid() || (dbResult.IsValid() && dbResult < result))
       result = dbResult;
   }
@@ -599,7 +610,7 @@ CDateTime CPVREpgTagsContainer::GetLastEndTime() const
 
   if (m_database)
   {
-    const CDateTime dbResult = m_database->GetLastEndTime(m_iEpgID);
+    const CDateTime dbResult = m_tagsIndex->GetLastEndTime();
     if (result.IsValid() || (dbResult.IsValid() && dbResult > result))
       result = dbResult;
   }
@@ -622,7 +633,10 @@ void CPVREpgTagsContainer::QueuePersistQuery()
                 m_changedTags.size(), m_deletedTags.size());
 
     for (const auto& tag : m_deletedTags)
+    {
       m_database->QueueDeleteTagQuery(*tag.second);
+      m_tagsIndex->QueueErase(*tag.second);
+    }
 
     m_deletedTags.clear();
 
@@ -633,8 +647,11 @@ void CPVREpgTagsContainer::QueuePersistQuery()
       // remove any conflicting events from database before persisting the new event
       m_database->QueueDeleteEpgTagsByMinEndMaxStartTimeQuery(
           m_iEpgID, tag.second->StartAsUTC() + ONE_SECOND, tag.second->EndAsUTC() - ONE_SECOND);
+      m_tagsIndex->QueueEraseByMinEndMaxStartTime(tag.second->StartAsUTC() + ONE_SECOND,
+                                                  tag.second->EndAsUTC() - ONE_SECOND);
 
       tag.second->QueuePersistQuery(m_database);
+      m_tagsIndex->QueueInsert(*tag.second);
     }
 
     m_changedTags.clear();
@@ -643,10 +660,16 @@ void CPVREpgTagsContainer::QueuePersistQuery()
   }
 }
 
+void CPVREpgTagsContainer::OnPersisted(bool bSuccess)
+{
+  m_tagsIndex->OnQueriesCommitted(bSuccess);
+}
+
 void CPVREpgTagsContainer::QueueDelete()
 {
   if (m_database)
     m_database->QueueDeleteEpgTags(m_iEpgID);
 
+  m_tagsIndex->Clear();
   Clear();
 }
@@ -17,6 +17,7 @@
 namespace PVR
 {
 class CPVREpgTagsCache;
+class CPVREpgTagsIndex;
 class CPVREpgChannelData;
 class CPVREpgDatabase;
 class CPVREpgInfoTag;
@@ -170,6 +171,12 @@ public:
    */
   void QueuePersistQuery();
 
+  /*!
+   * @brief Update the in-memory state after the queued queries were committed to the database.
+   * @param bSuccess True if the queries were committed, false otherwise.
+   */
+  void OnPersisted(bool bSuccess);
+
   /*!
    * @brief Queue the deletion of this container from its database.
    */
@@ -209,6 +216,7 @@ private:
   int m_iEpgID = 0;
   std::shared_ptr<CPVREpgChannelData> m_channelData;
   const std::shared_ptr<CPVREpgDatabase> m_database;
+  const std::unique_ptr<CPVREpgTagsIndex> m_tagsIndex;
   const std::unique_ptr<CPVREpgTagsCache> m_tagsCache;
 
   std::map<CDateTime, std::shared_ptr<CPVREpgInfoTag>> m_changedTags;
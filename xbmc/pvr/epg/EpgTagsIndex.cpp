@@ -0,0 +1,437 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "EpgTagsIndex.h"
+
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace PVR;
+
+namespace
+{
+time_t ToTime(const CDateTime& time)
+{
+  time_t t;
+  time.GetAsTime(t);
+  return t;
+}
+} // unnamed namespace
+
+CPVREpgTagsIndex::CPVREpgTagsIndex(int iEpgID, const std::shared_ptr<CPVREpgDatabase>& database)
+  : m_iEpgID(iEpgID), m_database(database)
+{
+}
+
+void CPVREpgTagsIndex::SetEpgID(int iEpgID)
+{
+  m_iEpgID = iEpgID;
+}
+
+void CPVREpgTagsIndex::Reset()
+{
+  m_entries.clear();
+  m_entries.shrink_to_fit();
+  m_bLoaded = false;
+
+  // the entries loaded next won't contain changes not committed yet
+  m_bChangesMissed |= !m_changes.empty();
+  m_changes.clear();
+}
+
+void CPVREpgTagsIndex::Clear()
+{
+  m_entries.clear();
+  m_changes.clear();
+  m_bChangesMissed = false;
+  m_bLoaded = true;
+}
+
+bool CPVREpgTagsIndex::ReleaseIfUnused()
+{
+  const bool bRelease = m_bLoaded && !m_bUsed;
+  if (bRelease)
+    Reset();
+
+  m_bUsed = false;
+  return bRelease;
+}
+
+void CPVREpgTagsIndex::Load() const
+{
+  m_entries.clear();
+
+  if (m_database && m_iEpgID > 0)
+  {
+    const std::vector<std::shared_ptr<CPVREpgInfoTag>> tags = m_database->GetAllEpgTags(m_iEpgID);
+    m_entries.reserve(tags.size());
+
+    time_t maxEnd = 0;
+    for (const auto& tag : tags)
+    {
+      const time_t end = ToTime(tag->EndAsUTC());
+      maxEnd = std::max(maxEnd, end);
+      m_entries.push_back({ToTime(tag->StartAsUTC()), end, maxEnd, tag->UniqueBroadcastID(),
+                           tag->DatabaseID(), tag});
+    }
+  }
+
+  m_bLoaded = true;
+}
+
+const CPVREpgTagsIndex::Entries& CPVREpgTagsIndex::GetEntries() const
+{
+  if (!m_bLoaded)
+    Load();
+
+  m_bUsed = true;
+  return m_entries;
+}
+
+void CPVREpgTagsIndex::UpdateMaxEnd(size_t first)
+{
+  time_t maxEnd = first > 0 ? m_entries[first - 1].maxEnd : 0;
+  for (auto it = m_entries.begin() + first; it != m_entries.end(); ++it)
+  {
+    maxEnd = std::max(maxEnd, (*it).end);
+    (*it).maxEnd = maxEnd;
+  }
+}
+
+CPVREpgTagsIndex::Entries::const_iterator CPVREpgTagsIndex::LowerBound(time_t start) const
+{
+  return std::lower_bound(m_entries.cbegin(), m_entries.cend(), start,
+                          [](const Entry& entry, time_t time) { return entry.start < time; });
+}
+
+CPVREpgTagsIndex::Entries::const_iterator CPVREpgTagsIndex::UpperBound(time_t start) const
+{
+  return std::upper_bound(m_entries.cbegin(), m_entries.cend(), start,
+                          [](time_t time, const Entry& entry) { return time < entry.start; });
+}
+
+template<typename Predicate>
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsIndex::CloneTags(
+    Entries::const_iterator first, Entries::const_iterator last, Predicate matches) const
+{
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (; first < last; ++first)
+  {
+    if (matches(*first))
+      tags.emplace_back((*first).tag->Clone());
+  }
+  return tags;
+}
+
+void CPVREpgTagsIndex::QueueInsert(const CPVREpgInfoTag& tag)
+{
+  QueueChange({Change::Type::INSERT, ToTime(tag.StartAsUTC()), ToTime(tag.EndAsUTC()),
+               tag.DatabaseID(), tag.Clone()});
+}
+
+void CPVREpgTagsIndex::QueueErase(const CPVREpgInfoTag& tag)
+{
+  QueueChange({Change::Type::ERASE, ToTime(tag.StartAsUTC()), ToTime(tag.EndAsUTC()),
+               tag.DatabaseID(), {}});
+}
+
+void CPVREpgTagsIndex::QueueEraseByMinEndMaxStartTime(const CDateTime& minEnd,
+                                                      const CDateTime& maxStart)
+{
+  QueueChange({Change::Type::ERASE_RANGE, ToTime(maxStart), ToTime(minEnd), 0, {}});
+}
+
+void CPVREpgTagsIndex::QueueChange(Change change)
+{
+  if (m_bLoaded)
+    m_changes.emplace_back(std::move(change));
+  else
+    m_bChangesMissed = true; // loaded from the database on first access
+}
+
+void CPVREpgTagsIndex::OnQueriesCommitted(bool bSuccess)
+{
+  if (!bSuccess || (m_bChangesMissed && m_bLoaded))
+  {
+    // the database may or may not contain the changes, only it knows
+    Reset();
+  }
+  else if (m_bLoaded)
+  {
+    for (const auto& change : m_changes)
+    {
+      switch (change.type)
+      {
+        case Change::Type::INSERT:
+          Insert(change);
+          break;
+        case Change::Type::ERASE:
+          Erase(change);
+          break;
+        case Change::Type::ERASE_RANGE:
+          EraseByMinEndMaxStartTime(change.end, change.start);
+          break;
+      }
+    }
+  }
+
+  m_changes.clear();
+  m_bChangesMissed = false;
+}
+
+void CPVREpgTagsIndex::Insert(const Change& change)
+{
+  // the database replaces the row with the same id, which may have started at another time
+  const int iDatabaseID = change.iDatabaseID;
+  if (iDatabaseID > 0)
+  {
+    const auto it =
+        std::find_if(m_entries.begin(), m_entries.end(), [iDatabaseID](const Entry& entry) {
+          return entry.iDatabaseID == iDatabaseID;
+        });
+    if (it != m_entries.end())
+    {
+      const size_t first = it - m_entries.begin();
+      m_entries.erase(it);
+      UpdateMaxEnd(first);
+    }
+  }
+
+  const Entry entry{change.start,
+                    change.end,
+                    0,
+                    change.tag->UniqueBroadcastID(),
+                    std::max(iDatabaseID, 0),
+                    change.tag};
+
+  auto it = m_entries.begin() + (LowerBound(change.start) - m_entries.cbegin());
+  if (it != m_entries.end() && (*it).start == change.start)
+    *it = entry;
+  else
+    it = m_entries.insert(it, entry);
+
+  UpdateMaxEnd(it - m_entries.begin());
+}
+
+void CPVREpgTagsIndex::Erase(const Change& change)
+{
+  // entries of tags persisted after loading have no database id, but start times are unique
+  const int iDatabaseID = change.iDatabaseID;
+  auto it = m_entries.begin() + (LowerBound(change.start) - m_entries.cbegin());
+  if (it == m_entries.end() || (*it).start != change.start ||
+      (iDatabaseID > 0 && (*it).iDatabaseID > 0 && (*it).iDatabaseID != iDatabaseID))
+  {
+    it = iDatabaseID > 0 ? std::find_if(m_entries.begin(), m_entries.end(),
+                                        [iDatabaseID](const Entry& entry) {
+                                          return entry.iDatabaseID == iDatabaseID;
+                                        })
+                         : m_entries.end();
+  }
+
+  if (it != m_entries.end())
+  {
+    const size_t first = it - m_entries.begin();
+    m_entries.erase(it);
+    UpdateMaxEnd(first);
+  }
+}
+
+void CPVREpgTagsIndex::EraseByMinEndMaxStartTime(time_t minEnd, time_t maxStart)
+{
+  // entries before the first one with a maximum end time >= minEnd all end before minEnd
+  auto first = std::partition_point(m_entries.begin(), m_entries.end(),
+                                    [minEnd](const Entry& entry) { return entry.maxEnd < minEnd; });
+  const auto last = m_entries.begin() + (UpperBound(maxStart) - m_entries.cbegin());
+  if (first >= last)
+    return;
+
+  const size_t firstIndex = first - m_entries.begin();
+  m_entries.erase(std::remove_if(first, last,
+                                 [minEnd](const Entry& entry) { return entry.end >= minEnd; }),
+                  last);
+  UpdateMaxEnd(firstIndex);
+}
+
+void CPVREpgTagsIndex::EraseByMaxEndTime(const CDateTime& maxEnd)
+{
+  if (!m_bLoaded)
+    return;
+
+  const time_t maxEndTime = ToTime(maxEnd);
+  m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                 [maxEndTime](const Entry& entry) {
+                                   return entry.end < maxEndTime;
+                                 }),
+                  m_entries.end());
+  UpdateMaxEnd(0);
+}
+
+CDateTime CPVREpgTagsIndex::GetFirstStartTime() const
+{
+  // a single query is cheaper than loading all tags just for a time
+  if (!m_bLoaded)
+    return m_database && m_iEpgID > 0 ? m_database->GetFirstStartTime(m_iEpgID) : CDateTime();
+
+  if (m_entries.empty())
+    return {};
+
+  return CDateTime(m_entries.front().start);
+}
+
+CDateTime CPVREpgTagsIndex::GetLastEndTime() const
+{
+  if (!m_bLoaded)
+    return m_database && m_iEpgID > 0 ? m_database->GetLastEndTime(m_iEpgID) : CDateTime();
+
+  if (m_entries.empty())
+    return {};
+
+  return CDateTime(m_entries.back().maxEnd);
+}
+
+CDateTime CPVREpgTagsIndex::GetMinStartTime(const CDateTime& minStart) const
+{
+  if (!m_bLoaded)
+    return m_database && m_iEpgID > 0 ? m_database->GetMinStartTime(m_iEpgID, minStart)
+                                      : CDateTime();
+
+  const auto it = UpperBound(ToTime(minStart));
+  if (it == m_entries.cend())
+    return {};
+
+  return CDateTime((*it).start);
+}
+
+CDateTime CPVREpgTagsIndex::GetMaxEndTime(const CDateTime& maxEnd) const
+{
+  if (!m_bLoaded)
+    return m_database && m_iEpgID > 0 ? m_database->GetMaxEndTime(m_iEpgID, maxEnd) : CDateTime();
+
+  const time_t maxEndTime = ToTime(maxEnd);
+
+  // walk back from the last entry starting before maxEnd until all preceding entries end before
+  bool bFound = false;
+  time_t result = 0;
+  for (auto it = UpperBound(maxEndTime); it != m_entries.cbegin();)
+  {
+    --it;
+    if ((*it).maxEnd <= maxEndTime)
+    {
+      result = std::max(result, (*it).maxEnd);
+      bFound = true;
+      break;
+    }
+
+    if ((*it).end <= maxEndTime)
+    {
+      result = std::max(result, (*it).end);
+      bFound = true;
+    }
+  }
+
+  if (!bFound)
+    return {};
+
+  return CDateTime(result);
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsIndex::GetTagByStartTime(
+    const CDateTime& startTime) const
+{
+  const Entries& entries = GetEntries();
+  const time_t start = ToTime(startTime);
+  const auto it = LowerBound(start);
+  if (it == entries.cend() || (*it).start != start)
+    return {};
+
+  return (*it).tag->Clone();
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsIndex::GetTagByUniqueBroadcastID(
+    unsigned int iUniqueBroadcastID) const
+{
+  for (const auto& entry : GetEntries())
+  {
+    if (entry.iUniqueBroadcastID == iUniqueBroadcastID)
+      return entry.tag->Clone();
+  }
+  return {};
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsIndex::GetTagByMinStartTime(
+    const CDateTime& minStart) const
+{
+  const Entries& entries = GetEntries();
+  const auto it = LowerBound(ToTime(minStart));
+  if (it == entries.cend())
+    return {};
+
+  return (*it).tag->Clone();
+}
+
+std::shared_ptr<CPVREpgInfoTag> CPVREpgTagsIndex::GetTagByMaxEndTime(const CDateTime& maxEnd) const
+{
+  const Entries& entries = GetEntries();
+  const time_t maxEndTime = ToTime(maxEnd);
+
+  // the latest starting entry ending before maxEnd, usually right before the upper bound
+  for (auto it = UpperBound(maxEndTime); it != entries.cbegin();)
+  {
+    --it;
+    if ((*it).end <= maxEndTime)
+      return (*it).tag->Clone();
+  }
+  return {};
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsIndex::GetTagsByMinStartMaxEndTime(
+    const CDateTime& minStart, const CDateTime& maxEnd) const
+{
+  GetEntries();
+  const time_t minStartTime = ToTime(minStart);
+  const time_t maxEndTime = ToTime(maxEnd);
+
+  return CloneTags(LowerBound(minStartTime), UpperBound(maxEndTime),
+                   [minStartTime, maxEndTime](const Entry& entry) {
+                     return entry.start >= minStartTime && entry.end <= maxEndTime;
+                   });
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsIndex::GetTagsByMinEndMaxStartTime(
+    const CDateTime& minEnd, const CDateTime& maxStart) const
+{
+  const Entries& entries = GetEntries();
+  const time_t minEndTime = ToTime(minEnd);
+  const time_t maxStartTime = ToTime(maxStart);
+
+  // entries before the first one with a maximum end time >= minEnd all end before minEnd
+  auto it = std::partition_point(entries.cbegin(), entries.cend(),
+                                 [minEndTime](const Entry& entry) {
+                                   return entry.maxEnd < minEndTime;
+                                 });
+
+  return CloneTags(it, UpperBound(maxStartTime),
+                   [minEndTime, maxStartTime](const Entry& entry) {
+                     return entry.end >= minEndTime && entry.start <= maxStartTime;
+                   });
+}
+
+std::vector<std::shared_ptr<CPVREpgInfoTag>> CPVREpgTagsIndex::GetAllTags() const
+{
+  const Entries& entries = GetEntries();
+
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  tags.reserve(entries.size());
+  for (const auto& entry : entries)
+    tags.emplace_back(entry.tag->Clone());
+
+  return tags;
+}
@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "XBDateTime.h"
+
+#include <ctime>
+#include <memory>
+#include <vector>
+
+namespace PVR
+{
+class CPVREpgDatabase;
+class CPVREpgInfoTag;
+
+/*!
+ * @brief In-memory index of the EPG tags of one EPG stored in the database.
+ *
+ * The index holds immutable snapshots of the tags, loaded from the database on first access. The
+ * changes the tags container queues for the database are only applied to the index once the
+ * database has committed them, a failed commit makes the index load the tags again. The methods
+ * answer the same questions as the respective CPVREpgDatabase methods, but from memory, and every
+ * caller gets its own copies of the tags, just like from the database. Until the index is needed
+ * for tags, times are still answered by the database.
+ *
+ * The snapshots take about as much memory as the tags did before they were moved to the
+ * database, so the index of an EPG not used since the last cleanup is released.
+ *
+ * Entries are kept sorted by start time along with the running maximum of their end times. Range
+ * queries find their first candidate with a binary search over both and then only visit entries
+ * starting within the range, in O(log n + k).
+ */
+class CPVREpgTagsIndex
+{
+public:
+  CPVREpgTagsIndex() = delete;
+  CPVREpgTagsIndex(int iEpgID, const std::shared_ptr<CPVREpgDatabase>& database);
+
+  /*!
+   * @brief Set the EPG id of the tags to load.
+   * @param iEpgID The ID.
+   */
+  void SetEpgID(int iEpgID);
+
+  /*!
+   * @brief Release all tags. They are loaded from the database again on next access.
+   */
+  void Reset();
+
+  /*!
+   * @brief Release all tags, because the database does not contain any tags for this EPG.
+   */
+  void Clear();
+
+  /*!
+   * @brief Release all tags if the index was not accessed since the last call of this method.
+   * @return True if the tags were released, false otherwise.
+   */
+  bool ReleaseIfUnused();
+
+  /*!
+   * @brief Queue the insertion of a tag about to be persisted. A snapshot of the tag replaces the
+   * one with the same start time or database id, like in the database, once the queries have been
+   * committed.
+   * @param tag The tag.
+   */
+  void QueueInsert(const CPVREpgInfoTag& tag);
+
+  /*!
+   * @brief Queue the removal of a tag about to be deleted from the database.
+   * @param tag The tag, identified by its start time and its database id, if it has one.
+   */
+  void QueueErase(const CPVREpgInfoTag& tag);
+
+  /*!
+   * @brief Queue the removal of all tags ending at or after minEnd and starting at or before
+   * maxStart.
+   * @param minEnd The minimum end time.
+   * @param maxStart The maximum start time.
+   */
+  void QueueEraseByMinEndMaxStartTime(const CDateTime& minEnd, const CDateTime& maxStart);
+
+  /*!
+   * @brief Apply the queued changes after the database committed the respective queries.
+   * @param bSuccess True if the queries were committed, false otherwise. The tags are loaded from
+   * the database again on next access then.
+   */
+  void OnQueriesCommitted(bool bSuccess);
+
+  /*!
+   * @brief Remove all tags ending before the given time, after they were deleted from the
+   * database.
+   * @param maxEnd The time.
+   */
+  void EraseByMaxEndTime(const CDateTime& maxEnd);
+
+  /*!
+   * @brief Get the start time of the first tag.
+   * @return The time, invalid if there are no tags.
+   */
+  CDateTime GetFirstStartTime() const;
+
+  /*!
+   * @brief Get the end time of the last tag.
+   * @return The time, invalid if there are no tags.
+   */
+  CDateTime GetLastEndTime() const;
+
+  /*!
+   * @brief Get the start time of the first tag starting after the given time.
+   * @param minStart The time.
+   * @return The time, invalid if there is no such tag.
+   */
+  CDateTime GetMinStartTime(const CDateTime& minStart) const;
+
+  /*!
+   * @brief Get the end time of the last tag ending at or before the given time.
+   * @param maxEnd The time.
+   * @return The time, invalid if there is no such tag.
+   */
+  CDateTime GetMaxEndTime(const CDateTime& maxEnd) const;
+
+  /*!
+   * @brief Get a tag given its start time.
+   * @param startTime The start time.
+   * @return The tag or nullptr if no tag was found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetTagByStartTime(const CDateTime& startTime) const;
+
+  /*!
+   * @brief Get a tag given its unique broadcast id.
+   * @param iUniqueBroadcastID The id.
+   * @return The tag or nullptr if no tag was found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetTagByUniqueBroadcastID(unsigned int iUniqueBroadcastID) const;
+
+  /*!
+   * @brief Get the first tag starting at or after the given time.
+   * @param minStart The time.
+   * @return The tag or nullptr if no tag was found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetTagByMinStartTime(const CDateTime& minStart) const;
+
+  /*!
+   * @brief Get the last tag ending at or before the given time.
+   * @param maxEnd The time.
+   * @return The tag or nullptr if no tag was found.
+   */
+  std::shared_ptr<CPVREpgInfoTag> GetTagByMaxEndTime(const CDateTime& maxEnd) const;
+
+  /*!
+   * @brief Get all tags starting at or after minStart and ending at or before maxEnd.
+   * @param minStart The minimum start time.
+   * @param maxEnd The maximum end time.
+   * @return The tags, sorted by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTagsByMinStartMaxEndTime(
+      const CDateTime& minStart, const CDateTime& maxEnd) const;
+
+  /*!
+   * @brief Get all tags ending at or after minEnd and starting at or before maxStart.
+   * @param minEnd The minimum end time.
+   * @param maxStart The maximum start time.
+   * @return The tags, sorted by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetTagsByMinEndMaxStartTime(
+      const CDateTime& minEnd, const CDateTime& maxStart) const;
+
+  /*!
+   * @brief Get all tags.
+   * @return The tags, sorted by start time.
+   */
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> GetAllTags() const;
+
+private:
+  struct Entry
+  {
+    time_t start;
+    time_t end;
+    time_t maxEnd; ///< maximum end time of this and all preceding entries
+    unsigned int iUniqueBroadcastID;
+    int iDatabaseID; ///< 0 for tags persisted after the entries were loaded
+    std::shared_ptr<const CPVREpgInfoTag> tag;
+  };
+
+  using Entries = std::vector<Entry>;
+
+  struct Change
+  {
+    enum class Type
+    {
+      INSERT,
+      ERASE,
+      ERASE_RANGE,
+    };
+
+    Type type;
+    time_t start; ///< for ERASE_RANGE, the maximum start time
+    time_t end; ///< for ERASE_RANGE, the minimum end time
+    int iDatabaseID;
+    std::shared_ptr<const CPVREpgInfoTag> tag;
+  };
+
+  const Entries& GetEntries() const;
+  void Load() const;
+  void UpdateMaxEnd(size_t first);
+
+  void QueueChange(Change change);
+  void Insert(const Change& change);
+  void Erase(const Change& change);
+  void EraseByMinEndMaxStartTime(time_t minEnd, time_t maxStart);
+
+  Entries::const_iterator LowerBound(time_t start) const;
+  Entries::const_iterator UpperBound(time_t start) const;
+
+  template<typename Predicate>
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> CloneTags(Entries::const_iterator first,
+                                                         Entries::const_iterator last,
+                                                         Predicate matches) const;
+
+  int m_iEpgID = 0;
+  const std::shared_ptr<CPVREpgDatabase> m_database;
+
+  mutable Entries m_entries;
+  std::vector<Change> m_changes;
+  bool m_bChangesMissed = false; ///< changes were queued while the entries were not loaded
+  mutable bool m_bLoaded = false;
+  mutable bool m_bUsed = false;
+};
+
+} // namespace PVR
@@ -0,0 +1,226 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBDateTime.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgSearchData.h"
+#include "settings/AdvancedSettings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const char* TAG_INSERT = "INSERT INTO epgtags (idEpg, iStartTime, iEndTime, sTitle, sPlotOutline, "
+                         "sPlot, sEpisodeName, sGenre) VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
+
+const time_t GUIDE_START = 1600000000;
+
+const char* WORDS[] = {"news",    "weather", "football",  "drama",   "comedy",  "documentary",
+                       "nature",  "history", "science",   "travel",  "cooking", "concert",
+                       "thriller", "crime",  "detective", "police",  "hospital", "family",
+                       "cartoon", "quiz",    "late",      "morning", "evening", "world",
+                       "politics", "economy", "market",   "health",  "garden",  "island"};
+
+std::string Words(unsigned int& seed, int count)
+{
+  std::string words;
+  for (int i = 0; i < count; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    if (!words.empty())
+      words += ' ';
+    words += WORDS[(seed >> 16) % (sizeof(WORDS) / sizeof(WORDS[0]))];
+  }
+  return words;
+}
+} // namespace
+
+class TestEpgDatabase : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    m_database = std::make_shared<CPVREpgDatabase>();
+    ASSERT_TRUE(m_database->Connect("epgtest", settings, true));
+  }
+
+  //! drops the search index, so that the following searches use LIKE
+  void DropSearchIndex()
+  {
+    m_database->ExecuteQuery("DROP TABLE epgtags_fts");
+
+    // the index is only looked up once per connection
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    m_database = std::make_shared<CPVREpgDatabase>();
+    ASSERT_TRUE(m_database->Connect("epgtest", settings, false));
+  }
+
+  void TearDown() override
+  {
+    m_database->Close();
+    XFILE::CFile::Delete("special://temp/epgtest.db");
+  }
+
+  void AddTag(int channel,
+              time_t start,
+              const std::string& title,
+              const std::string& plotOutline,
+              const std::string& plot,
+              const std::string& episodeName = "",
+              const std::string& genre = "")
+  {
+    using dbiplus::field_value;
+    m_database->ExecuteQuery(
+        TAG_INSERT, {field_value(channel), field_value(static_cast<int64_t>(start)),
+                     field_value(static_cast<int64_t>(start + 1800)), field_value(title.c_str()),
+                     field_value(plotOutline.c_str()), field_value(plot.c_str()),
+                     field_value(episodeName.c_str()), field_value(genre.c_str())});
+  }
+
+  //! generates a guide of the given number of channels with 30 minutes broadcasts
+  void AddGuide(int channels, int days)
+  {
+    unsigned int seed = 1;
+    m_database->BeginTransaction();
+    for (int channel = 1; channel <= channels; channel++)
+    {
+      for (time_t start = GUIDE_START; start < GUIDE_START + days * 24 * 3600; start += 1800)
+        AddTag(channel, start, Words(seed, 3), Words(seed, 8), Words(seed, 20), Words(seed, 2));
+    }
+    m_database->CommitTransaction();
+  }
+
+  std::vector<std::string> Search(const std::string& term, bool inDescription = false)
+  {
+    PVREpgSearchData searchData;
+    searchData.m_strSearchTerm = term;
+    searchData.m_bSearchInDescription = inDescription;
+    searchData.m_startDateTime.SetFromUTCDateTime(CDateTime(GUIDE_START - 24 * 3600));
+    searchData.m_endDateTime.SetFromUTCDateTime(CDateTime(GUIDE_START + 30 * 24 * 3600));
+
+    std::vector<std::string> titles;
+    for (const auto& tag : m_database->GetEpgTags(searchData))
+      titles.emplace_back(tag->Title());
+    std::sort(titles.begin(), titles.end());
+    return titles;
+  }
+
+  std::shared_ptr<CPVREpgDatabase> m_database;
+};
+
+TEST_F(TestEpgDatabase, Search)
+{
+  m_database->BeginTransaction();
+  AddTag(1, GUIDE_START, "Newsnight", "The news of the day", "Politics and \"economy\"");
+  AddTag(1, GUIDE_START + 1800, "Weather", "Forecast", "Rain in the Café district", "Autumn");
+  AddTag(2, GUIDE_START, "Football", "Live football", "Cup final", "", "Sports");
+  AddTag(2, GUIDE_START + 1800, "Late News", "", "Weather and sport");
+  m_database->CommitTransaction();
+
+  // the term anywhere, in any case
+  EXPECT_EQ(std::vector<std::string>({"Late News", "Newsnight"}), Search("news"));
+  EXPECT_EQ(std::vector<std::string>({"Weather"}), Search("autumn"));
+  EXPECT_EQ(std::vector<std::string>({"Football"}), Search("sports"));
+  EXPECT_EQ(std::vector<std::string>({}), Search("café"));
+  EXPECT_EQ(std::vector<std::string>({"Weather"}), Search("café", true));
+
+  // operators and phrases
+  EXPECT_EQ(std::vector<std::string>({"Late News", "Weather"}), Search("weather", true));
+  EXPECT_EQ(std::vector<std::string>({"Late News"}), Search("weather + sport", true));
+  EXPECT_EQ(std::vector<std::string>({"Newsnight"}), Search("news !late"));
+  EXPECT_EQ(std::vector<std::string>({"Football", "Weather"}), Search("football | forecast"));
+  EXPECT_EQ(std::vector<std::string>({"Football", "Weather"}), Search("football forecast"));
+  EXPECT_EQ(std::vector<std::string>({"Newsnight"}), Search("\"economy\"", true));
+
+  // the index is kept in sync with the tags
+  m_database->ExecuteQuery("UPDATE epgtags SET sTitle = 'Evening News' WHERE sTitle = 'Newsnight'");
+  m_database->ExecuteQuery("DELETE FROM epgtags WHERE sTitle = 'Late News'");
+  EXPECT_EQ(std::vector<std::string>({"Evening News"}), Search("news"));
+  m_database->ExecuteQuery(
+      "REPLACE INTO epgtags (idEpg, iStartTime, iEndTime, sTitle) VALUES (2, 1600000000, "
+      "1600001800, 'Sportsnight')");
+  EXPECT_EQ(std::vector<std::string>({"Sportsnight"}), Search("sports"));
+  EXPECT_EQ(std::vector<std::string>({}), Search("football"));
+}
+
+TEST_F(TestEpgDatabase, SearchInsideWords)
+{
+  m_database->BeginTransaction();
+  AddTag(1, GUIDE_START, "Batman", "Superhero", "Gotham at night");
+  AddTag(1, GUIDE_START + 1800, "Manhattan", "", "Skyline");
+  AddTag(2, GUIDE_START, "Late News", "", "Weather and sport");
+  AddTag(2, GUIDE_START + 1800, "Notting Hill", "", "");
+  m_database->CommitTransaction();
+
+  // with the index, and with LIKE for the terms that are too short for it
+  const std::vector<std::string> terms = {"man", "MAN",     "man + !bat", "ather",
+                                          "\"e n\"", "tm", "at + ht", "notting"};
+  std::vector<std::vector<std::string>> indexed;
+  for (const auto& term : terms)
+    indexed.emplace_back(Search(term, true));
+
+  EXPECT_EQ(std::vector<std::string>({"Batman", "Manhattan"}), indexed[0]);
+  EXPECT_EQ(std::vector<std::string>({"Batman", "Manhattan"}), indexed[1]);
+  EXPECT_EQ(std::vector<std::string>({"Manhattan"}), indexed[2]);
+  EXPECT_EQ(std::vector<std::string>({"Late News"}), indexed[3]);
+  EXPECT_EQ(std::vector<std::string>({"Late News"}), indexed[4]);
+  EXPECT_EQ(std::vector<std::string>({"Batman"}), indexed[5]);
+  EXPECT_EQ(std::vector<std::string>({"Batman"}), indexed[6]);
+  // a term starting like an operator
+  EXPECT_EQ(std::vector<std::string>({"Notting Hill"}), indexed[7]);
+
+  // the same as without the index
+  DropSearchIndex();
+  for (size_t i = 0; i < terms.size(); i++)
+    EXPECT_EQ(indexed[i], Search(terms[i], true)) << terms[i];
+}
+
+TEST_F(TestEpgDatabase, DISABLED_SearchBenchmark)
+{
+  // 800 channels with 14 days of guide data, and a rare broadcast, so that the time is spent in
+  // the search rather than in loading the found tags
+  AddGuide(800, 14);
+  AddTag(1, GUIDE_START - 1800, "Columbo", "Detective series", "A murder in Los Angeles");
+
+  auto start = std::chrono::steady_clock::now();
+  const std::vector<std::string> indexed = Search("columbo", true);
+  const auto indexedTime = std::chrono::steady_clock::now() - start;
+
+  // searching without the index falls back to LIKE
+  DropSearchIndex();
+  start = std::chrono::steady_clock::now();
+  const std::vector<std::string> scanned = Search("columbo", true);
+  const auto scannedTime = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(std::vector<std::string>({"Columbo"}), indexed);
+  EXPECT_EQ(scanned, indexed);
+  RecordProperty("IndexedMs", static_cast<int>(
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(indexedTime)
+                                     .count()));
+  RecordProperty("ScannedMs", static_cast<int>(
+                                 std::chrono::duration_cast<std::chrono::milliseconds>(scannedTime)
+                                     .count()));
+}
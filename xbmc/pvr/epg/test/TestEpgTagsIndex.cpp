@@ -0,0 +1,289 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "XBDateTime.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pvr/epg/EpgDatabase.h"
+#include "pvr/epg/EpgInfoTag.h"
+#include "pvr/epg/EpgTagsIndex.h"
+#include "settings/AdvancedSettings.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace PVR;
+
+namespace
+{
+const char* TAG_INSERT =
+    "INSERT INTO epgtags (idEpg, iStartTime, iEndTime, sTitle) VALUES (?, ?, ?, 'Title')";
+
+const time_t GUIDE_START = 1600000000;
+
+std::vector<time_t> StartTimes(const std::vector<std::shared_ptr<CPVREpgInfoTag>>& tags)
+{
+  std::vector<time_t> times;
+  for (const auto& tag : tags)
+  {
+    time_t time;
+    tag->StartAsUTC().GetAsTime(time);
+    times.emplace_back(time);
+  }
+  return times;
+}
+
+time_t StartTime(const std::shared_ptr<CPVREpgInfoTag>& tag)
+{
+  time_t time = 0;
+  if (tag)
+    tag->StartAsUTC().GetAsTime(time);
+  return time;
+}
+
+//! the start times of the entries, answered from memory
+std::vector<time_t> IndexedStartTimes(const CPVREpgTagsIndex& index)
+{
+  std::vector<time_t> times;
+  for (CDateTime start = index.GetFirstStartTime(); start.IsValid();
+       start = index.GetMinStartTime(start))
+  {
+    time_t time;
+    start.GetAsTime(time);
+    times.emplace_back(time);
+  }
+  return times;
+}
+
+std::shared_ptr<CPVREpgInfoTag> CreateTag(time_t start, time_t end)
+{
+  return std::make_shared<CPVREpgInfoTag>(nullptr, 1, CDateTime(start), CDateTime(end), false);
+}
+} // namespace
+
+class TestEpgTagsIndex : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+
+    m_database = std::make_shared<CPVREpgDatabase>();
+    ASSERT_TRUE(m_database->Connect("epgindextest", settings, true));
+  }
+
+  void TearDown() override
+  {
+    m_database->Close();
+    XFILE::CFile::Delete("special://temp/epgindextest.db");
+  }
+
+  void AddTag(int epg, time_t start, time_t end)
+  {
+    using dbiplus::field_value;
+    m_database->ExecuteQuery(TAG_INSERT,
+                             {field_value(epg), field_value(static_cast<int64_t>(start)),
+                              field_value(static_cast<int64_t>(end))});
+  }
+
+  //! generates broadcasts of varying length with gaps and one event overlapping the others
+  void AddGuide(int epgs, int days)
+  {
+    m_database->BeginTransaction();
+    for (int epg = 1; epg <= epgs; epg++)
+    {
+      time_t start = GUIDE_START;
+      for (int i = 0; start < GUIDE_START + days * 24 * 3600; i++)
+      {
+        const time_t duration = 600 * (1 + i % 7);
+        AddTag(epg, start, start + duration);
+        start += duration + (i % 5 == 0 ? 300 : 0);
+      }
+      AddTag(epg, GUIDE_START + 3 * 3600 + 60, GUIDE_START + 9 * 3600);
+    }
+    m_database->CommitTransaction();
+  }
+
+  std::shared_ptr<CPVREpgDatabase> m_database;
+};
+
+TEST_F(TestEpgTagsIndex, MatchesDatabase)
+{
+  AddGuide(2, 1);
+  const CPVREpgTagsIndex index(1, m_database);
+
+  EXPECT_EQ(m_database->GetFirstStartTime(1), index.GetFirstStartTime());
+  EXPECT_EQ(m_database->GetLastEndTime(1), index.GetLastEndTime());
+  EXPECT_EQ(StartTimes(m_database->GetAllEpgTags(1)), StartTimes(index.GetAllTags()));
+
+  for (time_t time = GUIDE_START - 3600; time < GUIDE_START + 26 * 3600; time += 150)
+  {
+    const CDateTime t(time);
+    const CDateTime later(time + 5400);
+
+    EXPECT_EQ(m_database->GetMinStartTime(1, t), index.GetMinStartTime(t)) << time;
+    EXPECT_EQ(m_database->GetMaxEndTime(1, t), index.GetMaxEndTime(t)) << time;
+    EXPECT_EQ(StartTime(m_database->GetEpgTagByStartTime(1, t)),
+              StartTime(index.GetTagByStartTime(t)))
+        << time;
+    EXPECT_EQ(StartTime(m_database->GetEpgTagByMinStartTime(1, t)),
+              StartTime(index.GetTagByMinStartTime(t)))
+        << time;
+    EXPECT_EQ(StartTime(m_database->GetEpgTagByMaxEndTime(1, t)),
+              StartTime(index.GetTagByMaxEndTime(t)))
+        << time;
+    EXPECT_EQ(StartTimes(m_database->GetEpgTagsByMinStartMaxEndTime(1, t, later)),
+              StartTimes(index.GetTagsByMinStartMaxEndTime(t, later)))
+        << time;
+    EXPECT_EQ(StartTimes(m_database->GetEpgTagsByMinEndMaxStartTime(1, t, later)),
+              StartTimes(index.GetTagsByMinEndMaxStartTime(t, later)))
+        << time;
+  }
+
+  // the index stays in sync with the tags deleted from the database
+  CPVREpgTagsIndex syncedIndex(1, m_database);
+  syncedIndex.GetAllTags();
+
+  const CDateTime cleanupTime(GUIDE_START + 6 * 3600);
+  m_database->DeleteEpgTags(1, cleanupTime);
+  syncedIndex.EraseByMaxEndTime(cleanupTime);
+  EXPECT_EQ(StartTimes(m_database->GetAllEpgTags(1)), StartTimes(syncedIndex.GetAllTags()));
+}
+
+TEST_F(TestEpgTagsIndex, Sync)
+{
+  CPVREpgTagsIndex index(1, nullptr);
+  EXPECT_FALSE(index.GetFirstStartTime().IsValid());
+
+  index.Clear();
+  index.QueueInsert(*CreateTag(GUIDE_START + 3600, GUIDE_START + 7200));
+  index.QueueInsert(*CreateTag(GUIDE_START, GUIDE_START + 1800));
+  index.QueueInsert(*CreateTag(GUIDE_START + 1800, GUIDE_START + 3600));
+  EXPECT_FALSE(index.GetFirstStartTime().IsValid());
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(std::vector<time_t>({GUIDE_START, GUIDE_START + 1800, GUIDE_START + 3600}),
+            IndexedStartTimes(index));
+  EXPECT_EQ(CDateTime(GUIDE_START + 7200), index.GetLastEndTime());
+
+  // a tag with the same start time replaces the existing one
+  index.QueueInsert(*CreateTag(GUIDE_START, GUIDE_START + 900));
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(CDateTime(GUIDE_START + 900), index.GetMaxEndTime(CDateTime(GUIDE_START + 1700)));
+  EXPECT_EQ(3u, IndexedStartTimes(index).size());
+
+  // replacing the events overlapping a changed tag, like the tags container does
+  index.QueueEraseByMinEndMaxStartTime(CDateTime(GUIDE_START + 1), CDateTime(GUIDE_START + 3599));
+  index.QueueInsert(*CreateTag(GUIDE_START, GUIDE_START + 3600));
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(std::vector<time_t>({GUIDE_START, GUIDE_START + 3600}), IndexedStartTimes(index));
+  EXPECT_FALSE(index.GetMaxEndTime(CDateTime(GUIDE_START + 3599)).IsValid());
+  EXPECT_EQ(CDateTime(GUIDE_START + 3600), index.GetMaxEndTime(CDateTime(GUIDE_START + 3600)));
+
+  // tags inserted without a database id can be removed again
+  index.QueueInsert(*CreateTag(GUIDE_START + 7200, GUIDE_START + 9000));
+  index.QueueErase(*CreateTag(GUIDE_START + 7200, GUIDE_START + 9000));
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(std::vector<time_t>({GUIDE_START, GUIDE_START + 3600}), IndexedStartTimes(index));
+  EXPECT_EQ(CDateTime(GUIDE_START + 7200), index.GetLastEndTime());
+
+  index.EraseByMaxEndTime(CDateTime(GUIDE_START + 3601));
+  EXPECT_EQ(CDateTime(GUIDE_START + 3600), index.GetFirstStartTime());
+
+  // unused indexes are released, used ones are kept
+  EXPECT_FALSE(index.ReleaseIfUnused());
+  EXPECT_TRUE(index.ReleaseIfUnused());
+}
+
+TEST_F(TestEpgTagsIndex, TagsAreCopies)
+{
+  AddGuide(1, 1);
+  CPVREpgTagsIndex index(1, m_database);
+  const CDateTime lastEnd = index.GetLastEndTime();
+
+  // changing a tag, like the tags container does when fixing overlaps, changes neither the index
+  // nor the tags handed out later
+  const std::shared_ptr<CPVREpgInfoTag> tag = index.GetTagByStartTime(CDateTime(GUIDE_START));
+  ASSERT_TRUE(tag);
+  tag->SetEndFromUTC(lastEnd + CDateTimeSpan(1, 0, 0, 0));
+  EXPECT_EQ(lastEnd, index.GetLastEndTime());
+
+  const std::shared_ptr<CPVREpgInfoTag> sameTag = index.GetTagByStartTime(CDateTime(GUIDE_START));
+  ASSERT_TRUE(sameTag);
+  EXPECT_NE(tag, sameTag);
+  EXPECT_EQ(CDateTime(GUIDE_START + 600), sameTag->EndAsUTC());
+
+  // tags are removed by their database id
+  index.QueueErase(*sameTag);
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(CDateTime(GUIDE_START + 900), index.GetFirstStartTime());
+}
+
+TEST_F(TestEpgTagsIndex, CommitOutcome)
+{
+  AddGuide(1, 1);
+  CPVREpgTagsIndex index(1, m_database);
+
+  // times are answered by the database until tags are needed
+  EXPECT_EQ(CDateTime(GUIDE_START), index.GetFirstStartTime());
+  EXPECT_FALSE(index.ReleaseIfUnused());
+  index.GetAllTags();
+
+  // a failed commit leaves the database unchanged, the index follows it
+  const std::shared_ptr<CPVREpgInfoTag> tag = index.GetTagByStartTime(CDateTime(GUIDE_START));
+  ASSERT_TRUE(tag);
+  index.QueueErase(*tag);
+  index.OnQueriesCommitted(false);
+  EXPECT_EQ(CDateTime(GUIDE_START), index.GetFirstStartTime());
+  EXPECT_EQ(StartTimes(m_database->GetAllEpgTags(1)), StartTimes(index.GetAllTags()));
+
+  // changes queued before the index was released are not lost when it is loaded again
+  index.QueueErase(*tag);
+  index.Reset();
+  index.GetAllTags();
+  m_database->DeleteEpgTags(1, CDateTime(GUIDE_START + 601));
+  index.OnQueriesCommitted(true);
+  EXPECT_EQ(StartTimes(m_database->GetAllEpgTags(1)), StartTimes(index.GetAllTags()));
+}
+
+TEST_F(TestEpgTagsIndex, DISABLED_QueryBenchmark)
+{
+  // 100 channels with 14 days of guide data, querying 2 hour windows like the EPG grid
+  AddGuide(100, 14);
+
+  const CPVREpgTagsIndex index(50, m_database);
+  index.GetAllTags();
+
+  size_t indexedCount = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (time_t time = GUIDE_START; time < GUIDE_START + 14 * 24 * 3600; time += 600)
+    indexedCount +=
+        index.GetTagsByMinEndMaxStartTime(CDateTime(time), CDateTime(time + 7200)).size();
+  const auto indexedTime = std::chrono::steady_clock::now() - start;
+
+  size_t queriedCount = 0;
+  start = std::chrono::steady_clock::now();
+  for (time_t time = GUIDE_START; time < GUIDE_START + 14 * 24 * 3600; time += 600)
+    queriedCount +=
+        m_database->GetEpgTagsByMinEndMaxStartTime(50, CDateTime(time), CDateTime(time + 7200))
+            .size();
+  const auto queriedTime = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(queriedCount, indexedCount);
+  RecordProperty("IndexedUs", static_cast<int>(
+                                  std::chrono::duration_cast<std::chrono::microseconds>(indexedTime)
+                                      .count()));
+  RecordProperty("QueriedUs", static_cast<int>(
+                                  std::chrono::duration_cast<std::chrono::microseconds>(queriedTime)
+                                      .count()));
+}
@@ -21,9 +21,11 @@
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/epg/EpgInfoTag.h"
 #include "pvr/guilib/GUIEPGGridContainerModel.h"
+#include "threads/SystemClock.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
+#include "utils/log.h"
 
 #include <algorithm>
 #include <memory>
@@ -744,6 +746,11 @@ void CGUIEPGGridContainer::UpdateItems()
   m_lastItem = nullptr;
   m_lastChannel = nullptr;
 
+  // only the channels whose EPG changed since the current grid was filled need to be fetched again.
+  const int iTakenChannels = m_updatedGridModel->TakeUnchangedEpgTags(*m_gridModel);
+  CLog::LogFC(LOGDEBUG, LOGEPG, "Took over the EPG tags of {} unchanged channels, holding {} items",
+              iTakenChannels, m_updatedGridModel->GetMaterializedItemsSize());
+
   // always use asynchronously precalculated grid data.
   m_gridModel = std::move(m_updatedGridModel);
 
@@ -1800,8 +1807,14 @@ void CGUIEPGGridContainer::SetTimelineItems(const std::unique_ptr<CFileItemList>
   std::unique_ptr<CGUIEPGGridContainerModel> oldUpdatedGridModel;
   std::unique_ptr<CGUIEPGGridContainerModel> newUpdatedGridModel(new CGUIEPGGridContainerModel);
 
+  const unsigned int iStartTime = XbmcThreads::SystemClockMillis();
   newUpdatedGridModel->Initialize(items, gridStart, gridEnd, iFirstChannel, iChannelsPerPage,
                                   iFirstBlock, iBlocksPerPage, iRulerUnit, fBlockSize);
+  CLog::LogFC(LOGDEBUG, LOGEPG,
+              "Grid model with {} channels and {} blocks created in {} ms, holding {} items",
+              newUpdatedGridModel->ChannelItemsSize(), newUpdatedGridModel->GridItemsSize(),
+              XbmcThreads::SystemClockMillis() - iStartTime,
+              newUpdatedGridModel->GetMaterializedItemsSize());
   {
     CSingleLock lock(m_critSection);
 
@@ -2364,8 +2377,13 @@ void CGUIEPGGridContainer::HandleProgrammeGrid(bool bRender, unsigned int curren
     if (lastBlock > m_gridModel->GetLastBlock())
       lastBlock = m_gridModel->GetLastBlock();
 
+    const unsigned int iStartTime = XbmcThreads::SystemClockMillis();
     if (m_gridModel->FreeProgrammeMemory(firstChannel, lastChannel, firstBlock, lastBlock))
     {
+      CLog::LogFC(LOGDEBUG, LOGEPG, "Grid viewport updated in {} ms, holding {} items",
+                  XbmcThreads::SystemClockMillis() - iStartTime,
+                  m_gridModel->GetMaterializedItemsSize());
+
       // announce changed viewport
       const CGUIMessage msg(
           GUI_MSG_REFRESH_LIST, GetParentID(), GetID(), static_cast<int>(PVREvent::Epg));
@@ -19,6 +19,7 @@
 #include "utils/Variant.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <vector>
@@ -34,7 +35,15 @@ void CGUIEPGGridContainerModel::SetInvalid()
   for (const auto& channel : m_channelItems)
     channel->SetInvalid();
   for (const auto& ruler : m_rulerItems)
-    ruler->SetInvalid();
+  {
+    if (ruler)
+      ruler->SetInvalid();
+  }
+  for (const auto& gap : m_gapItems)
+  {
+    if (gap)
+      gap->SetInvalid();
+  }
 }
 
 std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateGapItem(int iChannel) const
@@ -85,6 +94,7 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   {
     m_channelItems.emplace_back(channelItem);
   }
+  m_gapItems.resize(m_channelItems.size());
 
   /* check for invalid start and end time */
   if (gridStart >= gridEnd)
@@ -121,22 +131,19 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   }
 
   ////////////////////////////////////////////////////////////////////////
-  // Create ruler items
-  CDateTime ruler;
-  ruler.SetFromUTCDateTime(m_gridStart);
+  // Prepare ruler items. The date label plus one item per ruler unit, created on demand.
+  m_rulerStart.SetFromUTCDateTime(m_gridStart);
   CDateTime rulerEnd;
   rulerEnd.SetFromUTCDateTime(m_gridEnd);
-  CFileItemPtr rulerItem(new CFileItem(ruler.GetAsLocalizedDate(true)));
-  rulerItem->SetProperty("DateLabel", true);
-  m_rulerItems.emplace_back(rulerItem);
+  m_iRulerUnit = iRulerUnit;
 
-  const CDateTimeSpan unit(0, 0, iRulerUnit * MINSPERBLOCK, 0);
-  for (; ruler < rulerEnd; ruler += unit)
+  int iRulerItems = 1;
+  if (m_rulerStart < rulerEnd)
   {
-    rulerItem.reset(new CFileItem(ruler.GetAsLocalizedTime("", false)));
-    rulerItem->SetLabel2(ruler.GetAsLocalizedDate(true));
-    m_rulerItems.emplace_back(rulerItem);
+    const int iUnitSeconds = iRulerUnit * MINSPERBLOCK * 60;
+    iRulerItems += ((rulerEnd - m_rulerStart).GetSecondsTotal() + iUnitSeconds - 1) / iUnitSeconds;
   }
+  m_rulerItems.resize(iRulerItems);
 
   m_firstActiveChannel = iFirstChannel;
   m_lastActiveChannel = iFirstChannel + iChannelsPerPage - 1;
@@ -144,10 +151,45 @@ void CGUIEPGGridContainerModel::Initialize(const std::unique_ptr<CFileItemList>&
   m_lastActiveBlock = iFirstBlock + iBlocksPerPage - 1;
 }
 
+std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetRulerItem(int iIndex) const
+{
+  std::shared_ptr<CFileItem>& rulerItem = m_rulerItems[iIndex];
+  if (!rulerItem)
+  {
+    if (iIndex == 0)
+    {
+      rulerItem = std::make_shared<CFileItem>(m_rulerStart.GetAsLocalizedDate(true));
+      rulerItem->SetProperty("DateLabel", true);
+    }
+    else
+    {
+      const CDateTime ruler =
+          m_rulerStart + CDateTimeSpan(0, 0, (iIndex - 1) * m_iRulerUnit * MINSPERBLOCK, 0);
+      rulerItem = std::make_shared<CFileItem>(ruler.GetAsLocalizedTime("", false));
+      rulerItem->SetLabel2(ruler.GetAsLocalizedDate(true));
+    }
+  }
+  return rulerItem;
+}
+
+void CGUIEPGGridContainerModel::GetEpgVersion(int iChannel,
+                                              int& iEpgId,
+                                              unsigned int& iEpgVersion) const
+{
+  const std::shared_ptr<CPVREpg> epg = m_channelItems[iChannel]->GetPVRChannelInfoTag()->GetEPG();
+  iEpgId = epg ? epg->EpgID() : -1;
+  iEpgVersion = epg ? epg->GetTagsVersion() : 0;
+}
+
 std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTags(int iChannel, int iBlock) const
 {
   std::shared_ptr<CFileItem> result;
 
+  // get the version before fetching, so that changes made meanwhile are not missed
+  int iEpgId;
+  unsigned int iEpgVersion;
+  GetEpgVersion(iChannel, iEpgId, iEpgVersion);
+
   const int firstBlock = iBlock < m_firstActiveBlock ? iBlock : m_firstActiveBlock;
   const int lastBlock = iBlock > m_lastActiveBlock ? iBlock : m_lastActiveBlock;
 
@@ -164,6 +206,8 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::CreateEpgTags(int iChannel
 
   epgTags.firstBlock = firstResultBlock;
   epgTags.lastBlock = lastResultBlock;
+  epgTags.epgId = iEpgId;
+  epgTags.epgVersion = iEpgVersion;
 
   for (const auto& tag : tags)
   {
@@ -335,6 +379,29 @@ std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetEpgTagsAfter(EpgTags& e
   return result;
 }
 
+void CGUIEPGGridContainerModel::TrimEpgTags(EpgTags& epgTags, int iFirstBlock, int iLastBlock) const
+{
+  // tags are sorted and contiguous, so the ones to drop are at the front and at the back
+  auto& tags = epgTags.tags;
+
+  auto itFirst = tags.begin();
+  while (itFirst != tags.end() && GetLastEventBlock((*itFirst)->GetEPGInfoTag()) < iFirstBlock)
+    ++itFirst;
+
+  auto itLast = itFirst;
+  while (itLast != tags.end() && GetFirstEventBlock((*itLast)->GetEPGInfoTag()) <= iLastBlock)
+    ++itLast;
+
+  tags.erase(itLast, tags.end());
+  tags.erase(tags.begin(), itFirst);
+
+  if (!tags.empty())
+  {
+    epgTags.firstBlock = GetFirstEventBlock(tags.front()->GetEPGInfoTag());
+    epgTags.lastBlock = GetLastEventBlock(tags.back()->GetEPGInfoTag());
+  }
+}
+
 std::shared_ptr<CFileItem> CGUIEPGGridContainerModel::GetItem(int iChannel, int iBlock) const
 {
   std::shared_ptr<CFileItem> result;
@@ -509,8 +576,6 @@ bool CGUIEPGGridContainerModel::FreeProgrammeMemory(int firstChannel,
   // clear the grid. it will be recreated on-demand.
   m_gridIndex.clear();
 
-  bool newChannels = false;
-
   if (channelsChanged)
   {
     // purge epg tags for inactive channels
@@ -523,45 +588,55 @@ bool CGUIEPGGridContainerModel::FreeProgrammeMemory(int firstChannel,
       }
       ++it;
     }
-
-    newChannels = (firstChannel < m_firstActiveChannel) || (lastChannel > m_lastActiveChannel);
   }
 
-  if (blocksChanged || newChannels)
+  // keep the epg tags already fetched for the active area, only fetch the missing ones
+  const CDateTime maxEnd = GetStartTimeForBlock(firstBlock);
+  const CDateTime minStart = GetStartTimeForBlock(lastBlock);
+  std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
+  for (int i = firstChannel; i <= lastChannel; ++i)
   {
-    // clear and refetch epg tags for active channels
-    const CDateTime maxEnd = GetStartTimeForBlock(firstBlock);
-    const CDateTime minStart = GetStartTimeForBlock(lastBlock);
-    std::vector<std::shared_ptr<CPVREpgInfoTag>> tags;
-    for (int i = firstChannel; i <= lastChannel; ++i)
+    auto it = m_epgItems.find(i);
+    if (it != m_epgItems.end())
     {
-      auto it = m_epgItems.find(i);
-      if (it == m_epgItems.end())
-        it = m_epgItems.insert({i, EpgTags()}).first;
+      EpgTags& epgTags = (*it).second;
 
-      if (blocksChanged || i < m_firstActiveChannel || i > m_lastActiveChannel)
+      if (blocksChanged)
+        TrimEpgTags(epgTags, firstBlock, lastBlock);
+
+      if (!epgTags.tags.empty())
       {
-        EpgTags& epgTags = (*it).second;
+        if (firstBlock < epgTags.firstBlock)
+          GetEpgTagsBefore(epgTags, i, firstBlock);
+        if (lastBlock > epgTags.lastBlock)
+          GetEpgTagsAfter(epgTags, i, lastBlock);
+
+        continue; // next channel
+      }
+    }
+    else
+    {
+      it = m_epgItems.insert({i, EpgTags()}).first;
+    }
 
-        (*it).second.tags.clear();
+    EpgTags& epgTags = (*it).second;
 
-        tags = GetEPGTimeline(i, maxEnd, minStart);
-        const int firstResultBlock = GetFirstEventBlock(tags.front());
-        const int lastResultBlock = GetLastEventBlock(tags.back());
-        if (firstResultBlock > lastResultBlock)
-          continue;
+    GetEpgVersion(i, epgTags.epgId, epgTags.epgVersion);
+    tags = GetEPGTimeline(i, maxEnd, minStart);
+    const int firstResultBlock = GetFirstEventBlock(tags.front());
+    const int lastResultBlock = GetLastEventBlock(tags.back());
+    if (firstResultBlock > lastResultBlock)
+      continue;
 
-        epgTags.firstBlock = firstResultBlock;
-        epgTags.lastBlock = lastResultBlock;
+    epgTags.firstBlock = firstResultBlock;
+    epgTags.lastBlock = lastResultBlock;
 
-        for (const auto& tag : tags)
-        {
-          if (GetFirstEventBlock(tag) > GetLastEventBlock(tag))
-            continue;
+    for (const auto& tag : tags)
+    {
+      if (GetFirstEventBlock(tag) > GetLastEventBlock(tag))
+        continue;
 
-          epgTags.tags.emplace_back(std::make_shared<CFileItem>(tag));
-        }
-      }
+      epgTags.tags.emplace_back(std::make_shared<CFileItem>(tag));
     }
   }
 
@@ -575,13 +650,14 @@ bool CGUIEPGGridContainerModel::FreeProgrammeMemory(int firstChannel,
 
 void CGUIEPGGridContainerModel::FreeRulerMemory(int keepStart, int keepEnd)
 {
+  // ruler items are cheap to create again, so drop them altogether
   if (keepStart < keepEnd)
   {
     // remove before keepStart and after keepEnd
     for (int i = 1; i < keepStart && i < RulerItemsSize(); ++i)
-      m_rulerItems[i]->FreeMemory();
+      m_rulerItems[i].reset();
     for (int i = keepEnd + 1; i < RulerItemsSize(); ++i)
-      m_rulerItems[i]->FreeMemory();
+      m_rulerItems[i].reset();
   }
   else
   {
@@ -591,7 +667,7 @@ void CGUIEPGGridContainerModel::FreeRulerMemory(int keepStart, int keepEnd)
       if (i == 0)
         continue;
 
-      m_rulerItems[i]->FreeMemory();
+      m_rulerItems[i].reset();
     }
   }
 }
@@ -705,8 +781,10 @@ std::unique_ptr<CFileItemList> CGUIEPGGridContainerModel::GetCurrentTimeLineItem
     }
     else
     {
-      // fake empty EPG
-      const std::shared_ptr<CFileItem> tag = CreateGapItem(channel);
+      // fake empty EPG, kept for the next timeline of this grid
+      std::shared_ptr<CFileItem>& tag = m_gapItems[channel];
+      if (!tag)
+        tag = CreateGapItem(channel);
       tag->SetProperty("TimelineIndex", i);
       items->Add(tag);
       ++i;
@@ -714,3 +792,63 @@ std::unique_ptr<CFileItemList> CGUIEPGGridContainerModel::GetCurrentTimeLineItem
   }
   return items;
 }
+
+size_t CGUIEPGGridContainerModel::GetMaterializedItemsSize() const
+{
+  size_t size = m_channelItems.size() + m_gridIndex.size();
+
+  for (const auto& epgTags : m_epgItems)
+    size += epgTags.second.tags.size();
+
+  size += std::count_if(m_rulerItems.cbegin(), m_rulerItems.cend(),
+                        [](const std::shared_ptr<CFileItem>& item) { return item != nullptr; });
+  size += std::count_if(m_gapItems.cbegin(), m_gapItems.cend(),
+                        [](const std::shared_ptr<CFileItem>& item) { return item != nullptr; });
+  return size;
+}
+
+int CGUIEPGGridContainerModel::TakeUnchangedEpgTags(const CGUIEPGGridContainerModel& other)
+{
+  // block indexes and gap tags are only valid for the grid they were created for
+  if (other.m_gridStart != m_gridStart || other.m_gridEnd != m_gridEnd)
+    return 0;
+
+  // channels may have been added, removed or moved, so match them by identity
+  std::unordered_map<const CPVRChannel*, int> channels;
+  for (int i = 0; i < ChannelItemsSize(); ++i)
+    channels.insert({m_channelItems[i]->GetPVRChannelInfoTag().get(), i});
+
+  for (int i = 0; i < other.ChannelItemsSize(); ++i)
+  {
+    if (!other.m_gapItems[i])
+      continue;
+
+    const auto it = channels.find(other.m_channelItems[i]->GetPVRChannelInfoTag().get());
+    if (it != channels.end())
+      m_gapItems[(*it).second] = other.m_gapItems[i];
+  }
+
+  int iTaken = 0;
+  for (const auto& otherEpgTags : other.m_epgItems)
+  {
+    const auto it =
+        channels.find(other.m_channelItems[otherEpgTags.first]->GetPVRChannelInfoTag().get());
+    if (it == channels.end())
+      continue;
+
+    const int iChannel = (*it).second;
+    if (iChannel < m_firstActiveChannel || iChannel > m_lastActiveChannel)
+      continue;
+
+    int iEpgId;
+    unsigned int iEpgVersion;
+    GetEpgVersion(iChannel, iEpgId, iEpgVersion);
+    if (iEpgId != otherEpgTags.second.epgId || iEpgVersion != otherEpgTags.second.epgVersion)
+      continue; // changed, will be fetched again on demand
+
+    m_epgItems.insert({iChannel, otherEpgTags.second});
+    ++iTaken;
+  }
+
+  return iTaken;
+}
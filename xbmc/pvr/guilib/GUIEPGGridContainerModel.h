@@ -81,7 +81,7 @@ namespace PVR
       return m_channelItems.empty() ? -1 : static_cast<int>(m_channelItems.size()) - 1;
     }
 
-    std::shared_ptr<CFileItem> GetRulerItem(int iIndex) const { return m_rulerItems[iIndex]; }
+    std::shared_ptr<CFileItem> GetRulerItem(int iIndex) const;
     int RulerItemsSize() const { return static_cast<int>(m_rulerItems.size()); }
 
     int GridItemsSize() const { return m_blocks; }
@@ -110,6 +110,21 @@ namespace PVR
 
     std::unique_ptr<CFileItemList> GetCurrentTimeLineItems() const;
 
+    /*!
+     * @brief Get the number of items currently held by the model. Ruler and programme items are
+     * only created for the part of the grid that was requested so far.
+     * @return The number of items.
+     */
+    size_t GetMaterializedItemsSize() const;
+
+    /*!
+     * @brief Take over the EPG tags already fetched by another model for all channels whose EPG
+     * did not change since, so that only the changed channels need to be fetched again.
+     * @param other The model to take the EPG tags from. Must cover the same grid.
+     * @return The number of channels whose EPG tags were taken over.
+     */
+    int TakeUnchangedEpgTags(const CGUIEPGGridContainerModel& other);
+
   private:
     GridItem* GetGridItemPtr(int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> CreateGapItem(int iChannel) const;
@@ -123,16 +138,21 @@ namespace PVR
       std::vector<std::shared_ptr<CFileItem>> tags;
       int firstBlock = -1;
       int lastBlock = -1;
+      int epgId = -1; // the EPG the tags were fetched from
+      unsigned int epgVersion = 0; // its tags version before the tags were first fetched
     };
 
     using EpgTagsMap = std::unordered_map<int, EpgTags>;
 
+    void GetEpgVersion(int iChannel, int& iEpgId, unsigned int& iEpgVersion) const;
+
     std::shared_ptr<CFileItem> CreateEpgTags(int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> GetEpgTags(EpgTagsMap::iterator& itEpg,
                                           int iChannel,
                                           int iBlock) const;
     std::shared_ptr<CFileItem> GetEpgTagsBefore(EpgTags& epgTags, int iChannel, int iBlock) const;
     std::shared_ptr<CFileItem> GetEpgTagsAfter(EpgTags& epgTags, int iChannel, int iBlock) const;
+    void TrimEpgTags(EpgTags& epgTags, int iFirstBlock, int iLastBlock) const;
 
     mutable EpgTagsMap m_epgItems;
 
@@ -140,7 +160,11 @@ namespace PVR
     CDateTime m_gridEnd;
 
     std::vector<std::shared_ptr<CFileItem>> m_channelItems;
-    std::vector<std::shared_ptr<CFileItem>> m_rulerItems;
+    mutable std::vector<std::shared_ptr<CFileItem>> m_rulerItems; // created on demand
+    mutable std::vector<std::shared_ptr<CFileItem>> m_gapItems; // created on demand
+
+    CDateTime m_rulerStart;
+    int m_iRulerUnit = 0;
 
     struct GridCoordinates
     {
@@ -155,6 +155,7 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoDemuxZeroCopy = true;
 
   m_videoDefaultLatency = 0.0;
 
@@ -341,6 +342,8 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlParallelConnections = 1;
+  m_curlParallelChunkSize = 1024 * 1024;
 
 #if defined(TARGET_DARWIN_EMBEDDED)
   m_startFullScreen = true;
@@ -384,6 +387,10 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // use the lock-free (and where possible mirrored) memory cache instead of CCircularCache
+  m_cacheLockFree = false;
+  // keep downloaded data of seekable network files on disk across seeks and sessions
+  m_cachePersistentSize = 0;
 
   m_addonPackageFolderSize = 200;
 
@@ -396,6 +403,7 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiPersistGlyphCache = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -707,6 +715,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    // pass the packets of ffmpeg's demuxer to the codecs without copying them
+    XMLUtils::GetBoolean(pElement, "demuxzerocopy", m_videoDemuxZeroCopy);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -825,6 +835,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlkeepaliveinterval", m_curlKeepAliveInterval, 0, 300);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetInt(pElement, "curlparallelconnections", m_curlParallelConnections, 1, 16);
+    XMLUtils::GetInt(pElement, "curlparallelchunksize", m_curlParallelChunkSize, 64 * 1024,
+                     16 * 1024 * 1024);
     XMLUtils::GetString(pElement, "catrustfile", m_caTrustFile);
   }
 
@@ -835,6 +848,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "lockfree", m_cacheLockFree);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -1199,6 +1214,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetBoolean(pElement, "persistglyphcache", m_guiPersistGlyphCache);
   }
 
   std::string seekSteps;
@@ -173,6 +173,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_videoFpsDetect;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoDemuxZeroCopy = true;
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -288,6 +289,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlKeepAliveInterval;    // seconds
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    int m_curlParallelConnections; // number of concurrent range requests for cached reads, 1 disables
+    int m_curlParallelChunkSize; // bytes requested per range
 
     std::string m_caTrustFile;
 
@@ -334,12 +337,15 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiPersistGlyphCache; ///< keep rendered font glyphs in special://temp across restarts
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
+    bool m_cacheLockFree;
+    unsigned int m_cachePersistentSize; // in MiB, 0 disables the persistent cache
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "addons/Skin.h"
+#include "addons/addoninfo/AddonInfo.h"
+#include "filesystem/Directory.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/guiinfo/GUIInfoLabel.h"
+#include "test/TestUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+class TestGUIInfoManager : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_gui.reset(new CGUIComponent());
+    CServiceBroker::RegisterGUI(m_gui.get());
+
+    // skin settings used in conditions are translated by the skin in use
+    m_skin = g_SkinInfo;
+    g_SkinInfo = std::make_shared<ADDON::CSkinInfo>(
+        std::make_shared<ADDON::CAddonInfo>("skin.estuary", ADDON::ADDON_SKIN),
+        RESOLUTION_INFO(1920, 1080, 0, "xml"));
+  }
+
+  void TearDown() override
+  {
+    g_SkinInfo = m_skin;
+    CServiceBroker::UnregisterGUI();
+    m_gui.reset();
+  }
+
+  CGUIInfoManager& GetInfoManager() { return m_gui->GetInfoManager(); }
+
+private:
+  std::unique_ptr<CGUIComponent> m_gui;
+  std::shared_ptr<ADDON::CSkinInfo> m_skin;
+};
+
+// registers the conditions and info labels of an element and its children like the control
+// factory does while loading a window
+void RegisterConditions(CGUIInfoManager& infoMgr,
+                        const TiXmlElement* element,
+                        int context,
+                        unsigned int& count)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const char* condition = element->Attribute("condition");
+    if (condition && infoMgr.Register(condition, context))
+      count++;
+
+    const std::string& name = element->ValueStr();
+    const TiXmlNode* text = element->FirstChild();
+    if (text && text->Type() == TiXmlNode::TINYXML_TEXT)
+    {
+      if (name == "visible" || name == "enable" || name == "selected" || name == "usealttexture")
+      {
+        if (infoMgr.Register(text->ValueStr(), context))
+          count++;
+      }
+      else if (name == "label" || name == "label2" || name == "texture")
+      {
+        KODI::GUILIB::GUIINFO::CGUIInfoLabel label(text->ValueStr(), "", context);
+        count++;
+      }
+    }
+
+    RegisterConditions(infoMgr, element->FirstChildElement(), context, count);
+  }
+}
+
+} // unnamed namespace
+
+TEST_F(TestGUIInfoManager, Register)
+{
+  CGUIInfoManager& infoMgr = GetInfoManager();
+
+  INFO::InfoPtr info = infoMgr.Register("System.AlwaysTrue + !Player.HasMedia", 10000);
+  ASSERT_TRUE(info);
+  EXPECT_EQ(info, infoMgr.Register("  system.alwaystrue + !player.hasmedia ", 10000));
+  EXPECT_NE(info, infoMgr.Register("System.AlwaysTrue + !Player.HasMedia", 10001));
+
+  // operands are registered as conditions of their own
+  INFO::InfoPtr single = infoMgr.Register("Player.HasMedia", 10000);
+  ASSERT_TRUE(single);
+  EXPECT_FALSE(single->ListItemDependent());
+  EXPECT_EQ(single, infoMgr.Register("player.hasmedia", 10000));
+
+  EXPECT_FALSE(infoMgr.Register("   ", 10000));
+}
+
+TEST_F(TestGUIInfoManager, TranslateString)
+{
+  CGUIInfoManager& infoMgr = GetInfoManager();
+
+  const int condition = infoMgr.TranslateString("String.IsEqual(Window.Property(Test),value)");
+  EXPECT_NE(0, condition);
+  EXPECT_EQ(condition, infoMgr.TranslateString("String.IsEqual(Window.Property(Test),value)"));
+  EXPECT_NE(condition, infoMgr.TranslateString("String.IsEqual(Window.Property(Test),other)"));
+
+  bool listItemDependent = false;
+  const int item = infoMgr.TranslateSingleString("ListItem.IsFolder", listItemDependent);
+  EXPECT_TRUE(listItemDependent);
+  // the dependency is kept for cached translations
+  listItemDependent = false;
+  EXPECT_EQ(item, infoMgr.TranslateSingleString("ListItem.IsFolder", listItemDependent));
+  EXPECT_TRUE(listItemDependent);
+}
+
+TEST_F(TestGUIInfoManager, Evaluate)
+{
+  CGUIInfoManager& infoMgr = GetInfoManager();
+
+  EXPECT_TRUE(infoMgr.EvaluateBool("true + !false"));
+  EXPECT_FALSE(infoMgr.EvaluateBool("[false | true] + [false | !true]"));
+  EXPECT_TRUE(infoMgr.EvaluateBool("![false | false] + [true | false]"));
+  EXPECT_FALSE(infoMgr.EvaluateBool("true + [false"));
+}
+
+/*!
+ * Registers the conditions and info labels of all windows of the default skin like loading them
+ * would, once into an empty info manager and again like reopening the windows does. Reports the
+ * time of both.
+ */
+TEST_F(TestGUIInfoManager, DISABLED_LoadSkinWindows)
+{
+  using Clock = std::chrono::steady_clock;
+  constexpr int RELOADS = 5;
+
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.estuary/xml"),
+                                              items, ".xml", XFILE::DIR_FLAG_DEFAULTS));
+  ASSERT_FALSE(items.IsEmpty());
+
+  std::vector<std::unique_ptr<CXBMCTinyXML>> windows;
+  for (const auto& item : items)
+  {
+    std::unique_ptr<CXBMCTinyXML> doc(new CXBMCTinyXML());
+    ASSERT_TRUE(doc->LoadFile(item->GetPath())) << item->GetPath();
+    windows.emplace_back(std::move(doc));
+  }
+
+  CGUIInfoManager& infoMgr = GetInfoManager();
+  auto load = [&]() {
+    unsigned int count = 0;
+    int context = 10000;
+    for (const auto& doc : windows)
+      RegisterConditions(infoMgr, doc->RootElement(), context++, count);
+    return count;
+  };
+
+  const auto start = Clock::now();
+  const unsigned int conditions = load();
+  const auto cold = Clock::now() - start;
+  EXPECT_GT(conditions, 0u);
+
+  const auto reloadStart = Clock::now();
+  for (int i = 0; i < RELOADS; ++i)
+    EXPECT_EQ(conditions, load());
+  const auto warm = (Clock::now() - reloadStart) / RELOADS;
+
+  using std::chrono::duration;
+  RecordProperty("Windows", std::to_string(windows.size()));
+  RecordProperty("Conditions", std::to_string(conditions));
+  RecordProperty("FirstLoadMs", std::to_string(duration<double, std::milli>(cold).count()));
+  RecordProperty("ReloadMs", std::to_string(duration<double, std::milli>(warm).count()));
+}
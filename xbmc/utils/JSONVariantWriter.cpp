@@ -10,6 +10,11 @@
 
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <map>
+#include <string.h>
+#include <vector>
+
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
@@ -90,3 +95,179 @@ bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool
   output = stringBuffer.GetString();
   return true;
 }
+
+namespace
+{
+// rapidjson output stream appending to a std::string
+class CStringOutputStream
+{
+public:
+  typedef char Ch;
+
+  explicit CStringOutputStream(std::string& output) : m_output(output) {}
+
+  void Put(Ch c) { m_output.push_back(c); }
+  void Flush() {}
+
+private:
+  std::string& m_output;
+};
+} // namespace
+
+class CJSONVariantStreamWriter::CImpl
+{
+public:
+  CImpl(CVariant&& value, bool compact, ItemSources&& itemSources)
+    : m_value(std::move(value)), m_stream(m_pending), m_compact(compact), m_writer(m_stream),
+      m_prettyWriter(m_stream)
+  {
+    m_prettyWriter.SetIndent('\t', 1);
+    m_stack.push_back(Frame{&m_value});
+
+    for (auto& itemSource : itemSources)
+      m_itemSources[itemSource.first].source = std::move(itemSource.second);
+  }
+
+  ssize_t Read(char* buffer, size_t size)
+  {
+    // write ahead until there is enough to fill the buffer
+    while (m_pending.size() - m_readPos < size && !m_stack.empty())
+    {
+      if (!(m_compact ? Step(m_writer) : Step(m_prettyWriter)))
+        return -1;
+    }
+
+    if (m_stack.empty() && !(m_compact ? m_writer.IsComplete() : m_prettyWriter.IsComplete()))
+      return -1;
+
+    const size_t length = std::min(size, m_pending.size() - m_readPos);
+    memcpy(buffer, m_pending.data() + m_readPos, length);
+    m_readPos += length;
+
+    if (m_readPos == m_pending.size())
+    {
+      m_pending.clear();
+      m_readPos = 0;
+    }
+    else if (m_readPos > m_pending.size() / 2)
+    {
+      m_pending.erase(0, m_readPos);
+      m_readPos = 0;
+    }
+
+    return length;
+  }
+
+private:
+  struct ItemSource
+  {
+    std::unique_ptr<IJSONVariantItemSource> source;
+    CVariant item; ///< the item taken from the source last
+  };
+
+  struct Frame
+  {
+    CVariant* value;
+    bool started = false;
+    CVariant* child = nullptr; ///< the array item or member written last
+    CVariant::iterator_array item;
+    CVariant::iterator_map member;
+    ItemSource* itemSource = nullptr;
+  };
+
+  // writes the next token of the value on top of the stack
+  template<class TWriter>
+  bool Step(TWriter& writer)
+  {
+    Frame& frame = m_stack.back();
+    CVariant& value = *frame.value;
+
+    // the previous item/member has been written completely, it isn't needed anymore
+    if (frame.child)
+    {
+      *frame.child = CVariant();
+      frame.child = nullptr;
+    }
+
+    switch (value.type())
+    {
+      case CVariant::VariantTypeArray:
+        if (!frame.started)
+        {
+          frame.started = true;
+          frame.item = value.begin_array();
+          auto itemSource = m_itemSources.find(&value);
+          if (itemSource != m_itemSources.end())
+            frame.itemSource = &itemSource->second;
+          return writer.StartArray();
+        }
+        if (frame.item != value.end_array())
+        {
+          frame.child = &*frame.item++;
+          m_stack.push_back(Frame{frame.child});
+          return true;
+        }
+        if (frame.itemSource)
+        {
+          if (frame.itemSource->source->GetNext(frame.itemSource->item))
+          {
+            frame.child = &frame.itemSource->item;
+            m_stack.push_back(Frame{frame.child});
+            return true;
+          }
+          // release whatever the source holds right away
+          frame.itemSource = nullptr;
+          m_itemSources.erase(&value);
+        }
+        m_stack.pop_back();
+        return writer.EndArray();
+
+      case CVariant::VariantTypeObject:
+        if (!frame.started)
+        {
+          frame.started = true;
+          frame.member = value.begin_map();
+          return writer.StartObject();
+        }
+        if (frame.member != value.end_map())
+        {
+          CVariant::iterator_map member = frame.member++;
+          if (!writer.Key(member->first.c_str(), member->first.size()))
+            return false;
+          frame.child = &member->second;
+          m_stack.push_back(Frame{frame.child});
+          return true;
+        }
+        m_stack.pop_back();
+        return writer.EndObject();
+
+      default:
+        m_stack.pop_back();
+        return InternalWrite(writer, value);
+    }
+  }
+
+  CVariant m_value;
+  std::string m_pending;
+  size_t m_readPos = 0;
+  CStringOutputStream m_stream;
+  bool m_compact;
+  rapidjson::Writer<CStringOutputStream> m_writer;
+  rapidjson::PrettyWriter<CStringOutputStream> m_prettyWriter;
+  std::vector<Frame> m_stack;
+  std::map<const CVariant*, ItemSource> m_itemSources;
+};
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(CVariant&& value,
+                                                   bool compact,
+                                                   ItemSources itemSources)
+  : m_impl(new CImpl(std::move(value), compact, std::move(itemSources)))
+{
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter() = default;
+
+ssize_t CJSONVariantStreamWriter::Read(char* buffer, size_t size)
+{
+  return m_impl->Read(buffer, size);
+}
@@ -8,9 +8,12 @@
 
 #pragma once
 
-#include <string>
+#include "utils/Variant.h"
 
-class CVariant;
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/types.h>
 
 class CJSONVariantWriter
 {
@@ -19,3 +22,52 @@ public:
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
 };
+
+/*!
+ \brief Source of array items which are only created while the array is being written
+ */
+class IJSONVariantItemSource
+{
+public:
+  virtual ~IJSONVariantItemSource() = default;
+
+  /*!
+   \brief Gets the next item
+   \param item [out] The item
+   \return True if there was another item, false once all items have been returned
+   */
+  virtual bool GetNext(CVariant& item) = 0;
+};
+
+/*!
+ \brief Serializes a CVariant to JSON piece by piece
+
+ Instead of producing the whole JSON document at once, Read() returns it in parts of the size
+ asked for, so it can be passed on to a connection while the rest is still being written. Array
+ items and object members of the value are released as soon as they have been written, so the
+ value and its JSON representation never need to be in memory completely at the same time.
+
+ Arrays of the value can have an item source, whose items are written after the array's own ones.
+ They are taken from the source one at a time, so they don't even have to exist before.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  //! Item sources by the array of the value they belong to
+  using ItemSources = std::map<const CVariant*, std::unique_ptr<IJSONVariantItemSource>>;
+
+  CJSONVariantStreamWriter(CVariant&& value, bool compact, ItemSources itemSources = {});
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   \brief Writes the next part of the JSON document
+   \param buffer Buffer to write to
+   \param size Size of the buffer
+   \return The number of bytes written, 0 once the whole document has been read or -1 on error
+   */
+  ssize_t Read(char* buffer, size_t size);
+
+private:
+  class CImpl;
+  std::unique_ptr<CImpl> m_impl;
+};
@@ -23,9 +23,17 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
+namespace
+{
+// the worker running on the current thread, if any
+thread_local CJobWorker* currentWorker = nullptr;
+}
+
 CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_queue = manager->m_nextWorkerQueue++ % manager->m_queues.size();
+  m_currentQueue = m_queue;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -42,6 +50,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  currentWorker = this;
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -58,8 +67,9 @@ void CJobWorker::Process()
     {
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, job->GetType());
     }
-    m_jobManager->OnJobComplete(success, job);
+    m_jobManager->OnJobComplete(this, success, job);
   }
+  currentWorker = nullptr;
 }
 
 void CJobQueue::CJobPointer::CancelJob()
@@ -170,6 +180,13 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+
+  // one work queue per worker of the regular (non dedicated) pool
+  for (unsigned int i = 0; i < GetMaxWorkers(CJob::PRIORITY_HIGH); ++i)
+    m_queues.emplace_back(new CWorkQueue);
+  for (auto& queued : m_queuedJobs)
+    queued = 0;
+  ResetLatencyHistograms();
 }
 
 void CJobManager::Restart()
@@ -186,15 +203,21 @@ void CJobManager::CancelJobs()
   CSingleLock lock(m_section);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (auto& queue : m_queues)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
-    m_jobQueue[priority].clear();
-  }
+    CSingleLock queueLock(queue->m_section);
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      for_each(queue->m_jobQueue[priority].begin(), queue->m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
+      m_queuedJobs[priority] -= queue->m_jobQueue[priority].size();
+      queue->m_jobQueue[priority].clear();
+    }
+
+    // cancel any callbacks on jobs still processing
+    for_each(queue->m_processing.begin(), queue->m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+  }
 
   // tell our workers to finish
   while (m_workers.size())
@@ -208,19 +231,27 @@ void CJobManager::CancelJobs()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
+
+  // jobs queued from within a job stay with that worker, others are spread round robin
+  const size_t index = currentWorker && currentWorker->m_jobManager == this
+                           ? currentWorker->m_queue
+                           : m_nextQueue++ % m_queues.size();
+  CWorkQueue &queue = *m_queues[index];
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+  {
+    CSingleLock lock(queue.m_section);
+    queue.m_jobQueue[priority].push_back(work);
+    ++m_queuedJobs[priority];
+  }
 
   StartWorkers(priority);
   return work.m_id;
@@ -228,35 +259,44 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
-
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (auto& queue : m_queues)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CSingleLock lock(queue->m_section);
+
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue::iterator i = find(queue->m_jobQueue[priority].begin(), queue->m_jobQueue[priority].end(), jobID);
+      if (i != queue->m_jobQueue[priority].end())
+      {
+        delete i->m_job;
+        queue->m_jobQueue[priority].erase(i);
+        --m_queuedJobs[priority];
+        return;
+      }
+    }
+    // or if we're processing it
+    Processing::iterator it = find(queue->m_processing.begin(), queue->m_processing.end(), jobID);
+    if (it != queue->m_processing.end())
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
 {
+  // check and add under the lock, so that jobs added at once don't all start a worker
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (m_processingJobs >= GetMaxWorkers(priority))
     return;
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  // do we have any sleeping threads? Workers still starting up count as well, they look for
+  // jobs before they go to sleep
+  if (m_processingJobs < m_workers.size())
   {
     m_jobEvent.Set();
     return;
@@ -266,53 +306,123 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   m_workers.push_back(new CJobWorker(this));
 }
 
-CJob *CJobManager::PopJob()
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
+{
+  const unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int processing = m_processingJobs;
+  do
+  {
+    if (processing >= maxWorkers)
+      return false;
+  } while (!m_processingJobs.compare_exchange_weak(processing, processing + 1));
+  return true;
+}
+
+bool CJobManager::HasQueuedJobs() const
+{
+  for (const auto& queued : m_queuedJobs)
+  {
+    if (queued > 0)
+      return true;
+  }
+  return false;
+}
+
+CJob *CJobManager::PopJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (m_queuedJobs[priority] == 0 || !ReserveWorker(CJob::PRIORITY(priority)))
+      continue;
+
+    // the oldest job of our own queue, else the oldest one of another queue
+    for (size_t n = 0; n < m_queues.size(); ++n)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
+      const size_t index = (worker->m_queue + n) % m_queues.size();
+      CWorkQueue &queue = *m_queues[index];
+      CSingleLock lock(queue.m_section);
+
+      JobQueue &jobs = queue.m_jobQueue[priority];
+      if (jobs.empty())
+        continue;
+
+      // pop the job off the queue, stolen jobs too are taken first in, first out
+      CWorkItem job = jobs.front();
+      jobs.pop_front();
+      --m_queuedJobs[priority];
 
       // add to the processing vector
-      m_processing.push_back(job);
+      queue.m_processing.push_back(job);
       job.m_job->m_callback = this;
+      lock.Leave();
+
+      worker->m_currentQueue = index;
+      RecordLatency(job);
       return job.m_job;
     }
+
+    // somebody else was faster, give back the slot
+    --m_processingJobs;
   }
   return NULL;
 }
 
+void CJobManager::RecordLatency(const CWorkItem &item)
+{
+  const auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - item.m_queuedAt).count();
+
+  // the bucket is the bit width of the latency in microseconds
+  size_t bucket = 0;
+  for (uint64_t us = waited > 0 ? waited : 0; us && bucket < LATENCY_BUCKETS - 1; us >>= 1)
+    ++bucket;
+  m_latency[item.m_priority][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+CJobManager::LatencyHistogram CJobManager::GetLatencyHistogram(CJob::PRIORITY priority) const
+{
+  LatencyHistogram histogram;
+  for (size_t i = 0; i < LATENCY_BUCKETS; ++i)
+    histogram[i] = m_latency[priority][i].load(std::memory_order_relaxed);
+  return histogram;
+}
+
+void CJobManager::ResetLatencyHistograms()
+{
+  for (auto& buckets : m_latency)
+  {
+    for (auto& bucket : buckets)
+      bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& queue : m_queues)
   {
-    if (priority == it->m_priority)
-      return true;
+    CSingleLock lock(queue->m_section);
+    for(Processing::const_iterator it = queue->m_processing.begin(); it < queue->m_processing.end(); ++it)
+    {
+      if (priority == it->m_priority)
+        return true;
+    }
   }
   return false;
 }
@@ -320,40 +430,49 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& queue : m_queues)
   {
-    if (type == std::string(it->m_job->GetType()))
-      jobsMatched++;
+    CSingleLock lock(queue->m_section);
+    for(Processing::const_iterator it = queue->m_processing.begin(); it < queue->m_processing.end(); ++it)
+    {
+      if (type == std::string(it->m_job->GetType()))
+        jobsMatched++;
+    }
   }
   return jobsMatched;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  // count as idle before looking for a job, so a job added meanwhile is
+  // either found by us or wakes us up
+  ++m_idleWorkers;
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
+    {
+      --m_idleWorkers;
+      // wake up another sleeping worker if there's more to do
+      if (m_idleWorkers > 0 && HasQueuedJobs())
+        m_jobEvent.Set();
       return job;
+    }
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
-      break;
+    if (!m_jobEvent.WaitMSec(30000))
+    {
+      --m_idleWorkers;
+      if (RemoveIdleWorker(worker))
+        return NULL;
+      ++m_idleWorkers;
+    }
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
-  if (job)
-    return job;
+  --m_idleWorkers;
   // have no jobs
   RemoveWorker(worker);
   return NULL;
@@ -361,28 +480,37 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  for (size_t n = 0; n < m_queues.size(); ++n)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    // usually called from the job itself, so start with the queue it was taken from
+    const size_t first = currentWorker && currentWorker->m_jobManager == this ? currentWorker->m_currentQueue : 0;
+    const CWorkQueue &queue = *m_queues[(first + n) % m_queues.size()];
+    CSingleLock lock(queue.m_section);
+
+    // find the job in the processing queue, and check whether it's cancelled (no callback)
+    Processing::const_iterator i = find(queue.m_processing.begin(), queue.m_processing.end(), job);
+    if (i != queue.m_processing.end())
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(*i);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      break;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
 }
 
-void CJobManager::OnJobComplete(bool success, CJob *job)
+void CJobManager::OnJobComplete(CJobWorker *worker, bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
+  CWorkQueue &queue = *m_queues[worker->m_currentQueue];
+  CSingleLock lock(queue.m_section);
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  Processing::iterator i = find(queue.m_processing.begin(), queue.m_processing.end(), job);
+  if (i != queue.m_processing.end())
   {
     // tell any listeners we're done with the job, then delete it
     CWorkItem item(*i);
@@ -397,12 +525,13 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    Processing::iterator j = find(queue.m_processing.begin(), queue.m_processing.end(), job);
+    if (j != queue.m_processing.end())
+      queue.m_processing.erase(j);
     lock.Leave();
     item.FreeJob();
   }
+  --m_processingJobs;
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
@@ -414,6 +543,17 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
+bool CJobManager::RemoveIdleWorker(const CJobWorker *worker)
+{
+  // a job queued after we stopped counting as idle didn't wake us up, so stay
+  // around for it (AddJob() starts a new worker in case it saw none idle)
+  if (m_running && HasQueuedJobs())
+    return false;
+
+  RemoveWorker(worker);
+  return true;
+}
+
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
 {
   static const unsigned int max_workers = 5;
@@ -12,6 +12,10 @@
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <queue>
 #include <string>
 #include <vector>
@@ -26,7 +30,11 @@ public:
 
   void Process() override;
 private:
+  friend class CJobManager;
+
   CJobManager  *m_jobManager;
+  size_t        m_queue;        ///< index of the work queue this worker takes jobs from first
+  size_t        m_currentQueue; ///< index of the work queue the job in progress was taken from
 };
 
 template<typename F>
@@ -187,6 +195,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Jobs are spread over several work queues, one per regular worker, each with its own
+ lock. A worker takes the oldest job of its own queue and steals the oldest job of
+ another queue when its own one is empty, always going for the highest priority
+ that has jobs waiting. Queuing a job therefore only contends with the few workers
+ touching the same queue; the manager lock is held just to wake or start a worker.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -200,6 +214,7 @@ class CJobManager final
       m_id = id;
       m_callback = callback;
       m_priority = priority;
+      m_queuedAt = std::chrono::steady_clock::now();
     }
     bool operator==(unsigned int jobID) const
     {
@@ -222,9 +237,19 @@ class CJobManager final
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+    std::chrono::steady_clock::time_point m_queuedAt;
   };
 
 public:
+  static constexpr size_t LATENCY_BUCKETS = 24;
+
+  /*!
+   \brief Histogram of the time jobs waited in the queue before a worker picked them up.
+   Bucket 0 counts waits below 1us, bucket i waits in [2^(i-1), 2^i) us. The last
+   bucket also counts everything longer.
+   */
+  typedef std::array<uint64_t, LATENCY_BUCKETS> LatencyHistogram;
+
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
    \return the global instance.
@@ -259,6 +284,13 @@ public:
     AddJob(new CLambdaJob<F>(std::forward<F>(f)), callback, priority);
   }
 
+  /*!
+   \brief The number of jobs of a priority that are processed at once at most
+   \param priority the priority of the jobs
+   \return the number of jobs, counting the jobs of higher priority that are processing
+   */
+  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+
   /*!
    \brief Cancel a job with the given id.
    \param jobID the id of the job to cancel, retrieved previously from AddJob()
@@ -309,6 +341,20 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Get the queue latency histogram of all jobs started with the given priority.
+   \param priority the priority to get the histogram for
+   \return the histogram
+   \sa LatencyHistogram, ResetLatencyHistograms()
+   */
+  LatencyHistogram GetLatencyHistogram(CJob::PRIORITY priority) const;
+
+  /*!
+   \brief Clear the queue latency histograms of all priorities.
+   \sa GetLatencyHistogram()
+   */
+  void ResetLatencyHistograms();
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -319,16 +365,17 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
    Calls IJobCallback::OnJobComplete(), and then destroys job.
+   \param worker the CJobWorker instance that processed the job.
    \param job a pointer to the calling subclassed CJob instance.
    \param success the result from the DoWork call
    \sa IJobCallback, CJob
    */
-  void  OnJobComplete(bool success, CJob *job);
+  void  OnJobComplete(CJobWorker *worker, bool success, CJob *job);
 
   /*!
    \brief Callback from CJob to report progress and check for cancellation.
@@ -347,27 +394,51 @@ private:
   CJobManager(const CJobManager&) = delete;
   CJobManager const& operator=(CJobManager const&) = delete;
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*! \brief A work queue shard, holding the waiting jobs of each priority and the jobs taken
+   from it that are still processing. Both live under one lock so a job is never in between.
+   */
+  struct CWorkQueue
+  {
+    JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
+    Processing m_processing;
+    mutable CCriticalSection m_section;
+  };
+
+  /*! \brief Pop a job off the job queues and add to the processing queue ready to process
+   \param worker the worker to pop the job for, its own queue is tried first
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(CJobWorker *worker);
+
+  /*! \brief Claim a worker slot for a job of the given priority
+   \return true if fewer than GetMaxWorkers(priority) jobs are processing, false otherwise
+   */
+  bool ReserveWorker(CJob::PRIORITY priority);
+  bool HasQueuedJobs() const;
+  void RecordLatency(const CWorkItem &item);
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  bool RemoveIdleWorker(const CJobWorker *worker);
 
-  unsigned int m_jobCounter;
-
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  std::atomic<unsigned int> m_jobCounter;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
-  Processing m_processing;
+  std::vector<std::unique_ptr<CWorkQueue>> m_queues;
+  std::atomic<size_t> m_nextQueue{0};
+  std::atomic<size_t> m_nextWorkerQueue{0};
+  std::atomic<unsigned int> m_queuedJobs[CJob::PRIORITY_DEDICATED + 1];
+  std::atomic<unsigned int> m_processingJobs{0};
+  std::atomic<unsigned int> m_idleWorkers{0};
+  std::atomic<bool> m_pauseJobs;
   Workers    m_workers;
 
+  std::atomic<uint64_t> m_latency[CJob::PRIORITY_DEDICATED + 1][LATENCY_BUCKETS];
+
   mutable CCriticalSection m_section;
   CEvent           m_jobEvent;
-  bool             m_running;
+  std::atomic<bool> m_running;
 };
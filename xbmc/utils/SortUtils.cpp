@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <inttypes.h>
+#include <numeric>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
@@ -1018,6 +1019,103 @@ void SortUtils::Sort(const SortDescription &sortDescription, SortItems& items)
   Sort(sortDescription.sortBy, sortDescription.sortOrder, sortDescription.sortAttributes, items, sortDescription.limitEnd, sortDescription.limitStart);
 }
 
+std::vector<size_t> SortUtils::SortIndexed(const SortDescription& sortDescription,
+                                           size_t count,
+                                           const std::function<void(size_t, SortItem&)>& fill,
+                                           std::vector<std::wstring>* sortLabels /* = nullptr */)
+{
+  std::vector<size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+
+  std::vector<std::wstring> labels;
+  SortPreparator preparator = NULL;
+  if (sortDescription.sortBy != SortByNone)
+    preparator = getPreparator(sortDescription.sortBy);
+
+  if (preparator != NULL)
+  {
+    const Fields& sortingFields = GetFieldsForSorting(sortDescription.sortBy);
+    const SortAttribute attributes = sortDescription.sortAttributes;
+
+    // the columns to sort on
+    std::vector<int8_t> special(count, SortSpecialNone);
+    std::vector<int8_t> folder(count, -1);
+    std::vector<uint64_t> keys;
+    std::vector<size_t> keyOffsets(count + 1, 0);
+    labels.resize(count);
+    bool useKeys = true;
+
+    SortItem item;
+    for (size_t index = 0; index < count; ++index)
+    {
+      item.clear();
+      for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+
+      fill(index, item);
+
+      SortItem::const_iterator it = item.find(FieldSortSpecial);
+      if (it != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+        special[index] = static_cast<int8_t>(it->second.asInteger());
+      it = item.find(FieldFolder);
+      if (it != item.end())
+        folder[index] = it->second.asBoolean() ? 1 : 0;
+
+      g_charsetConverter.utf8ToW(preparator(attributes, item), labels[index], false);
+      keyOffsets[index] = keys.size();
+      if (useKeys)
+        useKeys = StringUtils::AlphaNumericCollationKey(labels[index], keys);
+    }
+    keyOffsets[count] = keys.size();
+
+    const bool handleFolder = !(attributes & SortAttributeIgnoreFolders);
+    const bool descending = sortDescription.sortOrder == SortOrderDescending;
+    auto compareLabels = [&](size_t left, size_t right) -> int64_t {
+      if (!useKeys)
+        return StringUtils::AlphaNumericCompare(labels[left].c_str(), labels[right].c_str());
+
+      const uint64_t* l = keys.data() + keyOffsets[left];
+      const uint64_t* lEnd = keys.data() + keyOffsets[left + 1];
+      const uint64_t* r = keys.data() + keyOffsets[right];
+      const uint64_t* rEnd = keys.data() + keyOffsets[right + 1];
+      auto mismatch = std::mismatch(l, lEnd, r, rEnd);
+      if (mismatch.first == lEnd)
+        return mismatch.second == rEnd ? 0 : -1;
+      if (mismatch.second == rEnd)
+        return 1;
+      return *mismatch.first < *mismatch.second ? -1 : 1;
+    };
+
+    // same rules as preliminarySort() and the Sorter* functions
+    std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+      if (special[left] != special[right])
+        return special[left] == SortSpecialOnTop || special[right] == SortSpecialOnBottom;
+      if (special[left] != SortSpecialNone)
+        return false;
+
+      if (handleFolder && folder[left] >= 0 && folder[right] >= 0 && folder[left] != folder[right])
+        return folder[left] == 1;
+
+      const int64_t result = compareLabels(left, right);
+      return descending ? result > 0 : result < 0;
+    });
+  }
+
+  int limitEnd = sortDescription.limitEnd;
+  if (sortDescription.limitStart > 0 && (size_t)sortDescription.limitStart < order.size())
+  {
+    order.erase(order.begin(), order.begin() + sortDescription.limitStart);
+    limitEnd -= sortDescription.limitStart;
+  }
+  if (limitEnd > 0 && (size_t)limitEnd < order.size())
+    order.erase(order.begin() + limitEnd, order.end());
+
+  if (sortLabels)
+    *sortLabels = std::move(labels);
+
+  return order;
+}
+
 bool SortUtils::SortFromDataset(const SortDescription &sortDescription, const MediaType &mediaType, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results)
 {
   FieldList fields;
@@ -12,6 +12,7 @@
 #include "LabelFormatter.h"
 #include "SortFileItem.h"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -204,6 +205,24 @@ public:
   static void Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attributes, SortItems& items, int limitEnd = -1, int limitStart = 0);
   static void Sort(const SortDescription &sortDescription, DatabaseResults& items);
   static void Sort(const SortDescription &sortDescription, SortItems& items);
+
+  /*! \brief Sort items without keeping a SortItem per item around (columnar sort).
+
+   Each item's sort fields are filled into a temporary SortItem, from which only the sort label
+   is kept as a precomputed collation key in one contiguous array, next to arrays of the
+   special sort and folder flags. Numbers in the labels (dates, years, track numbers, ...)
+   become integers in the key. An index permutation is then sorted on these arrays, giving
+   the same order as Sort().
+   \param sortDescription the sort method, order, attributes and limits to apply
+   \param count the number of items to sort
+   \param fill called once per item with its index, to fill in its sort fields
+   \param sortLabels (optional) receives the sort label of each item, in original item order
+   \return the sorted item indices, limited according to sortDescription
+   */
+  static std::vector<size_t> SortIndexed(const SortDescription& sortDescription,
+                                         size_t count,
+                                         const std::function<void(size_t, SortItem&)>& fill,
+                                         std::vector<std::wstring>* sortLabels = nullptr);
   static bool SortFromDataset(const SortDescription &sortDescription, const MediaType &mediaType, const std::unique_ptr<dbiplus::Dataset> &dataset, DatabaseResults &results);
 
   static void GetFieldsForSQLSort(const MediaType& mediaType, SortBy sortMethod, FieldList& fields);
@@ -1139,6 +1139,51 @@ int64_t StringUtils::AlphaNumericCompare(const wchar_t* left, const wchar_t* rig
   return 0; // files are the same
 }
 
+bool StringUtils::AlphaNumericCollationKey(const std::wstring& label, std::vector<uint64_t>& key)
+{
+  if (g_langInfo.UseLocaleCollation())
+    return false;
+
+  // Every char becomes one key element, in the same order AlphaNumericCompare() puts them:
+  // ascii punctuation and symbols (their code) first, then all other chars (their case and
+  // accent folded weight). A run of up to 15 digits sorts among the other chars like a digit
+  // does, and becomes a marker followed by its numerical value.
+  static constexpr uint64_t OTHER = static_cast<uint64_t>(1) << 32;
+  const wchar_t* c = label.c_str();
+  while (*c != 0)
+  {
+    if (*c >= L'0' && *c <= L'9')
+    {
+      const wchar_t* start = c;
+      int64_t num = 0;
+      while (*c >= L'0' && *c <= L'9' && c < start + 15)
+      { // compare only up to 15 digits
+        num *= 10;
+        num += *c++ - L'0';
+      }
+      key.push_back(OTHER + L'0');
+      key.push_back(static_cast<uint64_t>(num));
+      continue;
+    }
+
+    wchar_t lc = *c++;
+    const bool sym = (lc >= 32 && lc < L'0') || (lc > L'9' && lc < L'A') ||
+                     (lc > L'Z' && lc < L'a') || (lc > L'z' && lc < 128);
+    if (sym)
+    {
+      key.push_back(static_cast<uint64_t>(lc));
+      continue;
+    }
+
+    if (lc > 128)
+      lc = GetCollationWeight(lc);
+    if (lc >= L'A' && lc <= L'Z')
+      lc += L'a' - L'A';
+    key.push_back(OTHER + static_cast<uint32_t>(lc));
+  }
+  return true;
+}
+
 /*
   Convert the UTF8 character to which z points into a 31-bit Unicode point.
   Return how many bytes (0 to 3) of UTF8 data encode the character.
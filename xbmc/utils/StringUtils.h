@@ -247,6 +247,15 @@ public:
                                              size_t iMaxStrings = 0);
   static int FindNumber(const std::string& strInput, const std::string &strFind);
   static int64_t AlphaNumericCompare(const wchar_t *left, const wchar_t *right);
+  /*! \brief Append a collation key of the given string to key.
+   Comparing two keys with std::lexicographical_compare orders the strings like
+   AlphaNumericCompare(), which allows to compute the key once per string when sorting.
+   \param label the string to compute the key of
+   \param key vector to append the key to
+   \return false (leaving key untouched) if locale collation is in use, which can't be
+   expressed as a key
+   */
+  static bool AlphaNumericCollationKey(const std::wstring& label, std::vector<uint64_t>& key);
   static int AlphaNumericCollation(int nKey1, const void* pKey1, int nKey2, const void* pKey2);
   static long TimeStringToSeconds(const std::string &timeString);
   static void RemoveCRLF(std::string& strLine);
@@ -8,6 +8,8 @@
 
 #include "Variant.h"
 
+#include <algorithm>
+#include <new>
 #include <stdlib.h>
 #include <string.h>
 #include <utility>
@@ -116,6 +118,131 @@ double str2double(const std::wstring &str, double fallback /* = 0.0 */)
   return fallback;
 }
 
+CVariant::VariantMap::VariantMap(const VariantMap& rhs)
+{
+  if (rhs.empty())
+    return;
+
+  // one block in key order, so iterating the copy walks memory linearly
+  addBlock(rhs.size());
+  for (const value_type* entry : rhs.m_index)
+    m_index.push_back(new (m_block->entries() + m_block->used++) value_type(*entry));
+}
+
+CVariant::VariantMap::~VariantMap()
+{
+  clear();
+}
+
+CVariant::VariantMap::Index::const_iterator CVariant::VariantMap::lowerBound(
+    const std::string& key) const
+{
+  // members are mostly added in key order (copies, sorted sources), check the end first
+  if (m_index.empty() || m_index.back()->first < key)
+    return m_index.end();
+
+  return std::lower_bound(m_index.begin(), m_index.end(), key,
+                          [](const value_type* entry, const std::string& key) {
+                            return entry->first < key;
+                          });
+}
+
+void CVariant::VariantMap::addBlock(size_t capacity)
+{
+  static_assert(sizeof(Block) % alignof(value_type) == 0, "members would be misaligned");
+
+  // the index grows along, so it doesn't need to reallocate in between
+  m_index.reserve(m_index.size() + m_free.size() + capacity);
+
+  Block* block = static_cast<Block*>(::operator new(sizeof(Block) + capacity * sizeof(value_type)));
+  block->previous = m_block;
+  block->used = 0;
+  block->capacity = capacity;
+  m_block = block;
+}
+
+CVariant::VariantMap::value_type* CVariant::VariantMap::allocate()
+{
+  if (!m_free.empty())
+  {
+    value_type* entry = m_free.back();
+    m_free.pop_back();
+    return entry;
+  }
+
+  if (!m_block)
+    addBlock(8);
+  else if (m_block->used == m_block->capacity)
+    addBlock(m_index.size()); // doubles the total capacity
+
+  return m_block->entries() + m_block->used++;
+}
+
+CVariant::VariantMap::const_iterator CVariant::VariantMap::find(const std::string& key) const
+{
+  Index::const_iterator it = lowerBound(key);
+  if (it != m_index.end() && (*it)->first == key)
+    return const_iterator(it);
+
+  return end();
+}
+
+CVariant& CVariant::VariantMap::operator[](const std::string& key)
+{
+  Index::const_iterator it = lowerBound(key);
+  if (it != m_index.end() && (*it)->first == key)
+    return (*it)->second;
+
+  const size_t position = it - m_index.begin();
+  value_type* entry = allocate();
+  it = m_index.insert(m_index.begin() + position, entry);
+  try
+  {
+    new (entry) value_type(key, CVariant());
+  }
+  catch (...)
+  {
+    m_index.erase(it);
+    m_free.push_back(entry);
+    throw;
+  }
+
+  return entry->second;
+}
+
+void CVariant::VariantMap::erase(const std::string& key)
+{
+  Index::const_iterator it = lowerBound(key);
+  if (it == m_index.end() || (*it)->first != key)
+    return;
+
+  value_type* entry = *it;
+  m_index.erase(it);
+  entry->~value_type();
+  m_free.push_back(entry);
+}
+
+void CVariant::VariantMap::clear()
+{
+  for (value_type* entry : m_index)
+    entry->~value_type();
+  while (m_block)
+  {
+    Block* previous = m_block->previous;
+    ::operator delete(m_block);
+    m_block = previous;
+  }
+
+  m_index.clear();
+  m_free.clear();
+}
+
+bool CVariant::VariantMap::operator==(const VariantMap& rhs) const
+{
+  return std::equal(m_index.begin(), m_index.end(), rhs.m_index.begin(), rhs.m_index.end(),
+                    [](const value_type* lhs, const value_type* rhs) { return *lhs == *rhs; });
+}
+
 CVariant::CVariant()
   : CVariant(VariantTypeNull)
 {
@@ -144,10 +271,10 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      setString("", 0);
       break;
     case VariantTypeWideString:
-      m_data.wstring = new std::wstring();
+      setWideString(L"", 0);
       break;
     case VariantTypeArray:
       m_data.array = new VariantArray();
@@ -207,50 +334,42 @@ CVariant::CVariant(bool boolean)
 
 CVariant::CVariant(const char *str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  setString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
-  m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str);
+  setWideString(str, wcslen(str));
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
-  m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str, length);
+  setWideString(str, length);
 }
 
 CVariant::CVariant(const std::wstring &str)
 {
-  m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(str);
+  setWideString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::wstring &&str)
 {
-  m_type = VariantTypeWideString;
-  m_data.wstring = new std::wstring(std::move(str));
+  setWideString(std::move(str));
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
@@ -267,13 +386,15 @@ CVariant::CVariant(const std::map<std::string, std::string> &strMap)
   m_type = VariantTypeObject;
   m_data.map = new VariantMap;
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    (*m_data.map)[it->first] = CVariant(it->second);
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
 {
   m_type = VariantTypeObject;
-  m_data.map = new VariantMap(variantMap.begin(), variantMap.end());
+  m_data.map = new VariantMap;
+  for (std::map<std::string, CVariant>::const_iterator it = variantMap.begin(); it != variantMap.end(); ++it)
+    (*m_data.map)[it->first] = it->second;
 }
 
 CVariant::CVariant(const CVariant &variant)
@@ -301,12 +422,14 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
+    if (m_shortLength == LONG_STRING)
+      delete m_data.string;
     m_data.string = nullptr;
     break;
 
   case VariantTypeWideString:
-    delete m_data.wstring;
+    if (m_shortLength == LONG_STRING)
+      delete m_data.wstring;
     m_data.wstring = nullptr;
     break;
 
@@ -323,6 +446,83 @@ void CVariant::cleanup()
     break;
   }
   m_type = VariantTypeNull;
+  m_shortLength = LONG_STRING;
+}
+
+void CVariant::setString(const char* str, size_t length)
+{
+  m_type = VariantTypeString;
+  if (length <= MAX_SHORT_STRING)
+  {
+    memcpy(m_data.shortString, str, length);
+    m_data.shortString[length] = '\0';
+    m_shortLength = static_cast<uint8_t>(length);
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_shortLength = LONG_STRING;
+  }
+}
+
+void CVariant::setString(std::string&& str)
+{
+  if (str.size() <= MAX_SHORT_STRING)
+    setString(str.c_str(), str.size());
+  else
+  {
+    m_type = VariantTypeString;
+    m_data.string = new std::string(std::move(str));
+    m_shortLength = LONG_STRING;
+  }
+}
+
+void CVariant::setWideString(const wchar_t* str, size_t length)
+{
+  m_type = VariantTypeWideString;
+  if (length <= MAX_SHORT_WIDESTRING)
+  {
+    wmemcpy(m_data.shortWideString, str, length);
+    m_data.shortWideString[length] = L'\0';
+    m_shortLength = static_cast<uint8_t>(length);
+  }
+  else
+  {
+    m_data.wstring = new std::wstring(str, length);
+    m_shortLength = LONG_STRING;
+  }
+}
+
+void CVariant::setWideString(std::wstring&& str)
+{
+  if (str.size() <= MAX_SHORT_WIDESTRING)
+    setWideString(str.c_str(), str.size());
+  else
+  {
+    m_type = VariantTypeWideString;
+    m_data.wstring = new std::wstring(std::move(str));
+    m_shortLength = LONG_STRING;
+  }
+}
+
+const char* CVariant::stringData() const
+{
+  return m_shortLength == LONG_STRING ? m_data.string->c_str() : m_data.shortString;
+}
+
+size_t CVariant::stringSize() const
+{
+  return m_shortLength == LONG_STRING ? m_data.string->size() : m_shortLength;
+}
+
+const wchar_t* CVariant::wideStringData() const
+{
+  return m_shortLength == LONG_STRING ? m_data.wstring->c_str() : m_data.shortWideString;
+}
+
+size_t CVariant::wideStringSize() const
+{
+  return m_shortLength == LONG_STRING ? m_data.wstring->size() : m_shortLength;
 }
 
 bool CVariant::isInteger() const
@@ -391,9 +591,9 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(asString(), fallback);
     case VariantTypeWideString:
-      return str2int64(*m_data.wstring, fallback);
+      return str2int64(asWideString(), fallback);
     default:
       return fallback;
   }
@@ -417,9 +617,9 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(asString(), fallback);
     case VariantTypeWideString:
-      return str2uint64(*m_data.wstring, fallback);
+      return str2uint64(asWideString(), fallback);
     default:
       return fallback;
   }
@@ -443,9 +643,9 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(asString(), fallback);
     case VariantTypeWideString:
-      return str2double(*m_data.wstring, fallback);
+      return str2double(asWideString(), fallback);
     default:
       return fallback;
   }
@@ -464,9 +664,9 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(asString(), fallback);
     case VariantTypeWideString:
-      return (float)str2double(*m_data.wstring, fallback);
+      return (float)str2double(asWideString(), fallback);
     default:
       return fallback;
   }
@@ -487,11 +687,11 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+      if (stringSize() == 0 || strcmp(stringData(), "0") == 0 || strcmp(stringData(), "false") == 0)
         return false;
       return true;
     case VariantTypeWideString:
-      if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
+      if (wideStringSize() == 0 || wcscmp(wideStringData(), L"0") == 0 || wcscmp(wideStringData(), L"false") == 0)
         return false;
       return true;
     default:
@@ -506,7 +706,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return std::string(stringData(), stringSize());
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -527,7 +727,7 @@ std::wstring CVariant::asWideString(const std::wstring &fallback /* = L"" */) co
   switch (m_type)
   {
     case VariantTypeWideString:
-      return *m_data.wstring;
+      return std::wstring(wideStringData(), wideStringSize());
     case VariantTypeBoolean:
       return m_data.boolean ? L"true" : L"false";
     case VariantTypeInteger:
@@ -606,16 +806,16 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    setString(rhs.stringData(), rhs.stringSize());
     break;
   case VariantTypeWideString:
-    m_data.wstring = new std::wstring(*rhs.m_data.wstring);
+    setWideString(rhs.wideStringData(), rhs.wideStringSize());
     break;
   case VariantTypeArray:
     m_data.array = new VariantArray(rhs.m_data.array->begin(), rhs.m_data.array->end());
     break;
   case VariantTypeObject:
-    m_data.map = new VariantMap(rhs.m_data.map->begin(), rhs.m_data.map->end());
+    m_data.map = new VariantMap(*rhs.m_data.map);
     break;
   default:
     break;
@@ -634,6 +834,7 @@ CVariant& CVariant::operator=(CVariant&& rhs) noexcept
     cleanup();
 
   m_type = rhs.m_type;
+  m_shortLength = rhs.m_shortLength;
   m_data = rhs.m_data;
 
   //Should be enough to just set m_type here
@@ -648,6 +849,7 @@ CVariant& CVariant::operator=(CVariant&& rhs) noexcept
     rhs.m_data.map = nullptr;
 
   rhs.m_type = VariantTypeNull;
+  rhs.m_shortLength = LONG_STRING;
 
   return *this;
 }
@@ -667,9 +869,11 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringSize() == rhs.stringSize() &&
+             memcmp(stringData(), rhs.stringData(), stringSize()) == 0;
     case VariantTypeWideString:
-      return *m_data.wstring == *rhs.m_data.wstring;
+      return wideStringSize() == rhs.wideStringSize() &&
+             wmemcmp(wideStringData(), rhs.wideStringData(), wideStringSize()) == 0;
     case VariantTypeArray:
       return *m_data.array == *rhs.m_data.array;
     case VariantTypeObject:
@@ -730,7 +934,7 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
@@ -738,12 +942,15 @@ const char *CVariant::c_str() const
 void CVariant::swap(CVariant &rhs)
 {
   VariantType  temp_type = m_type;
+  uint8_t      temp_shortLength = m_shortLength;
   VariantUnion temp_data = m_data;
 
   m_type = rhs.m_type;
+  m_shortLength = rhs.m_shortLength;
   m_data = rhs.m_data;
 
   rhs.m_type = temp_type;
+  rhs.m_shortLength = temp_shortLength;
   rhs.m_data = temp_data;
 }
 
@@ -818,9 +1025,9 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringSize();
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->size();
+    return wideStringSize();
   else
     return 0;
 }
@@ -832,9 +1039,9 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringSize() == 0;
   else if (m_type == VariantTypeWideString)
-    return m_data.wstring->empty();
+    return wideStringSize() == 0;
   else if (m_type == VariantTypeNull)
     return true;
 
@@ -848,9 +1055,15 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    cleanup();
+    setString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
-    m_data.wstring->clear();
+  {
+    cleanup();
+    setWideString(L"", 0);
+  }
 }
 
 void CVariant::erase(const std::string &key)
@@ -8,9 +8,13 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <map>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <wchar.h>
 
@@ -114,7 +118,109 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+
+  /*!
+   \brief Storage of the members of an object, ordered by key like a std::map
+
+   The members are constructed in a few blocks of growing size and are looked up by a binary
+   search over a sorted vector of pointers to them. Filling an object therefore takes a handful
+   of allocations instead of one per member. Members never move once added, so references to
+   them stay valid until they are erased, just like with a std::map.
+   */
+  class VariantMap
+  {
+  public:
+    typedef std::pair<const std::string, CVariant> value_type;
+
+  private:
+    typedef std::vector<value_type*> Index;
+
+  public:
+    template<typename Value>
+    class Iterator
+    {
+    public:
+      typedef std::bidirectional_iterator_tag iterator_category;
+      typedef typename std::remove_const<Value>::type value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef Value* pointer;
+      typedef Value& reference;
+
+      Iterator() = default;
+      explicit Iterator(Index::const_iterator it) : m_it(it) {}
+      template<typename Other,
+               typename = typename std::enable_if<std::is_const<Value>::value &&
+                                                  !std::is_const<Other>::value>::type>
+      Iterator(const Iterator<Other>& other) : m_it(other.m_it)
+      {
+      }
+
+      reference operator*() const { return **m_it; }
+      pointer operator->() const { return *m_it; }
+      Iterator& operator++()
+      {
+        ++m_it;
+        return *this;
+      }
+      Iterator operator++(int) { return Iterator(m_it++); }
+      Iterator& operator--()
+      {
+        --m_it;
+        return *this;
+      }
+      Iterator operator--(int) { return Iterator(m_it--); }
+
+      friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.m_it == rhs.m_it; }
+      friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.m_it != rhs.m_it; }
+
+    private:
+      template<typename>
+      friend class Iterator;
+      Index::const_iterator m_it;
+    };
+
+    typedef Iterator<value_type> iterator;
+    typedef Iterator<const value_type> const_iterator;
+
+    VariantMap() = default;
+    VariantMap(const VariantMap& rhs);
+    ~VariantMap();
+    VariantMap& operator=(const VariantMap& rhs) = delete;
+
+    iterator begin() { return iterator(m_index.begin()); }
+    const_iterator begin() const { return const_iterator(m_index.begin()); }
+    iterator end() { return iterator(m_index.end()); }
+    const_iterator end() const { return const_iterator(m_index.end()); }
+
+    size_t size() const { return m_index.size(); }
+    bool empty() const { return m_index.empty(); }
+
+    const_iterator find(const std::string& key) const;
+    CVariant& operator[](const std::string& key);
+    void erase(const std::string& key);
+    void clear();
+
+    bool operator==(const VariantMap& rhs) const;
+
+  private:
+    //! header of a block, followed by the storage for capacity members
+    struct Block
+    {
+      Block* previous;
+      size_t used;
+      size_t capacity;
+
+      value_type* entries() { return reinterpret_cast<value_type*>(this + 1); }
+    };
+
+    Index::const_iterator lowerBound(const std::string& key) const;
+    void addBlock(size_t capacity);
+    value_type* allocate();
+
+    Index m_index;
+    Block* m_block = nullptr; ///< the most recently added block
+    std::vector<value_type*> m_free; ///< storage of erased members, reused first
+  };
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -155,9 +261,27 @@ private:
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
+    char shortString[24];
+    wchar_t shortWideString[24 / sizeof(wchar_t)];
   };
 
+  static constexpr size_t MAX_SHORT_STRING = sizeof(VariantUnion::shortString) - 1;
+  static constexpr size_t MAX_SHORT_WIDESTRING = sizeof(VariantUnion::shortWideString) / sizeof(wchar_t) - 1;
+  static constexpr uint8_t LONG_STRING = 0xff;
+
+  void setString(const char* str, size_t length);
+  void setString(std::string&& str);
+  void setWideString(const wchar_t* str, size_t length);
+  void setWideString(std::wstring&& str);
+  const char* stringData() const;
+  size_t stringSize() const;
+  const wchar_t* wideStringData() const;
+  size_t wideStringSize() const;
+
   VariantType m_type;
+  /*! length of a string stored in m_data.shortString/shortWideString, or LONG_STRING if it
+   is allocated on the heap */
+  uint8_t m_shortLength = LONG_STRING;
   VariantUnion m_data;
 
   static VariantArray EMPTY_ARRAY;
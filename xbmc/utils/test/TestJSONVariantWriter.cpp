@@ -9,6 +9,10 @@
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(TestJSONVariantWriter, CanWriteNull)
@@ -149,3 +153,121 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+namespace
+{
+std::string ReadAll(CJSONVariantStreamWriter& writer, size_t chunkSize)
+{
+  std::string str;
+  std::vector<char> buffer(chunkSize);
+  ssize_t read;
+  while ((read = writer.Read(buffer.data(), buffer.size())) > 0)
+    str.append(buffer.data(), read);
+
+  EXPECT_EQ(0, read);
+  return str;
+}
+
+CVariant CreateSong(int id)
+{
+  CVariant song;
+  song["songid"] = id;
+  song["label"] = "Song " + std::to_string(id);
+  song["genre"].push_back("Rock");
+  song["genre"].push_back("Pop");
+  song["rating"] = 0.5 * id;
+  song["empty"] = CVariant(CVariant::VariantTypeArray);
+  return song;
+}
+
+// creates the songs from a range of ids only when they are asked for
+class CSongSource : public IJSONVariantItemSource
+{
+public:
+  CSongSource(int begin, int end, int& created) : m_next(begin), m_end(end), m_created(created) {}
+
+  bool GetNext(CVariant& item) override
+  {
+    if (m_next == m_end)
+      return false;
+
+    item = CreateSong(m_next++);
+    m_created++;
+    return true;
+  }
+
+private:
+  int m_next;
+  const int m_end;
+  int& m_created;
+};
+} // namespace
+
+TEST(TestJSONVariantWriter, CanStream)
+{
+  CVariant variant;
+  variant["id"] = 1;
+  variant["jsonrpc"] = "2.0";
+  variant["result"]["limits"]["total"] = 100;
+  for (int i = 0; i < 100; i++)
+    variant["result"]["songs"].push_back(CreateSong(i));
+
+  for (bool compact : {true, false})
+  {
+    std::string expected;
+    ASSERT_TRUE(CJSONVariantWriter::Write(variant, expected, compact));
+
+    for (size_t chunkSize : {1, 7, 1024, 65536})
+    {
+      CJSONVariantStreamWriter writer(CVariant(variant), compact);
+      EXPECT_EQ(expected, ReadAll(writer, chunkSize)) << "chunk size " << chunkSize;
+    }
+  }
+
+  CJSONVariantStreamWriter scalar(CVariant("foo"), true);
+  EXPECT_EQ("\"foo\"", ReadAll(scalar, 2));
+}
+
+TEST(TestJSONVariantWriter, CanStreamItemSources)
+{
+  CVariant expected;
+  expected["result"]["limits"]["total"] = 100;
+  for (int i = 0; i < 100; i++)
+    expected["result"]["songs"].push_back(CreateSong(i));
+  expected["result"]["none"] = CVariant(CVariant::VariantTypeArray);
+  expected["result"]["other"].push_back(CreateSong(1000));
+
+  for (bool compact : {true, false})
+  {
+    std::string expectedStr;
+    ASSERT_TRUE(CJSONVariantWriter::Write(expected, expectedStr, compact));
+
+    // the first songs are part of the value, the others come from the source after them
+    CVariant variant;
+    variant["result"]["limits"]["total"] = 100;
+    for (int i = 0; i < 10; i++)
+      variant["result"]["songs"].push_back(CreateSong(i));
+    variant["result"]["none"] = CVariant(CVariant::VariantTypeArray);
+    variant["result"]["other"] = CVariant(CVariant::VariantTypeArray);
+
+    int created = 0;
+    int createdOther = 0;
+    int createdNone = 0;
+    CJSONVariantStreamWriter::ItemSources itemSources;
+    itemSources[&variant["result"]["songs"]] = std::make_unique<CSongSource>(10, 100, created);
+    itemSources[&variant["result"]["other"]] =
+        std::make_unique<CSongSource>(1000, 1001, createdOther);
+    itemSources[&variant["result"]["none"]] = std::make_unique<CSongSource>(0, 0, createdNone);
+
+    CJSONVariantStreamWriter writer(std::move(variant), compact, std::move(itemSources));
+
+    // only the songs needed for the start of the document have been created
+    std::vector<char> buffer(100);
+    ASSERT_EQ(100, writer.Read(buffer.data(), buffer.size()));
+    EXPECT_GT(5, created);
+
+    EXPECT_EQ(expectedStr, std::string(buffer.data(), buffer.size()) + ReadAll(writer, 1000));
+    EXPECT_EQ(90, created);
+    EXPECT_EQ(1, createdOther);
+  }
+}
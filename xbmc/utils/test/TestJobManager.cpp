@@ -11,7 +11,10 @@
 #include "utils/JobManager.h"
 #include "utils/XTimeUtils.h"
 
+#include <algorithm>
 #include <atomic>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -213,3 +216,98 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+uint64_t HistogramCount(const CJobManager::LatencyHistogram& histogram)
+{
+  uint64_t count = 0;
+  for (uint64_t bucket : histogram)
+    count += bucket;
+  return count;
+}
+
+// upper bound in microseconds of the bucket holding the given percentile
+uint64_t HistogramPercentile(const CJobManager::LatencyHistogram& histogram, double percentile)
+{
+  const uint64_t count = HistogramCount(histogram);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < histogram.size(); ++i)
+  {
+    seen += histogram[i];
+    if (count && seen >= count * percentile)
+      return uint64_t(1) << i;
+  }
+  return uint64_t(1) << (histogram.size() - 1);
+}
+}
+
+TEST_F(TestJobManager, LatencyHistogram)
+{
+  CJobManager::GetInstance().ResetLatencyHistograms();
+
+  std::atomic<int> done{0};
+  for (int i = 0; i < 100; i++)
+    CJobManager::GetInstance().Submit([&done]() { ++done; }, CJob::PRIORITY_NORMAL);
+  ASSERT_TRUE(poll([&done]() -> bool { return done == 100; }));
+
+  EXPECT_EQ(100U, HistogramCount(CJobManager::GetInstance().GetLatencyHistogram(CJob::PRIORITY_NORMAL)));
+  EXPECT_EQ(0U, HistogramCount(CJobManager::GetInstance().GetLatencyHistogram(CJob::PRIORITY_HIGH)));
+}
+
+TEST_F(TestJobManager, AddJobFromJob)
+{
+  // jobs added by a worker go to its own queue, idle workers have to steal them
+  std::atomic<int> done{0};
+  CJobManager::GetInstance().Submit([&done]() {
+    for (int i = 0; i < 50; i++)
+      CJobManager::GetInstance().Submit([&done]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++done;
+      });
+  });
+  ASSERT_TRUE(poll([&done]() -> bool { return done == 50; }));
+}
+
+TEST_F(TestJobManager, DISABLED_ThroughputAndLatency)
+{
+  // a library scan like load of many short low priority jobs queued from several
+  // threads, with high priority jobs mixed in as the GUI would
+  constexpr int PRODUCERS = 4;
+  constexpr int LOW_JOBS = 20000;
+  constexpr int HIGH_JOBS = 500;
+
+  CJobManager::GetInstance().ResetLatencyHistograms();
+  std::atomic<int> done{0};
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; p++)
+  {
+    producers.emplace_back([&done]() {
+      for (int i = 0; i < LOW_JOBS / PRODUCERS; i++)
+      {
+        CJobManager::GetInstance().Submit([&done]() { ++done; }, CJob::PRIORITY_LOW);
+        if (i % (LOW_JOBS / HIGH_JOBS) == 0)
+          CJobManager::GetInstance().Submit([&done]() { ++done; }, CJob::PRIORITY_HIGH);
+      }
+    });
+  }
+  for (auto& producer : producers)
+    producer.join();
+
+  ASSERT_TRUE(poll(60000, [&done]() -> bool { return done == LOW_JOBS + HIGH_JOBS; }));
+  const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start).count();
+
+  const auto low = CJobManager::GetInstance().GetLatencyHistogram(CJob::PRIORITY_LOW);
+  const auto high = CJobManager::GetInstance().GetLatencyHistogram(CJob::PRIORITY_HIGH);
+  EXPECT_EQ(static_cast<uint64_t>(LOW_JOBS), HistogramCount(low));
+  EXPECT_EQ(static_cast<uint64_t>(HIGH_JOBS), HistogramCount(high));
+
+  RecordProperty("JobsPerSecond", static_cast<int>((LOW_JOBS + HIGH_JOBS) * 1000000LL / std::max<int64_t>(elapsed, 1)));
+  RecordProperty("LowP50us", static_cast<int>(HistogramPercentile(low, 0.5)));
+  RecordProperty("LowP99us", static_cast<int>(HistogramPercentile(low, 0.99)));
+  RecordProperty("HighP50us", static_cast<int>(HistogramPercentile(high, 0.5)));
+  RecordProperty("HighP99us", static_cast<int>(HistogramPercentile(high, 0.99)));
+}
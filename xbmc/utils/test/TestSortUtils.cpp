@@ -7,8 +7,12 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(TestSortUtils, Sort_SortBy)
@@ -121,3 +125,97 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+namespace
+{
+// a music library like set of items, with duplicate keys to check the sort is stable
+std::vector<SortItem> CreateSongs(size_t count)
+{
+  std::vector<SortItem> songs(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    SortItem& song = songs[i];
+    song[FieldId] = static_cast<int>(i);
+    song[FieldArtist] = StringUtils::Format("Artist {}", (i * 7919) % 997);
+    song[FieldAlbum] = StringUtils::Format("The Album {}", (i * 104729) % 4999);
+    song[FieldTrackNumber] = static_cast<int>(i % 23);
+    song[FieldYear] = static_cast<int>(1950 + (i % 70));
+    song[FieldLabel] = StringUtils::Format("{:02d} - Song {}", i % 23, (i * 31) % 10007);
+    song[FieldSize] = static_cast<int64_t>((i * 2654435761u) % 100000000);
+    song[FieldFolder] = (i % 101) == 0;
+    if (i % 997 == 5)
+      song[FieldSortSpecial] = SortSpecialOnBottom;
+  }
+  return songs;
+}
+
+std::vector<int> SortWithSortItems(const std::vector<SortItem>& songs, const SortDescription& sorting)
+{
+  SortItems items;
+  items.reserve(songs.size());
+  for (const SortItem& song : songs)
+    items.push_back(SortItemPtr(new SortItem(song)));
+
+  SortUtils::Sort(sorting, items);
+
+  std::vector<int> order;
+  for (const SortItemPtr& item : items)
+    order.push_back(static_cast<int>(item->at(FieldId).asInteger()));
+  return order;
+}
+
+std::vector<int> SortWithIndices(const std::vector<SortItem>& songs, const SortDescription& sorting)
+{
+  const std::vector<size_t> indices =
+      SortUtils::SortIndexed(sorting, songs.size(), [&songs](size_t index, SortItem& item) {
+        for (const auto& field : songs[index])
+          item[field.first] = field.second;
+      });
+  return std::vector<int>(indices.begin(), indices.end());
+}
+} // namespace
+
+TEST(TestSortUtils, SortIndexed)
+{
+  const std::vector<SortItem> songs = CreateSongs(2000);
+
+  for (SortBy sortBy : {SortByLabel, SortByArtist, SortByAlbum, SortByYear, SortBySize, SortByTrackNumber})
+  {
+    for (SortOrder sortOrder : {SortOrderAscending, SortOrderDescending})
+    {
+      SortDescription sorting;
+      sorting.sortBy = sortBy;
+      sorting.sortOrder = sortOrder;
+      EXPECT_EQ(SortWithSortItems(songs, sorting), SortWithIndices(songs, sorting))
+          << "sortBy " << sortBy << ", sortOrder " << sortOrder;
+    }
+  }
+
+  SortDescription limited;
+  limited.sortBy = SortByArtist;
+  limited.sortAttributes = SortAttributeIgnoreFolders;
+  limited.limitStart = 10;
+  limited.limitEnd = 110;
+  const std::vector<int> order = SortWithIndices(songs, limited);
+  EXPECT_EQ(100U, order.size());
+  EXPECT_EQ(SortWithSortItems(songs, limited), order);
+}
+
+TEST(TestSortUtils, DISABLED_SortIndexedBenchmark)
+{
+  const std::vector<SortItem> songs = CreateSongs(50000);
+  SortDescription sorting;
+  sorting.sortBy = SortByArtist;
+
+  auto start = std::chrono::steady_clock::now();
+  const std::vector<int> expected = SortWithSortItems(songs, sorting);
+  const auto sortItemsTime = std::chrono::steady_clock::now() - start;
+
+  start = std::chrono::steady_clock::now();
+  const std::vector<int> order = SortWithIndices(songs, sorting);
+  const auto indexedTime = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(expected, order);
+  RecordProperty("SortItemsMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(sortItemsTime).count()));
+  RecordProperty("SortIndexedMs", static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(indexedTime).count()));
+}
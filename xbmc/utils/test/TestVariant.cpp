@@ -6,8 +6,12 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <chrono>
+#include <string>
+
 #include <gtest/gtest.h>
 
 TEST(TestVariant, VariantTypeInteger)
@@ -332,3 +336,123 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, shortAndLongStrings)
+{
+  const std::string shortString("short");
+  const std::string longString("a string too long to be stored inline");
+  CVariant a(shortString), b(longString);
+  CVariant c(std::wstring(L"wide")), d(std::wstring(L"a long wide string"));
+
+  EXPECT_EQ(shortString, a.asString());
+  EXPECT_EQ(longString, b.asString());
+  EXPECT_EQ(L"wide", c.asWideString());
+  EXPECT_EQ(L"a long wide string", d.asWideString());
+  EXPECT_EQ(shortString.size(), a.size());
+  EXPECT_EQ(longString.size(), b.size());
+
+  CVariant e(a), f(b);
+  EXPECT_EQ(a, e);
+  EXPECT_EQ(b, f);
+  EXPECT_NE(a, b);
+
+  e.swap(f);
+  EXPECT_EQ(longString, e.asString());
+  EXPECT_EQ(shortString, f.asString());
+
+  CVariant g(std::move(e));
+  EXPECT_EQ(longString, g.asString());
+  EXPECT_TRUE(e.isNull());
+
+  g = a;
+  EXPECT_STREQ("short", g.c_str());
+  g.clear();
+  EXPECT_TRUE(g.isString());
+  EXPECT_TRUE(g.empty());
+}
+
+TEST(TestVariant, objectMembers)
+{
+  CVariant a;
+  a["b"] = 2;
+  a["c"] = 3;
+  CVariant& first = a["a"];
+  first = 1;
+  for (int i = 0; i < 100; i++)
+    a["key" + std::to_string(i)] = i;
+
+  // adding members doesn't move the existing ones
+  EXPECT_EQ(&first, &a["a"]);
+  EXPECT_EQ(1, first.asInteger());
+
+  // iterated in key order
+  std::string previous;
+  for (CVariant::const_iterator_map it = a.begin_map(); it != a.end_map(); ++it)
+  {
+    EXPECT_LT(previous, it->first);
+    previous = it->first;
+  }
+
+  a.erase("b");
+  EXPECT_FALSE(a.isMember("b"));
+  EXPECT_EQ(102u, a.size());
+  a["d"] = 4;
+  EXPECT_EQ(4, a["d"].asInteger());
+  EXPECT_EQ(1, first.asInteger());
+
+  CVariant b(a);
+  EXPECT_EQ(a, b);
+  b["d"] = 5;
+  EXPECT_NE(a, b);
+}
+
+TEST(TestVariant, DISABLED_Benchmark)
+{
+  using clock = std::chrono::steady_clock;
+  auto elapsedUs = [](clock::time_point start) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count());
+  };
+
+  // shaped like a JSON-RPC item list
+  auto start = clock::now();
+  CVariant items(CVariant::VariantTypeArray);
+  for (int i = 0; i < 10000; i++)
+  {
+    CVariant item;
+    item["songid"] = i;
+    item["label"] = "Song " + std::to_string(i);
+    item["artist"].push_back("Artist " + std::to_string(i % 100));
+    item["album"] = "Album " + std::to_string(i % 1000);
+    item["file"] = "/storage/music/a long path to some song number " + std::to_string(i) + ".flac";
+    item["track"] = i % 20;
+    item["year"] = 1970 + i % 50;
+    item["rating"] = 5.0;
+    items.push_back(std::move(item));
+  }
+  RecordProperty("ConstructionUs", elapsedUs(start));
+
+  start = clock::now();
+  CVariant copy(items);
+  RecordProperty("CopyUs", elapsedUs(start));
+  EXPECT_EQ(items, copy);
+
+  start = clock::now();
+  int64_t sum = 0;
+  for (int pass = 0; pass < 10; pass++)
+  {
+    for (CVariant::const_iterator_array it = copy.begin_array(); it != copy.end_array(); ++it)
+    {
+      const CVariant& item = *it;
+      sum += item["songid"].asInteger() + item["year"].asInteger() + item["label"].size();
+    }
+  }
+  RecordProperty("LookupUs", elapsedUs(start));
+  EXPECT_NE(0, sum);
+
+  start = clock::now();
+  std::string json;
+  EXPECT_TRUE(CJSONVariantWriter::Write(items, json, true));
+  RecordProperty("SerializationUs", elapsedUs(start));
+  EXPECT_FALSE(json.empty());
+}